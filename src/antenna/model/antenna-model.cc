@@ -20,7 +20,10 @@
 
 
 #include <ns3/log.h>
+#include <ns3/double.h>
 #include <cmath>
+#include <sstream>
+#include <algorithm>
 #include "antenna-model.h"
 
 
@@ -32,7 +35,49 @@ NS_OBJECT_ENSURE_REGISTERED (AntennaModel)
   ;
 
 
+/// the lowest gain (dBi) of the tables, which keeps the nulls of the
+/// radiation patterns finite so that they can be interpolated
+static const double g_minGainDb = -300.0;
+
+/**
+ * \param x the x coordinate of a vector
+ * \param y the y coordinate of a vector
+ * \return the pseudo-angle in [0, 4) of the azimuth of the vector,
+ * which increases with the azimuth by 1 for each quadrant
+ */
+static double
+GetAzimuthPseudoAngle (double x, double y)
+{
+  if (x == 0 && y == 0)
+    {
+      return 0;
+    }
+  if (y >= 0)
+    {
+      return x >= 0 ? y / (x + y) : 1 - x / (-x + y);
+    }
+  return x < 0 ? 2 - y / (-x - y) : 3 + x / (x - y);
+}
+
+/**
+ * \param r the distance of a vector to the z axis
+ * \param z the z coordinate of the vector
+ * \return the pseudo-angle in [-1, 1] of the vector, which decreases
+ * with the inclination from 1 on the positive z axis to -1 on the
+ * negative z axis
+ */
+static double
+GetInclinationPseudoAngle (double r, double z)
+{
+  if (r + std::abs (z) == 0)
+    {
+      return 0;
+    }
+  return z / (r + std::abs (z));
+}
+
 AntennaModel::AntennaModel ()
+  : m_gainTable (0)
 {
 }
 
@@ -45,10 +90,138 @@ AntennaModel::GetTypeId ()
 {
   static TypeId tid = TypeId ("ns3::AntennaModel")
     .SetParent<Object> ()
+    .AddAttribute ("GainTableResolution",
+                   "The approximate angular step (degrees) of the table of the radiation pattern "
+                   "used by GetGainDbInDirection and GetGainsDbInDirections, "
+                   "or zero to compute the gains without a table.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&AntennaModel::m_gainTableResolution),
+                   MakeDoubleChecker<double> (0.0, 90.0))
   ;
   return tid;
 }
 
+AntennaModel::GainTables *
+AntennaModel::GetGainTables (void)
+{
+  static GainTables tables;
+  return &tables;
+}
+
+double
+AntennaModel::GetGainDbInDirection (const Vector &direction)
+{
+  if (m_gainTableResolution > 0)
+    {
+      return LookupGainDb (GetGainTable (), direction);
+    }
+  return GetGainDb (Angles (direction));
+}
+
+void
+AntennaModel::GetGainsDbInDirections (const std::vector<Vector> &directions, std::vector<double> &gainsDb)
+{
+  NS_LOG_FUNCTION (this << directions.size ());
+  gainsDb.resize (directions.size ());
+  if (m_gainTableResolution > 0)
+    {
+      const GainTable *table = GetGainTable ();
+      for (uint32_t i = 0; i < directions.size (); i++)
+        {
+          gainsDb[i] = LookupGainDb (table, directions[i]);
+        }
+    }
+  else
+    {
+      for (uint32_t i = 0; i < directions.size (); i++)
+        {
+          gainsDb[i] = GetGainDb (Angles (directions[i]));
+        }
+    }
+}
+
+double
+AntennaModel::LookupGainDb (const GainTable *table, const Vector &direction)
+{
+  double r = std::sqrt (direction.x * direction.x + direction.y * direction.y);
+  double u = GetAzimuthPseudoAngle (direction.x, direction.y) * table->nAzimuths / 4;
+  double v = (GetInclinationPseudoAngle (r, direction.z) + 1) * (table->nInclinations - 1) / 2;
+  uint32_t j = std::min (static_cast<uint32_t> (u), table->nAzimuths - 1);
+  uint32_t i = std::min (static_cast<uint32_t> (v), table->nInclinations - 2);
+  double wu = u - j;
+  double wv = v - i;
+  // the azimuths wrap around
+  uint32_t nextJ = j + 1 < table->nAzimuths ? j + 1 : 0;
+  const double *low = &table->gains[i * table->nAzimuths];
+  const double *high = low + table->nAzimuths;
+  return (1 - wv) * ((1 - wu) * low[j] + wu * low[nextJ])
+         + wv * ((1 - wu) * high[j] + wu * high[nextJ]);
+}
+
+std::string
+AntennaModel::GetGainTableKey (void) const
+{
+  std::ostringstream oss;
+  TypeId tid = GetInstanceTypeId ();
+  oss << tid.GetName ();
+  for (; tid != Object::GetTypeId (); tid = tid.GetParent ())
+    {
+      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info = tid.GetAttribute (i);
+          Ptr<AttributeValue> value = info.checker->Create ();
+          if (GetAttributeFailSafe (info.name, *value))
+            {
+              oss << " " << info.name << "=" << value->SerializeToString (info.checker);
+            }
+        }
+    }
+  return oss.str ();
+}
+
+const AntennaModel::GainTable *
+AntennaModel::GetGainTable (void)
+{
+  if (m_gainTable != 0)
+    {
+      return m_gainTable;
+    }
+  NS_LOG_FUNCTION (this);
+  GainTables *tables = GetGainTables ();
+  std::string key = GetGainTableKey ();
+  GainTables::const_iterator it = tables->find (key);
+  if (it != tables->end ())
+    {
+      m_gainTable = &it->second;
+      return m_gainTable;
+    }
+
+  NS_LOG_DEBUG ("computing table " << key);
+  GainTable &table = (*tables)[key];
+  table.nAzimuths = std::max (4, static_cast<int> (std::ceil (360.0 / m_gainTableResolution)));
+  table.nInclinations = std::max (3, static_cast<int> (std::ceil (180.0 / m_gainTableResolution)) + 1);
+  table.gains.reserve (table.nAzimuths * table.nInclinations);
+  for (uint32_t i = 0; i < table.nInclinations; i++)
+    {
+      // the inverse of GetInclinationPseudoAngle
+      double e = -1 + 2.0 * i / (table.nInclinations - 1);
+      double theta = std::atan2 (1 - std::abs (e), e);
+      for (uint32_t j = 0; j < table.nAzimuths; j++)
+        {
+          // the inverse of GetAzimuthPseudoAngle
+          double d = 4.0 * j / table.nAzimuths;
+          uint32_t quadrant = static_cast<uint32_t> (d);
+          double f = d - quadrant;
+          double x[4] = { 1 - f, -f, f - 1, f };
+          double y[4] = { f, 1 - f, -f, f - 1 };
+          double phi = std::atan2 (y[quadrant], x[quadrant]);
+          table.gains.push_back (std::max (GetGainDb (Angles (phi, theta)), g_minGainDb));
+        }
+    }
+  m_gainTable = &table;
+  return m_gainTable;
+}
+
 
 
 }
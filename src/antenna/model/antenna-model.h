@@ -24,6 +24,10 @@
 
 #include <ns3/object.h>
 #include <ns3/angles.h>
+#include <ns3/vector.h>
+#include <vector>
+#include <string>
+#include <map>
 
 namespace ns3 {
 
@@ -39,7 +43,17 @@ namespace ns3 {
  * and Design", C.A. Balanis, Wiley, 2nd Ed., see in particular
  * section 2.2 "Radiation pattern".
  * 
- *
+ * GetGainDbInDirection and GetGainsDbInDirections evaluate the
+ * radiation pattern in the direction of cartesian vectors, which is
+ * what the channels need. If the GainTableResolution attribute is
+ * positive, these methods look up the gain in a table of the pattern
+ * instead of calling GetGainDb. The table is indexed by pseudo-angles
+ * which are computed with one square root and two divisions, instead of
+ * the atan2 and acos of Angles, and the gain is interpolated bilinearly
+ * between its entries; the step of the entries is within 30% of the
+ * resolution. The table is computed at the first lookup, and shared by
+ * all the antennas of the same TypeId with the same attribute values, so
+ * the attributes must be set before the first lookup.
  */
 class AntennaModel : public Object
 {
@@ -66,6 +80,55 @@ public:
    */
   virtual double GetGainDb (Angles a) = 0;
 
+  /**
+   * \param direction the vector from the antenna in the direction of
+   * which the radiation pattern should be evaluated
+   *
+   * \return the power gain in dBi of the antenna radiation pattern in
+   * that direction, from the table of the pattern if GainTableResolution
+   * is positive
+   */
+  double GetGainDbInDirection (const Vector &direction);
+
+  /**
+   * \param directions the vectors from the antenna in the direction of
+   * which the radiation pattern should be evaluated
+   * \param gainsDb the power gain in dBi of the antenna radiation pattern
+   * in each direction, from the table of the pattern if
+   * GainTableResolution is positive
+   */
+  void GetGainsDbInDirections (const std::vector<Vector> &directions, std::vector<double> &gainsDb);
+
+private:
+  /// the gains (dBi) of a table of the radiation pattern
+  struct GainTable
+  {
+    uint32_t nAzimuths;        //!< the number of azimuth pseudo-angles
+    uint32_t nInclinations;    //!< the number of inclination pseudo-angles
+    std::vector<double> gains; //!< the gains, inclination major
+  };
+  /// the tables of all the instances, indexed by GetGainTableKey
+  typedef std::map<std::string, GainTable> GainTables;
+
+  /**
+   * \return the table of the radiation pattern, computed if needed
+   */
+  const GainTable * GetGainTable (void);
+  /**
+   * \return the key of the table of this instance in the shared tables
+   */
+  std::string GetGainTableKey (void) const;
+  /**
+   * \param table a table of the radiation pattern
+   * \param direction a vector from the antenna
+   * \return the gain (dBi) interpolated from the table in the direction
+   */
+  static double LookupGainDb (const GainTable *table, const Vector &direction);
+
+  static GainTables * GetGainTables (void);
+
+  double m_gainTableResolution;  //!< the approximate angular step of the table (degrees), or 0
+  const GainTable *m_gainTable;  //!< the table used by this instance, once computed
 };
 
 
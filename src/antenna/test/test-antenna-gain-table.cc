@@ -0,0 +1,178 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/double.h>
+#include <ns3/antenna-model.h>
+#include <ns3/cosine-antenna-model.h>
+#include <ns3/parabolic-antenna-model.h>
+#include <cmath>
+#include <string>
+#include <vector>
+
+
+NS_LOG_COMPONENT_DEFINE ("TestAntennaGainTable");
+
+namespace ns3 {
+
+/**
+ * A radiation pattern which depends on both angles, to check the
+ * inclinations of the tables.
+ */
+class InclinedTestAntennaModel : public AntennaModel
+{
+public:
+  static TypeId GetTypeId ();
+  virtual double GetGainDb (Angles a);
+};
+
+NS_OBJECT_ENSURE_REGISTERED (InclinedTestAntennaModel)
+  ;
+
+TypeId
+InclinedTestAntennaModel::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::InclinedTestAntennaModel")
+    .SetParent<AntennaModel> ()
+    .AddConstructor<InclinedTestAntennaModel> ()
+  ;
+  return tid;
+}
+
+double
+InclinedTestAntennaModel::GetGainDb (Angles a)
+{
+  return 10 * std::cos (a.theta) + 3 * std::sin (a.phi) * std::sin (a.theta);
+}
+
+} // namespace ns3
+
+using namespace ns3;
+
+/**
+ * Compare the gains looked up in the table of an antenna with the gains
+ * computed by GetGainDb, in directions which are not on the entries of
+ * the table.
+ */
+class AntennaGainTableTestCase : public TestCase
+{
+public:
+  /**
+   * \param antenna the antenna, whose GainTableResolution is set by the
+   * test
+   * \param name the name of the antenna
+   * \param minGainDb the gains below minGainDb are not compared
+   * \param toleranceDb the tolerance of the gains above minGainDb
+   */
+  AntennaGainTableTestCase (Ptr<AntennaModel> antenna, std::string name, double minGainDb, double toleranceDb);
+
+private:
+  virtual void DoRun (void);
+
+  Ptr<AntennaModel> m_antenna;
+  double m_minGainDb;
+  double m_toleranceDb;
+};
+
+AntennaGainTableTestCase::AntennaGainTableTestCase (Ptr<AntennaModel> antenna, std::string name, double minGainDb, double toleranceDb)
+  : TestCase (name),
+    m_antenna (antenna),
+    m_minGainDb (minGainDb),
+    m_toleranceDb (toleranceDb)
+{
+}
+
+void
+AntennaGainTableTestCase::DoRun ()
+{
+  std::vector<Vector> directions;
+  for (double phi = -179.3; phi < 180; phi += 7.7)
+    {
+      for (double theta = 0.4; theta < 180; theta += 6.1)
+        {
+          double r = 1 + directions.size () % 7 * 100;
+          directions.push_back (Vector (r * std::sin (DegreesToRadians (theta)) * std::cos (DegreesToRadians (phi)),
+                                        r * std::sin (DegreesToRadians (theta)) * std::sin (DegreesToRadians (phi)),
+                                        r * std::cos (DegreesToRadians (theta))));
+        }
+    }
+  // the axes and the diagonals are the boundaries of the pseudo-angles
+  directions.push_back (Vector (5, 0, 0));
+  directions.push_back (Vector (0, 5, 0));
+  directions.push_back (Vector (-5, 0, 0));
+  directions.push_back (Vector (0, -5, 0));
+  directions.push_back (Vector (0, 0, 5));
+  directions.push_back (Vector (0, 0, -5));
+  directions.push_back (Vector (3, -3, 3));
+  directions.push_back (Vector (-3, 3, -3));
+
+  // without a table, the gains are those of GetGainDb
+  std::vector<double> gainsDb;
+  m_antenna->GetGainsDbInDirections (directions, gainsDb);
+  NS_TEST_ASSERT_MSG_EQ (gainsDb.size (), directions.size (), "wrong number of gains");
+  for (uint32_t i = 0; i < directions.size (); i++)
+    {
+      double expected = m_antenna->GetGainDb (Angles (directions[i]));
+      NS_TEST_EXPECT_MSG_EQ (m_antenna->GetGainDbInDirection (directions[i]), expected, "wrong gain in direction " << directions[i]);
+      NS_TEST_EXPECT_MSG_EQ (gainsDb[i], expected, "wrong batched gain in direction " << directions[i]);
+    }
+
+  m_antenna->SetAttribute ("GainTableResolution", DoubleValue (1.0));
+  m_antenna->GetGainsDbInDirections (directions, gainsDb);
+  NS_TEST_ASSERT_MSG_EQ (gainsDb.size (), directions.size (), "wrong number of gains");
+  for (uint32_t i = 0; i < directions.size (); i++)
+    {
+      double expected = m_antenna->GetGainDb (Angles (directions[i]));
+      double gain = m_antenna->GetGainDbInDirection (directions[i]);
+      NS_TEST_EXPECT_MSG_EQ (gainsDb[i], gain, "wrong batched gain in direction " << directions[i]);
+      if (expected >= m_minGainDb)
+        {
+          NS_TEST_EXPECT_MSG_EQ_TOL (gain, expected, m_toleranceDb, "wrong gain in direction " << directions[i]);
+        }
+      else
+        {
+          NS_TEST_EXPECT_MSG_LT (gain, m_minGainDb + m_toleranceDb, "gain too high in direction " << directions[i]);
+        }
+    }
+}
+
+
+class AntennaGainTableTestSuite : public TestSuite
+{
+public:
+  AntennaGainTableTestSuite ();
+};
+
+AntennaGainTableTestSuite::AntennaGainTableTestSuite ()
+  : TestSuite ("antenna-gain-table", UNIT)
+{
+  Ptr<AntennaModel> cosine = CreateObject<CosineAntennaModel> ();
+  cosine->SetAttribute ("Beamwidth", DoubleValue (60));
+  cosine->SetAttribute ("Orientation", DoubleValue (30));
+  cosine->SetAttribute ("MaxGain", DoubleValue (5));
+  AddTestCase (new AntennaGainTableTestCase (cosine, "cosine", -20, 0.01), TestCase::QUICK);
+
+  Ptr<AntennaModel> parabolic = CreateObject<ParabolicAntennaModel> ();
+  parabolic->SetAttribute ("Beamwidth", DoubleValue (70));
+  parabolic->SetAttribute ("Orientation", DoubleValue (-120));
+  AddTestCase (new AntennaGainTableTestCase (parabolic, "parabolic", -15, 0.01), TestCase::QUICK);
+
+  AddTestCase (new AntennaGainTableTestCase (CreateObject<InclinedTestAntennaModel> (), "inclined", -100, 0.01), TestCase::QUICK);
+}
+
+static AntennaGainTableTestSuite g_antennaGainTableTestSuite;
@@ -27,6 +27,10 @@
 #include "ns3/assert.h"
 #include "building-list.h"
 #include "building.h"
+#include "ns3/spatial-grid.h"
+#include <cmath>
+#include <limits>
+#include <algorithm>
 
 namespace ns3 {
 
@@ -48,6 +52,8 @@ public:
   BuildingList::Iterator End (void) const;
   Ptr<Building> GetBuilding (uint32_t n);
   uint32_t GetNBuildings (void);
+  std::vector<Ptr<Building> > GetBuildingsAt (Vector position);
+  void NotifyBoundariesChanged (void);
 
   static Ptr<BuildingListPriv> Get (void);
 
@@ -55,7 +61,12 @@ private:
   virtual void DoDispose (void);
   static Ptr<BuildingListPriv> *DoGet (void);
   static void Delete (void);
+  /// build m_grid again from the boundaries of all the buildings
+  void UpdateIndex (void);
   std::vector<Ptr<Building> > m_buildings;
+  SpatialGrid m_grid;            //!< the buildings which overlap each cell
+  std::vector<uint32_t> m_large; //!< the buildings which overlap too many cells to be indexed
+  bool m_indexValid;             //!< whether m_grid matches the buildings
 };
 
 NS_OBJECT_ENSURE_REGISTERED (BuildingListPriv)
@@ -101,6 +112,7 @@ BuildingListPriv::Delete (void)
 
 
 BuildingListPriv::BuildingListPriv ()
+  : m_indexValid (false)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -119,6 +131,9 @@ BuildingListPriv::DoDispose (void)
       *i = 0;
     }
   m_buildings.erase (m_buildings.begin (), m_buildings.end ());
+  m_grid.Clear ();
+  m_large.clear ();
+  m_indexValid = false;
   Object::DoDispose ();
 }
 
@@ -128,6 +143,7 @@ BuildingListPriv::Add (Ptr<Building> building)
 {
   uint32_t index = m_buildings.size ();
   m_buildings.push_back (building);
+  m_indexValid = false;
   Simulator::ScheduleWithContext (index, TimeStep (0), &Building::Initialize, building);
   return index;
 
@@ -156,6 +172,85 @@ BuildingListPriv::GetBuilding (uint32_t n)
   return m_buildings.at (n);
 }
 
+void
+BuildingListPriv::NotifyBoundariesChanged (void)
+{
+  m_indexValid = false;
+}
+
+void
+BuildingListPriv::UpdateIndex (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_grid.Clear ();
+  m_large.clear ();
+  if (m_buildings.empty ())
+    {
+      m_indexValid = true;
+      return;
+    }
+  // cells about as large as the average building, so that each building
+  // overlaps a few cells and each cell a few buildings
+  double area = 0;
+  uint32_t nFinite = 0;
+  for (std::vector<Ptr<Building> >::const_iterator i = m_buildings.begin (); i != m_buildings.end (); ++i)
+    {
+      Box box = (*i)->GetBoundaries ();
+      double buildingArea = (box.xMax - box.xMin) * (box.yMax - box.yMin);
+      if (buildingArea >= 0 && buildingArea < std::numeric_limits<double>::infinity ())
+        {
+          area += buildingArea;
+          nFinite++;
+        }
+    }
+  m_grid.SetCellSize ((nFinite > 0 && area > 0) ? std::sqrt (area / nFinite) : 1.0);
+
+  const double maxCells = 1024;
+  for (uint32_t i = 0; i < m_buildings.size (); i++)
+    {
+      if (!m_grid.Insert (m_buildings[i]->GetBoundaries (), i, maxCells))
+        {
+          m_large.push_back (i);
+        }
+    }
+  NS_LOG_DEBUG (m_buildings.size () << " buildings, " << m_grid.GetNCells () << " cells of "
+                << m_grid.GetCellSize () << "m, " << m_large.size () << " large buildings");
+  m_indexValid = true;
+}
+
+std::vector<Ptr<Building> >
+BuildingListPriv::GetBuildingsAt (Vector position)
+{
+  if (!m_indexValid)
+    {
+      UpdateIndex ();
+    }
+  std::vector<uint32_t> found;
+  std::vector<uint32_t> candidates;
+  m_grid.Find (Box (position.x, position.x, position.y, position.y, 0, 0), candidates);
+  for (std::vector<uint32_t>::const_iterator i = candidates.begin (); i != candidates.end (); ++i)
+    {
+      if (m_buildings[*i]->IsInside (position))
+        {
+          found.push_back (*i);
+        }
+    }
+  for (std::vector<uint32_t>::const_iterator i = m_large.begin (); i != m_large.end (); ++i)
+    {
+      if (m_buildings[*i]->IsInside (position))
+        {
+          found.push_back (*i);
+        }
+    }
+  std::sort (found.begin (), found.end ());
+  std::vector<Ptr<Building> > buildings;
+  for (std::vector<uint32_t>::const_iterator i = found.begin (); i != found.end (); ++i)
+    {
+      buildings.push_back (m_buildings[*i]);
+    }
+  return buildings;
+}
+
 }
 
 /**
@@ -190,5 +285,15 @@ BuildingList::GetNBuildings (void)
 {
   return BuildingListPriv::Get ()->GetNBuildings ();
 }
+std::vector<Ptr<Building> >
+BuildingList::GetBuildingsAt (Vector position)
+{
+  return BuildingListPriv::Get ()->GetBuildingsAt (position);
+}
+void
+BuildingList::NotifyBoundariesChanged (void)
+{
+  BuildingListPriv::Get ()->NotifyBoundariesChanged ();
+}
 
 } // namespace ns3
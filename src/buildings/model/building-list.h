@@ -25,6 +25,7 @@
 
 #include <vector>
 #include "ns3/ptr.h"
+#include "ns3/vector.h"
 
 namespace ns3 {
 
@@ -62,6 +63,22 @@ public:
    * \returns the number of buildings currently in the list.
    */
   static uint32_t GetNBuildings (void);
+  /**
+   * \param position a position
+   * \returns the buildings whose boundaries contain position, in the
+   *          order of this list.
+   *
+   * The buildings are looked up in a uniform grid over their boundaries,
+   * which is built again when buildings are added or moved.
+   */
+  static std::vector<Ptr<Building> > GetBuildingsAt (Vector position);
+  /**
+   * Notify the list that the boundaries of a building changed.
+   *
+   * This method is called automatically from Building::SetBoundaries so
+   * the user has little reason to call it himself.
+   */
+  static void NotifyBoundariesChanged (void);
 };
 
 } // namespace ns3
@@ -141,6 +141,7 @@ Building::SetBoundaries (Box boundaries)
 {
   NS_LOG_FUNCTION (this << boundaries);
   m_buildingBounds = boundaries;
+  BuildingList::NotifyBoundariesChanged ();
 }
 
 void
@@ -25,9 +25,11 @@
 #include <ns3/mobility-building-info.h>
 #include <ns3/constant-position-mobility-model.h>
 #include <ns3/building.h>
+#include <ns3/building-list.h>
 #include <ns3/buildings-helper.h>
 #include <ns3/mobility-helper.h>
 #include <ns3/simulator.h>
+#include <algorithm>
 
 NS_LOG_COMPONENT_DEFINE ("BuildingsHelperTest");
 
@@ -174,6 +176,90 @@ BuildingsHelperOneTestCase::DoRun ()
 
 
 
+/**
+ * Check BuildingList::GetBuildingsAt against a scan of all the buildings,
+ * with many buildings of various sizes.
+ */
+class BuildingsIndexTestCase : public TestCase
+{
+public:
+  BuildingsIndexTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void Check (void);
+};
+
+BuildingsIndexTestCase::BuildingsIndexTestCase ()
+  : TestCase ("BuildingList::GetBuildingsAt with many buildings")
+{
+}
+
+void
+BuildingsIndexTestCase::Check (void)
+{
+  for (double x = -20; x <= 420; x += 3.7)
+    {
+      for (double y = -20; y <= 420; y += 4.1)
+        {
+          Vector position (x, y, 1.0);
+          std::vector<Ptr<Building> > expected;
+          for (BuildingList::Iterator i = BuildingList::Begin (); i != BuildingList::End (); ++i)
+            {
+              if ((*i)->IsInside (position))
+                {
+                  expected.push_back (*i);
+                }
+            }
+          std::vector<Ptr<Building> > found = BuildingList::GetBuildingsAt (position);
+          NS_TEST_ASSERT_MSG_EQ (found.size (), expected.size (), "Wrong number of buildings at " << position);
+          for (uint32_t k = 0; k < found.size (); k++)
+            {
+              NS_TEST_ASSERT_MSG_EQ (found[k], expected[k], "Wrong building at " << position);
+            }
+        }
+    }
+}
+
+void
+BuildingsIndexTestCase::DoRun ()
+{
+  // a 20x20 grid of buildings of various sizes, some of them touching
+  for (uint32_t i = 0; i < 20; i++)
+    {
+      for (uint32_t j = 0; j < 20; j++)
+        {
+          Ptr<Building> b = CreateObject<Building> ();
+          double side = 5.0 + (i * j) % 16;
+          b->SetBoundaries (Box (i * 20.0, i * 20.0 + side, j * 20.0, j * 20.0 + side, 0.0, 10.0));
+        }
+    }
+  Check ();
+  if (IsStatusFailure ())
+    {
+      return;
+    }
+
+  // a building which covers all the others, and buildings added and moved
+  // after the index was built
+  Ptr<Building> large = CreateObject<Building> ();
+  large->SetBoundaries (Box (-10.0, 410.0, -10.0, 410.0, 0.0, 2.0));
+  Ptr<Building> moved = CreateObject<Building> ();
+  moved->SetBoundaries (Box (101.0, 111.0, 101.0, 111.0, 0.0, 10.0));
+  Check ();
+  if (IsStatusFailure ())
+    {
+      return;
+    }
+  moved->SetBoundaries (Box (301.0, 311.0, 1.0, 11.0, 0.0, 10.0));
+  Check ();
+  std::vector<Ptr<Building> > before = BuildingList::GetBuildingsAt (Vector (105.0, 105.0, 5.0));
+  std::vector<Ptr<Building> > after = BuildingList::GetBuildingsAt (Vector (305.0, 5.0, 5.0));
+  NS_TEST_ASSERT_MSG_EQ ((std::find (before.begin (), before.end (), moved) == before.end ()), true, "Moved building still found");
+  NS_TEST_ASSERT_MSG_EQ ((std::find (after.begin (), after.end (), moved) != after.end ()), true, "Moved building not found");
+  Simulator::Destroy ();
+}
+
 class BuildingsHelperTestSuite : public TestSuite
 {
 public:
@@ -322,6 +408,8 @@ BuildingsHelperTestSuite::BuildingsHelperTestSuite ()
   q7.pos = vq7;
   q7.indoor = false;
   AddTestCase (new BuildingsHelperOneTestCase (q7, b2), TestCase::QUICK);     
+
+  AddTestCase (new BuildingsIndexTestCase, TestCase::QUICK);
 }
 
 static BuildingsHelperTestSuite buildingsHelperAntennaTestSuiteInstance;
@@ -30,6 +30,7 @@
 #include "ns3/uinteger.h"
 #include "ns3/pointer.h"
 #include "ns3/trace-source-accessor.h"
+#include "ns3/segmentation-offload-tag.h"
 #include "csma-net-device.h"
 #include "csma-channel.h"
 
@@ -492,6 +493,18 @@ CsmaNetDevice::TransmitStart (void)
           m_phyTxBeginTrace (m_currentPkt);
 
           Time tEvent = Seconds (m_bps.CalculateTxTime (m_currentPkt->GetSize ()));
+
+          //
+          // A super-segment holds the channel for the whole train of frames
+          // it stands for, including the interframe gaps between them.
+          //
+          SegmentationOffloadTag offloadTag;
+          if (m_currentPkt->PeekPacketTag (offloadTag))
+            {
+              uint32_t nSegments = offloadTag.GetSegmentCount ();
+              tEvent = Seconds (m_bps.CalculateTxTime (offloadTag.GetWireSize (m_currentPkt->GetSize ())))
+                + TimeStep (m_tInterframeGap.GetTimeStep () * (nSegments - 1));
+            }
           NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << tEvent.GetSeconds () << "sec");
           Simulator::Schedule (tEvent, &CsmaNetDevice::TransmitCompleteEvent, this);
         }
@@ -1014,6 +1027,16 @@ CsmaNetDevice::SupportsSendFrom () const
   return true;
 }
 
+bool
+CsmaNetDevice::SupportsSegmentationOffload (void) const
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  //
+  // The LLC/SNAP length field cannot describe a frame larger than the MTU.
+  //
+  return m_encapMode == DIX;
+}
+
 int64_t
 CsmaNetDevice::AssignStreams (int64_t stream)
 {
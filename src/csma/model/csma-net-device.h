@@ -321,6 +321,13 @@ public:
   virtual void SetPromiscReceiveCallback (PromiscReceiveCallback cb);
   virtual bool SupportsSendFrom (void) const;
 
+  /**
+   * Is this device able to transmit transport super-segments?
+   *
+   * \returns True if the encapsulation mode is DIX.
+   */
+  virtual bool SupportsSegmentationOffload (void) const;
+
  /**
   * Assign a fixed random variable stream number to the random variables
   * used by this model.  Return the number of streams (possibly zero) that
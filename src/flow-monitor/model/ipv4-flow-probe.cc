@@ -363,6 +363,10 @@ Ipv4FlowProbe::DropLogger (const Ipv4Header &ipHeader, Ptr<const Packet> ipPaylo
           myReason = DROP_FRAGMENT_TIMEOUT;
           NS_LOG_DEBUG ("DROP_FRAGMENT_TIMEOUT");
           break;
+        case Ipv4L3Protocol::DROP_FRAGMENT_MEMORY:
+          myReason = DROP_FRAGMENT_MEMORY;
+          NS_LOG_DEBUG ("DROP_FRAGMENT_MEMORY");
+          break;
 
         default:
           myReason = DROP_INVALID_REASON;
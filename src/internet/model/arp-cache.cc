@@ -180,44 +180,62 @@ ArpCache::StartWaitReplyTimer (void)
     }
 }
 
+void
+ArpCache::AddWaitReplyEntry (ArpCache::Entry *entry)
+{
+  NS_LOG_FUNCTION (this << entry);
+  if (!entry->m_waitReplyListed)
+    {
+      entry->m_waitReplyListed = true;
+      m_waitReplyEntries.push_back (entry);
+    }
+}
+
 void
 ArpCache::HandleWaitReplyTimeout (void)
 {
   NS_LOG_FUNCTION (this);
   ArpCache::Entry* entry;
   bool restartWaitReplyTimer = false;
-  for (CacheI i = m_arpCache.begin (); i != m_arpCache.end (); i++) 
+  std::list<ArpCache::Entry *>::iterator i = m_waitReplyEntries.begin ();
+  while (i != m_waitReplyEntries.end ())
     {
-      entry = (*i).second;
-      if (entry != 0 && entry->IsWaitReply ())
+      entry = *i;
+      if (!entry->IsWaitReply ())
         {
-          if (entry->GetRetries () < m_maxRetries)
-            {
-              NS_LOG_LOGIC ("node="<< m_device->GetNode ()->GetId () <<
-                            ", ArpWaitTimeout for " << entry->GetIpv4Address () <<
-                            " expired -- retransmitting arp request since retries = " <<
-                            entry->GetRetries ());
-              m_arpRequestCallback (this, entry->GetIpv4Address ());
-              restartWaitReplyTimer = true;
-              entry->IncrementRetries ();
-            }
-          else
+          // resolved (or marked dead) since the last timeout
+          entry->m_waitReplyListed = false;
+          i = m_waitReplyEntries.erase (i);
+          continue;
+        }
+      if (entry->GetRetries () < m_maxRetries)
+        {
+          NS_LOG_LOGIC ("node="<< m_device->GetNode ()->GetId () <<
+                        ", ArpWaitTimeout for " << entry->GetIpv4Address () <<
+                        " expired -- retransmitting arp request since retries = " <<
+                        entry->GetRetries ());
+          m_arpRequestCallback (this, entry->GetIpv4Address ());
+          restartWaitReplyTimer = true;
+          entry->IncrementRetries ();
+          i++;
+        }
+      else
+        {
+          NS_LOG_LOGIC ("node="<<m_device->GetNode ()->GetId () <<
+                        ", wait reply for " << entry->GetIpv4Address () <<
+                        " expired -- drop since max retries exceeded: " <<
+                        entry->GetRetries ());
+          entry->MarkDead ();
+          entry->ClearRetries ();
+          Ptr<Packet> pending = entry->DequeuePending ();
+          while (pending != 0)
             {
-              NS_LOG_LOGIC ("node="<<m_device->GetNode ()->GetId () <<
-                            ", wait reply for " << entry->GetIpv4Address () <<
-                            " expired -- drop since max retries exceeded: " <<
-                            entry->GetRetries ());
-              entry->MarkDead ();
-              entry->ClearRetries ();
-              Ptr<Packet> pending = entry->DequeuePending ();
-              while (pending != 0)
-                {
-                  m_dropTrace (pending);
-                  pending = entry->DequeuePending ();
-                }
+              m_dropTrace (pending);
+              pending = entry->DequeuePending ();
             }
+          entry->m_waitReplyListed = false;
+          i = m_waitReplyEntries.erase (i);
         }
-
     }
   if (restartWaitReplyTimer)
     {
@@ -236,6 +254,7 @@ ArpCache::Flush (void)
       delete (*i).second;
     }
   m_arpCache.erase (m_arpCache.begin (), m_arpCache.end ());
+  m_waitReplyEntries.clear ();
   if (m_waitReplyTimer.IsRunning ())
     {
       NS_LOG_LOGIC ("Stopping WaitReplyTimer at " << Simulator::Now ().GetSeconds () << " due to ArpCache flush");
@@ -247,10 +266,10 @@ ArpCache::Entry *
 ArpCache::Lookup (Ipv4Address to)
 {
   NS_LOG_FUNCTION (this << to);
-  if (m_arpCache.find (to) != m_arpCache.end ()) 
+  CacheI it = m_arpCache.find (to);
+  if (it != m_arpCache.end ()) 
     {
-      ArpCache::Entry *entry = m_arpCache[to];
-      return entry;
+      return it->second;
     }
   return 0;
 }
@@ -270,7 +289,8 @@ ArpCache::Add (Ipv4Address to)
 ArpCache::Entry::Entry (ArpCache *arp)
   : m_arp (arp),
     m_state (ALIVE),
-    m_retries (0)
+    m_retries (0),
+    m_waitReplyListed (false)
 {
   NS_LOG_FUNCTION (this << arp);
 }
@@ -340,6 +360,7 @@ ArpCache::Entry::MarkWaitReply (Ptr<Packet> waiting)
   m_state = WAIT_REPLY;
   m_pending.push_back (waiting);
   UpdateSeen ();
+  m_arp->AddWaitReplyEntry (this);
   m_arp->StartWaitReplyTimer ();
 }
 
@@ -234,6 +234,8 @@ public:
     void ClearRetries (void);
 
 private:
+    friend class ArpCache;
+
     /**
      * \brief ARP cache entry states
      */
@@ -261,6 +263,7 @@ private:
     Ipv4Address m_ipv4Address; //!< entry's IP address
     std::list<Ptr<Packet> > m_pending; //!< list of pending packets for the entry's IP
     uint32_t m_retries; //!< rerty counter
+    bool m_waitReplyListed; //!< true if the entry is in the cache's list of pending resolutions
   };
 
 private:
@@ -290,8 +293,17 @@ private:
    * If there are no Arp requests pending, this event is not scheduled.
    */
   void HandleWaitReplyTimeout (void);
+  /**
+   * \brief Remember an entry which entered the WAIT_REPLY state
+   *
+   * The wait reply timeout only visits these entries, instead of
+   * scanning the whole cache.
+   * \param entry the entry waiting for a reply
+   */
+  void AddWaitReplyEntry (ArpCache::Entry *entry);
   uint32_t m_pendingQueueSize; //!< number of packets waiting for a resolution
   Cache m_arpCache; //!< the ARP cache
+  std::list<ArpCache::Entry *> m_waitReplyEntries; //!< entries which may still be in WAIT_REPLY state
   TracedCallback<Ptr<const Packet> > m_dropTrace; //!< trace for packets dropped by the ARP cache queue
 };
 
@@ -32,6 +32,7 @@
 #include "ns3/ipv4-header.h"
 #include "ns3/boolean.h"
 #include "ns3/ipv4-routing-table-entry.h"
+#include "ns3/segmentation-offload-tag.h"
 
 #include "loopback-net-device.h"
 #include "arp-l3-protocol.h"
@@ -68,6 +69,12 @@ Ipv4L3Protocol::GetTypeId (void)
                    TimeValue (Seconds (30)),
                    MakeTimeAccessor (&Ipv4L3Protocol::m_fragmentExpirationTimeout),
                    MakeTimeChecker ())
+    .AddAttribute ("FragmentMemoryLimit",
+                   "The maximum number of bytes held by the packets waiting for reassembly, 0 for no limit. "
+                   "When it is reached, the oldest packets are dropped.",
+                   UintegerValue (4194304),
+                   MakeUintegerAccessor (&Ipv4L3Protocol::m_fragmentsMemoryLimit),
+                   MakeUintegerChecker<uint32_t> ())
     .AddTraceSource ("Tx", "Send ipv4 packet to outgoing interface.",
                      MakeTraceSourceAccessor (&Ipv4L3Protocol::m_txTrace))
     .AddTraceSource ("Rx", "Receive ipv4 packet from incoming interface.",
@@ -91,7 +98,8 @@ Ipv4L3Protocol::GetTypeId (void)
 }
 
 Ipv4L3Protocol::Ipv4L3Protocol()
-  : m_identification (0)
+  : m_identification (0),
+    m_fragmentsMemory (0)
 
 {
   NS_LOG_FUNCTION (this);
@@ -231,6 +239,8 @@ Ipv4L3Protocol::DoDispose (void)
 
   m_fragments.clear ();
   m_fragmentsTimers.clear ();
+  m_fragmentsExpiries.clear ();
+  m_fragmentsMemory = 0;
 
   Object::DoDispose ();
 }
@@ -748,12 +758,17 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
   Ptr<Ipv4Interface> outInterface = GetInterface (interface);
   NS_LOG_LOGIC ("Send via NetDevice ifIndex " << outDev->GetIfIndex () << " ipv4InterfaceIndex " << interface);
 
+  // A transport super-segment is never fragmented by a device which
+  // segments it by itself.
+  SegmentationOffloadTag offloadTag;
+  bool offloaded = outDev->SupportsSegmentationOffload () && packet->PeekPacketTag (offloadTag);
+
   if (!route->GetGateway ().IsEqual (Ipv4Address ("0.0.0.0")))
     {
       if (outInterface->IsUp ())
         {
           NS_LOG_LOGIC ("Send to gateway " << route->GetGateway ());
-          if ( packet->GetSize () > outInterface->GetDevice ()->GetMtu () )
+          if (!offloaded && packet->GetSize () > outInterface->GetDevice ()->GetMtu ())
             {
               std::list<Ptr<Packet> > listFragments;
               DoFragmentation (packet, outInterface->GetDevice ()->GetMtu (), listFragments);
@@ -782,7 +797,7 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
       if (outInterface->IsUp ())
         {
           NS_LOG_LOGIC ("Send to destination " << ipHeader.GetDestination ());
-          if ( packet->GetSize () > outInterface->GetDevice ()->GetMtu () )
+          if (!offloaded && packet->GetSize () > outInterface->GetDevice ()->GetMtu ())
             {
               std::list<Ptr<Packet> > listFragments;
               DoFragmentation (packet, outInterface->GetDevice ()->GetMtu (), listFragments);
@@ -1257,6 +1272,10 @@ Ipv4L3Protocol::DoFragmentation (Ptr<Packet> packet, uint32_t outIfaceMtu, std::
       Ptr<Packet> fragment = p->CreateFragment (offset, currentFragmentablePartSize);
       NS_LOG_LOGIC ("Fragment created - " << offset << ", " << fragment->GetSize ()  );
 
+      // A fragment of a super-segment is an ordinary packet on the wire
+      SegmentationOffloadTag offloadTag;
+      fragment->RemovePacketTag (offloadTag);
+
       fragmentHeader.SetFragmentOffset (offset+originalOffset);
       fragmentHeader.SetPayloadSize (currentFragmentablePartSize);
 
@@ -1290,8 +1309,8 @@ Ipv4L3Protocol::ProcessFragment (Ptr<Packet>& packet, Ipv4Header& ipHeader, uint
 {
   NS_LOG_FUNCTION (this << packet << ipHeader << iif);
 
-  uint64_t addressCombination = uint64_t (ipHeader.GetSource ().Get ()) << 32 & uint64_t (ipHeader.GetDestination ().Get ());
-  uint32_t idProto = uint32_t (ipHeader.GetIdentification ()) << 16 & uint32_t (ipHeader.GetProtocol ());
+  uint64_t addressCombination = uint64_t (ipHeader.GetSource ().Get ()) << 32 | uint64_t (ipHeader.GetDestination ().Get ());
+  uint32_t idProto = uint32_t (ipHeader.GetIdentification ()) << 16 | uint32_t (ipHeader.GetProtocol ());
   std::pair<uint64_t, uint32_t> key;
   bool ret = false;
   Ptr<Packet> p = packet->Copy ();
@@ -1299,16 +1318,25 @@ Ipv4L3Protocol::ProcessFragment (Ptr<Packet>& packet, Ipv4Header& ipHeader, uint
   key.first = addressCombination;
   key.second = idProto;
 
+  if (!ReclaimFragmentsMemory (p->GetSize ()))
+    {
+      NS_LOG_LOGIC ("Fragment larger than the reassembly memory, dropping");
+      m_dropTrace (ipHeader, p, DROP_FRAGMENT_MEMORY, m_node->GetObject<Ipv4> (), iif);
+      return false;
+    }
+
   Ptr<Fragments> fragments;
 
   MapFragments_t::iterator it = m_fragments.find (key);
   if (it == m_fragments.end ())
     {
-      fragments = Create<Fragments> ();
+      fragments = Create<Fragments> (ipHeader, iif);
       m_fragments.insert (std::make_pair (key, fragments));
-      m_fragmentsTimers[key] = Simulator::Schedule (m_fragmentExpirationTimeout,
-                                                    &Ipv4L3Protocol::HandleFragmentsTimeout, this,
-                                                    key, ipHeader, iif);
+      EventId timeout = Simulator::Schedule (m_fragmentExpirationTimeout,
+                                             &Ipv4L3Protocol::HandleFragmentsTimeout, this,
+                                             key, ipHeader, iif);
+      m_fragmentsTimers[key] = timeout;
+      m_fragmentsExpiries.insert (std::make_pair (timeout.GetTs (), key));
     }
   else
     {
@@ -1317,11 +1345,14 @@ Ipv4L3Protocol::ProcessFragment (Ptr<Packet>& packet, Ipv4Header& ipHeader, uint
 
   NS_LOG_LOGIC ("Adding fragment - Size: " << packet->GetSize ( ) << " - Offset: " << (ipHeader.GetFragmentOffset ()) );
 
+  m_fragmentsMemory -= fragments->GetSize ();
   fragments->AddFragment (p, ipHeader.GetFragmentOffset (), !ipHeader.IsLastFragment () );
+  m_fragmentsMemory += fragments->GetSize ();
 
   if ( fragments->IsEntire () )
     {
       packet = fragments->GetPacket ();
+      m_fragmentsMemory -= fragments->GetSize ();
       fragments = 0;
       m_fragments.erase (key);
       if (m_fragmentsTimers[key].IsRunning ())
@@ -1329,6 +1360,7 @@ Ipv4L3Protocol::ProcessFragment (Ptr<Packet>& packet, Ipv4Header& ipHeader, uint
           NS_LOG_LOGIC ("Stopping WaitFragmentsTimer at " << Simulator::Now ().GetSeconds () << " due to complete packet");
           m_fragmentsTimers[key].Cancel ();
         }
+      RemoveFragmentsExpiry (key, m_fragmentsTimers[key]);
       m_fragmentsTimers.erase (key);
       ret = true;
     }
@@ -1336,8 +1368,49 @@ Ipv4L3Protocol::ProcessFragment (Ptr<Packet>& packet, Ipv4Header& ipHeader, uint
   return ret;
 }
 
-Ipv4L3Protocol::Fragments::Fragments ()
-  : m_moreFragment (0)
+bool
+Ipv4L3Protocol::ReclaimFragmentsMemory (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+
+  if (m_fragmentsMemoryLimit == 0)
+    {
+      return true;
+    }
+  if (size > m_fragmentsMemoryLimit)
+    {
+      return false;
+    }
+
+  while (m_fragmentsMemory + size > m_fragmentsMemoryLimit)
+    {
+      NS_ASSERT (!m_fragmentsExpiries.empty ());
+      // the oldest packet is the first to expire
+      std::pair<uint64_t, uint32_t> key = m_fragmentsExpiries.begin ()->second;
+      m_fragmentsExpiries.erase (m_fragmentsExpiries.begin ());
+      MapFragmentsTimers_t::iterator timer = m_fragmentsTimers.find (key);
+      timer->second.Cancel ();
+      m_fragmentsTimers.erase (timer);
+
+      MapFragments_t::iterator it = m_fragments.find (key);
+      Ptr<Fragments> fragments = it->second;
+      m_fragments.erase (it);
+      m_fragmentsMemory -= fragments->GetSize ();
+
+      NS_LOG_LOGIC ("Reassembly memory full, dropping " << fragments->GetSize () << " bytes");
+      m_dropTrace (fragments->GetHeader (), fragments->GetPartialPacket (), DROP_FRAGMENT_MEMORY,
+                   m_node->GetObject<Ipv4> (), fragments->GetInterface ());
+    }
+  return true;
+}
+
+Ipv4L3Protocol::Fragments::Fragments (const Ipv4Header &ipHeader, uint32_t iif)
+  : m_lastFragmentReceived (false),
+    m_packetSize (0),
+    m_contiguousSize (0),
+    m_size (0),
+    m_ipHeader (ipHeader),
+    m_iif (iif)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -1352,22 +1425,59 @@ Ipv4L3Protocol::Fragments::AddFragment (Ptr<Packet> fragment, uint16_t fragmentO
 {
   NS_LOG_FUNCTION (this << fragment << fragmentOffset << moreFragment);
 
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::iterator it;
+  uint32_t fragmentStart = fragmentOffset;
+  uint32_t fragmentEnd = fragmentStart + fragment->GetSize ();
 
-  for (it = m_fragments.begin (); it != m_fragments.end (); it++)
+  if (!moreFragment)
     {
-      if (it->second > fragmentOffset)
+      m_lastFragmentReceived = true;
+      m_packetSize = fragmentEnd;
+    }
+
+  // first stored fragment ending after the start of the new one
+  std::map<uint32_t, Ptr<Packet> >::iterator it = m_fragments.upper_bound (fragmentStart);
+  if (it != m_fragments.begin ())
+    {
+      std::map<uint32_t, Ptr<Packet> >::iterator previous = it;
+      previous--;
+      if (previous->first + previous->second->GetSize () > fragmentStart)
         {
-          break;
+          it = previous;
         }
     }
 
-  if (it == m_fragments.end ())
+  // store the holes the new fragment fills, the old bytes are kept
+  uint32_t start = fragmentStart;
+  while (start < fragmentEnd)
     {
-      m_moreFragment = moreFragment;
+      uint32_t end = fragmentEnd;
+      if (it != m_fragments.end () && it->first < end)
+        {
+          end = it->first;
+        }
+      if (end > start)
+        {
+          Ptr<Packet> hole = fragment;
+          if (end - start != fragment->GetSize ())
+            {
+              hole = fragment->CreateFragment (start - fragmentStart, end - start);
+            }
+          m_fragments.insert (it, std::make_pair (start, hole));
+          m_size += end - start;
+        }
+      if (it == m_fragments.end ())
+        {
+          break;
+        }
+      start = std::max (start, it->first + it->second->GetSize ());
+      it++;
     }
 
-  m_fragments.insert (it, std::pair<Ptr<Packet>, uint16_t> (fragment, fragmentOffset));
+  std::map<uint32_t, Ptr<Packet> >::const_iterator next;
+  while ((next = m_fragments.find (m_contiguousSize)) != m_fragments.end ())
+    {
+      m_contiguousSize += next->second->GetSize ();
+    }
 }
 
 bool
@@ -1375,29 +1485,7 @@ Ipv4L3Protocol::Fragments::IsEntire () const
 {
   NS_LOG_FUNCTION (this);
 
-  bool ret = !m_moreFragment && m_fragments.size () > 0;
-
-  if (ret)
-    {
-      uint16_t lastEndOffset = 0;
-
-      for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin (); it != m_fragments.end (); it++)
-        {
-          // overlapping fragments do exist
-          NS_LOG_LOGIC ("Checking overlaps " << lastEndOffset << " - " << it->second );
-
-          if (lastEndOffset < it->second)
-            {
-              ret = false;
-              break;
-            }
-          // fragments might overlap in strange ways
-          uint16_t fragmentEnd = it->first->GetSize () + it->second;
-          lastEndOffset = std::max ( lastEndOffset, fragmentEnd );
-        }
-    }
-
-  return ret;
+  return m_lastFragmentReceived && m_contiguousSize >= m_packetSize;
 }
 
 Ptr<Packet>
@@ -1405,74 +1493,49 @@ Ipv4L3Protocol::Fragments::GetPacket () const
 {
   NS_LOG_FUNCTION (this);
 
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin ();
-
-  Ptr<Packet> p = it->first->Copy ();
-  uint16_t lastEndOffset = p->GetSize ();
-  it++;
-
-  for ( ; it != m_fragments.end (); it++)
-    {
-      if ( lastEndOffset > it->second )
-        {
-          // The fragments are overlapping.
-          // We do not overwrite the "old" with the "new" because we do not know when each arrived.
-          // This is different from what Linux does.
-          // It is not possible to emulate a fragmentation attack.
-          uint32_t newStart = lastEndOffset - it->second;
-          if ( it->first->GetSize () > newStart )
-            {
-              uint32_t newSize = it->first->GetSize () - newStart;
-              Ptr<Packet> tempFragment = it->first->CreateFragment (newStart, newSize);
-              p->AddAtEnd (tempFragment);
-            }
-        }
-      else
-        {
-          NS_LOG_LOGIC ("Adding: " << *(it->first) );
-          p->AddAtEnd (it->first);
-        }
-      lastEndOffset = p->GetSize ();
-    }
-
-  return p;
+  return GetPartialPacket ();
 }
 
 Ptr<Packet>
 Ipv4L3Protocol::Fragments::GetPartialPacket () const
 {
   NS_LOG_FUNCTION (this);
-  
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin ();
-
-  Ptr<Packet> p = Create<Packet> ();
-  uint16_t lastEndOffset = 0;
 
-  if ( m_fragments.begin ()->second > 0 )
+  if (m_fragments.empty () || m_fragments.begin ()->first > 0)
     {
-      return p;
+      return Create<Packet> ();
     }
 
-  for ( it = m_fragments.begin (); it != m_fragments.end (); it++)
+  // the fragments do not overlap, they are appended as they are
+  std::map<uint32_t, Ptr<Packet> >::const_iterator it = m_fragments.begin ();
+  Ptr<Packet> p = it->second->Copy ();
+  for (it++; it != m_fragments.end () && it->first == p->GetSize (); it++)
     {
-      if ( lastEndOffset > it->second )
-        {
-          uint32_t newStart = lastEndOffset - it->second;
-          uint32_t newSize = it->first->GetSize () - newStart;
-          Ptr<Packet> tempFragment = it->first->CreateFragment (newStart, newSize);
-          p->AddAtEnd (tempFragment);
-        }
-      else if ( lastEndOffset == it->second )
-        {
-          NS_LOG_LOGIC ("Adding: " << *(it->first) );
-          p->AddAtEnd (it->first);
-        }
-      lastEndOffset = p->GetSize ();
+      NS_LOG_LOGIC ("Adding: " << *(it->second) );
+      p->AddAtEnd (it->second);
     }
 
   return p;
 }
 
+uint32_t
+Ipv4L3Protocol::Fragments::GetSize () const
+{
+  return m_size;
+}
+
+const Ipv4Header &
+Ipv4L3Protocol::Fragments::GetHeader () const
+{
+  return m_ipHeader;
+}
+
+uint32_t
+Ipv4L3Protocol::Fragments::GetInterface () const
+{
+  return m_iif;
+}
+
 void
 Ipv4L3Protocol::HandleFragmentsTimeout (std::pair<uint64_t, uint32_t> key, Ipv4Header & ipHeader, uint32_t iif)
 {
@@ -1480,6 +1543,7 @@ Ipv4L3Protocol::HandleFragmentsTimeout (std::pair<uint64_t, uint32_t> key, Ipv4H
 
   MapFragments_t::iterator it = m_fragments.find (key);
   Ptr<Packet> packet = it->second->GetPartialPacket ();
+  m_fragmentsMemory -= it->second->GetSize ();
 
   // if we have at least 8 bytes, we can send an ICMP.
   if ( packet->GetSize () > 8 )
@@ -1493,7 +1557,25 @@ Ipv4L3Protocol::HandleFragmentsTimeout (std::pair<uint64_t, uint32_t> key, Ipv4H
   it->second = 0;
 
   m_fragments.erase (key);
+  RemoveFragmentsExpiry (key, m_fragmentsTimers[key]);
   m_fragmentsTimers.erase (key);
 }
 
+void
+Ipv4L3Protocol::RemoveFragmentsExpiry (std::pair<uint64_t, uint32_t> key, const EventId &timeout)
+{
+  NS_LOG_FUNCTION (this << &key);
+
+  std::pair<FragmentsExpiries_t::iterator, FragmentsExpiries_t::iterator> range;
+  range = m_fragmentsExpiries.equal_range (timeout.GetTs ());
+  for (FragmentsExpiries_t::iterator it = range.first; it != range.second; it++)
+    {
+      if (it->second == key)
+        {
+          m_fragmentsExpiries.erase (it);
+          return;
+        }
+    }
+}
+
 } // namespace ns3
@@ -100,7 +100,8 @@ public:
     DROP_BAD_CHECKSUM,   /**< Bad checksum */
     DROP_INTERFACE_DOWN,   /**< Interface is down so can not send packet */
     DROP_ROUTE_ERROR,   /**< Route error */
-    DROP_FRAGMENT_TIMEOUT /**< Fragment timeout exceeded */
+    DROP_FRAGMENT_TIMEOUT, /**< Fragment timeout exceeded */
+    DROP_FRAGMENT_MEMORY /**< Reassembly memory limit exceeded */
   };
 
   /**
@@ -377,6 +378,21 @@ private:
    */
   void HandleFragmentsTimeout ( std::pair<uint64_t, uint32_t> key, Ipv4Header & ipHeader, uint32_t iif);
 
+  /**
+   * \brief Drop the oldest incomplete packets until there is room
+   * for the given number of bytes in the reassembly memory
+   * \param size the number of bytes needed
+   * \return false if the limit is lower than the size needed
+   */
+  bool ReclaimFragmentsMemory (uint32_t size);
+
+  /**
+   * \brief Remove a packet from the expiration order
+   * \param key representing the packet fragments
+   * \param timeout the expiration event of the packet
+   */
+  void RemoveFragmentsExpiry (std::pair<uint64_t, uint32_t> key, const EventId &timeout);
+
   /**
    * \brief Container of the IPv4 Interfaces.
    */
@@ -428,8 +444,10 @@ private:
 public:
     /**
      * \brief Constructor.
+     * \param ipHeader the IP header of the first fragment received
+     * \param iif the interface the first fragment was received on
      */
-    Fragments ();
+    Fragments (const Ipv4Header &ipHeader, uint32_t iif);
 
     /**
      * \brief Destructor.
@@ -438,6 +456,10 @@ public:
 
     /**
      * \brief Add a fragment.
+     *
+     * The bytes already received are cut from the fragment, so that the
+     * stored fragments never overlap: the old bytes are kept.
+     *
      * \param fragment the fragment
      * \param fragmentOffset the offset of the fragment
      * \param moreFragment the bit "More Fragment"
@@ -462,27 +484,67 @@ public:
      */
     Ptr<Packet> GetPartialPacket () const;
 
+    /**
+     * \brief Get the number of payload bytes stored.
+     * \return the number of bytes stored
+     */
+    uint32_t GetSize () const;
+
+    /**
+     * \brief Get the IP header of the first fragment received.
+     * \return the IP header
+     */
+    const Ipv4Header & GetHeader () const;
+
+    /**
+     * \brief Get the interface the first fragment was received on.
+     * \return the interface index
+     */
+    uint32_t GetInterface () const;
+
 private:
     /**
-     * \brief True if other fragments will be sent.
+     * \brief The fragments, indexed by offset. They do not overlap.
+     */
+    std::map<uint32_t, Ptr<Packet> > m_fragments;
+
+    /**
+     * \brief True once the last fragment has been received.
+     */
+    bool m_lastFragmentReceived;
+
+    /**
+     * \brief The size of the packet, known once the last fragment is received.
+     */
+    uint32_t m_packetSize;
+
+    /**
+     * \brief The number of bytes received without hole from offset 0.
      */
-    bool m_moreFragment;
+    uint32_t m_contiguousSize;
 
     /**
-     * \brief The current fragments.
+     * \brief The number of bytes stored.
      */
-    std::list<std::pair<Ptr<Packet>, uint16_t> > m_fragments;
+    uint32_t m_size;
 
+    Ipv4Header m_ipHeader; //!< IP header of the first fragment.
+    uint32_t m_iif; //!< Interface of the first fragment.
   };
 
   /// Container of fragments, stored as pairs(src+dst addr, src+dst port) / fragment
   typedef std::map< std::pair<uint64_t, uint32_t>, Ptr<Fragments> > MapFragments_t;
   /// Container of fragment timeout event, stored as pairs(src+dst addr, src+dst port) / EventId
   typedef std::map< std::pair<uint64_t, uint32_t>, EventId > MapFragmentsTimers_t;
+  /// Container of fragment keys, ordered by the timestamp of their timeout event
+  typedef std::multimap< uint64_t, std::pair<uint64_t, uint32_t> > FragmentsExpiries_t;
 
   MapFragments_t       m_fragments; //!< Fragmented packets.
   Time                 m_fragmentExpirationTimeout; //!< Expiration timeout
   MapFragmentsTimers_t m_fragmentsTimers; //!< Expiration events.
+  FragmentsExpiries_t  m_fragmentsExpiries; //!< Fragmented packets, oldest first.
+  uint32_t             m_fragmentsMemory; //!< Bytes held by the incomplete packets.
+  uint32_t             m_fragmentsMemoryLimit; //!< Maximum bytes held by the incomplete packets.
 
 };
 
@@ -297,11 +297,18 @@ TypeId Ipv6ExtensionFragment::GetTypeId ()
   static TypeId tid = TypeId ("ns3::Ipv6ExtensionFragment")
     .SetParent<Ipv6Extension> ()
     .AddConstructor<Ipv6ExtensionFragment> ()
+    .AddAttribute ("FragmentMemoryLimit",
+                   "The maximum number of bytes held by the packets waiting for reassembly, 0 for no limit. "
+                   "When it is reached, the oldest packets are dropped.",
+                   UintegerValue (4194304),
+                   MakeUintegerAccessor (&Ipv6ExtensionFragment::m_fragmentsMemoryLimit),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
 
 Ipv6ExtensionFragment::Ipv6ExtensionFragment ()
+  : m_fragmentsMemory (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -317,10 +324,13 @@ void Ipv6ExtensionFragment::DoDispose ()
 
   for (MapFragments_t::iterator it = m_fragments.begin (); it != m_fragments.end (); it++)
     {
+      it->second->CancelTimeout ();
       it->second = 0;
     }
 
   m_fragments.clear ();
+  m_fragmentsExpiries.clear ();
+  m_fragmentsMemory = 0;
   Ipv6Extension::DoDispose ();
 }
 
@@ -357,6 +367,14 @@ uint8_t Ipv6ExtensionFragment::Process (Ptr<Packet>& packet, uint8_t offset, Ipv
   Ipv6Header ipHeader = ipv6Header;
   ipHeader.SetNextHeader (fragmentHeader.GetNextHeader ());
 
+  if (!ReclaimFragmentsMemory (p->GetSize ()))
+    {
+      NS_LOG_LOGIC ("Fragment larger than the reassembly memory, dropping");
+      m_dropTrace (p);
+      isDropped = true;
+      return 0;
+    }
+
   MapFragments_t::iterator it = m_fragments.find (fragmentsId);
   if (it == m_fragments.end ())
     {
@@ -366,6 +384,7 @@ uint8_t Ipv6ExtensionFragment::Process (Ptr<Packet>& packet, uint8_t offset, Ipv
                                              &Ipv6ExtensionFragment::HandleFragmentsTimeout, this,
                                              fragmentsId, ipHeader);
       fragments->SetTimeoutEventId (timeout);
+      m_fragmentsExpiries.insert (std::make_pair (timeout.GetTs (), fragmentsId));
     }
   else
     {
@@ -379,12 +398,16 @@ uint8_t Ipv6ExtensionFragment::Process (Ptr<Packet>& packet, uint8_t offset, Ipv
       fragments->SetUnfragmentablePart (unfragmentablePart);
     }
 
+  m_fragmentsMemory -= fragments->GetSize ();
   fragments->AddFragment (p, fragmentOffset, moreFragment);
+  m_fragmentsMemory += fragments->GetSize ();
 
   if (fragments->IsEntire ())
     {
       packet = fragments->GetPacket ();
+      m_fragmentsMemory -= fragments->GetSize ();
       fragments->CancelTimeout ();
+      RemoveFragmentsExpiry (fragmentsId, fragments->GetTimeoutEventId ());
       m_fragments.erase (fragmentsId);
       isDropped = false;
     }
@@ -580,25 +603,84 @@ void Ipv6ExtensionFragment::HandleFragmentsTimeout (std::pair<Ipv6Address, uint3
   MapFragments_t::iterator it = m_fragments.find (fragmentsId);
   NS_ASSERT_MSG(it != m_fragments.end (), "IPv6 Fragment timeout reached for non-existent fragment");
   fragments = it->second;
+  m_fragmentsMemory -= fragments->GetSize ();
 
   Ptr<Packet> packet = fragments->GetPartialPacket ();
 
-  packet->AddHeader (ipHeader);
-
-  // if we have at least 8 bytes, we can send an ICMP.
-  if ( packet->GetSize () > 8 )
+  // the first fragment may have never been received
+  if (packet)
     {
-      Ptr<Icmpv6L4Protocol> icmp = GetNode ()->GetObject<Icmpv6L4Protocol> ();
-      icmp->SendErrorTimeExceeded (packet, ipHeader.GetSourceAddress (), Icmpv6Header::ICMPV6_FRAGTIME);
+      packet->AddHeader (ipHeader);
+
+      // if we have at least 8 bytes, we can send an ICMP.
+      if ( packet->GetSize () > 8 )
+        {
+          Ptr<Icmpv6L4Protocol> icmp = GetNode ()->GetObject<Icmpv6L4Protocol> ();
+          icmp->SendErrorTimeExceeded (packet, ipHeader.GetSourceAddress (), Icmpv6Header::ICMPV6_FRAGTIME);
+        }
+      m_dropTrace (packet);
     }
-  m_dropTrace (packet);
 
   // clear the buffers
+  RemoveFragmentsExpiry (fragmentsId, fragments->GetTimeoutEventId ());
   m_fragments.erase (fragmentsId);
 }
 
+bool Ipv6ExtensionFragment::ReclaimFragmentsMemory (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+
+  if (m_fragmentsMemoryLimit == 0)
+    {
+      return true;
+    }
+  if (size > m_fragmentsMemoryLimit)
+    {
+      return false;
+    }
+
+  while (m_fragmentsMemory + size > m_fragmentsMemoryLimit)
+    {
+      NS_ASSERT (!m_fragmentsExpiries.empty ());
+      // the oldest packet is the first to expire
+      MapFragments_t::iterator oldest = m_fragments.find (m_fragmentsExpiries.begin ()->second);
+      m_fragmentsExpiries.erase (m_fragmentsExpiries.begin ());
+      Ptr<Fragments> fragments = oldest->second;
+      fragments->CancelTimeout ();
+      m_fragments.erase (oldest);
+      m_fragmentsMemory -= fragments->GetSize ();
+
+      NS_LOG_LOGIC ("Reassembly memory full, dropping " << fragments->GetSize () << " bytes");
+      Ptr<Packet> packet = fragments->GetPartialPacket ();
+      if (packet)
+        {
+          m_dropTrace (packet);
+        }
+    }
+  return true;
+}
+
+void Ipv6ExtensionFragment::RemoveFragmentsExpiry (std::pair<Ipv6Address, uint32_t> key, const EventId &timeout)
+{
+  NS_LOG_FUNCTION (this << &key);
+
+  std::pair<FragmentsExpiries_t::iterator, FragmentsExpiries_t::iterator> range;
+  range = m_fragmentsExpiries.equal_range (timeout.GetTs ());
+  for (FragmentsExpiries_t::iterator it = range.first; it != range.second; it++)
+    {
+      if (it->second == key)
+        {
+          m_fragmentsExpiries.erase (it);
+          return;
+        }
+    }
+}
+
 Ipv6ExtensionFragment::Fragments::Fragments ()
-  : m_moreFragment (0)
+  : m_lastFragmentReceived (false),
+    m_packetSize (0),
+    m_contiguousSize (0),
+    m_size (0)
 {
 }
 
@@ -608,22 +690,64 @@ Ipv6ExtensionFragment::Fragments::~Fragments ()
 
 void Ipv6ExtensionFragment::Fragments::AddFragment (Ptr<Packet> fragment, uint16_t fragmentOffset, bool moreFragment)
 {
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::iterator it;
+  uint32_t fragmentStart = fragmentOffset;
+  uint32_t fragmentEnd = fragmentStart + fragment->GetSize ();
 
-  for (it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
+  if (!moreFragment)
     {
-      if (it->second > fragmentOffset)
+      m_lastFragmentReceived = true;
+      m_packetSize = fragmentEnd;
+    }
+
+  // first stored fragment ending after the start of the new one
+  std::map<uint32_t, Ptr<Packet> >::iterator it = m_packetFragments.upper_bound (fragmentStart);
+  if (it != m_packetFragments.begin ())
+    {
+      std::map<uint32_t, Ptr<Packet> >::iterator previous = it;
+      previous--;
+      if (previous->first + previous->second->GetSize () > fragmentStart)
+        {
+          it = previous;
+        }
+    }
+
+  // store the holes the new fragment fills, the old bytes are kept
+  uint32_t start = fragmentStart;
+  while (start < fragmentEnd)
+    {
+      uint32_t end = fragmentEnd;
+      if (it != m_packetFragments.end () && it->first < end)
+        {
+          end = it->first;
+        }
+      if (end > start)
+        {
+          Ptr<Packet> hole = fragment;
+          if (end - start != fragment->GetSize ())
+            {
+              hole = fragment->CreateFragment (start - fragmentStart, end - start);
+            }
+          m_packetFragments.insert (it, std::make_pair (start, hole));
+          m_size += end - start;
+        }
+      if (it == m_packetFragments.end ())
         {
           break;
         }
+      start = std::max (start, it->first + it->second->GetSize ());
+      it++;
     }
 
-  if (it == m_packetFragments.end ())
+  std::map<uint32_t, Ptr<Packet> >::const_iterator next;
+  while ((next = m_packetFragments.find (m_contiguousSize)) != m_packetFragments.end ())
     {
-      m_moreFragment = moreFragment;
+      m_contiguousSize += next->second->GetSize ();
     }
+}
 
-  m_packetFragments.insert (it, std::pair<Ptr<Packet>, uint16_t> (fragment, fragmentOffset));
+uint32_t Ipv6ExtensionFragment::Fragments::GetSize () const
+{
+  return m_size;
 }
 
 void Ipv6ExtensionFragment::Fragments::SetUnfragmentablePart (Ptr<Packet> unfragmentablePart)
@@ -633,37 +757,12 @@ void Ipv6ExtensionFragment::Fragments::SetUnfragmentablePart (Ptr<Packet> unfrag
 
 bool Ipv6ExtensionFragment::Fragments::IsEntire () const
 {
-  bool ret = !m_moreFragment && m_packetFragments.size () > 0;
-
-  if (ret)
-    {
-      uint16_t lastEndOffset = 0;
-
-      for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
-        {
-          if (lastEndOffset != it->second)
-            {
-              ret = false;
-              break;
-            }
-
-          lastEndOffset += it->first->GetSize ();
-        }
-    }
-
-  return ret;
+  return m_unfragmentable && m_lastFragmentReceived && m_contiguousSize >= m_packetSize;
 }
 
 Ptr<Packet> Ipv6ExtensionFragment::Fragments::GetPacket () const
 {
-  Ptr<Packet> p =  m_unfragmentable->Copy ();
-
-  for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
-    {
-      p->AddAtEnd (it->first);
-    }
-
-  return p;
+  return GetPartialPacket ();
 }
 
 Ptr<Packet> Ipv6ExtensionFragment::Fragments::GetPartialPacket () const
@@ -679,16 +778,17 @@ Ptr<Packet> Ipv6ExtensionFragment::Fragments::GetPartialPacket () const
       return p;
     }
 
-  uint16_t lastEndOffset = 0;
+  // the fragments do not overlap, they are appended as they are
+  uint32_t lastEndOffset = 0;
 
-  for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
+  for (std::map<uint32_t, Ptr<Packet> >::const_iterator it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
     {
-      if (lastEndOffset != it->second)
+      if (lastEndOffset != it->first)
         {
           break;
         }
-      p->AddAtEnd (it->first);
-      lastEndOffset += it->first->GetSize ();
+      p->AddAtEnd (it->second);
+      lastEndOffset += it->second->GetSize ();
     }
 
   return p;
@@ -700,6 +800,11 @@ void Ipv6ExtensionFragment::Fragments::SetTimeoutEventId (EventId event)
   return;
 }
 
+EventId Ipv6ExtensionFragment::Fragments::GetTimeoutEventId () const
+{
+  return m_timeoutEventId;
+}
+
 void Ipv6ExtensionFragment::Fragments::CancelTimeout ()
 {
   m_timeoutEventId.Cancel ();
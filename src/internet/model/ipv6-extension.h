@@ -315,12 +315,22 @@ public:
 
     /**
      * \brief Add a fragment.
+     *
+     * The bytes already received are cut from the fragment, so that the
+     * stored fragments never overlap: the old bytes are kept.
+     *
      * \param fragment the fragment
      * \param fragmentOffset the offset of the fragment
      * \param moreFragment the bit "More Fragment"
      */
     void AddFragment (Ptr<Packet> fragment, uint16_t fragmentOffset, bool moreFragment);
 
+    /**
+     * \brief Get the number of fragmentable bytes stored.
+     * \return the number of bytes stored
+     */
+    uint32_t GetSize () const;
+
     /**
      * \brief Set the unfragmentable part of the packet.
      * \param unfragmentablePart the unfragmentable part
@@ -350,6 +360,12 @@ public:
      */
     void SetTimeoutEventId (EventId event);
 
+    /**
+     * \brief Get the Timeout EventId.
+     * \return the timeout event
+     */
+    EventId GetTimeoutEventId () const;
+
     /**
      * \brief Cancel the timeout event
      */
@@ -357,14 +373,29 @@ public:
 
 private:
     /**
-     * \brief If other fragments will be sent.
+     * \brief True once the last fragment has been received.
+     */
+    bool m_lastFragmentReceived;
+
+    /**
+     * \brief The size of the fragmentable part, known once the last fragment is received.
      */
-    bool m_moreFragment;
+    uint32_t m_packetSize;
 
     /**
-     * \brief The current fragments.
+     * \brief The number of bytes received without hole from offset 0.
      */
-    std::list<std::pair<Ptr<Packet>, uint16_t> > m_packetFragments;
+    uint32_t m_contiguousSize;
+
+    /**
+     * \brief The number of bytes stored.
+     */
+    uint32_t m_size;
+
+    /**
+     * \brief The current fragments, indexed by offset. They do not overlap.
+     */
+    std::map<uint32_t, Ptr<Packet> > m_packetFragments;
 
     /**
      * \brief The unfragmentable part.
@@ -384,6 +415,21 @@ private:
    */
   void HandleFragmentsTimeout (std::pair<Ipv6Address, uint32_t> key, Ipv6Header & ipHeader);
 
+  /**
+   * \brief Drop the oldest incomplete packets until there is room
+   * for the given number of bytes in the reassembly memory
+   * \param size the number of bytes needed
+   * \return false if the limit is lower than the size needed
+   */
+  bool ReclaimFragmentsMemory (uint32_t size);
+
+  /**
+   * \brief Remove a packet from the expiration order
+   * \param key representing the packet fragments
+   * \param timeout the expiration event of the packet
+   */
+  void RemoveFragmentsExpiry (std::pair<Ipv6Address, uint32_t> key, const EventId &timeout);
+
   /**
    * \brief Get the packet parts so far received.
    * \return the partial packet
@@ -409,6 +455,26 @@ private:
    * \brief The hash of fragmented packets.
    */
   MapFragments_t m_fragments;
+
+  /**
+   * \brief Container for the packet keys, ordered by the timestamp of their timeout event.
+   */
+  typedef std::multimap<uint64_t, std::pair<Ipv6Address, uint32_t> > FragmentsExpiries_t;
+
+  /**
+   * \brief The fragmented packets, oldest first.
+   */
+  FragmentsExpiries_t m_fragmentsExpiries;
+
+  /**
+   * \brief The number of bytes held by the incomplete packets.
+   */
+  uint32_t m_fragmentsMemory;
+
+  /**
+   * \brief The maximum number of bytes held by the incomplete packets.
+   */
+  uint32_t m_fragmentsMemoryLimit;
 };
 
 /**
@@ -21,6 +21,7 @@
 #include "ns3/log.h"
 #include "ns3/uinteger.h"
 #include "ns3/node.h"
+#include "ns3/simulator.h"
 
 #include "ipv6-l3-protocol.h" 
 #include "icmpv6-l4-protocol.h"
@@ -50,6 +51,7 @@ TypeId NdiscCache::GetTypeId ()
 } 
 
 NdiscCache::NdiscCache ()
+  : m_nextTimerUid (1)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -92,10 +94,10 @@ NdiscCache::Entry* NdiscCache::Lookup (Ipv6Address dst)
 {
   NS_LOG_FUNCTION (this << dst);
 
-  if (m_ndCache.find (dst) != m_ndCache.end ())
+  CacheI it = m_ndCache.find (dst);
+  if (it != m_ndCache.end ())
     {
-      NdiscCache::Entry* entry = m_ndCache[dst];
-      return entry;
+      return it->second;
     }
   return 0;
 }
@@ -115,15 +117,12 @@ void NdiscCache::Remove (NdiscCache::Entry* entry)
 {
   NS_LOG_FUNCTION_NOARGS ();
 
-  for (CacheI i = m_ndCache.begin (); i != m_ndCache.end (); i++)
+  CacheI i = m_ndCache.find (entry->GetIpv6Address ());
+  if (i != m_ndCache.end () && (*i).second == entry)
     {
-      if ((*i).second == entry)
-        {
-          m_ndCache.erase (i);
-          entry->ClearWaitingPacket ();
-          delete entry;
-          return;
-        }
+      m_ndCache.erase (i);
+      entry->ClearWaitingPacket ();
+      delete entry;
     }
 }
 
@@ -137,6 +136,12 @@ void NdiscCache::Flush ()
     }
 
   m_ndCache.erase (m_ndCache.begin (), m_ndCache.end ());
+
+  m_timerEvent.Cancel ();
+  while (!m_timers.empty ())
+    {
+      m_timers.pop ();
+    }
 }
 
 void NdiscCache::SetUnresQlen (uint32_t unresQlen)
@@ -151,18 +156,101 @@ uint32_t NdiscCache::GetUnresQlen ()
   return m_unresQlen;
 }
 
+void NdiscCache::StartTimer (NdiscCache::Entry* entry, TimerType type, Time delay)
+{
+  NS_LOG_FUNCTION (this << entry << type << delay);
+
+  if (entry->m_timerUid[type] != 0)
+    {
+      NS_FATAL_ERROR ("NUD timer is still running while re-scheduling.");
+    }
+
+  TimerDeadline deadline;
+  deadline.expires = Simulator::Now () + delay;
+  deadline.uid = m_nextTimerUid++;
+  deadline.address = entry->GetIpv6Address ();
+  deadline.type = type;
+  entry->m_timerUid[type] = deadline.uid;
+  m_timers.push (deadline);
+  ScheduleTimerEvent ();
+}
+
+void NdiscCache::StopTimer (NdiscCache::Entry* entry, TimerType type)
+{
+  NS_LOG_FUNCTION (this << entry << type);
+  /* the deadline stays in the queue and is discarded when it expires */
+  entry->m_timerUid[type] = 0;
+}
+
+void NdiscCache::ScheduleTimerEvent ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  if (m_timers.empty ())
+    {
+      return;
+    }
+  Time next = m_timers.top ().expires;
+  if (m_timerEvent.IsRunning ())
+    {
+      if (m_timerEvent.GetTs () <= static_cast<uint64_t> (next.GetTimeStep ()))
+        {
+          return;
+        }
+      m_timerEvent.Cancel ();
+    }
+  m_timerEvent = Simulator::Schedule (next - Simulator::Now (), &NdiscCache::HandleTimerEvent, this);
+}
+
+void NdiscCache::HandleTimerEvent ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  while (!m_timers.empty () && m_timers.top ().expires <= Simulator::Now ())
+    {
+      TimerDeadline deadline = m_timers.top ();
+      m_timers.pop ();
+
+      /* the entry may have been removed, or the timer stopped or restarted */
+      CacheI it = m_ndCache.find (deadline.address);
+      if (it == m_ndCache.end () || it->second->m_timerUid[deadline.type] != deadline.uid)
+        {
+          continue;
+        }
+      NdiscCache::Entry* entry = it->second;
+      entry->m_timerUid[deadline.type] = 0;
+
+      switch (deadline.type)
+        {
+        case REACHABLE_TIMER:
+          entry->FunctionReachableTimeout ();
+          break;
+        case RETRANSMIT_TIMER:
+          entry->FunctionRetransmitTimeout ();
+          break;
+        case PROBE_TIMER:
+          entry->FunctionProbeTimeout ();
+          break;
+        case DELAY_TIMER:
+          entry->FunctionDelayTimeout ();
+          break;
+        }
+    }
+  ScheduleTimerEvent ();
+}
+
 NdiscCache::Entry::Entry (NdiscCache* nd)
   : m_ndCache (nd),
     m_waiting (),
     m_router (false),
-    m_reachableTimer (Timer::CANCEL_ON_DESTROY),
-    m_retransTimer (Timer::CANCEL_ON_DESTROY),
-    m_probeTimer (Timer::CANCEL_ON_DESTROY),
-    m_delayTimer (Timer::CANCEL_ON_DESTROY),
     m_lastReachabilityConfirmation (Seconds (0.0)),
     m_nsRetransmit (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      m_timerUid[i] = 0;
+    }
 }
 
 void NdiscCache::Entry::SetRouter (bool router)
@@ -337,6 +425,12 @@ void NdiscCache::Entry::SetIpv6Address (Ipv6Address ipv6Address)
   m_ipv6Address = ipv6Address;
 }
 
+Ipv6Address NdiscCache::Entry::GetIpv6Address () const
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return m_ipv6Address;
+}
+
 uint8_t NdiscCache::Entry::GetNSRetransmit () const
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -369,29 +463,25 @@ void NdiscCache::Entry::UpdateLastReachabilityconfirmation ()
 void NdiscCache::Entry::StartReachableTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  m_reachableTimer.SetFunction (&NdiscCache::Entry::FunctionReachableTimeout, this);
-  m_reachableTimer.SetDelay (MilliSeconds (Icmpv6L4Protocol::REACHABLE_TIME));
-  m_reachableTimer.Schedule ();
+  m_ndCache->StartTimer (this, NdiscCache::REACHABLE_TIMER, MilliSeconds (Icmpv6L4Protocol::REACHABLE_TIME));
 }
 
 void NdiscCache::Entry::StopReachableTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  m_reachableTimer.Cancel ();
+  m_ndCache->StopTimer (this, NdiscCache::REACHABLE_TIMER);
 }
 
 void NdiscCache::Entry::StartProbeTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  m_probeTimer.SetFunction (&NdiscCache::Entry::FunctionProbeTimeout, this);
-  m_probeTimer.SetDelay (MilliSeconds (Icmpv6L4Protocol::RETRANS_TIMER));
-  m_probeTimer.Schedule ();
+  m_ndCache->StartTimer (this, NdiscCache::PROBE_TIMER, MilliSeconds (Icmpv6L4Protocol::RETRANS_TIMER));
 }
 
 void NdiscCache::Entry::StopProbeTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  m_probeTimer.Cancel ();
+  m_ndCache->StopTimer (this, NdiscCache::PROBE_TIMER);
   ResetNSRetransmit ();
 }
 
@@ -399,30 +489,26 @@ void NdiscCache::Entry::StopProbeTimer ()
 void NdiscCache::Entry::StartDelayTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  m_delayTimer.SetFunction (&NdiscCache::Entry::FunctionDelayTimeout, this);
-  m_delayTimer.SetDelay (Seconds (Icmpv6L4Protocol::DELAY_FIRST_PROBE_TIME));
-  m_delayTimer.Schedule ();
+  m_ndCache->StartTimer (this, NdiscCache::DELAY_TIMER, Seconds (Icmpv6L4Protocol::DELAY_FIRST_PROBE_TIME));
 }
 
 void NdiscCache::Entry::StopDelayTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  m_delayTimer.Cancel ();
+  m_ndCache->StopTimer (this, NdiscCache::DELAY_TIMER);
   ResetNSRetransmit ();
 }
 
 void NdiscCache::Entry::StartRetransmitTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  m_retransTimer.SetFunction (&NdiscCache::Entry::FunctionRetransmitTimeout, this);
-  m_retransTimer.SetDelay (MilliSeconds (Icmpv6L4Protocol::RETRANS_TIMER));
-  m_retransTimer.Schedule ();
+  m_ndCache->StartTimer (this, NdiscCache::RETRANSMIT_TIMER, MilliSeconds (Icmpv6L4Protocol::RETRANS_TIMER));
 }
 
 void NdiscCache::Entry::StopRetransmitTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  m_retransTimer.Cancel ();
+  m_ndCache->StopTimer (this, NdiscCache::RETRANSMIT_TIMER);
   ResetNSRetransmit ();
 }
 
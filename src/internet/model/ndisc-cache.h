@@ -24,13 +24,15 @@
 #include <stdint.h>
 
 #include <list>
+#include <queue>
+#include <vector>
 
 #include "ns3/packet.h"
 #include "ns3/nstime.h"
 #include "ns3/net-device.h"
 #include "ns3/ipv6-address.h"
 #include "ns3/ptr.h"
-#include "ns3/timer.h"
+#include "ns3/event-id.h"
 #include "ns3/sgi-hashmap.h"
 
 namespace ns3
@@ -42,6 +44,12 @@ class Ipv6Interface;
 /**
  * \class NdiscCache
  * \brief IPv6 Neighbor Discovery cache.
+ *
+ * The NUD timers of all the entries (reachable, retransmit, probe and
+ * delay) are kept in a single deadline-ordered queue, and the cache
+ * has at most one event scheduled in the simulator: the one for the
+ * earliest deadline.  Stopping a timer does not touch the queue, the
+ * stale deadline is simply ignored when it is reached.
  */
 class NdiscCache : public Object
 {
@@ -337,7 +345,14 @@ public:
      */
     void SetIpv6Address (Ipv6Address ipv6Address);
 
+    /**
+     * \brief Get the IPv6 address.
+     * \return the IPv6 address
+     */
+    Ipv6Address GetIpv6Address () const;
+
 private:
+    friend class NdiscCache;
     /**
      * \brief The IPv6 address.
      */
@@ -381,24 +396,11 @@ private:
     bool m_router;
 
     /**
-     * \brief Reachable timer (used for NUD in REACHABLE state).
-     */
-    Timer m_reachableTimer;
-
-    /**
-     * \brief Retransmission timer (used for NUD in INCOMPLETE state).
-     */
-    Timer m_retransTimer;
-
-    /**
-     * \brief Probe timer (used for NUD in PROBE state).
-     */
-    Timer m_probeTimer;
-
-    /**
-     * \brief Delay timer (used for NUD when in DELAY state).
+     * \brief Identifier of the pending deadline of each NUD timer, 0 if the timer is not running.
+     *
+     * Indexed by NdiscCache::TimerType.
      */
-    Timer m_delayTimer;
+    uint64_t m_timerUid[4];
 
     /**
      * \brief Last time we see a reachability confirmation.
@@ -412,6 +414,68 @@ private:
   };
 
 private:
+  /**
+   * \brief The NUD timers of an entry.
+   */
+  enum TimerType
+  {
+    REACHABLE_TIMER, /**< Reachable timer (used for NUD in REACHABLE state) */
+    RETRANSMIT_TIMER, /**< Retransmission timer (used for NUD in INCOMPLETE state) */
+    PROBE_TIMER, /**< Probe timer (used for NUD in PROBE state) */
+    DELAY_TIMER /**< Delay timer (used for NUD when in DELAY state) */
+  };
+
+  /**
+   * \brief A deadline of one of the NUD timers of an entry.
+   */
+  struct TimerDeadline
+  {
+    Time expires; //!< expiration time
+    uint64_t uid; //!< unique identifier, also breaks ties in scheduling order
+    Ipv6Address address; //!< address of the entry owning the timer
+    TimerType type; //!< which timer of the entry
+  };
+
+  /**
+   * \brief Orders the deadline queue with the earliest deadline on top.
+   */
+  struct TimerDeadlineCompare
+  {
+    bool operator() (const TimerDeadline &a, const TimerDeadline &b) const
+    {
+      if (a.expires != b.expires)
+        {
+          return a.expires > b.expires;
+        }
+      return a.uid > b.uid;
+    }
+  };
+
+  /**
+   * \brief Start one of the NUD timers of an entry.
+   * \param entry the entry
+   * \param type the timer to start
+   * \param delay the delay before the timer expires
+   */
+  void StartTimer (NdiscCache::Entry* entry, TimerType type, Time delay);
+
+  /**
+   * \brief Stop one of the NUD timers of an entry.
+   * \param entry the entry
+   * \param type the timer to stop
+   */
+  void StopTimer (NdiscCache::Entry* entry, TimerType type);
+
+  /**
+   * \brief Make sure the cache event is scheduled for the earliest pending deadline.
+   */
+  void ScheduleTimerEvent ();
+
+  /**
+   * \brief Expire all the deadlines which are due and call the matching timeout functions.
+   */
+  void HandleTimerEvent ();
+
   /**
    * \brief Neighbor Discovery Cache container
    */
@@ -460,6 +524,21 @@ private:
    * \brief Max number of packet stored in m_waiting.
    */
   uint32_t m_unresQlen;
+
+  /**
+   * \brief The pending NUD timer deadlines, earliest on top.
+   */
+  std::priority_queue<TimerDeadline, std::vector<TimerDeadline>, TimerDeadlineCompare> m_timers;
+
+  /**
+   * \brief The event which expires the earliest deadline.
+   */
+  EventId m_timerEvent;
+
+  /**
+   * \brief Identifier of the next deadline.
+   */
+  uint64_t m_nextTimerUid;
 };
 
 } /* namespace ns3 */
@@ -29,6 +29,7 @@
 #include "ns3/simulator.h"
 #include "ns3/ipv4-route.h"
 #include "ns3/ipv6-route.h"
+#include "ns3/segmentation-offload-tag.h"
 
 #include "tcp-l4-protocol.h"
 #include "tcp-header.h"
@@ -44,6 +45,7 @@
 #include "rtt-estimator.h"
 
 #include <vector>
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
 
@@ -641,6 +643,20 @@ TcpL4Protocol::SendPacket (Ptr<Packet> packet, const TcpHeader &outgoing,
           NS_LOG_ERROR ("No IPV4 Routing Protocol");
           route = 0;
         }
+      SegmentationOffloadTag offloadTag;
+      if (route != 0 && !route->GetOutputDevice ()->SupportsSegmentationOffload ()
+          && packet->PeekPacketTag (offloadTag))
+        { // The outgoing device cannot carry the super-segment, split it here
+          packet->RemoveAtStart (outgoingHeader.GetSerializedSize ());
+          std::list<std::pair<Ptr<Packet>, TcpHeader> > segments;
+          Segment (packet, outgoing, segments);
+          for (std::list<std::pair<Ptr<Packet>, TcpHeader> >::iterator i = segments.begin ();
+               i != segments.end (); ++i)
+            {
+              SendPacket (i->first, i->second, saddr, daddr, oif);
+            }
+          return;
+        }
       m_downTarget (packet, saddr, daddr, PROT_NUMBER, route);
     }
   else
@@ -663,6 +679,18 @@ TcpL4Protocol::SendPacket (Ptr<Packet> packet, const TcpHeader &outgoing,
     {
       return (SendPacket (packet, outgoing, saddr.GetIpv4MappedAddress(), daddr.GetIpv4MappedAddress(), oif));
     }
+  SegmentationOffloadTag offloadTag;
+  if (packet->PeekPacketTag (offloadTag))
+    { // IPv6 never hands super-segments to the devices, split it here
+      std::list<std::pair<Ptr<Packet>, TcpHeader> > segments;
+      Segment (packet, outgoing, segments);
+      for (std::list<std::pair<Ptr<Packet>, TcpHeader> >::iterator i = segments.begin ();
+           i != segments.end (); ++i)
+        {
+          SendPacket (i->first, i->second, saddr, daddr, oif);
+        }
+      return;
+    }
   TcpHeader outgoingHeader = outgoing;
   outgoingHeader.SetLength (5); //header length in units of 32bit words
   /** \todo UrgentPointer */
@@ -699,6 +727,30 @@ TcpL4Protocol::SendPacket (Ptr<Packet> packet, const TcpHeader &outgoing,
     NS_FATAL_ERROR ("Trying to use Tcp on a node without an Ipv6 interface");
 }
 
+void
+TcpL4Protocol::Segment (Ptr<Packet> packet, const TcpHeader &outgoing,
+                        std::list<std::pair<Ptr<Packet>, TcpHeader> > &segments) const
+{
+  NS_LOG_FUNCTION (this << packet);
+
+  SegmentationOffloadTag offloadTag;
+  packet->RemovePacketTag (offloadTag);
+  uint32_t segmentSize = offloadTag.GetSegmentSize ();
+  uint32_t size = packet->GetSize ();
+  NS_ASSERT (segmentSize > 0);
+  for (uint32_t offset = 0; offset < size; offset += segmentSize)
+    {
+      uint32_t length = std::min (segmentSize, size - offset);
+      TcpHeader header = outgoing;
+      header.SetSequenceNumber (outgoing.GetSequenceNumber () + SequenceNumber32 (offset));
+      if (offset + length < size)
+        { // Only the last segment carries the FIN
+          header.SetFlags (outgoing.GetFlags () & ~TcpHeader::FIN);
+        }
+      segments.push_back (std::make_pair (packet->CreateFragment (offset, length), header));
+    }
+}
+
 void
 TcpL4Protocol::SetDownTarget (IpL4Protocol::DownTargetCallback callback)
 {
@@ -22,6 +22,7 @@
 #define TCP_L4_PROTOCOL_H
 
 #include <stdint.h>
+#include <list>
 
 #include "ns3/packet.h"
 #include "ns3/ipv4-address.h"
@@ -239,6 +240,17 @@ private:
   void SendPacket (Ptr<Packet>, const TcpHeader &,
                    Ipv6Address, Ipv6Address, Ptr<NetDevice> oif = 0);
 
+  /**
+   * \brief Segment in software a super-segment handed down by a socket
+   * with segmentation offload enabled
+   * \param packet the payload of the super-segment, carrying a
+   *        SegmentationOffloadTag
+   * \param outgoing the TCP header of the super-segment
+   * \param segments the segments and their TCP headers
+   */
+  void Segment (Ptr<Packet> packet, const TcpHeader &outgoing,
+                std::list<std::pair<Ptr<Packet>, TcpHeader> > &segments) const;
+
   /**
    * \brief Copy constructor
    *
@@ -39,6 +39,8 @@
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/segmentation-offload-tag.h"
 #include "ns3/trace-source-accessor.h"
 #include "tcp-socket-base.h"
 #include "tcp-l4-protocol.h"
@@ -76,6 +78,17 @@ TcpSocketBase::GetTypeId (void)
                    UintegerValue (65535),
                    MakeUintegerAccessor (&TcpSocketBase::m_maxWinSize),
                    MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("SegmentationOffload",
+                   "Hand super-segments of several segments down to the IP layer in one packet (TSO/GSO). "
+                   "Devices which do not support segmentation offload get them segmented in software.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_segmentationOffload),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxOffloadSize",
+                   "Maximum payload of a super-segment, rounded down to a multiple of the segment size",
+                   UintegerValue (65000),
+                   MakeUintegerAccessor (&TcpSocketBase::m_maxOffloadSize),
+                   MakeUintegerChecker<uint32_t> (0, 65495))
     .AddAttribute ("IcmpCallback", "Callback invoked whenever an icmp error is received on this socket.",
                    CallbackValue (),
                    MakeCallbackAccessor (&TcpSocketBase::m_icmpCallback),
@@ -128,7 +141,10 @@ TcpSocketBase::TcpSocketBase (void)
     m_connected (false),
     m_segmentSize (0),
     // For attribute initialization consistency (quiet valgrind)
-    m_rWnd (0)
+    m_rWnd (0),
+    m_segmentationOffload (false),
+    m_maxOffloadSize (0),
+    m_splittingAck (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -163,7 +179,10 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
     m_msl (sock.m_msl),
     m_segmentSize (sock.m_segmentSize),
     m_maxWinSize (sock.m_maxWinSize),
-    m_rWnd (sock.m_rWnd)
+    m_rWnd (sock.m_rWnd),
+    m_segmentationOffload (sock.m_segmentationOffload),
+    m_maxOffloadSize (sock.m_maxOffloadSize),
+    m_splittingAck (false)
 {
   NS_LOG_FUNCTION (this);
   NS_LOG_LOGIC ("Invoked the copy constructor");
@@ -1109,6 +1128,10 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
   else if (tcpHeader.GetAckNumber () > m_txBuffer.HeadSequence ())
     { // Case 3: New ACK, reset m_dupAckCount and update m_txBuffer
       NS_LOG_LOGIC ("New ack of " << tcpHeader.GetAckNumber ());
+      if (m_segmentationOffload)
+        {
+          SplitOffloadedAck (tcpHeader.GetAckNumber ());
+        }
       NewAck (tcpHeader.GetAckNumber ());
       m_dupAckCount = 0;
     }
@@ -1867,6 +1890,14 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
       p->AddPacketTag (ipHopLimitTag);
     }
 
+  // A payload larger than one segment is a super-segment: let the device
+  // (or TcpL4Protocol, if the device cannot) know how to segment it.
+  if (sz > m_segmentSize)
+    {
+      SegmentationOffloadTag offloadTag (m_segmentSize, sz);
+      p->AddPacketTag (offloadTag);
+    }
+
   if (m_closeOnEmpty && (remainingData == 0))
     {
       flags |= TcpHeader::FIN;
@@ -1970,6 +2001,11 @@ TcpSocketBase::SendPendingData (bool withAck)
           break;
         }
       uint32_t s = std::min (w, m_segmentSize);  // Send no more than window
+      if (m_segmentationOffload && w > m_segmentSize)
+        { // Send as many whole segments as allowed in one super-segment
+          uint32_t maxOffload = std::max (m_maxOffloadSize - m_maxOffloadSize % m_segmentSize, m_segmentSize);
+          s = std::min (w - w % m_segmentSize, maxOffload);
+        }
       uint32_t sz = SendDataPacket (m_nextTxSequence, s, withAck);
       nPacketsSent++;                             // Count sent this loop
       m_nextTxSequence += sz;                     // Advance next tx sequence
@@ -2024,6 +2060,14 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
                 " ack " << tcpHeader.GetAckNumber () <<
                 " pkt size " << p->GetSize () );
 
+  // A coalesced super-segment counts for all the segments it carries
+  uint32_t nSegments = 1;
+  SegmentationOffloadTag offloadTag;
+  if (p->RemovePacketTag (offloadTag))
+    {
+      nSegments = offloadTag.GetSegmentCount ();
+    }
+
   // Put into Rx buffer
   SequenceNumber32 expectedSeq = m_rxBuffer.NextRxSequence ();
   if (!m_rxBuffer.Add (p, tcpHeader))
@@ -2035,10 +2079,16 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
   if (m_rxBuffer.Size () > m_rxBuffer.Available () || m_rxBuffer.NextRxSequence () > expectedSeq + p->GetSize ())
     { // A gap exists in the buffer, or we filled a gap: Always ACK
       SendEmptyPacket (TcpHeader::ACK);
+      // Out of order, every segment of the train would have been a duplicate ACK
+      for (uint32_t i = 1; m_rxBuffer.NextRxSequence () == expectedSeq && i < nSegments; i++)
+        {
+          SendEmptyPacket (TcpHeader::ACK);
+        }
     }
   else
     { // In-sequence packet: ACK if delayed ack count allows
-      if (++m_delAckCount >= m_delAckMaxCount)
+      m_delAckCount += nSegments;
+      if (m_delAckCount >= m_delAckMaxCount)
         {
           m_delAckEvent.Cancel ();
           m_delAckCount = 0;
@@ -2099,6 +2149,16 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack)
 {
   NS_LOG_FUNCTION (this << ack);
 
+  if (m_splittingAck)
+    { // Intermediate ACK of a split super-segment ACK: release the data only,
+      // timers and transmissions are dealt with on the final ACK
+      m_txBuffer.DiscardUpTo (ack);
+      if (ack > m_nextTxSequence)
+        {
+          m_nextTxSequence = ack;
+        }
+      return;
+    }
   if (m_state != SYN_RCVD)
     { // Set RTO unless the ACK is received in SYN_RCVD state
       NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
@@ -2145,6 +2205,24 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack)
   SendPendingData (m_connected);
 }
 
+/* A receiver coalesces a super-segment and acknowledges it at once. Replay
+   the cumulative ACKs a receiver of the segment train would have sent, one
+   every m_delAckMaxCount segments, so that the congestion window grows as
+   in the segmented flow. */
+void
+TcpSocketBase::SplitOffloadedAck (SequenceNumber32 const& ack)
+{
+  NS_LOG_FUNCTION (this << ack);
+
+  uint32_t step = m_segmentSize * std::max (m_delAckMaxCount, (uint32_t) 1);
+  m_splittingAck = true;
+  while (ack > m_txBuffer.HeadSequence () + step)
+    {
+      NewAck (m_txBuffer.HeadSequence () + step);
+    }
+  m_splittingAck = false;
+}
+
 // Retransmit timeout
 void
 TcpSocketBase::ReTxTimeout ()
@@ -2242,6 +2320,10 @@ void
 TcpSocketBase::DoRetransmit ()
 {
   NS_LOG_FUNCTION (this);
+  if (m_splittingAck)
+    { // Retransmissions triggered by a split ACK wait for the final ACK
+      return;
+    }
   // Retransmit SYN packet
   if (m_state == SYN_SENT)
     {
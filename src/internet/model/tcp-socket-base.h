@@ -501,6 +501,13 @@ protected:
    */
   virtual void NewAck (SequenceNumber32 const& seq);
 
+  /**
+   * \brief Split the ACK of a super-segment into the ACKs the segment train
+   * would have triggered, calling NewAck() for all but the last one
+   * \param ack the acknowledgment number of the ACK
+   */
+  void SplitOffloadedAck (SequenceNumber32 const& ack);
+
   /**
    * \brief Received dupack (duplicate ACK)
    * \param tcpHeader the packet's TCP header
@@ -600,6 +607,11 @@ protected:
   uint32_t              m_segmentSize; //!< Segment size
   uint16_t              m_maxWinSize;  //!< Maximum window size to advertise
   TracedValue<uint32_t> m_rWnd;        //!< Flow control window at remote side
+
+  // Segmentation offload
+  bool     m_segmentationOffload; //!< Send super-segments (TSO/GSO)
+  uint32_t m_maxOffloadSize;      //!< Maximum payload of a super-segment
+  bool     m_splittingAck;        //!< Replaying the ACK of a super-segment
 };
 
 } // namespace ns3
@@ -0,0 +1,277 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sstream>
+#include <string>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/uinteger.h"
+#include "ns3/packet.h"
+#include "ns3/node.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/mac48-address.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/arp-cache.h"
+
+using namespace ns3;
+
+/**
+ * Base class of the ArpCache tests: builds a cache which records the
+ * ARP requests it asks for and the packets it drops.
+ */
+class ArpCacheTestCase : public TestCase
+{
+public:
+  ArpCacheTestCase (std::string name);
+
+protected:
+  /**
+   * Create m_cache, with a one second wait reply timeout.
+   *
+   * \param maxRetries the number of ARP requests retransmitted for an entry
+   */
+  void CreateCache (uint32_t maxRetries);
+  /**
+   * Add an entry to m_cache and wait for its reply.
+   *
+   * \param address the address of the entry
+   */
+  void AddWaitReply (Ipv4Address address);
+  /**
+   * Receive the reply for an entry of m_cache.
+   *
+   * \param address the address of the entry
+   */
+  void MarkAlive (Ipv4Address address);
+
+  Ptr<ArpCache> m_cache; //!< the cache under test
+  std::string m_requests; //!< "time:address " for each ARP request
+  std::string m_drops; //!< "time " for each packet dropped
+
+private:
+  /**
+   * Record an ARP request.
+   *
+   * \param cache the cache which asks for the request
+   * \param to the address to resolve
+   */
+  void Request (Ptr<const ArpCache> cache, Ipv4Address to);
+  /**
+   * Record a dropped packet.
+   *
+   * \param packet the packet
+   */
+  void Drop (Ptr<const Packet> packet);
+};
+
+ArpCacheTestCase::ArpCacheTestCase (std::string name)
+  : TestCase (name)
+{
+}
+
+void
+ArpCacheTestCase::CreateCache (uint32_t maxRetries)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+  device->SetAddress (Mac48Address::Allocate ());
+  node->AddDevice (device);
+
+  m_cache = CreateObject<ArpCache> ();
+  m_cache->SetAttribute ("MaxRetries", UintegerValue (maxRetries));
+  m_cache->SetDevice (device, 0);
+  m_cache->SetWaitReplyTimeout (Seconds (1));
+  m_cache->SetArpRequestCallback (MakeCallback (&ArpCacheTestCase::Request, this));
+  m_cache->TraceConnectWithoutContext ("Drop", MakeCallback (&ArpCacheTestCase::Drop, this));
+  m_requests = "";
+  m_drops = "";
+}
+
+void
+ArpCacheTestCase::AddWaitReply (Ipv4Address address)
+{
+  ArpCache::Entry *entry = m_cache->Lookup (address);
+  if (entry == 0)
+    {
+      entry = m_cache->Add (address);
+    }
+  entry->MarkWaitReply (Create<Packet> (100));
+}
+
+void
+ArpCacheTestCase::MarkAlive (Ipv4Address address)
+{
+  m_cache->Lookup (address)->MarkAlive (Mac48Address::Allocate ());
+}
+
+void
+ArpCacheTestCase::Request (Ptr<const ArpCache> cache, Ipv4Address to)
+{
+  std::ostringstream oss;
+  oss << Simulator::Now ().GetSeconds () << ":" << to << " ";
+  m_requests += oss.str ();
+}
+
+void
+ArpCacheTestCase::Drop (Ptr<const Packet> packet)
+{
+  std::ostringstream oss;
+  oss << Simulator::Now ().GetSeconds () << " ";
+  m_drops += oss.str ();
+}
+
+/**
+ * The entries waiting for a reply are retransmitted, then marked dead,
+ * together and in the order they started waiting.
+ */
+class ArpCacheRetransmitTestCase : public ArpCacheTestCase
+{
+public:
+  ArpCacheRetransmitTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+ArpCacheRetransmitTestCase::ArpCacheRetransmitTestCase ()
+  : ArpCacheTestCase ("ArpCache retransmits, then expires, its entries in order")
+{
+}
+
+void
+ArpCacheRetransmitTestCase::DoRun (void)
+{
+  CreateCache (2);
+  Simulator::Schedule (Seconds (0), &ArpCacheRetransmitTestCase::AddWaitReply, this, Ipv4Address ("10.0.0.3"));
+  Simulator::Schedule (Seconds (0), &ArpCacheRetransmitTestCase::AddWaitReply, this, Ipv4Address ("10.0.0.1"));
+  Simulator::Schedule (Seconds (0.5), &ArpCacheRetransmitTestCase::AddWaitReply, this, Ipv4Address ("10.0.0.2"));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_requests, "1:10.0.0.3 1:10.0.0.1 1:10.0.0.2 2:10.0.0.3 2:10.0.0.1 2:10.0.0.2 ",
+                         "ARP requests not retransmitted in order");
+  NS_TEST_EXPECT_MSG_EQ (m_drops, "3 3 3 ", "pending packets not dropped when the entries expire");
+  NS_TEST_EXPECT_MSG_EQ (m_cache->Lookup (Ipv4Address ("10.0.0.1"))->IsDead (), true, "entry not dead");
+  NS_TEST_EXPECT_MSG_EQ (m_cache->Lookup (Ipv4Address ("10.0.0.2"))->IsDead (), true, "entry not dead");
+  NS_TEST_EXPECT_MSG_EQ (m_cache->Lookup (Ipv4Address ("10.0.0.3"))->IsDead (), true, "entry not dead");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), Seconds (3), "wait reply timer restarted with no entry waiting");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * The entries which got a reply, or which were marked dead, are no
+ * longer visited by the wait reply timer, until they wait again.
+ */
+class ArpCacheDeadEntryTestCase : public ArpCacheTestCase
+{
+public:
+  ArpCacheDeadEntryTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+ArpCacheDeadEntryTestCase::ArpCacheDeadEntryTestCase ()
+  : ArpCacheTestCase ("ArpCache stops visiting the entries which no longer wait")
+{
+}
+
+void
+ArpCacheDeadEntryTestCase::DoRun (void)
+{
+  CreateCache (1);
+  Simulator::Schedule (Seconds (0), &ArpCacheDeadEntryTestCase::AddWaitReply, this, Ipv4Address ("10.0.0.1"));
+  Simulator::Schedule (Seconds (0), &ArpCacheDeadEntryTestCase::AddWaitReply, this, Ipv4Address ("10.0.0.2"));
+  Simulator::Schedule (Seconds (0), &ArpCacheDeadEntryTestCase::AddWaitReply, this, Ipv4Address ("10.0.0.3"));
+  Simulator::Schedule (Seconds (0.5), &ArpCacheDeadEntryTestCase::MarkAlive, this, Ipv4Address ("10.0.0.2"));
+  // 10.0.0.1 and 10.0.0.3 expire at 2 s and no timer is left running
+  Simulator::Schedule (Seconds (2.5), &ArpCacheDeadEntryTestCase::AddWaitReply, this, Ipv4Address ("10.0.0.3"));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_requests, "1:10.0.0.1 1:10.0.0.3 3.5:10.0.0.3 ",
+                         "ARP requests sent for entries which no longer wait");
+  NS_TEST_EXPECT_MSG_EQ (m_drops, "2 2 4.5 ", "wrong packets dropped");
+  NS_TEST_EXPECT_MSG_EQ (m_cache->Lookup (Ipv4Address ("10.0.0.1"))->IsDead (), true, "entry not dead");
+  NS_TEST_EXPECT_MSG_EQ (m_cache->Lookup (Ipv4Address ("10.0.0.2"))->IsAlive (), true, "entry not alive");
+  NS_TEST_EXPECT_MSG_EQ (m_cache->Lookup (Ipv4Address ("10.0.0.3"))->IsDead (), true, "entry not dead");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), Seconds (4.5), "wait reply timer restarted with no entry waiting");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * Flushing the cache stops the wait reply timer and forgets the entries
+ * which were waiting.
+ */
+class ArpCacheFlushTestCase : public ArpCacheTestCase
+{
+public:
+  ArpCacheFlushTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Flush the cache and check that it is empty.
+   */
+  void Flush (void);
+};
+
+ArpCacheFlushTestCase::ArpCacheFlushTestCase ()
+  : ArpCacheTestCase ("ArpCache flush stops the wait reply timer")
+{
+}
+
+void
+ArpCacheFlushTestCase::Flush (void)
+{
+  m_cache->Flush ();
+  NS_TEST_EXPECT_MSG_EQ (m_cache->Lookup (Ipv4Address ("10.0.0.1")) == 0, true, "entry not flushed");
+  NS_TEST_EXPECT_MSG_EQ (m_cache->Lookup (Ipv4Address ("10.0.0.2")) == 0, true, "entry not flushed");
+}
+
+void
+ArpCacheFlushTestCase::DoRun (void)
+{
+  CreateCache (1);
+  Simulator::Schedule (Seconds (0), &ArpCacheFlushTestCase::AddWaitReply, this, Ipv4Address ("10.0.0.1"));
+  Simulator::Schedule (Seconds (0), &ArpCacheFlushTestCase::AddWaitReply, this, Ipv4Address ("10.0.0.2"));
+  Simulator::Schedule (Seconds (1.5), &ArpCacheFlushTestCase::Flush, this);
+  // the wait reply timer restarted at 1 s would expire at 2 s: a new
+  // resolution only gets a timer of its own if the flush stopped it
+  Simulator::Schedule (Seconds (1.6), &ArpCacheFlushTestCase::AddWaitReply, this, Ipv4Address ("10.0.0.2"));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_requests, "1:10.0.0.1 1:10.0.0.2 2.6:10.0.0.2 ",
+                         "ARP requests sent for flushed entries, or at the time of the flushed timer");
+  NS_TEST_EXPECT_MSG_EQ (m_drops, "3.6 ", "wrong packets dropped after the flush");
+
+  Simulator::Destroy ();
+}
+
+static class ArpCacheTestSuite : public TestSuite
+{
+public:
+  ArpCacheTestSuite ()
+    : TestSuite ("arp-cache", UNIT)
+  {
+    AddTestCase (new ArpCacheRetransmitTestCase, TestCase::QUICK);
+    AddTestCase (new ArpCacheDeadEntryTestCase, TestCase::QUICK);
+    AddTestCase (new ArpCacheFlushTestCase, TestCase::QUICK);
+  }
+} g_arpCacheTestSuite;
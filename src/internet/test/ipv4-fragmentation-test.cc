@@ -90,6 +90,7 @@ class Ipv4FragmentationTest: public TestCase
   uint8_t *m_data;
   uint32_t m_size;
   uint8_t m_icmpType;
+  uint32_t m_memoryDrops;
 
 public:
   virtual void DoRun (void);
@@ -99,6 +100,8 @@ public:
   // server part
   void StartServer (Ptr<Node> ServerNode);
   void HandleReadServer (Ptr<Socket> socket);
+  void HandleDropServer (const Ipv4Header &ipHeader, Ptr<const Packet> packet,
+                         Ipv4L3Protocol::DropReason reason, Ptr<Ipv4> ipv4, uint32_t interface);
 
   // client part
   void StartClient (Ptr<Node> ClientNode);
@@ -118,6 +121,7 @@ Ipv4FragmentationTest::Ipv4FragmentationTest ()
   m_socketServer = 0;
   m_data = 0;
   m_dataSize = 0;
+  m_memoryDrops = 0;
 }
 
 Ipv4FragmentationTest::~Ipv4FragmentationTest ()
@@ -169,6 +173,16 @@ Ipv4FragmentationTest::HandleReadServer (Ptr<Socket> socket)
     }
 }
 
+void
+Ipv4FragmentationTest::HandleDropServer (const Ipv4Header &ipHeader, Ptr<const Packet> packet,
+                                         Ipv4L3Protocol::DropReason reason, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  if (reason == Ipv4L3Protocol::DROP_FRAGMENT_MEMORY)
+    {
+      m_memoryDrops++;
+    }
+}
+
 void
 Ipv4FragmentationTest::StartClient (Ptr<Node> ClientNode)
 {
@@ -398,6 +412,38 @@ Ipv4FragmentationTest::DoRun (void)
       NS_TEST_EXPECT_MSG_EQ ((m_icmpType == 11), true, "Client did not receive ICMP::TIME_EXCEEDED");
     }
 
+  // Fourth test: normal channel, no errors, no delays, small reassembly memory.
+  // The packets bigger than the memory are dropped when their fragments fill it,
+  // the smaller ones are still reassembled.
+  serverDevErrorModel->Disable();
+  m_memoryDrops = 0;
+  Ptr<Ipv4L3Protocol> serverIpv4 = serverNode->GetObject<Ipv4L3Protocol> ();
+  serverIpv4->SetAttribute ("FragmentMemoryLimit", UintegerValue (3000));
+  serverIpv4->TraceConnectWithoutContext ("Drop", MakeCallback (&Ipv4FragmentationTest::HandleDropServer, this));
+  for( int i= 1; i<4; i++)
+    {
+      uint32_t packetSize = packetSizes[i];
+
+      SetFill (fillData, 78, packetSize);
+
+      m_receivedPacketServer = Create<Packet> ();
+      Simulator::ScheduleWithContext (m_socketClient->GetNode ()->GetId (), Seconds (0),
+                                      &Ipv4FragmentationTest::SendClient, this);
+      Simulator::Run ();
+
+      uint16_t recvSize = m_receivedPacketServer->GetSize ();
+
+      if (packetSize <= 3000)
+        {
+          NS_TEST_EXPECT_MSG_EQ (recvSize, packetSize, "Packet size not correct");
+        }
+      else
+        {
+          NS_TEST_EXPECT_MSG_EQ (recvSize, 0, "Server got a packet bigger than the reassembly memory");
+        }
+    }
+  NS_TEST_EXPECT_MSG_GT (m_memoryDrops, 0, "No packet dropped because of the reassembly memory");
+
 
   Simulator::Destroy ();
 }
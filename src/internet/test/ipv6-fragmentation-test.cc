@@ -54,6 +54,8 @@
 
 #include "ns3/ipv6-l3-protocol.h"
 #include "ns3/icmpv6-l4-protocol.h"
+#include "ns3/ipv6-extension-demux.h"
+#include "ns3/ipv6-extension.h"
 
 #include <string>
 #include <limits>
@@ -104,6 +106,7 @@ class Ipv6FragmentationTest : public TestCase
   uint32_t m_size;
   uint8_t m_icmpType;
   uint8_t m_icmpCode;
+  uint32_t m_memoryDrops;
 
 public:
   virtual void DoRun (void);
@@ -113,6 +116,7 @@ public:
   // server part
   void StartServer (Ptr<Node> ServerNode);
   void HandleReadServer (Ptr<Socket> socket);
+  void HandleDropServer (Ptr<const Packet> packet);
 
   // client part
   void StartClient (Ptr<Node> ClientNode);
@@ -132,6 +136,7 @@ Ipv6FragmentationTest::Ipv6FragmentationTest ()
   m_socketServer = 0;
   m_data = 0;
   m_dataSize = 0;
+  m_memoryDrops = 0;
 }
 
 Ipv6FragmentationTest::~Ipv6FragmentationTest ()
@@ -178,6 +183,13 @@ Ipv6FragmentationTest::HandleReadServer (Ptr<Socket> socket)
     }
 }
 
+void
+Ipv6FragmentationTest::HandleDropServer (Ptr<const Packet> packet)
+{
+  // only the reassembly memory drops packets in the fourth test
+  m_memoryDrops++;
+}
+
 void
 Ipv6FragmentationTest::StartClient (Ptr<Node> ClientNode)
 {
@@ -409,6 +421,38 @@ Ipv6FragmentationTest::DoRun (void)
                              true, "Client did not receive ICMPv6::TIME_EXCEEDED " << int(m_icmpType) << int(m_icmpCode) );
     }
 
+  // Fourth test: normal channel, no errors, no delays, small reassembly memory.
+  // The packets bigger than the memory are dropped when their fragments fill it,
+  // the smaller ones are still reassembled.
+  serverDevErrorModel->Disable ();
+  m_memoryDrops = 0;
+  Ptr<Ipv6Extension> fragmentExtension = serverNode->GetObject<Ipv6ExtensionDemux> ()->GetExtension (Ipv6ExtensionFragment::EXT_NUMBER);
+  fragmentExtension->SetAttribute ("FragmentMemoryLimit", UintegerValue (3000));
+  fragmentExtension->TraceConnectWithoutContext ("Drop", MakeCallback (&Ipv6FragmentationTest::HandleDropServer, this));
+  for ( int i = 1; i < 4; i++)
+    {
+      uint32_t packetSize = packetSizes[i];
+
+      SetFill (fillData, 78, packetSize);
+
+      m_receivedPacketServer = Create<Packet> ();
+      Simulator::ScheduleWithContext (m_socketClient->GetNode ()->GetId (), Seconds (0),
+                                      &Ipv6FragmentationTest::SendClient, this);
+      Simulator::Run ();
+
+      uint16_t recvSize = m_receivedPacketServer->GetSize ();
+
+      if (packetSize <= 3000)
+        {
+          NS_TEST_EXPECT_MSG_EQ (recvSize, packetSize, "Packet size not correct");
+        }
+      else
+        {
+          NS_TEST_EXPECT_MSG_EQ (recvSize, 0, "Server got a packet bigger than the reassembly memory");
+        }
+    }
+  NS_TEST_EXPECT_MSG_GT (m_memoryDrops, 0, "No packet dropped because of the reassembly memory");
+
 
   Simulator::Destroy ();
 }
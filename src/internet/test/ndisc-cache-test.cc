@@ -0,0 +1,353 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sstream>
+#include <string>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/boolean.h"
+#include "ns3/packet.h"
+#include "ns3/node.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/mac48-address.h"
+#include "ns3/ipv6-address.h"
+#include "ns3/ipv6-interface-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv6-l3-protocol.h"
+#include "ns3/icmpv6-l4-protocol.h"
+#include "ns3/ndisc-cache.h"
+
+using namespace ns3;
+
+/**
+ * Base class of the NdiscCache tests: builds a cache on the interface
+ * 2001:1::1/64 of a node, and drives the NUD timers of its entries.
+ *
+ * The retransmit and probe timers expire every second, the delay timer
+ * after five seconds.
+ */
+class NdiscCacheTestCase : public TestCase
+{
+public:
+  NdiscCacheTestCase (std::string name);
+
+protected:
+  /**
+   * Create m_cache.
+   */
+  void CreateCache (void);
+  /**
+   * Add an incomplete entry and start its retransmit timer.
+   *
+   * \param address the address of the entry
+   */
+  void StartRetransmit (Ipv6Address address);
+  /**
+   * Add an entry in DELAY state and start its delay timer.
+   *
+   * \param address the address of the entry
+   */
+  void StartDelay (Ipv6Address address);
+  /**
+   * Receive the advertisement of an incomplete entry: stop its
+   * retransmit timer and mark it reachable.
+   *
+   * \param address the address of the entry
+   */
+  void MarkReachable (Ipv6Address address);
+  /**
+   * Remove an entry, whatever its timers.
+   *
+   * \param address the address of the entry
+   */
+  void Remove (Ipv6Address address);
+  /**
+   * Add a stale entry, without timer.
+   *
+   * \param address the address of the entry
+   */
+  void AddStale (Ipv6Address address);
+  /**
+   * Flush the cache.
+   */
+  void Flush (void);
+  /**
+   * Check the state of an entry.
+   *
+   * \param address the address of the entry
+   * \param expected "removed", or the state of the entry followed by
+   * its number of neighbor solicitations, e.g. "probe 2"
+   */
+  void CheckEntry (Ipv6Address address, std::string expected);
+
+  Ptr<NdiscCache> m_cache; //!< the cache under test
+};
+
+NdiscCacheTestCase::NdiscCacheTestCase (std::string name)
+  : TestCase (name)
+{
+}
+
+void
+NdiscCacheTestCase::CreateCache (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+  device->SetAddress (Mac48Address::Allocate ());
+  device->SetChannel (CreateObject<SimpleChannel> ());
+  node->AddDevice (device);
+
+  InternetStackHelper stack;
+  stack.SetIpv4StackInstall (false);
+  stack.Install (node);
+  Ptr<Ipv6L3Protocol> ipv6 = node->GetObject<Ipv6L3Protocol> ();
+  ipv6->GetIcmpv6 ()->SetAttribute ("DAD", BooleanValue (false));
+  uint32_t i = ipv6->AddInterface (device);
+  ipv6->AddAddress (i, Ipv6InterfaceAddress (Ipv6Address ("2001:1::1"), Ipv6Prefix (64)));
+  ipv6->SetUp (i);
+
+  m_cache = CreateObject<NdiscCache> ();
+  m_cache->SetDevice (device, ipv6->GetInterface (i));
+}
+
+void
+NdiscCacheTestCase::StartRetransmit (Ipv6Address address)
+{
+  NdiscCache::Entry *entry = m_cache->Add (address);
+  entry->MarkIncomplete (Create<Packet> (100));
+  entry->StartRetransmitTimer ();
+}
+
+void
+NdiscCacheTestCase::StartDelay (Ipv6Address address)
+{
+  NdiscCache::Entry *entry = m_cache->Add (address);
+  entry->MarkStale (Mac48Address::Allocate ());
+  entry->MarkDelay ();
+  entry->StartDelayTimer ();
+}
+
+void
+NdiscCacheTestCase::MarkReachable (Ipv6Address address)
+{
+  NdiscCache::Entry *entry = m_cache->Lookup (address);
+  entry->StopRetransmitTimer ();
+  entry->MarkReachable (Mac48Address::Allocate ());
+}
+
+void
+NdiscCacheTestCase::Remove (Ipv6Address address)
+{
+  m_cache->Remove (m_cache->Lookup (address));
+}
+
+void
+NdiscCacheTestCase::AddStale (Ipv6Address address)
+{
+  m_cache->Add (address)->MarkStale (Mac48Address::Allocate ());
+}
+
+void
+NdiscCacheTestCase::Flush (void)
+{
+  m_cache->Flush ();
+}
+
+void
+NdiscCacheTestCase::CheckEntry (Ipv6Address address, std::string expected)
+{
+  std::ostringstream actual;
+  NdiscCache::Entry *entry = m_cache->Lookup (address);
+  if (entry == 0)
+    {
+      actual << "removed";
+    }
+  else
+    {
+      if (entry->IsIncomplete ())
+        {
+          actual << "incomplete";
+        }
+      else if (entry->IsReachable ())
+        {
+          actual << "reachable";
+        }
+      else if (entry->IsStale ())
+        {
+          actual << "stale";
+        }
+      else if (entry->IsDelay ())
+        {
+          actual << "delay";
+        }
+      else if (entry->IsProbe ())
+        {
+          actual << "probe";
+        }
+      actual << " " << static_cast<uint32_t> (entry->GetNSRetransmit ());
+    }
+  NS_TEST_EXPECT_MSG_EQ (actual.str (), expected,
+                         "wrong entry " << address << " at " << Simulator::Now ().GetSeconds () << " s");
+}
+
+/**
+ * The timers of several entries expire in the order of their deadlines,
+ * and a stopped timer does not expire.
+ */
+class NdiscCacheTimerOrderTestCase : public NdiscCacheTestCase
+{
+public:
+  NdiscCacheTimerOrderTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NdiscCacheTimerOrderTestCase::NdiscCacheTimerOrderTestCase ()
+  : NdiscCacheTestCase ("NdiscCache timers expire in the order of their deadlines")
+{
+}
+
+void
+NdiscCacheTimerOrderTestCase::DoRun (void)
+{
+  Ipv6Address a ("2001:1::2");
+  Ipv6Address b ("2001:1::3");
+  Ipv6Address c ("2001:1::4");
+  CreateCache ();
+  Simulator::Schedule (Seconds (0), &NdiscCacheTimerOrderTestCase::StartDelay, this, c);
+  Simulator::Schedule (Seconds (0), &NdiscCacheTimerOrderTestCase::StartRetransmit, this, a);
+  Simulator::Schedule (Seconds (0.5), &NdiscCacheTimerOrderTestCase::StartRetransmit, this, b);
+  Simulator::Schedule (Seconds (0.9), &NdiscCacheTimerOrderTestCase::CheckEntry, this, a, std::string ("incomplete 0"));
+  Simulator::Schedule (Seconds (0.9), &NdiscCacheTimerOrderTestCase::CheckEntry, this, b, std::string ("incomplete 0"));
+  Simulator::Schedule (Seconds (1.2), &NdiscCacheTimerOrderTestCase::CheckEntry, this, a, std::string ("incomplete 1"));
+  Simulator::Schedule (Seconds (1.2), &NdiscCacheTimerOrderTestCase::CheckEntry, this, b, std::string ("incomplete 0"));
+  Simulator::Schedule (Seconds (1.7), &NdiscCacheTimerOrderTestCase::CheckEntry, this, a, std::string ("incomplete 1"));
+  Simulator::Schedule (Seconds (1.7), &NdiscCacheTimerOrderTestCase::CheckEntry, this, b, std::string ("incomplete 1"));
+  Simulator::Schedule (Seconds (2.1), &NdiscCacheTimerOrderTestCase::CheckEntry, this, a, std::string ("incomplete 2"));
+  Simulator::Schedule (Seconds (2.1), &NdiscCacheTimerOrderTestCase::CheckEntry, this, b, std::string ("incomplete 1"));
+  // the deadlines of 3 s and 3.5 s stay queued, and must be ignored
+  Simulator::Schedule (Seconds (2.2), &NdiscCacheTimerOrderTestCase::MarkReachable, this, a);
+  Simulator::Schedule (Seconds (2.7), &NdiscCacheTimerOrderTestCase::MarkReachable, this, b);
+  Simulator::Schedule (Seconds (4.9), &NdiscCacheTimerOrderTestCase::CheckEntry, this, a, std::string ("reachable 0"));
+  Simulator::Schedule (Seconds (4.9), &NdiscCacheTimerOrderTestCase::CheckEntry, this, b, std::string ("reachable 0"));
+  Simulator::Schedule (Seconds (4.9), &NdiscCacheTimerOrderTestCase::CheckEntry, this, c, std::string ("delay 0"));
+  // the delay timer expires at 5 s, then the probe timer every second
+  Simulator::Schedule (Seconds (5.1), &NdiscCacheTimerOrderTestCase::CheckEntry, this, c, std::string ("probe 1"));
+  Simulator::Schedule (Seconds (7.1), &NdiscCacheTimerOrderTestCase::CheckEntry, this, c, std::string ("probe 3"));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), Seconds (8), "the last probe timeout did not end the simulation");
+  CheckEntry (c, "removed");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * The deadlines of a removed entry are dropped when they come due, even
+ * if an entry with the same address has been added meanwhile.
+ */
+class NdiscCacheRemoveTestCase : public NdiscCacheTestCase
+{
+public:
+  NdiscCacheRemoveTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NdiscCacheRemoveTestCase::NdiscCacheRemoveTestCase ()
+  : NdiscCacheTestCase ("NdiscCache drops the timers of removed entries")
+{
+}
+
+void
+NdiscCacheRemoveTestCase::DoRun (void)
+{
+  Ipv6Address a ("2001:1::2");
+  Ipv6Address b ("2001:1::3");
+  CreateCache ();
+  Simulator::Schedule (Seconds (0), &NdiscCacheRemoveTestCase::StartRetransmit, this, a);
+  Simulator::Schedule (Seconds (0), &NdiscCacheRemoveTestCase::StartRetransmit, this, b);
+  Simulator::Schedule (Seconds (0.5), &NdiscCacheRemoveTestCase::Remove, this, a);
+  Simulator::Schedule (Seconds (0.5), &NdiscCacheRemoveTestCase::Remove, this, b);
+  Simulator::Schedule (Seconds (0.6), &NdiscCacheRemoveTestCase::AddStale, this, a);
+  Simulator::Schedule (Seconds (1.1), &NdiscCacheRemoveTestCase::CheckEntry, this, a, std::string ("stale 0"));
+  Simulator::Schedule (Seconds (1.1), &NdiscCacheRemoveTestCase::CheckEntry, this, b, std::string ("removed"));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), Seconds (1.1), "a removed entry rearmed its timer");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * Flushing the cache drops the pending timers, and the entries added
+ * after the flush get timers of their own.
+ */
+class NdiscCacheFlushTestCase : public NdiscCacheTestCase
+{
+public:
+  NdiscCacheFlushTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NdiscCacheFlushTestCase::NdiscCacheFlushTestCase ()
+  : NdiscCacheTestCase ("NdiscCache flush stops the pending timers")
+{
+}
+
+void
+NdiscCacheFlushTestCase::DoRun (void)
+{
+  Ipv6Address a ("2001:1::2");
+  Ipv6Address c ("2001:1::4");
+  CreateCache ();
+  Simulator::Schedule (Seconds (0), &NdiscCacheFlushTestCase::StartRetransmit, this, a);
+  Simulator::Schedule (Seconds (0), &NdiscCacheFlushTestCase::StartDelay, this, c);
+  Simulator::Schedule (Seconds (0.5), &NdiscCacheFlushTestCase::Flush, this);
+  Simulator::Schedule (Seconds (0.5), &NdiscCacheFlushTestCase::CheckEntry, this, a, std::string ("removed"));
+  Simulator::Schedule (Seconds (0.5), &NdiscCacheFlushTestCase::CheckEntry, this, c, std::string ("removed"));
+  // the flushed deadlines of 1 s and 5 s must not expire on the new entries
+  Simulator::Schedule (Seconds (0.6), &NdiscCacheFlushTestCase::StartRetransmit, this, a);
+  Simulator::Schedule (Seconds (0.6), &NdiscCacheFlushTestCase::AddStale, this, c);
+  Simulator::Schedule (Seconds (1.5), &NdiscCacheFlushTestCase::CheckEntry, this, a, std::string ("incomplete 0"));
+  Simulator::Schedule (Seconds (1.7), &NdiscCacheFlushTestCase::CheckEntry, this, a, std::string ("incomplete 1"));
+  Simulator::Schedule (Seconds (1.8), &NdiscCacheFlushTestCase::MarkReachable, this, a);
+  Simulator::Run ();
+
+  CheckEntry (a, "reachable 0");
+  CheckEntry (c, "stale 0");
+
+  Simulator::Destroy ();
+}
+
+static class NdiscCacheTestSuite : public TestSuite
+{
+public:
+  NdiscCacheTestSuite ()
+    : TestSuite ("ndisc-cache", UNIT)
+  {
+    AddTestCase (new NdiscCacheTimerOrderTestCase, TestCase::QUICK);
+    AddTestCase (new NdiscCacheRemoveTestCase, TestCase::QUICK);
+    AddTestCase (new NdiscCacheFlushTestCase, TestCase::QUICK);
+  }
+} g_ndiscCacheTestSuite;
@@ -36,6 +36,7 @@
 #include "ns3/inet-socket-address.h"
 #include "ns3/inet6-socket-address.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/log.h"
 
 #include "ns3/ipv4-end-point.h"
@@ -61,7 +62,8 @@ public:
                uint32_t sourceReadSize,
                uint32_t serverWriteSize,
                uint32_t serverReadSize,
-               bool useIpv6);
+               bool useIpv6,
+               bool useOffload);
 private:
   virtual void DoRun (void);
   virtual void DoTeardown (void);
@@ -92,6 +94,7 @@ private:
   uint8_t* m_serverRxPayload;
 
   bool m_useIpv6;
+  bool m_useOffload;
 };
 
 static std::string Name (std::string str, uint32_t totalStreamSize,
@@ -99,12 +102,14 @@ static std::string Name (std::string str, uint32_t totalStreamSize,
                          uint32_t serverReadSize,
                          uint32_t serverWriteSize,
                          uint32_t sourceReadSize,
-                         bool useIpv6)
+                         bool useIpv6,
+                         bool useOffload)
 {
   std::ostringstream oss;
   oss << str << " total=" << totalStreamSize << " sourceWrite=" << sourceWriteSize 
       << " sourceRead=" << sourceReadSize << " serverRead=" << serverReadSize
-      << " serverWrite=" << serverWriteSize << " useIpv6=" << useIpv6;
+      << " serverWrite=" << serverWriteSize << " useIpv6=" << useIpv6
+      << " useOffload=" << useOffload;
   return oss.str ();
 }
 
@@ -122,20 +127,23 @@ TcpTestCase::TcpTestCase (uint32_t totalStreamSize,
                           uint32_t sourceReadSize,
                           uint32_t serverWriteSize,
                           uint32_t serverReadSize,
-                          bool useIpv6)
+                          bool useIpv6,
+                          bool useOffload)
   : TestCase (Name ("Send string data from client to server and back", 
                     totalStreamSize, 
                     sourceWriteSize,
                     serverReadSize,
                     serverWriteSize,
                     sourceReadSize,
-                    useIpv6)),
+                    useIpv6,
+                    useOffload)),
     m_totalBytes (totalStreamSize),
     m_sourceWriteSize (sourceWriteSize),
     m_sourceReadSize (sourceReadSize),
     m_serverWriteSize (serverWriteSize),
     m_serverReadSize (serverReadSize),
-    m_useIpv6 (useIpv6)
+    m_useIpv6 (useIpv6),
+    m_useOffload (useOffload)
 {
 }
 
@@ -332,6 +340,8 @@ TcpTestCase::SetupDefaultSim (void)
 
   Ptr<Socket> server = sockFactory0->CreateSocket ();
   Ptr<Socket> source = sockFactory1->CreateSocket ();
+  server->SetAttribute ("SegmentationOffload", BooleanValue (m_useOffload));
+  source->SetAttribute ("SegmentationOffload", BooleanValue (m_useOffload));
 
   uint16_t port = 50000;
   InetSocketAddress serverlocaladdr (Ipv4Address::GetAny (), port);
@@ -368,6 +378,8 @@ TcpTestCase::SetupDefaultSim6 (void)
 
   Ptr<Socket> server = sockFactory0->CreateSocket ();
   Ptr<Socket> source = sockFactory1->CreateSocket ();
+  server->SetAttribute ("SegmentationOffload", BooleanValue (m_useOffload));
+  source->SetAttribute ("SegmentationOffload", BooleanValue (m_useOffload));
 
   uint16_t port = 50000;
   Inet6SocketAddress serverlocaladdr (Ipv6Address::GetAny (), port);
@@ -435,13 +447,17 @@ public:
     // 2) source write size, 3) source read size
     // 4) server write size, and 5) server read size
     // with units of bytes
-    AddTestCase (new TcpTestCase (13, 200, 200, 200, 200, false), TestCase::QUICK);
-    AddTestCase (new TcpTestCase (13, 1, 1, 1, 1, false), TestCase::QUICK);
-    AddTestCase (new TcpTestCase (100000, 100, 50, 100, 20, false), TestCase::QUICK);
+    AddTestCase (new TcpTestCase (13, 200, 200, 200, 200, false, false), TestCase::QUICK);
+    AddTestCase (new TcpTestCase (13, 1, 1, 1, 1, false, false), TestCase::QUICK);
+    AddTestCase (new TcpTestCase (100000, 100, 50, 100, 20, false, false), TestCase::QUICK);
 
-    AddTestCase (new TcpTestCase (13, 200, 200, 200, 200, true), TestCase::QUICK);
-    AddTestCase (new TcpTestCase (13, 1, 1, 1, 1, true), TestCase::QUICK);
-    AddTestCase (new TcpTestCase (100000, 100, 50, 100, 20, true), TestCase::QUICK);
+    AddTestCase (new TcpTestCase (13, 200, 200, 200, 200, true, false), TestCase::QUICK);
+    AddTestCase (new TcpTestCase (13, 1, 1, 1, 1, true, false), TestCase::QUICK);
+    AddTestCase (new TcpTestCase (100000, 100, 50, 100, 20, true, false), TestCase::QUICK);
+
+    // Super-segments segmented in software for devices without offload
+    AddTestCase (new TcpTestCase (100000, 100, 50, 100, 20, false, true), TestCase::QUICK);
+    AddTestCase (new TcpTestCase (100000, 100, 50, 100, 20, true, true), TestCase::QUICK);
   }
 
 } g_tcpTestSuite;
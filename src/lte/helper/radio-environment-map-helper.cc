@@ -36,14 +36,33 @@
 #include <ns3/node.h>
 #include <ns3/buildings-helper.h>
 #include <ns3/lte-spectrum-value-helper.h>
+#include <ns3/lte-enb-net-device.h>
+#include <ns3/lte-enb-phy.h>
+#include <ns3/lte-spectrum-phy.h>
+#include <ns3/node-list.h>
+#include <ns3/antenna-model.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/spectrum-propagation-loss-model.h>
+#include <ns3/spectrum-converter.h>
 
 #include <fstream>
 #include <limits>
+#include <cmath>
 
 NS_LOG_COMPONENT_DEFINE ("RadioEnvironmentMapHelper");
 
 namespace ns3 {
 
+/**
+ * An eNB whose control frames are received by the map
+ */
+struct RemTransmitter
+{
+  Ptr<MobilityModel> mobility;   ///< the position of the eNB
+  Ptr<AntennaModel> antenna;     ///< the antenna of the eNB, if any
+  Ptr<SpectrumValue> psd;        ///< the PSD of the control frames, in the spectrum model of the map
+  double power;                  ///< the integral of psd (W)
+};
 
 
 NS_OBJECT_ENSURE_REGISTERED (RadioEnvironmentMapHelper)
@@ -134,6 +153,13 @@ RadioEnvironmentMapHelper::GetTypeId (void)
                    MakeUintegerAccessor (&RadioEnvironmentMapHelper::SetBandwidth, 
                                          &RadioEnvironmentMapHelper::GetBandwidth),
                    MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("Direct",
+                   "If true, Install computes the map from the configuration of the eNBs and the "
+                   "propagation loss models of the channel, instead of simulating the reception "
+                   "of the control frames of the eNBs",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RadioEnvironmentMapHelper::m_direct),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -189,6 +215,18 @@ RadioEnvironmentMapHelper::Install ()
       NS_FATAL_ERROR ("Can't open file " << (m_outputFile));
       return;
     }
+
+  if (m_direct)
+    {
+      ComputeDirectly ();
+      m_outFile.close ();
+      if (m_stopWhenDone)
+        {
+          // the simulation is not running yet
+          Simulator::Stop (Seconds (0));
+        }
+      return;
+    }
   
   Simulator::Schedule (Seconds (0.0026), 
                        &RadioEnvironmentMapHelper::DelayedInstall,
@@ -319,6 +357,195 @@ RadioEnvironmentMapHelper::PrintAndReset ()
     }
 }
 
+void
+RadioEnvironmentMapHelper::ComputeDirectly ()
+{
+  NS_LOG_FUNCTION (this);
+  m_xStep = (m_xMax - m_xMin)/(m_xRes-1);
+  m_yStep = (m_yMax - m_yMin)/(m_yRes-1);
+
+  // the coordinates of the points, as in DelayedInstall
+  std::vector<double> xs;
+  std::vector<double> ys;
+  for (double x = m_xMin; x < m_xMax + 0.5*m_xStep; x += m_xStep)
+    {
+      xs.push_back (x);
+    }
+  for (double y = m_yMin; y < m_yMax + 0.5*m_yStep; y += m_yStep)
+    {
+      ys.push_back (y);
+    }
+  uint32_t nPoints = xs.size () * ys.size ();
+
+  Ptr<const SpectrumModel> rxSpectrumModel = LteSpectrumValueHelper::GetSpectrumModel (m_earfcn, m_bandwidth);
+  Ptr<PropagationLossModel> propagationLoss = m_channel->GetPropagationLossModel ();
+  Ptr<SpectrumPropagationLossModel> spectrumPropagationLoss = m_channel->GetSpectrumPropagationLossModel ();
+  DoubleValue maxLossDb (std::numeric_limits<double>::max ());
+  m_channel->GetAttributeFailSafe ("MaxLossDb", maxLossDb);
+
+  // the eNBs transmitting on the channel; their control frames use the
+  // whole downlink bandwidth
+  std::vector<RemTransmitter> transmitters;
+  for (NodeList::Iterator node = NodeList::Begin (); node != NodeList::End (); ++node)
+    {
+      for (uint32_t i = 0; i < (*node)->GetNDevices (); ++i)
+        {
+          Ptr<LteEnbNetDevice> enbDevice = DynamicCast<LteEnbNetDevice> ((*node)->GetDevice (i));
+          if (enbDevice == 0)
+            {
+              continue;
+            }
+          Ptr<LteSpectrumPhy> phy = enbDevice->GetPhy ()->GetDownlinkSpectrumPhy ();
+          if (phy->GetChannel () != m_channel || phy->GetMobility () == 0)
+            {
+              continue;
+            }
+          std::vector<int> dlRb;
+          for (uint8_t rb = 0; rb < enbDevice->GetDlBandwidth (); rb++)
+            {
+              dlRb.push_back (rb);
+            }
+          RemTransmitter transmitter;
+          transmitter.mobility = phy->GetMobility ();
+          transmitter.antenna = phy->GetRxAntenna ();
+          transmitter.psd = LteSpectrumValueHelper::CreateTxPowerSpectralDensity (enbDevice->GetDlEarfcn (),
+                                                                                  enbDevice->GetDlBandwidth (),
+                                                                                  enbDevice->GetPhy ()->GetTxPower (),
+                                                                                  dlRb);
+          if (transmitter.psd->GetSpectrumModelUid () != rxSpectrumModel->GetUid ())
+            {
+              SpectrumConverter converter (transmitter.psd->GetSpectrumModel (), rxSpectrumModel);
+              transmitter.psd = converter.Convert (transmitter.psd);
+            }
+          transmitter.power = Integral (*transmitter.psd);
+          transmitters.push_back (transmitter);
+        }
+    }
+  NS_LOG_LOGIC (transmitters.size () << " eNBs, " << nPoints << " points");
+
+  // the points are computed in batches of MaxPointsPerIteration, to
+  // bound the memory used
+  uint32_t batchSize = std::min (m_maxPointsPerIteration, nPoints);
+  std::vector<Ptr<MobilityModel> > mobilities;
+  for (uint32_t i = 0; i < batchSize; ++i)
+    {
+      Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      Ptr<MobilityBuildingInfo> buildingInfo = CreateObject<MobilityBuildingInfo> ();
+      mobility->AggregateObject (buildingInfo); // operation usually done by BuildingsHelper::Install
+      mobilities.push_back (mobility);
+    }
+
+  std::vector<double> txPowers;
+  for (uint32_t t = 0; t < transmitters.size (); ++t)
+    {
+      txPowers.push_back (transmitters[t].power);
+    }
+  std::vector<Vector> points;
+  std::vector<std::vector<double> > lossesDb (transmitters.size ());
+  std::vector<std::vector<double> > rxPowers;
+  if (spectrumPropagationLoss)
+    {
+      rxPowers.resize (transmitters.size ());
+    }
+  std::vector<double> gainsDb;
+  std::vector<Vector> directions;
+  std::vector<double> antennaGainsDb;
+  for (uint32_t first = 0; first < nPoints; first += batchSize)
+    {
+      uint32_t n = std::min (batchSize, nPoints - first);
+      mobilities.resize (n);
+      points.resize (n);
+      directions.resize (n);
+      for (uint32_t p = 0; p < n; ++p)
+        {
+          points[p] = Vector (xs[(first + p) / ys.size ()], ys[(first + p) % ys.size ()], m_z);
+          mobilities[p]->SetPosition (points[p]);
+          BuildingsHelper::MakeConsistent (mobilities[p]);
+        }
+
+      // the losses are computed as by the channel
+      for (uint32_t t = 0; t < transmitters.size (); ++t)
+        {
+          const RemTransmitter &transmitter = transmitters[t];
+          Vector txPosition = transmitter.mobility->GetPosition ();
+          gainsDb.assign (n, 0.0);
+          if (propagationLoss)
+            {
+              propagationLoss->CalcRxPowers (0, transmitter.mobility, mobilities, gainsDb);
+            }
+          if (transmitter.antenna != 0)
+            {
+              for (uint32_t p = 0; p < n; ++p)
+                {
+                  directions[p] = Vector (points[p].x - txPosition.x,
+                                          points[p].y - txPosition.y,
+                                          points[p].z - txPosition.z);
+                }
+              transmitter.antenna->GetGainsDbInDirections (directions, antennaGainsDb);
+            }
+          lossesDb[t].resize (n);
+          for (uint32_t p = 0; p < n; ++p)
+            {
+              lossesDb[t][p] = -gainsDb[p];
+              if (transmitter.antenna != 0)
+                {
+                  lossesDb[t][p] -= antennaGainsDb[p];
+                }
+            }
+          if (spectrumPropagationLoss)
+            {
+              rxPowers[t].resize (n);
+              for (uint32_t p = 0; p < n; ++p)
+                {
+                  if (lossesDb[t][p] > maxLossDb.Get ())
+                    {
+                      rxPowers[t][p] = 0;
+                      continue;
+                    }
+                  Ptr<SpectrumValue> psd = Copy<SpectrumValue> (transmitter.psd);
+                  *psd *= std::pow (10.0, -lossesDb[t][p] / 10.0);
+                  spectrumPropagationLoss->CalcRxPowerSpectralDensityInPlace (psd, transmitter.mobility, mobilities[p]);
+                  rxPowers[t][p] = Integral (*psd);
+                }
+            }
+        }
+
+      for (uint32_t p = 0; p < n; ++p)
+        {
+          // as in RemSpectrumPhy::GetSinr
+          double referenceSignalPower = 0;
+          double sumPower = 0;
+          for (uint32_t t = 0; t < transmitters.size (); ++t)
+            {
+              double power;
+              if (spectrumPropagationLoss)
+                {
+                  power = rxPowers[t][p];
+                }
+              else if (lossesDb[t][p] > maxLossDb.Get ())
+                {
+                  // as in MultiModelSpectrumChannel::StartTx
+                  power = 0;
+                }
+              else
+                {
+                  power = txPowers[t] * std::pow (10.0, -lossesDb[t][p] / 10.0);
+                }
+              sumPower += power;
+              if (power > referenceSignalPower)
+                {
+                  referenceSignalPower = power;
+                }
+            }
+          m_outFile << points[p].x << "\t"
+                    << points[p].y << "\t"
+                    << points[p].z << "\t"
+                    << referenceSignalPower / (sumPower - referenceSignalPower + m_noisePower)
+                    << "\n";
+        }
+    }
+}
+
 void 
 RadioEnvironmentMapHelper::Finalize ()
 {
@@ -39,6 +39,15 @@ class MobilityModel;
 /** 
  * Generates a 2D map of the SINR from the strongest transmitter in the downlink of an LTE FDD system.
  * 
+ * By default, the map is measured by RemSpectrumPhy instances attached
+ * to the channel, which receive the control frames of the eNBs during
+ * the simulation, MaxPointsPerIteration points at a time. If the Direct
+ * attribute is true, Install instead computes the map at once from the
+ * transmission power, position and antenna of the eNBs attached to the
+ * channel, and from the propagation loss models of the channel, without
+ * simulating any transmission. This computation is serial: the
+ * propagation loss and antenna models are not thread safe, and they
+ * take most of its time.
  */
 class RadioEnvironmentMapHelper : public Object
 {
@@ -74,6 +83,11 @@ private:
   void RunOneIteration (double xMin, double xMax, double yMin, double yMax);
   void PrintAndReset ();
   void Finalize ();
+  /**
+   * Compute the whole map from the configuration of the eNBs, and write
+   * it to the output file.
+   */
+  void ComputeDirectly ();
 
 
   struct RemPoint 
@@ -105,6 +119,8 @@ private:
   std::string m_outputFile;
 
   bool m_stopWhenDone;
+
+  bool m_direct; ///< whether the map is computed by ComputeDirectly
   
   Ptr<SpectrumChannel> m_channel;
 
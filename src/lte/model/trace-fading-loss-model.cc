@@ -153,7 +153,18 @@ TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
   Ptr<const MobilityModel> a,
   Ptr<const MobilityModel> b) const
 {
-  NS_LOG_FUNCTION (this << *txPsd << a << b);
+  Ptr<SpectrumValue> rxPsd = Copy<SpectrumValue> (txPsd);
+  DoCalcRxPowerSpectralDensityInPlace (rxPsd, a, b);
+  return rxPsd;
+}
+
+void
+TraceFadingLossModel::DoCalcRxPowerSpectralDensityInPlace (
+  Ptr<SpectrumValue> psd,
+  Ptr<const MobilityModel> a,
+  Ptr<const MobilityModel> b) const
+{
+  NS_LOG_FUNCTION (this << *psd << a << b);
   
   std::map <ChannelRealizationId_t, int >::iterator itOff;
   ChannelRealizationId_t mobilityPair = std::make_pair (a,b);
@@ -192,21 +203,20 @@ TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
     }
 
   
-  Ptr<SpectrumValue> rxPsd = Copy<SpectrumValue> (txPsd);
-  Values::iterator vit = rxPsd->ValuesBegin ();
+  Values::iterator vit = psd->ValuesBegin ();
   
   //Vector aSpeedVector = a->GetVelocity ();
   //Vector bSpeedVector = b->GetVelocity ();
   
   //double speed = std::sqrt (std::pow (aSpeedVector.x-bSpeedVector.x,2) + std::pow (aSpeedVector.y-bSpeedVector.y,2));
 
-  NS_LOG_LOGIC (this << *rxPsd);
+  NS_LOG_LOGIC (this << *psd);
   NS_ASSERT (!m_fadingTrace.empty ());
   int now_ms = static_cast<int> (Simulator::Now ().GetMilliSeconds () * m_timeGranularity);
   int lastUpdate_ms = static_cast<int> (m_lastWindowUpdate.GetMilliSeconds () * m_timeGranularity);
   int index = ((*itOff).second + now_ms - lastUpdate_ms) % m_samplesNum;
   int subChannel = 0;
-  while (vit != rxPsd->ValuesEnd ())
+  while (vit != psd->ValuesEnd ())
     {
       NS_ASSERT (subChannel < 100);
       if (*vit != 0.)
@@ -229,8 +239,7 @@ TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
 
     }
 
-  NS_LOG_LOGIC (this << *rxPsd);
-  return rxPsd;
+  NS_LOG_LOGIC (this << *psd);
 }
 
 int64_t
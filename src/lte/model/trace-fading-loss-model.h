@@ -79,6 +79,17 @@ private:
   Ptr<SpectrumValue> DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
                                                    Ptr<const MobilityModel> a,
                                                    Ptr<const MobilityModel> b) const;
+  /**
+   * Apply the fading to psd, without allocating a new SpectrumValue.
+   *
+   * \param psd set of values vs frequency representing the
+   *            transmission power, replaced by the received power
+   * \param a sender mobility
+   * \param b receiver mobility
+   */
+  virtual void DoCalcRxPowerSpectralDensityInPlace (Ptr<SpectrumValue> psd,
+                                                    Ptr<const MobilityModel> a,
+                                                    Ptr<const MobilityModel> b) const;
                                                    
   /**
   * \brief Get the value for a particular sub channel and a given speed
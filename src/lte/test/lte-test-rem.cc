@@ -0,0 +1,169 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include <fstream>
+#include <sstream>
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/buildings-helper.h"
+#include "ns3/lte-helper.h"
+#include "ns3/lte-enb-net-device.h"
+#include "ns3/lte-enb-phy.h"
+#include "ns3/lte-spectrum-phy.h"
+#include "ns3/spectrum-channel.h"
+#include "ns3/radio-environment-map-helper.h"
+
+NS_LOG_COMPONENT_DEFINE ("LteTestRem");
+
+using namespace ns3;
+
+/**
+ * Check that the map computed directly by RadioEnvironmentMapHelper is
+ * the same as the map obtained by simulating the reception of the
+ * control frames of the eNBs.
+ */
+class LteRemDirectTestCase : public TestCase
+{
+public:
+  LteRemDirectTestCase (uint32_t maxPointsPerIteration);
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Create the scenario and compute its map.
+   *
+   * \param direct the Direct attribute of the map
+   * \param fileName the file of the map
+   */
+  void ComputeMap (bool direct, std::string fileName);
+
+  uint32_t m_maxPointsPerIteration;
+};
+
+static std::string
+BuildNameString (uint32_t maxPointsPerIteration)
+{
+  std::ostringstream oss;
+  oss << "maxPointsPerIteration=" << maxPointsPerIteration;
+  return oss.str ();
+}
+
+LteRemDirectTestCase::LteRemDirectTestCase (uint32_t maxPointsPerIteration)
+  : TestCase (BuildNameString (maxPointsPerIteration)),
+    m_maxPointsPerIteration (maxPointsPerIteration)
+{
+}
+
+void
+LteRemDirectTestCase::ComputeMap (bool direct, std::string fileName)
+{
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::FriisPropagationLossModel"));
+
+  NodeContainer enbNodes;
+  enbNodes.Create (3);
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  positions->Add (Vector (0.0, 0.0, 10.0));
+  positions->Add (Vector (400.0, 50.0, 10.0));
+  positions->Add (Vector (150.0, 300.0, 10.0));
+  mobility.SetPositionAllocator (positions);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (enbNodes);
+  BuildingsHelper::Install (enbNodes);
+
+  NetDeviceContainer enbDevices = lteHelper->InstallEnbDevice (NodeContainer (enbNodes.Get (0), enbNodes.Get (1)));
+  lteHelper->SetEnbAntennaModelType ("ns3::CosineAntennaModel");
+  lteHelper->SetEnbAntennaModelAttribute ("Orientation", DoubleValue (-90));
+  lteHelper->SetEnbAntennaModelAttribute ("Beamwidth", DoubleValue (60));
+  lteHelper->SetEnbAntennaModelAttribute ("MaxGain", DoubleValue (5.0));
+  enbDevices.Add (lteHelper->InstallEnbDevice (enbNodes.Get (2)));
+  enbDevices.Get (1)->GetObject<LteEnbNetDevice> ()->GetPhy ()->SetTxPower (20.0);
+
+  Ptr<SpectrumChannel> channel = enbDevices.Get (0)->GetObject<LteEnbNetDevice> ()->GetPhy ()->GetDownlinkSpectrumPhy ()->GetChannel ();
+  std::ostringstream channelPath;
+  channelPath << "/ChannelList/" << channel->GetId ();
+
+  Ptr<RadioEnvironmentMapHelper> remHelper = CreateObject<RadioEnvironmentMapHelper> ();
+  remHelper->SetAttribute ("ChannelPath", StringValue (channelPath.str ()));
+  remHelper->SetAttribute ("OutputFile", StringValue (fileName));
+  remHelper->SetAttribute ("XMin", DoubleValue (-100.0));
+  remHelper->SetAttribute ("XMax", DoubleValue (500.0));
+  remHelper->SetAttribute ("XRes", UintegerValue (13));
+  remHelper->SetAttribute ("YMin", DoubleValue (-100.0));
+  remHelper->SetAttribute ("YMax", DoubleValue (400.0));
+  remHelper->SetAttribute ("YRes", UintegerValue (11));
+  remHelper->SetAttribute ("Z", DoubleValue (1.5));
+  remHelper->SetAttribute ("MaxPointsPerIteration", UintegerValue (m_maxPointsPerIteration));
+  remHelper->SetAttribute ("Direct", BooleanValue (direct));
+  remHelper->Install ();
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+LteRemDirectTestCase::DoRun (void)
+{
+  std::string simulated = CreateTempDirFilename ("rem-simulated.out");
+  std::string direct = CreateTempDirFilename ("rem-direct.out");
+  ComputeMap (false, simulated);
+  ComputeMap (true, direct);
+
+  std::ifstream simulatedFile (simulated.c_str ());
+  std::ifstream directFile (direct.c_str ());
+  NS_TEST_ASSERT_MSG_EQ (simulatedFile.is_open (), true, "cannot open " << simulated);
+  NS_TEST_ASSERT_MSG_EQ (directFile.is_open (), true, "cannot open " << direct);
+  uint32_t nPoints = 0;
+  double x1, y1, z1, sinr1, x2, y2, z2, sinr2;
+  while (simulatedFile >> x1 >> y1 >> z1 >> sinr1)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((bool) (directFile >> x2 >> y2 >> z2 >> sinr2), true, "missing point " << nPoints);
+      NS_TEST_ASSERT_MSG_EQ (x2, x1, "wrong x of point " << nPoints);
+      NS_TEST_ASSERT_MSG_EQ (y2, y1, "wrong y of point " << nPoints);
+      NS_TEST_ASSERT_MSG_EQ (z2, z1, "wrong z of point " << nPoints);
+      // the maps are written with 6 significant digits
+      NS_TEST_ASSERT_MSG_EQ_TOL (sinr2, sinr1, sinr1 * 1e-5, "wrong SINR of point " << nPoints);
+      nPoints++;
+    }
+  NS_TEST_ASSERT_MSG_EQ (nPoints, 13 * 11, "wrong number of points");
+  NS_TEST_ASSERT_MSG_EQ ((bool) (directFile >> x2), false, "too many points");
+}
+
+
+class LteRemTestSuite : public TestSuite
+{
+public:
+  LteRemTestSuite ();
+};
+
+LteRemTestSuite::LteRemTestSuite ()
+  : TestSuite ("lte-rem", SYSTEM)
+{
+  AddTestCase (new LteRemDirectTestCase (20000), TestCase::QUICK);
+  AddTestCase (new LteRemDirectTestCase (50), TestCase::QUICK);
+}
+
+static LteRemTestSuite g_lteRemTestSuite;
@@ -41,6 +41,8 @@
 #include <fstream>
 #include <sstream>
 #include <map>
+#include <set>
+#include <cmath>
 #include "ns3/log.h"
 #include "ns3/unused.h"
 #include "ns3/simulator.h"
@@ -136,24 +138,101 @@ static bool IsSchedSetPos (ParseResult pr);
 // Check if this corresponds to a line like this: $ns_ at 1 "$node_(0) set X_ 2"
 static bool IsSchedMobilityPos (ParseResult pr);
 
-// Set waypoints and speed for movement.
+// Set waypoints and speed for movement. The events are scheduled at time
+// at of the trace, elapsed being the trace time of now.
 static DestinationPoint SetMovement (Ptr<ConstantVelocityMobilityModel> model, Vector lastPos, double at,
-                                     double xFinalPosition, double yFinalPosition, double speed);
+                                     double xFinalPosition, double yFinalPosition, double speed, Time elapsed);
 
 // Set initial position for a node
 static Vector SetInitialPosition (Ptr<ConstantVelocityMobilityModel> model, std::string coord, double coordVal);
 
+// Parse a line which is not an initial position, and check that it has a
+// node id and a valid time. Return false if the line must be ignored.
+static bool ParseSchedLine (const std::string& line, ParseResult& pr, int& iNodeId, std::string& nodeId, double& at);
+
+// Schedule a setdest for a node, stopping its current movement if needed
+static void ScheduleSetdest (Ptr<ConstantVelocityMobilityModel> model, DestinationPoint& last, double at,
+                             double xFinalPosition, double yFinalPosition, double speed, Time elapsed);
+
 // Schedule a set of position for a node
-static Vector SetSchedPosition (Ptr<ConstantVelocityMobilityModel> model, double at, std::string coord, double coordVal);
+static void ScheduleSetPosition (Ptr<ConstantVelocityMobilityModel> model, DestinationPoint& last, double at,
+                                 Vector position, Time elapsed);
+
+
+/**
+ * \brief Index of a trace for streaming: the initial positions, the nodes
+ * of the trace and the offset of the first line of each time window.
+ */
+struct Ns2TraceIndex
+{
+  /// An initial position statement: $node_(id) set coord value
+  struct InitialCoord
+  {
+    int32_t id;
+    char coord;  // 'X', 'Y' or 'Z'
+    double value;
+  };
+  uint64_t traceSize;                 // size of the trace, to detect changes
+  double window;                      // duration of the windows (s)
+  std::vector<InitialCoord> initial;  // initial positions, in the order of the trace
+  std::vector<int32_t> nodes;         // ids of the nodes of the trace
+  std::vector<uint64_t> offsets;      // offsets of the windows, and of the end of the last one
+
+  // Build the index, return false if the statements are not ordered by window
+  bool Build (std::string filename);
+  // Load the index from a file, return false if it does not match the trace
+  bool Load (std::string filename, uint64_t size, double window);
+  void Save (std::string filename) const;
+};
+
+/**
+ * \brief Reads the scheduled statements of a trace one window at a time,
+ * at the start of each window.
+ */
+class Ns2TraceStream : public SimpleRefCount<Ns2TraceStream>
+{
+public:
+  Ns2TraceStream (std::string filename, const Ns2TraceIndex& index,
+                  const std::map<int, Ptr<ConstantVelocityMobilityModel> >& models,
+                  const std::map<int, DestinationPoint>& lastPos,
+                  const std::map<int, Vector>& positions);
+  // Schedule the statements of window k, and the reading of the next one
+  void ReadWindow (uint32_t k);
+
+private:
+  std::ifstream m_file;
+  std::vector<uint64_t> m_offsets;
+  double m_window;
+  Time m_start;                                                  // simulation time of the trace start
+  std::map<int, Ptr<ConstantVelocityMobilityModel> > m_models;
+  std::map<int, DestinationPoint> m_lastPos;                     // last movement of each node
+  std::map<int, Vector> m_positions;                             // position set by the last set statement
+};
+
+// Window of a scheduled time
+static uint32_t GetWindow (double at, double window);
 
 
 Ns2MobilityHelper::Ns2MobilityHelper (std::string filename)
-  : m_filename (filename)
+  : m_filename (filename),
+    m_window (Seconds (0))
 {
   std::ifstream file (m_filename.c_str (), std::ios::in);
   if (!(file.is_open ())) NS_FATAL_ERROR("Could not open trace file " << m_filename.c_str() << " for reading, aborting here \n"); 
 }
 
+void
+Ns2MobilityHelper::SetStreamingWindow (Time window)
+{
+  m_window = window;
+}
+
+void
+Ns2MobilityHelper::SetIndexFile (std::string filename)
+{
+  m_indexFile = filename;
+}
+
 Ptr<ConstantVelocityMobilityModel>
 Ns2MobilityHelper::GetMobilityModel (std::string idString, const ObjectStore &store) const
 {
@@ -179,6 +258,11 @@ Ns2MobilityHelper::GetMobilityModel (std::string idString, const ObjectStore &st
 void
 Ns2MobilityHelper::ConfigNodesMovements (const ObjectStore &store) const
 {
+  if (m_window.IsStrictlyPositive () && ConfigNodesMovementsStreaming (store))
+    {
+      return;
+    }
+
   std::map<int, DestinationPoint> last_pos;    // Stores previous movement scheduled for each node
 
   //*****************************************************************
@@ -270,30 +354,13 @@ Ns2MobilityHelper::ConfigNodesMovements (const ObjectStore &store) const
 
           getline (file, line);
 
-          // ignore empty lines
-          if (line.empty ())
+          double at;
+          ParseResult pr;
+          if (!ParseSchedLine (line, pr, iNodeId, nodeId, at))
             {
               continue;
             }
 
-          ParseResult pr = ParseNs2Line (line); // Parse line and obtain tokens
-
-          // Check if the line corresponds with one of the three types of line
-          if (pr.tokens.size () != 4 && pr.tokens.size () != 7 && pr.tokens.size () != 8)
-            {
-              NS_LOG_ERROR ("Line has not correct number of parameters (corrupted file?): " << line << "\n");
-              continue;
-            }
-
-          // Get the node Id
-          nodeId  = GetNodeIdString (pr);
-          iNodeId = GetNodeIdInt (pr);
-          if (iNodeId == -1)
-            {
-              NS_LOG_ERROR ("Node number couldn't be obtained (corrupted file?): " << line << "\n");
-              continue;
-            }
-
           // get mobility model of node
           Ptr<ConstantVelocityMobilityModel> model = GetMobilityModel (nodeId,store);
 
@@ -304,90 +371,36 @@ Ns2MobilityHelper::ConfigNodesMovements (const ObjectStore &store) const
               continue;
             }
 
-
           /*
-           * In this case a initial position is being seted
-           * line like $node_(0) set X_ 151.05190721688197
+           * In this case a new waypoint is added
+           * line like $ns_ at 1 "$node_(0) setdest 2 3 4"
            */
-          if (IsSetInitialPos (pr))
+          if (IsSchedMobilityPos (pr))
             {
-              // This is the second time this file has been parsed,
-              // and the initial node positions were already set the
-              // first time.  So, do nothing this time with this line.
-              continue;
+              //                                      time  X coord     Y coord      velocity
+              ScheduleSetdest (model, last_pos[iNodeId], at, pr.dvals[5], pr.dvals[6], pr.dvals[7], Seconds (0));
+
+              // Log new position
+              NS_LOG_DEBUG ("Positions after parse for node " << iNodeId << " " << nodeId << " position =" << last_pos[iNodeId].m_finalPosition);
             }
 
-          else // NOW EVENTS TO BE SCHEDULED
-            {
 
-              // This is a scheduled event, so time at should be present
-              double at;
-
-              if (!IsNumber (pr.tokens[2]))
-                {
-                  NS_LOG_WARN ("Time is not a number: " << pr.tokens[2]);
-                  continue;
-                }
-
-              at = pr.dvals[2]; // set time at
-
-              if ( at < 0 )
-                {
-                  NS_LOG_WARN ("Time is less than cero: " << at);
-                  continue;
-                }
-
-
-
-              /*
-               * In this case a new waypoint is added
-               * line like $ns_ at 1 "$node_(0) setdest 2 3 4"
-               */
-              if (IsSchedMobilityPos (pr))
-                {
-                  if (last_pos[iNodeId].m_targetArrivalTime > at)
-                    {
-                      NS_LOG_LOGIC ("Did not reach a destination! stoptime = " << last_pos[iNodeId].m_targetArrivalTime << ", at = "<<  at);
-                      double actuallytraveled = at - last_pos[iNodeId].m_travelStartTime;
-                      Vector reached = Vector (
-                          last_pos[iNodeId].m_startPosition.x + last_pos[iNodeId].m_speed.x * actuallytraveled,
-                          last_pos[iNodeId].m_startPosition.y + last_pos[iNodeId].m_speed.y * actuallytraveled,
-                          0
-                          );
-                      NS_LOG_LOGIC ("Final point = " << last_pos[iNodeId].m_finalPosition << ", actually reached = " << reached);
-                      last_pos[iNodeId].m_stopEvent.Cancel ();
-                      last_pos[iNodeId].m_finalPosition = reached;
-                    }
-                  //                                     last position     time  X coord     Y coord      velocity
-                  last_pos[iNodeId] = SetMovement (model, last_pos[iNodeId].m_finalPosition, at, pr.dvals[5], pr.dvals[6], pr.dvals[7]);
-
-                  // Log new position
-                  NS_LOG_DEBUG ("Positions after parse for node " << iNodeId << " " << nodeId << " position =" << last_pos[iNodeId].m_finalPosition);
-                }
-
-
-              /*
-               * Scheduled set position
-               * line like $ns_ at 4.634906291962 "$node_(0) set X_ 28.675920486450"
-               */
-              else if (IsSchedSetPos (pr))
-                {
-                  //                                         time  coordinate   coord value
-                  last_pos[iNodeId].m_finalPosition = SetSchedPosition (model, at, pr.tokens[5], pr.dvals[6]);
-                  if (last_pos[iNodeId].m_targetArrivalTime > at)
-                    {
-                      last_pos[iNodeId].m_stopEvent.Cancel ();
-                    }
-                  last_pos[iNodeId].m_targetArrivalTime = at;
-                  last_pos[iNodeId].m_travelStartTime = at;
-                  // Log new position
-                  NS_LOG_DEBUG ("Positions after parse for node " << iNodeId << " " << nodeId <<
-                                " position =" << last_pos[iNodeId].m_finalPosition);
-                }
-              else
-                {
-                  NS_LOG_WARN ("Format Line is not correct: " << line << "\n");
-                }
+          /*
+           * Scheduled set position
+           * line like $ns_ at 4.634906291962 "$node_(0) set X_ 28.675920486450"
+           */
+          else if (IsSchedSetPos (pr))
+            {
+              // update position
+              model->SetPosition (SetOneInitialCoord (model->GetPosition (), pr.tokens[5], pr.dvals[6]));
+              ScheduleSetPosition (model, last_pos[iNodeId], at, model->GetPosition (), Seconds (0));
+              // Log new position
+              NS_LOG_DEBUG ("Positions after parse for node " << iNodeId << " " << nodeId <<
+                            " position =" << last_pos[iNodeId].m_finalPosition);
+            }
+          else
+            {
+              NS_LOG_WARN ("Format Line is not correct: " << line << "\n");
             }
         }
       file.close ();
@@ -696,7 +709,7 @@ IsSchedMobilityPos (ParseResult pr)
 
 DestinationPoint
 SetMovement (Ptr<ConstantVelocityMobilityModel> model, Vector last_pos, double at,
-             double xFinalPosition, double yFinalPosition, double speed)
+             double xFinalPosition, double yFinalPosition, double speed, Time elapsed)
 {
   DestinationPoint retval;
   retval.m_startPosition = last_pos;
@@ -707,7 +720,7 @@ SetMovement (Ptr<ConstantVelocityMobilityModel> model, Vector last_pos, double a
   if (speed == 0)
     {
       // We have to maintain last position, and stop the movement
-      retval.m_stopEvent = Simulator::Schedule (Seconds (at), &ConstantVelocityMobilityModel::SetVelocity, model,
+      retval.m_stopEvent = Simulator::Schedule (Seconds (at) - elapsed, &ConstantVelocityMobilityModel::SetVelocity, model,
                                                 Vector (0, 0, 0));
       return retval;
     }
@@ -731,8 +744,8 @@ SetMovement (Ptr<ConstantVelocityMobilityModel> model, Vector last_pos, double a
       NS_LOG_DEBUG ("Calculated Speed: X=" << xSpeed << " Y=" << ySpeed << " Z=" << zSpeed);
 
       // Set the Values
-      Simulator::Schedule (Seconds (at), &ConstantVelocityMobilityModel::SetVelocity, model, Vector (xSpeed, ySpeed, zSpeed));
-      retval.m_stopEvent = Simulator::Schedule (Seconds (at + time), &ConstantVelocityMobilityModel::SetVelocity, model, Vector (0, 0, 0));
+      Simulator::Schedule (Seconds (at) - elapsed, &ConstantVelocityMobilityModel::SetVelocity, model, Vector (xSpeed, ySpeed, zSpeed));
+      retval.m_stopEvent = Simulator::Schedule (Seconds (at + time) - elapsed, &ConstantVelocityMobilityModel::SetVelocity, model, Vector (0, 0, 0));
       retval.m_finalPosition.x += xSpeed * time;
       retval.m_finalPosition.y += ySpeed * time;
       retval.m_targetArrivalTime += time;
@@ -754,22 +767,382 @@ SetInitialPosition (Ptr<ConstantVelocityMobilityModel> model, std::string coord,
   return position;
 }
 
-// Schedule a set of position for a node
-Vector
-SetSchedPosition (Ptr<ConstantVelocityMobilityModel> model, double at, std::string coord, double coordVal)
+bool
+ParseSchedLine (const std::string& line, ParseResult& pr, int& iNodeId, std::string& nodeId, double& at)
 {
-  // update position
-  model->SetPosition (SetOneInitialCoord (model->GetPosition (), coord, coordVal));
+  // ignore empty lines
+  if (line.empty ())
+    {
+      return false;
+    }
 
-  Vector position;
-  position.x = model->GetPosition ().x;
-  position.y = model->GetPosition ().y;
-  position.z = model->GetPosition ().z;
+  pr = ParseNs2Line (line); // Parse line and obtain tokens
+
+  // Check if the line corresponds with one of the three types of line
+  if (pr.tokens.size () != 4 && pr.tokens.size () != 7 && pr.tokens.size () != 8)
+    {
+      NS_LOG_ERROR ("Line has not correct number of parameters (corrupted file?): " << line << "\n");
+      return false;
+    }
+
+  // Get the node Id
+  nodeId  = GetNodeIdString (pr);
+  iNodeId = GetNodeIdInt (pr);
+  if (iNodeId == -1)
+    {
+      NS_LOG_ERROR ("Node number couldn't be obtained (corrupted file?): " << line << "\n");
+      return false;
+    }
+
+  /*
+   * In this case a initial position is being seted
+   * line like $node_(0) set X_ 151.05190721688197
+   * The initial node positions are set before the scheduled
+   * statements are read, so do nothing with this line.
+   */
+  if (IsSetInitialPos (pr))
+    {
+      return false;
+    }
 
+  // This is a scheduled event, so time at should be present
+  if (!IsNumber (pr.tokens[2]))
+    {
+      NS_LOG_WARN ("Time is not a number: " << pr.tokens[2]);
+      return false;
+    }
+
+  at = pr.dvals[2]; // set time at
+
+  if ( at < 0 )
+    {
+      NS_LOG_WARN ("Time is less than cero: " << at);
+      return false;
+    }
+  return true;
+}
+
+void
+ScheduleSetdest (Ptr<ConstantVelocityMobilityModel> model, DestinationPoint& last, double at,
+                 double xFinalPosition, double yFinalPosition, double speed, Time elapsed)
+{
+  if (last.m_targetArrivalTime > at)
+    {
+      NS_LOG_LOGIC ("Did not reach a destination! stoptime = " << last.m_targetArrivalTime << ", at = "<<  at);
+      double actuallytraveled = at - last.m_travelStartTime;
+      Vector reached = Vector (
+          last.m_startPosition.x + last.m_speed.x * actuallytraveled,
+          last.m_startPosition.y + last.m_speed.y * actuallytraveled,
+          0
+          );
+      NS_LOG_LOGIC ("Final point = " << last.m_finalPosition << ", actually reached = " << reached);
+      last.m_stopEvent.Cancel ();
+      last.m_finalPosition = reached;
+    }
+  //                         last position     time  X coord         Y coord         velocity
+  last = SetMovement (model, last.m_finalPosition, at, xFinalPosition, yFinalPosition, speed, elapsed);
+}
+
+void
+ScheduleSetPosition (Ptr<ConstantVelocityMobilityModel> model, DestinationPoint& last, double at,
+                     Vector position, Time elapsed)
+{
   // Chedule next positions
-  Simulator::Schedule (Seconds (at), &ConstantVelocityMobilityModel::SetPosition, model,position);
+  Simulator::Schedule (Seconds (at) - elapsed, &ConstantVelocityMobilityModel::SetPosition, model, position);
+  last.m_finalPosition = position;
+  if (last.m_targetArrivalTime > at)
+    {
+      last.m_stopEvent.Cancel ();
+    }
+  last.m_targetArrivalTime = at;
+  last.m_travelStartTime = at;
+}
 
-  return position;
+uint32_t
+GetWindow (double at, double window)
+{
+  uint32_t k = static_cast<uint32_t> (std::floor (at / window));
+  // the window must not start after the statement, despite rounding
+  while (k > 0 && Seconds (k * window) > Seconds (at))
+    {
+      k--;
+    }
+  return k;
+}
+
+bool
+Ns2MobilityHelper::ConfigNodesMovementsStreaming (const ObjectStore &store) const
+{
+  std::ifstream file (m_filename.c_str (), std::ios::in | std::ios::ate);
+  uint64_t size = file.tellg ();
+  file.close ();
+
+  Ns2TraceIndex index;
+  if (m_indexFile.empty () || !index.Load (m_indexFile, size, m_window.GetSeconds ()))
+    {
+      index.window = m_window.GetSeconds ();
+      if (!index.Build (m_filename))
+        {
+          NS_LOG_WARN ("The scheduled statements of " << m_filename << " are not ordered by time window, scheduling all of them");
+          return false;
+        }
+      if (!m_indexFile.empty ())
+        {
+          index.Save (m_indexFile);
+        }
+    }
+
+  std::map<int, Ptr<ConstantVelocityMobilityModel> > models;
+  for (std::vector<int32_t>::const_iterator i = index.nodes.begin (); i != index.nodes.end (); ++i)
+    {
+      std::ostringstream oss;
+      oss << *i;
+      Ptr<ConstantVelocityMobilityModel> model = GetMobilityModel (oss.str (), store);
+      if (model != 0)
+        {
+          models[*i] = model;
+        }
+    }
+
+  std::map<int, DestinationPoint> lastPos;
+  for (std::vector<Ns2TraceIndex::InitialCoord>::const_iterator i = index.initial.begin (); i != index.initial.end (); ++i)
+    {
+      std::map<int, Ptr<ConstantVelocityMobilityModel> >::const_iterator model = models.find (i->id);
+      if (model == models.end ())
+        {
+          NS_LOG_ERROR ("Unknown node ID (corrupted file?): " << i->id << "\n");
+          continue;
+        }
+      std::string coord (1, i->coord);
+      coord += '_';
+      DestinationPoint point;
+      point.m_finalPosition = SetInitialPosition (model->second, coord, i->value);
+      lastPos[i->id] = point;
+      NS_LOG_DEBUG ("Positions after parse for node " << i->id << " position = " << point.m_finalPosition);
+    }
+
+  // the scheduled set statements update the position set by the
+  // previous ones, starting from the initial position
+  std::map<int, Vector> positions;
+  for (std::map<int, Ptr<ConstantVelocityMobilityModel> >::const_iterator i = models.begin (); i != models.end (); ++i)
+    {
+      positions[i->first] = i->second->GetPosition ();
+    }
+
+  Ptr<Ns2TraceStream> stream = Create<Ns2TraceStream> (m_filename, index, models, lastPos, positions);
+  stream->ReadWindow (0);
+  return true;
+}
+
+/// Write a value to a binary index file
+template <typename T>
+static void
+WriteValue (std::ostream &os, T value)
+{
+  os.write (reinterpret_cast<const char *> (&value), sizeof (T));
+}
+
+/// Read a value from a binary index file
+template <typename T>
+static bool
+ReadValue (std::istream &is, T &value)
+{
+  is.read (reinterpret_cast<char *> (&value), sizeof (T));
+  return is.good ();
+}
+
+/// Identifies the format of the index files
+static const uint32_t NS2_INDEX_MAGIC = 0x6e733269;
+
+bool
+Ns2TraceIndex::Build (std::string filename)
+{
+  std::ifstream file (filename.c_str (), std::ios::in);
+  std::set<int32_t> ids;
+  initial.clear ();
+  offsets.clear ();
+  offsets.push_back (0);
+  while (!file.eof ())
+    {
+      uint64_t offset = file.tellg ();
+      std::string line;
+      getline (file, line);
+      if (line.empty ())
+        {
+          continue;
+        }
+      ParseResult pr = ParseNs2Line (line);
+      int id = GetNodeIdInt (pr);
+      if (id == -1)
+        {
+          continue;
+        }
+      ids.insert (id);
+      if (IsSetInitialPos (pr))
+        {
+          InitialCoord coord;
+          coord.id = id;
+          coord.coord = pr.tokens[2][0];
+          coord.value = pr.dvals[3];
+          initial.push_back (coord);
+        }
+      else if (IsNumber (pr.tokens[2]) && pr.dvals[2] >= 0)
+        {
+          uint32_t k = GetWindow (pr.dvals[2], window);
+          if (k + 1 < offsets.size ())
+            {
+              NS_LOG_LOGIC ("window " << k << " after window " << offsets.size () - 1 << ": " << line);
+              return false;
+            }
+          while (offsets.size () <= k)
+            {
+              offsets.push_back (offset);
+            }
+        }
+    }
+  file.clear ();
+  file.seekg (0, std::ios::end);
+  traceSize = file.tellg ();
+  offsets.push_back (traceSize);
+  nodes.assign (ids.begin (), ids.end ());
+  return true;
+}
+
+bool
+Ns2TraceIndex::Load (std::string filename, uint64_t size, double window)
+{
+  std::ifstream file (filename.c_str (), std::ios::in | std::ios::binary);
+  uint32_t magic;
+  if (!file.is_open () || !ReadValue (file, magic) || magic != NS2_INDEX_MAGIC
+      || !ReadValue (file, traceSize) || traceSize != size
+      || !ReadValue (file, this->window) || this->window != window)
+    {
+      NS_LOG_INFO ("No index of the trace in " << filename);
+      return false;
+    }
+  uint32_t n;
+  ReadValue (file, n);
+  initial.resize (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      ReadValue (file, initial[i].id);
+      ReadValue (file, initial[i].coord);
+      ReadValue (file, initial[i].value);
+    }
+  ReadValue (file, n);
+  nodes.resize (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      ReadValue (file, nodes[i]);
+    }
+  ReadValue (file, n);
+  offsets.resize (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      ReadValue (file, offsets[i]);
+    }
+  if (!file.good () || offsets.size () < 2)
+    {
+      NS_LOG_WARN ("Corrupted index file " << filename);
+      return false;
+    }
+  return true;
+}
+
+void
+Ns2TraceIndex::Save (std::string filename) const
+{
+  std::ofstream file (filename.c_str (), std::ios::out | std::ios::binary);
+  if (!file.is_open ())
+    {
+      NS_LOG_WARN ("Could not write index file " << filename);
+      return;
+    }
+  WriteValue (file, NS2_INDEX_MAGIC);
+  WriteValue (file, traceSize);
+  WriteValue (file, window);
+  WriteValue (file, static_cast<uint32_t> (initial.size ()));
+  for (std::vector<InitialCoord>::const_iterator i = initial.begin (); i != initial.end (); ++i)
+    {
+      WriteValue (file, i->id);
+      WriteValue (file, i->coord);
+      WriteValue (file, i->value);
+    }
+  WriteValue (file, static_cast<uint32_t> (nodes.size ()));
+  for (std::vector<int32_t>::const_iterator i = nodes.begin (); i != nodes.end (); ++i)
+    {
+      WriteValue (file, *i);
+    }
+  WriteValue (file, static_cast<uint32_t> (offsets.size ()));
+  for (std::vector<uint64_t>::const_iterator i = offsets.begin (); i != offsets.end (); ++i)
+    {
+      WriteValue (file, *i);
+    }
+}
+
+Ns2TraceStream::Ns2TraceStream (std::string filename, const Ns2TraceIndex& index,
+                                const std::map<int, Ptr<ConstantVelocityMobilityModel> >& models,
+                                const std::map<int, DestinationPoint>& lastPos,
+                                const std::map<int, Vector>& positions)
+  : m_file (filename.c_str (), std::ios::in),
+    m_offsets (index.offsets),
+    m_window (index.window),
+    m_start (Simulator::Now ()),
+    m_models (models),
+    m_lastPos (lastPos),
+    m_positions (positions)
+{
+}
+
+void
+Ns2TraceStream::ReadWindow (uint32_t k)
+{
+  NS_LOG_FUNCTION (this << k);
+  Time elapsed = Simulator::Now () - m_start;
+  m_file.clear ();
+  m_file.seekg (m_offsets[k]);
+  while (!m_file.eof () && static_cast<uint64_t> (m_file.tellg ()) < m_offsets[k + 1])
+    {
+      int         iNodeId = 0;
+      std::string nodeId;
+      std::string line;
+      double at;
+      ParseResult pr;
+
+      getline (m_file, line);
+      if (!ParseSchedLine (line, pr, iNodeId, nodeId, at))
+        {
+          continue;
+        }
+
+      std::map<int, Ptr<ConstantVelocityMobilityModel> >::const_iterator model = m_models.find (iNodeId);
+      if (model == m_models.end ())
+        {
+          NS_LOG_ERROR ("Unknown node ID (corrupted file?): " << nodeId << "\n");
+          continue;
+        }
+
+      if (IsSchedMobilityPos (pr))
+        {
+          ScheduleSetdest (model->second, m_lastPos[iNodeId], at, pr.dvals[5], pr.dvals[6], pr.dvals[7], elapsed);
+        }
+      else if (IsSchedSetPos (pr))
+        {
+          Vector position = SetOneInitialCoord (m_positions[iNodeId], pr.tokens[5], pr.dvals[6]);
+          m_positions[iNodeId] = position;
+          ScheduleSetPosition (model->second, m_lastPos[iNodeId], at, position, elapsed);
+        }
+      else
+        {
+          NS_LOG_WARN ("Format Line is not correct: " << line << "\n");
+        }
+    }
+
+  if (k + 2 < m_offsets.size ())
+    {
+      Simulator::Schedule (m_start + Seconds ((k + 1) * m_window) - Simulator::Now (),
+                           &Ns2TraceStream::ReadWindow, Ptr<Ns2TraceStream> (this), k + 1);
+    }
 }
 
 void
@@ -27,6 +27,7 @@
 #include <stdint.h>
 #include "ns3/ptr.h"
 #include "ns3/object.h"
+#include "ns3/nstime.h"
 
 namespace ns3 {
 
@@ -69,6 +70,15 @@ class ConstantVelocityMobilityModel;
  *
  *  See usage example in examples/mobility/ns2-mobility-trace.cc
  *
+ * By default, Install schedules all the movements of the trace at once.
+ * For long traces of many nodes, SetStreamingWindow makes Install index
+ * the trace instead, and read the scheduled movements of each time window
+ * at the start of the window, so that only the events of the current
+ * window are pending. This requires the scheduled statements to appear in
+ * the order of their time windows, as in the traces exported by SUMO; the
+ * whole trace is scheduled at once otherwise. SetIndexFile keeps the index
+ * in a file, so that later runs do not need to read the trace beforehand.
+ *
  * \bug Rounding errors may cause movement to diverge from the mobility
  * pattern in ns-2 (using the same trace).
  * See https://www.nsnam.org/bugzilla/show_bug.cgi?id=1316
@@ -82,6 +92,20 @@ public:
    */
   Ns2MobilityHelper (std::string filename);
 
+  /**
+   * \param window the duration of the time windows in which the scheduled
+   *        movements are read during the simulation, or zero to schedule
+   *        all of them in Install (the default).
+   */
+  void SetStreamingWindow (Time window);
+
+  /**
+   * \param filename the file in which the index of the trace built for
+   *        streaming is saved. If the file already holds an index of the
+   *        trace for the same window, the trace is not read in Install.
+   */
+  void SetIndexFile (std::string filename);
+
   /**
    * Read the ns2 trace file and configure the movement
    * patterns of all nodes contained in the global ns3::NodeList
@@ -111,8 +135,18 @@ public:
     virtual Ptr<Object> Get (uint32_t i) const = 0;
   };
   void ConfigNodesMovements (const ObjectStore &store) const;
+  /**
+   * Index the trace and start reading it one window at a time.
+   *
+   * \param store the objects whose movements are configured
+   * \return false if the scheduled statements are not in the order of
+   *         their windows, in which case nothing was done.
+   */
+  bool ConfigNodesMovementsStreaming (const ObjectStore &store) const;
   Ptr<ConstantVelocityMobilityModel> GetMobilityModel (std::string idString, const ObjectStore &store) const;
   std::string m_filename;
+  Time m_window;           //!< the streaming window, zero if not streaming
+  std::string m_indexFile; //!< the file of the streaming index, if any
 };
 
 } // namespace ns3
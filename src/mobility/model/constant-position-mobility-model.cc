@@ -57,5 +57,10 @@ ConstantPositionMobilityModel::DoGetVelocity (void) const
 {
   return Vector (0.0, 0.0, 0.0);
 }
+Time
+ConstantPositionMobilityModel::DoGetConstantVelocityEnd (void) const
+{
+  return Time::Max ();
+}
 
 } // namespace ns3
@@ -43,6 +43,7 @@ private:
   virtual Vector DoGetPosition (void) const;
   virtual void DoSetPosition (const Vector &position);
   virtual Vector DoGetVelocity (void) const;
+  virtual Time DoGetConstantVelocityEnd (void) const;
 
   Vector m_position;
 };
@@ -68,5 +68,10 @@ ConstantVelocityMobilityModel::DoGetVelocity (void) const
 {
   return m_helper.GetVelocity ();
 }
+Time
+ConstantVelocityMobilityModel::DoGetConstantVelocityEnd (void) const
+{
+  return Time::Max ();
+}
 
 } // namespace ns3
@@ -54,6 +54,7 @@ private:
   virtual Vector DoGetPosition (void) const;
   virtual void DoSetPosition (const Vector &position);
   virtual Vector DoGetVelocity (void) const;
+  virtual Time DoGetConstantVelocityEnd (void) const;
   void Update (void) const;
   ConstantVelocityHelper m_helper;
 };
@@ -0,0 +1,184 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "mobility-index.h"
+
+NS_LOG_COMPONENT_DEFINE ("MobilityIndex");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (MobilityIndex)
+  ;
+
+TypeId
+MobilityIndex::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MobilityIndex")
+    .SetParent<Object> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<MobilityIndex> ()
+  ;
+  return tid;
+}
+
+MobilityIndex::MobilityIndex ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MobilityIndex::~MobilityIndex ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MobilityIndex::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<Ptr<MobilityModel> >::const_iterator i = m_models.begin (); i != m_models.end (); ++i)
+    {
+      (*i)->TraceDisconnectWithoutContext ("CourseChange", MakeCallback (&MobilityIndex::CourseChanged, this));
+    }
+  m_models.clear ();
+  m_indices.clear ();
+  Object::DoDispose ();
+}
+
+uint32_t
+MobilityIndex::Add (Ptr<MobilityModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  NS_ASSERT_MSG (m_indices.find (PeekPointer (model)) == m_indices.end (), "mobility model already in the index");
+  uint32_t i = m_models.size ();
+  m_models.push_back (model);
+  m_indices[PeekPointer (model)] = i;
+  m_start.push_back (0);
+  m_end.push_back (0);
+  m_x.push_back (0);
+  m_y.push_back (0);
+  m_z.push_back (0);
+  m_vx.push_back (0);
+  m_vy.push_back (0);
+  m_vz.push_back (0);
+  model->TraceConnectWithoutContext ("CourseChange", MakeCallback (&MobilityIndex::CourseChanged, this));
+  Refresh (i);
+  return i;
+}
+
+uint32_t
+MobilityIndex::GetN (void) const
+{
+  return m_models.size ();
+}
+
+Ptr<MobilityModel>
+MobilityIndex::Get (uint32_t i) const
+{
+  NS_ASSERT (i < m_models.size ());
+  return m_models[i];
+}
+
+void
+MobilityIndex::GetPositions (std::vector<Vector> &positions)
+{
+  NS_LOG_FUNCTION (this);
+  double now = Simulator::Now ().GetSeconds ();
+  uint32_t n = m_models.size ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      if (m_end[i] <= now)
+        {
+          Refresh (i);
+        }
+    }
+  positions.resize (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double dt = now - m_start[i];
+      positions[i].x = m_x[i] + m_vx[i] * dt;
+      positions[i].y = m_y[i] + m_vy[i] * dt;
+      positions[i].z = m_z[i] + m_vz[i] * dt;
+    }
+}
+
+Vector
+MobilityIndex::GetPosition (uint32_t i)
+{
+  NS_LOG_FUNCTION (this << i);
+  NS_ASSERT (i < m_models.size ());
+  if (m_end[i] <= Simulator::Now ().GetSeconds ())
+    {
+      Refresh (i);
+    }
+  return GetSegmentPosition (i);
+}
+
+Vector
+MobilityIndex::GetSegmentPosition (uint32_t i) const
+{
+  double dt = Simulator::Now ().GetSeconds () - m_start[i];
+  return Vector (m_x[i] + m_vx[i] * dt, m_y[i] + m_vy[i] * dt, m_z[i] + m_vz[i] * dt);
+}
+
+Vector
+MobilityIndex::GetSegmentVelocity (uint32_t i) const
+{
+  return Vector (m_vx[i], m_vy[i], m_vz[i]);
+}
+
+double
+MobilityIndex::GetSegmentEnd (uint32_t i) const
+{
+  return m_end[i];
+}
+
+void
+MobilityIndex::NotifySegmentChanged (uint32_t i)
+{
+}
+
+void
+MobilityIndex::CourseChanged (Ptr<const MobilityModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  std::map<const MobilityModel *, uint32_t>::const_iterator it = m_indices.find (PeekPointer (model));
+  NS_ASSERT (it != m_indices.end ());
+  Refresh (it->second);
+}
+
+void
+MobilityIndex::Refresh (uint32_t i)
+{
+  NS_LOG_FUNCTION (this << i);
+  Ptr<MobilityModel> model = m_models[i];
+  // querying the position first lets lazy models update their course
+  Vector position = model->GetPosition ();
+  Vector velocity = model->GetVelocity ();
+  m_start[i] = Simulator::Now ().GetSeconds ();
+  m_end[i] = model->GetConstantVelocityEnd ().GetSeconds ();
+  m_x[i] = position.x;
+  m_y[i] = position.y;
+  m_z[i] = position.z;
+  m_vx[i] = velocity.x;
+  m_vy[i] = velocity.y;
+  m_vz[i] = velocity.z;
+  NotifySegmentChanged (i);
+}
+
+} // namespace ns3
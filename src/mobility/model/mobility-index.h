@@ -0,0 +1,142 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MOBILITY_INDEX_H
+#define MOBILITY_INDEX_H
+
+#include <map>
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/vector.h"
+#include "mobility-model.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Keep the positions of many mobility models up to date at once.
+ *
+ * The index keeps the current straight segment of the trajectory of each
+ * of its models: a start time, a position and a velocity, stored in one
+ * array per coordinate. A segment is replaced when its model calls the
+ * CourseChange callbacks, or when the time returned by
+ * MobilityModel::GetConstantVelocityEnd is reached, in which case the
+ * model is queried again. GetPositions then computes the positions of
+ * all the models in a single loop over these arrays, without calling
+ * the models whose segment is still valid.
+ *
+ * The models which do not override
+ * MobilityModel::DoGetConstantVelocityEnd (e.g., with an acceleration)
+ * are queried each time. The positions of the other models are the ones
+ * of the models, up to rounding errors.
+ *
+ * Waypoint-style models can also be configured to compute their legs
+ * lazily instead of scheduling events (see the LazyNotify attribute of
+ * WaypointMobilityModel and RandomWaypointMobilityModel): the index then
+ * queries them only when their current leg ends.
+ */
+class MobilityIndex : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+
+  MobilityIndex ();
+  virtual ~MobilityIndex ();
+
+  /**
+   * \param model the mobility model to add, which must not be in the
+   * index already
+   * \return the index of the model in the positions returned by
+   * GetPositions
+   */
+  uint32_t Add (Ptr<MobilityModel> model);
+  /**
+   * \return the number of mobility models in the index
+   */
+  uint32_t GetN (void) const;
+  /**
+   * \param i the index of a mobility model
+   * \return the mobility model
+   */
+  Ptr<MobilityModel> Get (uint32_t i) const;
+  /**
+   * \param positions the positions at the current time of all the
+   * mobility models, in the order in which they were added
+   */
+  void GetPositions (std::vector<Vector> &positions);
+  /**
+   * \param i the index of a mobility model
+   * \return the position of the model at the current time
+   */
+  Vector GetPosition (uint32_t i);
+
+protected:
+  virtual void DoDispose (void);
+
+  /**
+   * Query a model for its current segment.
+   *
+   * \param i the index of the model
+   */
+  void Refresh (uint32_t i);
+  /**
+   * Called each time the segment of a model was replaced, including
+   * when the model is added.
+   *
+   * \param i the index of the model
+   */
+  virtual void NotifySegmentChanged (uint32_t i);
+  /**
+   * \param i the index of a mobility model
+   * \return the position of the model at the current time, extrapolated
+   * from its current segment even if the segment ended
+   */
+  Vector GetSegmentPosition (uint32_t i) const;
+  /**
+   * \param i the index of a mobility model
+   * \return the velocity of the current segment of the model
+   */
+  Vector GetSegmentVelocity (uint32_t i) const;
+  /**
+   * \param i the index of a mobility model
+   * \return the time (s) until which the current segment of the model is valid
+   */
+  double GetSegmentEnd (uint32_t i) const;
+
+private:
+  /**
+   * Replace the segment of the model which changed its course.
+   *
+   * \param model the mobility model
+   */
+  void CourseChanged (Ptr<const MobilityModel> model);
+
+  std::vector<Ptr<MobilityModel> > m_models;         //!< the models, in index order
+  std::map<const MobilityModel *, uint32_t> m_indices; //!< the index of each model
+  std::vector<double> m_start; //!< the start time of each segment (s)
+  std::vector<double> m_end;   //!< the time until which each segment is valid (s)
+  std::vector<double> m_x;     //!< the x coordinate of each segment at its start
+  std::vector<double> m_y;     //!< the y coordinate of each segment at its start
+  std::vector<double> m_z;     //!< the z coordinate of each segment at its start
+  std::vector<double> m_vx;    //!< the x velocity of each segment
+  std::vector<double> m_vy;    //!< the y velocity of each segment
+  std::vector<double> m_vz;    //!< the z velocity of each segment
+};
+
+} // namespace ns3
+
+#endif /* MOBILITY_INDEX_H */
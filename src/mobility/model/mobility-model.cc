@@ -22,6 +22,7 @@
 
 #include "mobility-model.h"
 #include "ns3/trace-source-accessor.h"
+#include "ns3/simulator.h"
 
 namespace ns3 {
 
@@ -93,6 +94,12 @@ MobilityModel::GetRelativeSpeed (Ptr<const MobilityModel> other) const
   return sqrt( (x*x) + (y*y) + (z*z) );
 }
 
+Time
+MobilityModel::GetConstantVelocityEnd (void) const
+{
+  return DoGetConstantVelocityEnd ();
+}
+
 void
 MobilityModel::NotifyCourseChange (void) const
 {
@@ -112,5 +119,11 @@ MobilityModel::DoAssignStreams (int64_t start)
   return 0;
 }
 
+Time
+MobilityModel::DoGetConstantVelocityEnd (void) const
+{
+  return Simulator::Now ();
+}
+
 
 } // namespace ns3
@@ -23,6 +23,7 @@
 #include "ns3/vector.h"
 #include "ns3/object.h"
 #include "ns3/traced-callback.h"
+#include "ns3/nstime.h"
 
 namespace ns3 {
 
@@ -65,6 +66,13 @@ public:
    * \return the relative speed between the two objects. Unit is meters/s.
    */
   double GetRelativeSpeed (Ptr<const MobilityModel> other) const;
+  /**
+   * \return a time until which the current velocity is known to stay
+   * constant, unless the model is explicitly changed (e.g., with
+   * SetPosition). A time in the past or the current time means that the
+   * velocity may change at any time.
+   */
+  Time GetConstantVelocityEnd (void) const;
   /**
    * Assign a fixed random variable stream number to the random variables
    * used by this model. Return the number of streams (possibly zero) that
@@ -109,6 +117,12 @@ private:
    * override this.
    */
   virtual int64_t DoAssignStreams (int64_t start);
+  /**
+   * The default implementation returns the current time. Subclasses
+   * whose trajectories are made of straight segments at a constant
+   * velocity are expected to override this.
+   */
+  virtual Time DoGetConstantVelocityEnd (void) const;
 
   /**
    * Used to alert subscribers that a change in direction, velocity,
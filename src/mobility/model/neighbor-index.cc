@@ -0,0 +1,265 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/trace-source-accessor.h"
+#include "neighbor-index.h"
+
+NS_LOG_COMPONENT_DEFINE ("NeighborIndex");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (NeighborIndex)
+  ;
+
+TypeId
+NeighborIndex::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::NeighborIndex")
+    .SetParent<MobilityIndex> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<NeighborIndex> ()
+    .AddAttribute ("CellSize",
+                   "The side (m) of the cells of the grid.",
+                   DoubleValue (100.0),
+                   MakeDoubleAccessor (&NeighborIndex::SetCellSize,
+                                       &NeighborIndex::GetCellSize),
+                   MakeDoubleChecker<double> (1e-3))
+    .AddAttribute ("ProximityRange",
+                   "The distance (m) below which two models are in range of each other, "
+                   "or zero to disable the EnterRange and LeaveRange trace sources.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&NeighborIndex::SetProximityRange),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("ProximityInterval",
+                   "The interval between two samples of the pairs of models in range.",
+                   TimeValue (Seconds (1.0)),
+                   MakeTimeAccessor (&NeighborIndex::m_proximityInterval),
+                   MakeTimeChecker ())
+    .AddTraceSource ("EnterRange",
+                     "Two models came within ProximityRange of each other",
+                     MakeTraceSourceAccessor (&NeighborIndex::m_enterRangeTrace))
+    .AddTraceSource ("LeaveRange",
+                     "Two models are no longer within ProximityRange of each other",
+                     MakeTraceSourceAccessor (&NeighborIndex::m_leaveRangeTrace))
+  ;
+  return tid;
+}
+
+NeighborIndex::NeighborIndex ()
+  : m_proximityRange (0.0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+NeighborIndex::~NeighborIndex ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+NeighborIndex::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_proximityEvent.Cancel ();
+  m_grid.Clear ();
+  m_cells.clear ();
+  m_deadlines.clear ();
+  m_deadline.clear ();
+  m_inRange.clear ();
+  MobilityIndex::DoDispose ();
+}
+
+void
+NeighborIndex::SetCellSize (double cellSize)
+{
+  NS_LOG_FUNCTION (this << cellSize);
+  m_grid.SetCellSize (cellSize);
+  for (uint32_t i = 0; i < m_cells.size (); i++)
+    {
+      m_cells[i] = m_grid.GetCell (GetSegmentPosition (i));
+      m_grid.Insert (m_cells[i], i);
+    }
+  // the models may now move by half a cell sooner
+  for (uint32_t i = 0; i < m_cells.size (); i++)
+    {
+      Rebin (i);
+    }
+}
+
+double
+NeighborIndex::GetCellSize (void) const
+{
+  return m_grid.GetCellSize ();
+}
+
+void
+NeighborIndex::SetProximityRange (double range)
+{
+  NS_LOG_FUNCTION (this << range);
+  m_proximityRange = range;
+  if (m_proximityRange > 0 && !m_proximityEvent.IsRunning ())
+    {
+      m_proximityEvent = Simulator::ScheduleNow (&NeighborIndex::CheckProximity, this);
+    }
+  else if (m_proximityRange == 0)
+    {
+      m_proximityEvent.Cancel ();
+      m_inRange.clear ();
+    }
+}
+
+void
+NeighborIndex::GetNeighbors (const Vector &position, double range, std::vector<uint32_t> &neighbors)
+{
+  NS_LOG_FUNCTION (this << position << range);
+  Update ();
+  FindNeighbors (position, range, neighbors);
+}
+
+void
+NeighborIndex::GetNeighbors (uint32_t i, double range, std::vector<uint32_t> &neighbors)
+{
+  NS_LOG_FUNCTION (this << i << range);
+  NS_ASSERT (i < GetN ());
+  Update ();
+  FindNeighbors (GetSegmentPosition (i), range, neighbors);
+  std::vector<uint32_t>::iterator self = std::find (neighbors.begin (), neighbors.end (), i);
+  if (self != neighbors.end ())
+    {
+      neighbors.erase (self);
+    }
+}
+
+void
+NeighborIndex::FindNeighbors (const Vector &position, double range, std::vector<uint32_t> &neighbors) const
+{
+  neighbors.clear ();
+  // the models moved at most half a cell since they were put in their cell
+  double reach = range + m_grid.GetCellSize () / 2;
+  std::vector<uint32_t> candidates;
+  m_grid.Find (Box (position.x - reach, position.x + reach, position.y - reach, position.y + reach, 0, 0),
+               candidates);
+  for (std::vector<uint32_t>::const_iterator j = candidates.begin (); j != candidates.end (); ++j)
+    {
+      if (CalculateDistance (GetSegmentPosition (*j), position) <= range)
+        {
+          neighbors.push_back (*j);
+        }
+    }
+  std::sort (neighbors.begin (), neighbors.end ());
+}
+
+void
+NeighborIndex::NotifySegmentChanged (uint32_t i)
+{
+  NS_LOG_FUNCTION (this << i);
+  if (i == m_cells.size ())
+    {
+      // a new model
+      m_cells.push_back (m_grid.GetCell (GetSegmentPosition (i)));
+      m_grid.Insert (m_cells[i], i);
+      m_deadline.push_back (m_deadlines.insert (std::make_pair (0.0, i)));
+    }
+  Rebin (i);
+}
+
+void
+NeighborIndex::Rebin (uint32_t i)
+{
+  double now = Simulator::Now ().GetSeconds ();
+  SpatialGrid::Cell cell = m_grid.GetCell (GetSegmentPosition (i));
+  if (cell != m_cells[i])
+    {
+      m_grid.Erase (m_cells[i], i);
+      m_grid.Insert (cell, i);
+      m_cells[i] = cell;
+    }
+
+  double deadline = GetSegmentEnd (i);
+  Vector velocity = GetSegmentVelocity (i);
+  double speed = std::sqrt (velocity.x * velocity.x + velocity.y * velocity.y);
+  if (speed > 0)
+    {
+      deadline = std::min (deadline, now + m_grid.GetCellSize () / 2 / speed);
+    }
+  m_deadlines.erase (m_deadline[i]);
+  m_deadline[i] = m_deadlines.insert (std::make_pair (deadline, i));
+}
+
+void
+NeighborIndex::Update (void)
+{
+  double now = Simulator::Now ().GetSeconds ();
+  // the models whose segment has no end are refreshed again at once, so
+  // collect the models to update first
+  std::vector<uint32_t> due;
+  for (Deadlines::const_iterator it = m_deadlines.begin (); it != m_deadlines.end () && it->first <= now; ++it)
+    {
+      due.push_back (it->second);
+    }
+  for (std::vector<uint32_t>::const_iterator i = due.begin (); i != due.end (); ++i)
+    {
+      if (GetSegmentEnd (*i) <= now)
+        {
+          Refresh (*i);
+        }
+      else
+        {
+          Rebin (*i);
+        }
+    }
+}
+
+void
+NeighborIndex::CheckProximity (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::set<std::pair<uint32_t, uint32_t> > inRange;
+  std::vector<uint32_t> neighbors;
+  Update ();
+  for (uint32_t i = 0; i < GetN (); i++)
+    {
+      FindNeighbors (GetSegmentPosition (i), m_proximityRange, neighbors);
+      for (std::vector<uint32_t>::const_iterator j = std::upper_bound (neighbors.begin (), neighbors.end (), i);
+           j != neighbors.end (); ++j)
+        {
+          inRange.insert (std::make_pair (i, *j));
+        }
+    }
+  for (std::set<std::pair<uint32_t, uint32_t> >::const_iterator it = m_inRange.begin (); it != m_inRange.end (); ++it)
+    {
+      if (inRange.find (*it) == inRange.end ())
+        {
+          m_leaveRangeTrace (Get (it->first), Get (it->second));
+        }
+    }
+  for (std::set<std::pair<uint32_t, uint32_t> >::const_iterator it = inRange.begin (); it != inRange.end (); ++it)
+    {
+      if (m_inRange.find (*it) == m_inRange.end ())
+        {
+          m_enterRangeTrace (Get (it->first), Get (it->second));
+        }
+    }
+  m_inRange.swap (inRange);
+  m_proximityEvent = Simulator::Schedule (m_proximityInterval, &NeighborIndex::CheckProximity, this);
+}
+
+} // namespace ns3
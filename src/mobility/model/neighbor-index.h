@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NEIGHBOR_INDEX_H
+#define NEIGHBOR_INDEX_H
+
+#include <map>
+#include <set>
+#include <vector>
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/traced-callback.h"
+#include "mobility-index.h"
+#include "spatial-grid.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Find the mobility models within a range of a position.
+ *
+ * The index keeps its models in a uniform 2D grid of CellSize x CellSize
+ * cells (see SpatialGrid), so that a range query only looks at the
+ * models of the cells which overlap the range, instead of all of them.
+ * The positions are the ones kept by MobilityIndex, from the current
+ * straight segment of the trajectory of each model. A moving model is
+ * also moved to the cell of its current position before it travels half
+ * a cell, so that the queries only need to look half a cell beyond their
+ * range. The models which do not override
+ * MobilityModel::DoGetConstantVelocityEnd are queried by each range
+ * query.
+ *
+ * If ProximityRange is positive, the index also samples, every
+ * ProximityInterval from the time ProximityRange was set, the pairs of
+ * models which are within ProximityRange of each other, and calls the
+ * EnterRange callbacks for the new pairs and the LeaveRange callbacks for
+ * the pairs which are no longer within range. These events are scheduled
+ * until ProximityRange is set back to zero or the index is disposed, so
+ * the simulation must then be stopped with Simulator::Stop.
+ */
+class NeighborIndex : public MobilityIndex
+{
+public:
+  static TypeId GetTypeId (void);
+
+  NeighborIndex ();
+  virtual ~NeighborIndex ();
+
+  /**
+   * \param position a position
+   * \param range a distance (m)
+   * \param neighbors the indices, in increasing order, of the models
+   * which are at most range away from position at the current time
+   */
+  void GetNeighbors (const Vector &position, double range, std::vector<uint32_t> &neighbors);
+  /**
+   * \param i the index of a mobility model
+   * \param range a distance (m)
+   * \param neighbors the indices, in increasing order, of the other
+   * models which are at most range away from model i at the current time
+   */
+  void GetNeighbors (uint32_t i, double range, std::vector<uint32_t> &neighbors);
+
+protected:
+  virtual void DoDispose (void);
+  virtual void NotifySegmentChanged (uint32_t i);
+
+private:
+  /// The times at which the models must be moved to their current cell
+  typedef std::multimap<double, uint32_t> Deadlines;
+
+  /**
+   * \param cellSize the side of the cells (m)
+   */
+  void SetCellSize (double cellSize);
+  /**
+   * \return the side of the cells (m)
+   */
+  double GetCellSize (void) const;
+  /**
+   * Start or stop sampling the pairs of models in range.
+   *
+   * \param range the range of the proximity events (m), or zero
+   */
+  void SetProximityRange (double range);
+  /**
+   * Move a model to the cell of its current position, and compute when
+   * it must be moved again.
+   *
+   * \param i the index of the model
+   */
+  void Rebin (uint32_t i);
+  /**
+   * Refresh or move the models whose deadline is reached.
+   */
+  void Update (void);
+  /**
+   * \param position a position
+   * \param range a distance (m)
+   * \param neighbors the indices, in increasing order, of the models
+   * which are at most range away from position, once updated
+   */
+  void FindNeighbors (const Vector &position, double range, std::vector<uint32_t> &neighbors) const;
+  /**
+   * Sample the pairs of models within ProximityRange, and schedule the
+   * next sample.
+   */
+  void CheckProximity (void);
+
+  double m_proximityRange;   //!< the range of the proximity events (m)
+  Time m_proximityInterval;  //!< the interval between two samples of the proximity events
+  EventId m_proximityEvent;  //!< the next sample of the proximity events
+  /// the pairs of models (lowest index first) within ProximityRange at the last sample
+  std::set<std::pair<uint32_t, uint32_t> > m_inRange;
+  /// the EnterRange trace source
+  TracedCallback<Ptr<const MobilityModel>, Ptr<const MobilityModel> > m_enterRangeTrace;
+  /// the LeaveRange trace source
+  TracedCallback<Ptr<const MobilityModel>, Ptr<const MobilityModel> > m_leaveRangeTrace;
+
+  SpatialGrid m_grid;                                //!< the models of each cell
+  Deadlines m_deadlines;                             //!< the next update of each model
+  std::vector<SpatialGrid::Cell> m_cells;            //!< the cell of each model
+  std::vector<Deadlines::iterator> m_deadline;       //!< the deadline of each model
+};
+
+} // namespace ns3
+
+#endif /* NEIGHBOR_INDEX_H */
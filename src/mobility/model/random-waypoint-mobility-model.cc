@@ -22,6 +22,7 @@
 #include "ns3/random-variable-stream.h"
 #include "ns3/pointer.h"
 #include "ns3/string.h"
+#include "ns3/boolean.h"
 #include "random-waypoint-mobility-model.h"
 #include "position-allocator.h"
 
@@ -51,11 +52,24 @@ RandomWaypointMobilityModel::GetTypeId (void)
                    "The position model used to pick a destination point.",
                    PointerValue (),
                    MakePointerAccessor (&RandomWaypointMobilityModel::m_position),
-                   MakePointerChecker<PositionAllocator> ());
+                   MakePointerChecker<PositionAllocator> ())
+    .AddAttribute ("LazyNotify",
+                   "Compute the waypoints when the position is requested instead of "
+                   "scheduling events, and only call NotifyCourseChange then.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RandomWaypointMobilityModel::m_lazyNotify),
+                   MakeBooleanChecker ());
 
   return tid;
 }
 
+RandomWaypointMobilityModel::RandomWaypointMobilityModel ()
+  : m_lazyNotify (false),
+    m_walking (false),
+    m_legEnd (Time::Max ())
+{
+}
+
 void
 RandomWaypointMobilityModel::BeginWalk (void)
 {
@@ -81,10 +95,78 @@ RandomWaypointMobilityModel::BeginWalk (void)
 void
 RandomWaypointMobilityModel::DoInitialize (void)
 {
-  DoInitializePrivate ();
+  if (m_lazyNotify)
+    {
+      BeginLazyPause ();
+    }
+  else
+    {
+      DoInitializePrivate ();
+    }
   MobilityModel::DoInitialize ();
 }
 
+void
+RandomWaypointMobilityModel::BeginLazyPause (void)
+{
+  m_helper.Update ();
+  m_helper.Pause ();
+  m_walking = false;
+  m_legEnd = Simulator::Now () + Seconds (m_pause->GetValue ());
+  NotifyCourseChange ();
+}
+
+void
+RandomWaypointMobilityModel::LazyUpdate (void) const
+{
+  Time now = Simulator::Now ();
+  if (!m_lazyNotify || m_legEnd > now)
+    {
+      return;
+    }
+  NS_ASSERT_MSG (m_position, "No position allocator added before using this model");
+  Vector start = m_helper.GetCurrentPosition ();
+  Vector velocity;
+  Time legStart;
+  while (m_legEnd <= now)
+    {
+      legStart = m_legEnd;
+      if (m_walking)
+        {
+          start = m_destination;
+          m_walking = false;
+          m_legEnd += Seconds (m_pause->GetValue ());
+        }
+      else
+        {
+          m_destination = m_position->GetNext ();
+          double speed = m_speed->GetValue ();
+          double dx = (m_destination.x - start.x);
+          double dy = (m_destination.y - start.y);
+          double dz = (m_destination.z - start.z);
+          double k = speed / std::sqrt (dx*dx + dy*dy + dz*dz);
+          velocity = Vector (k*dx, k*dy, k*dz);
+          m_walking = true;
+          m_legEnd += Seconds (CalculateDistance (m_destination, start) / speed);
+        }
+    }
+  if (m_walking)
+    {
+      double t = (now - legStart).GetSeconds ();
+      m_helper.SetPosition (Vector (start.x + velocity.x * t,
+                                    start.y + velocity.y * t,
+                                    start.z + velocity.z * t));
+      m_helper.SetVelocity (velocity);
+      m_helper.Unpause ();
+    }
+  else
+    {
+      m_helper.SetPosition (start);
+      m_helper.Pause ();
+    }
+  NotifyCourseChange ();
+}
+
 void
 RandomWaypointMobilityModel::DoInitializePrivate (void)
 {
@@ -98,6 +180,7 @@ RandomWaypointMobilityModel::DoInitializePrivate (void)
 Vector
 RandomWaypointMobilityModel::DoGetPosition (void) const
 {
+  LazyUpdate ();
   m_helper.Update ();
   return m_helper.GetCurrentPosition ();
 }
@@ -105,12 +188,18 @@ void
 RandomWaypointMobilityModel::DoSetPosition (const Vector &position)
 {
   m_helper.SetPosition (position);
+  if (m_lazyNotify)
+    {
+      BeginLazyPause ();
+      return;
+    }
   Simulator::Remove (m_event);
   m_event = Simulator::ScheduleNow (&RandomWaypointMobilityModel::DoInitializePrivate, this);
 }
 Vector
 RandomWaypointMobilityModel::DoGetVelocity (void) const
 {
+  LazyUpdate ();
   return m_helper.GetVelocity ();
 }
 int64_t
@@ -123,6 +212,16 @@ RandomWaypointMobilityModel::DoAssignStreams (int64_t stream)
   positionStreamsAllocated = m_position->AssignStreams (stream + 2);
   return (2 + positionStreamsAllocated);
 }
+Time
+RandomWaypointMobilityModel::DoGetConstantVelocityEnd (void) const
+{
+  if (m_lazyNotify)
+    {
+      LazyUpdate ();
+      return m_legEnd;
+    }
+  return Simulator::Now () + Simulator::GetDelayLeft (m_event);
+}
 
 
 } // namespace ns3
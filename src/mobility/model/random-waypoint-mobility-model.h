@@ -48,26 +48,51 @@ namespace ns3 {
  * a 3d random waypoint position model to this mobility model, the model 
  * will still work. There is no 3d position allocator for now but it should
  * be trivial to add one.
+ *
+ * By default, an event is scheduled at the start and at the end of each
+ * pause, and the CourseChange callbacks are called at these times. When
+ * the LazyNotify attribute is true, no event is scheduled: the pauses and
+ * walks which ended since the last call are computed when the position
+ * or the velocity is requested, and the CourseChange callbacks are only
+ * called then. This saves two events per waypoint, but the destinations
+ * and speeds are drawn in the order in which the models are queried,
+ * which changes the trajectories when several models share the same
+ * PositionAllocator.
  */
 class RandomWaypointMobilityModel : public MobilityModel
 {
 public:
   static TypeId GetTypeId (void);
+  RandomWaypointMobilityModel ();
 protected:
   virtual void DoInitialize (void);
 private:
   void BeginWalk (void);
   void DoInitializePrivate (void);
+  /**
+   * Start a pause at the current time, without scheduling its end.
+   */
+  void BeginLazyPause (void);
+  /**
+   * Compute the pauses and walks which ended since the last update, when
+   * LazyNotify is true.
+   */
+  void LazyUpdate (void) const;
   virtual Vector DoGetPosition (void) const;
   virtual void DoSetPosition (const Vector &position);
   virtual Vector DoGetVelocity (void) const;
   virtual int64_t DoAssignStreams (int64_t);
+  virtual Time DoGetConstantVelocityEnd (void) const;
 
-  ConstantVelocityHelper m_helper;
+  mutable ConstantVelocityHelper m_helper;
   Ptr<PositionAllocator> m_position;
   Ptr<RandomVariableStream> m_speed;
   Ptr<RandomVariableStream> m_pause;
   EventId m_event;
+  bool m_lazyNotify;
+  mutable bool m_walking;      //!< whether the current leg is a walk, when LazyNotify is true
+  mutable Time m_legEnd;       //!< the end of the current leg, when LazyNotify is true
+  mutable Vector m_destination; //!< the destination of the current walk, when LazyNotify is true
 };
 
 } // namespace ns3
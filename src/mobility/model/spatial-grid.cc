@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "ns3/assert.h"
+#include "spatial-grid.h"
+
+namespace ns3 {
+
+SpatialGrid::SpatialGrid ()
+  : m_cellSize (1.0)
+{
+}
+
+void
+SpatialGrid::SetCellSize (double cellSize)
+{
+  NS_ASSERT (cellSize > 0);
+  m_cellSize = cellSize;
+  m_cells.clear ();
+}
+
+double
+SpatialGrid::GetCellSize (void) const
+{
+  return m_cellSize;
+}
+
+SpatialGrid::Cell
+SpatialGrid::GetCell (const Vector &position) const
+{
+  return Cell (static_cast<int64_t> (std::floor (position.x / m_cellSize)),
+               static_cast<int64_t> (std::floor (position.y / m_cellSize)));
+}
+
+void
+SpatialGrid::Insert (const Cell &cell, uint32_t item)
+{
+  m_cells[cell].push_back (item);
+}
+
+bool
+SpatialGrid::Insert (const Box &box, uint32_t item, double maxCells)
+{
+  double xMin = std::floor (box.xMin / m_cellSize);
+  double xMax = std::floor (box.xMax / m_cellSize);
+  double yMin = std::floor (box.yMin / m_cellSize);
+  double yMax = std::floor (box.yMax / m_cellSize);
+  // also catches infinite and NaN boundaries
+  if (!((xMax - xMin + 1) * (yMax - yMin + 1) <= maxCells))
+    {
+      return false;
+    }
+  for (int64_t x = static_cast<int64_t> (xMin); x <= static_cast<int64_t> (xMax); x++)
+    {
+      for (int64_t y = static_cast<int64_t> (yMin); y <= static_cast<int64_t> (yMax); y++)
+        {
+          m_cells[Cell (x, y)].push_back (item);
+        }
+    }
+  return true;
+}
+
+void
+SpatialGrid::Erase (const Cell &cell, uint32_t item)
+{
+  Cells::iterator it = m_cells.find (cell);
+  NS_ASSERT (it != m_cells.end ());
+  std::vector<uint32_t>::iterator j = std::find (it->second.begin (), it->second.end (), item);
+  NS_ASSERT (j != it->second.end ());
+  it->second.erase (j);
+  if (it->second.empty ())
+    {
+      m_cells.erase (it);
+    }
+}
+
+void
+SpatialGrid::Find (const Box &box, std::vector<uint32_t> &items) const
+{
+  double xMin = std::floor (box.xMin / m_cellSize);
+  double xMax = std::floor (box.xMax / m_cellSize);
+  double yMin = std::floor (box.yMin / m_cellSize);
+  double yMax = std::floor (box.yMax / m_cellSize);
+  if ((xMax - xMin + 1) * (yMax - yMin + 1) <= m_cells.size ())
+    {
+      for (int64_t x = static_cast<int64_t> (xMin); x <= static_cast<int64_t> (xMax); x++)
+        {
+          for (int64_t y = static_cast<int64_t> (yMin); y <= static_cast<int64_t> (yMax); y++)
+            {
+              Cells::const_iterator it = m_cells.find (Cell (x, y));
+              if (it != m_cells.end ())
+                {
+                  items.insert (items.end (), it->second.begin (), it->second.end ());
+                }
+            }
+        }
+    }
+  else
+    {
+      // the box covers more cells than there are non empty ones
+      for (Cells::const_iterator it = m_cells.begin (); it != m_cells.end (); ++it)
+        {
+          if (it->first.first >= xMin && it->first.first <= xMax
+              && it->first.second >= yMin && it->first.second <= yMax)
+            {
+              items.insert (items.end (), it->second.begin (), it->second.end ());
+            }
+        }
+    }
+}
+
+void
+SpatialGrid::Clear (void)
+{
+  m_cells.clear ();
+}
+
+uint32_t
+SpatialGrid::GetNCells (void) const
+{
+  return m_cells.size ();
+}
+
+} // namespace ns3
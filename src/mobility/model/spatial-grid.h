@@ -0,0 +1,109 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <map>
+#include <vector>
+#include <stdint.h>
+#include "ns3/vector.h"
+#include "box.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief A uniform 2D grid of items, for spatial indexes.
+ *
+ * The grid divides the plane in square cells of CellSize x CellSize and
+ * keeps, for each non empty cell, the items put in it. The items are
+ * integers, typically the indices of the indexed objects in a vector
+ * kept by the user of the grid, and the z coordinates are ignored.
+ */
+class SpatialGrid
+{
+public:
+  /// A cell of the grid, as its x and y indices
+  typedef std::pair<int64_t, int64_t> Cell;
+
+  SpatialGrid ();
+
+  /**
+   * Remove all the items and change the size of the cells.
+   *
+   * \param cellSize the side of the cells (m)
+   */
+  void SetCellSize (double cellSize);
+  /**
+   * \return the side of the cells (m)
+   */
+  double GetCellSize (void) const;
+  /**
+   * \param position a position
+   * \return the cell containing position
+   */
+  Cell GetCell (const Vector &position) const;
+  /**
+   * \param cell a cell
+   * \param item the item to put in the cell
+   */
+  void Insert (const Cell &cell, uint32_t item);
+  /**
+   * Put an item in all the cells which overlap a box, unless there are
+   * too many of them.
+   *
+   * \param box a box
+   * \param item the item to put in the cells
+   * \param maxCells the maximum number of cells to put the item in
+   * \return false, and the item is not put in any cell, if the box
+   * overlaps more than maxCells cells or its boundaries are not finite
+   */
+  bool Insert (const Box &box, uint32_t item, double maxCells);
+  /**
+   * \param cell a cell
+   * \param item an item of the cell, to remove from it
+   */
+  void Erase (const Cell &cell, uint32_t item);
+  /**
+   * \param box a box
+   * \param items the items of the cells which overlap the box are
+   * appended to it, in no particular order
+   *
+   * A box larger than the area covered by the non empty cells only
+   * costs as much as one over the whole grid.
+   */
+  void Find (const Box &box, std::vector<uint32_t> &items) const;
+  /**
+   * Remove all the items.
+   */
+  void Clear (void);
+  /**
+   * \return the number of non empty cells
+   */
+  uint32_t GetNCells (void) const;
+
+private:
+  /// The items of each non empty cell
+  typedef std::map<Cell, std::vector<uint32_t> > Cells;
+
+  double m_cellSize; //!< the side of the cells (m)
+  Cells m_cells;     //!< the items of each non empty cell
+};
+
+} // namespace ns3
+
+#endif /* SPATIAL_GRID_H */
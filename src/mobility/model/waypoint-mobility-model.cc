@@ -213,6 +213,20 @@ WaypointMobilityModel::DoGetVelocity (void) const
 {
   return m_velocity;
 }
+Time
+WaypointMobilityModel::DoGetConstantVelocityEnd (void) const
+{
+  Update ();
+  const Time now = Simulator::Now ();
+  if ( now < m_current.time )
+    {
+      return m_current.time;
+    }
+  // m_next is in the past once the last waypoint has been reached; a
+  // waypoint added later changes the course without notifying it, so the
+  // velocity is only known to hold now
+  return m_next.time > now ? m_next.time : now;
+}
 
 } // namespace ns3
 
@@ -132,6 +132,7 @@ private:
   virtual Vector DoGetPosition (void) const;
   virtual void DoSetPosition (const Vector &position);
   virtual Vector DoGetVelocity (void) const;
+  virtual Time DoGetConstantVelocityEnd (void) const;
 
   bool m_first;
   bool m_lazyNotify;
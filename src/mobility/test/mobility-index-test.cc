@@ -0,0 +1,491 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/pointer.h"
+#include "ns3/mobility-index.h"
+#include "ns3/neighbor-index.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/constant-acceleration-mobility-model.h"
+#include "ns3/waypoint-mobility-model.h"
+#include "ns3/random-waypoint-mobility-model.h"
+#include "ns3/position-allocator.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \param min the lower bound of the x and y coordinates of the waypoints
+ * \param max the upper bound of the x and y coordinates of the waypoints
+ * \param lazy the LazyNotify attribute of the model
+ * \param stream the first stream number of the model
+ * \return a random waypoint model moving in a square, with its own
+ * position allocator so that its trajectory only depends on the stream
+ * numbers
+ */
+static Ptr<MobilityModel>
+CreateRandomWaypointModel (double min, double max, bool lazy, int64_t stream)
+{
+  std::ostringstream coordinate;
+  coordinate << "ns3::UniformRandomVariable[Min=" << min << "|Max=" << max << "]";
+  Ptr<RandomRectanglePositionAllocator> allocator = CreateObject<RandomRectanglePositionAllocator> ();
+  allocator->SetAttribute ("X", StringValue (coordinate.str ()));
+  allocator->SetAttribute ("Y", StringValue (coordinate.str ()));
+  Ptr<MobilityModel> model = CreateObject<RandomWaypointMobilityModel> ();
+  model->SetAttribute ("PositionAllocator", PointerValue (allocator));
+  model->SetAttribute ("Speed", StringValue ("ns3::UniformRandomVariable[Min=5.0|Max=20.0]"));
+  model->SetAttribute ("Pause", StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=3.0]"));
+  model->SetAttribute ("LazyNotify", BooleanValue (lazy));
+  model->AssignStreams (stream);
+  return model;
+}
+
+/**
+ * Check an index against its mobility models every 0.37 s.
+ */
+class MobilityIndexTestCase : public TestCase
+{
+public:
+  MobilityIndexTestCase (std::string name);
+  virtual ~MobilityIndexTestCase ();
+
+protected:
+  /**
+   * Add m_models to the index, and check it until 40 s.
+   *
+   * \param index the index to check
+   */
+  void Run (Ptr<MobilityIndex> index);
+  /**
+   * Check the positions of the index against the ones of the models.
+   */
+  virtual void Check (void);
+
+  Ptr<MobilityIndex> m_index;
+  std::vector<Ptr<MobilityModel> > m_models;
+
+private:
+  virtual void DoTeardown (void);
+};
+
+MobilityIndexTestCase::MobilityIndexTestCase (std::string name)
+  : TestCase (name)
+{
+}
+
+MobilityIndexTestCase::~MobilityIndexTestCase ()
+{
+}
+
+void
+MobilityIndexTestCase::DoTeardown (void)
+{
+  m_index = 0;
+  m_models.clear ();
+}
+
+void
+MobilityIndexTestCase::Check (void)
+{
+  std::vector<Vector> positions;
+  m_index->GetPositions (positions);
+  NS_TEST_ASSERT_MSG_EQ (positions.size (), m_models.size (), "wrong number of positions");
+  for (uint32_t i = 0; i < m_models.size (); i++)
+    {
+      Vector expected = m_models[i]->GetPosition ();
+      NS_TEST_ASSERT_MSG_EQ_TOL (positions[i].x, expected.x, 1e-6, "wrong x for model " << i << " at " << Simulator::Now ().GetSeconds ());
+      NS_TEST_ASSERT_MSG_EQ_TOL (positions[i].y, expected.y, 1e-6, "wrong y for model " << i << " at " << Simulator::Now ().GetSeconds ());
+      NS_TEST_ASSERT_MSG_EQ_TOL (positions[i].z, expected.z, 1e-6, "wrong z for model " << i << " at " << Simulator::Now ().GetSeconds ());
+    }
+}
+
+void
+MobilityIndexTestCase::Run (Ptr<MobilityIndex> index)
+{
+  m_index = index;
+  for (uint32_t i = 0; i < m_models.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_index->Add (m_models[i]), i, "wrong index");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_index->GetN (), m_models.size (), "wrong number of models");
+
+  for (double t = 0; t < 40; t += 0.37)
+    {
+      Simulator::Schedule (Seconds (t), &MobilityIndexTestCase::Check, this);
+    }
+  Simulator::Stop (Seconds (40));
+  Simulator::Run ();
+  m_index->Dispose ();
+  Simulator::Destroy ();
+}
+
+class MobilityIndexPositionTestCase : public MobilityIndexTestCase
+{
+public:
+  MobilityIndexPositionTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MobilityIndexPositionTestCase::MobilityIndexPositionTestCase ()
+  : MobilityIndexTestCase ("Check the positions of a MobilityIndex against its mobility models")
+{
+}
+
+void
+MobilityIndexPositionTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> position = CreateObject<ConstantPositionMobilityModel> ();
+  position->SetPosition (Vector (1, 2, 3));
+  m_models.push_back (position);
+
+  Ptr<ConstantVelocityMobilityModel> velocity = CreateObject<ConstantVelocityMobilityModel> ();
+  velocity->SetVelocity (Vector (1, 0.5, 0));
+  Simulator::Schedule (Seconds (7.3), &ConstantVelocityMobilityModel::SetVelocity, velocity, Vector (-2, 0, 1));
+  m_models.push_back (velocity);
+
+  Ptr<ConstantAccelerationMobilityModel> acceleration = CreateObject<ConstantAccelerationMobilityModel> ();
+  acceleration->SetVelocityAndAcceleration (Vector (1, 0, 0), Vector (0, 0.1, 0));
+  m_models.push_back (acceleration);
+
+  for (uint32_t lazy = 0; lazy < 2; lazy++)
+    {
+      Ptr<WaypointMobilityModel> waypoint = CreateObject<WaypointMobilityModel> ();
+      waypoint->SetAttribute ("LazyNotify", BooleanValue (lazy));
+      waypoint->AddWaypoint (Waypoint (Seconds (1), Vector (0, 0, 0)));
+      waypoint->AddWaypoint (Waypoint (Seconds (5), Vector (10, 0, 0)));
+      waypoint->AddWaypoint (Waypoint (Seconds (12), Vector (10, 20, 0)));
+      waypoint->AddWaypoint (Waypoint (Seconds (20), Vector (0, 0, 5)));
+      m_models.push_back (waypoint);
+
+      // a waypoint added once the model stopped at its last waypoint
+      Ptr<WaypointMobilityModel> restarted = CreateObject<WaypointMobilityModel> ();
+      restarted->SetAttribute ("LazyNotify", BooleanValue (lazy));
+      restarted->AddWaypoint (Waypoint (Seconds (0), Vector (0, 0, 0)));
+      restarted->AddWaypoint (Waypoint (Seconds (2), Vector (10, 0, 0)));
+      Simulator::Schedule (Seconds (4), &WaypointMobilityModel::AddWaypoint, restarted,
+                           Waypoint (Seconds (10), Vector (50, 0, 0)));
+      m_models.push_back (restarted);
+
+      Ptr<MobilityModel> randomWaypoint = CreateRandomWaypointModel (0, 100, lazy, 10);
+      randomWaypoint->Initialize ();
+      m_models.push_back (randomWaypoint);
+    }
+
+  Run (CreateObject<MobilityIndex> ());
+}
+
+class RandomWaypointLazyNotifyTestCase : public TestCase
+{
+public:
+  RandomWaypointLazyNotifyTestCase ();
+  virtual ~RandomWaypointLazyNotifyTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  void Check (void);
+
+  Ptr<MobilityModel> m_eager;
+  Ptr<MobilityModel> m_lazy;
+};
+
+RandomWaypointLazyNotifyTestCase::RandomWaypointLazyNotifyTestCase ()
+  : TestCase ("Check that the lazy random waypoint model follows the same trajectory")
+{
+}
+
+RandomWaypointLazyNotifyTestCase::~RandomWaypointLazyNotifyTestCase ()
+{
+}
+
+void
+RandomWaypointLazyNotifyTestCase::DoTeardown (void)
+{
+  m_eager = 0;
+  m_lazy = 0;
+}
+
+void
+RandomWaypointLazyNotifyTestCase::Check (void)
+{
+  Vector eager = m_eager->GetPosition ();
+  Vector lazy = m_lazy->GetPosition ();
+  NS_TEST_ASSERT_MSG_EQ_TOL (lazy.x, eager.x, 1e-6, "wrong x at " << Simulator::Now ().GetSeconds ());
+  NS_TEST_ASSERT_MSG_EQ_TOL (lazy.y, eager.y, 1e-6, "wrong y at " << Simulator::Now ().GetSeconds ());
+  eager = m_eager->GetVelocity ();
+  lazy = m_lazy->GetVelocity ();
+  NS_TEST_ASSERT_MSG_EQ_TOL (lazy.x, eager.x, 1e-6, "wrong x velocity at " << Simulator::Now ().GetSeconds ());
+  NS_TEST_ASSERT_MSG_EQ_TOL (lazy.y, eager.y, 1e-6, "wrong y velocity at " << Simulator::Now ().GetSeconds ());
+}
+
+void
+RandomWaypointLazyNotifyTestCase::DoRun (void)
+{
+  m_eager = CreateRandomWaypointModel (0, 100, false, 10);
+  m_lazy = CreateRandomWaypointModel (0, 100, true, 10);
+  m_eager->Initialize ();
+  m_lazy->Initialize ();
+  // the checks do not fall on the legs boundaries, where the order of the
+  // events would matter
+  for (double t = 0.25; t < 200; t += 1.1)
+    {
+      Simulator::Schedule (Seconds (t), &RandomWaypointLazyNotifyTestCase::Check, this);
+    }
+  Simulator::Stop (Seconds (200));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+class MobilityIndexTestSuite : public TestSuite
+{
+public:
+  MobilityIndexTestSuite ();
+};
+
+MobilityIndexTestSuite::MobilityIndexTestSuite ()
+  : TestSuite ("mobility-index", UNIT)
+{
+  AddTestCase (new MobilityIndexPositionTestCase, TestCase::QUICK);
+  AddTestCase (new RandomWaypointLazyNotifyTestCase, TestCase::QUICK);
+}
+
+static MobilityIndexTestSuite g_mobilityIndexTestSuite;
+
+class NeighborIndexRangeTestCase : public MobilityIndexTestCase
+{
+public:
+  NeighborIndexRangeTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void Check (void);
+  /**
+   * Check the neighbors found by the index against the positions of the
+   * models.
+   */
+  void CheckNeighbors (const Vector &position, double range, uint32_t self,
+                       const std::vector<uint32_t> &neighbors);
+};
+
+NeighborIndexRangeTestCase::NeighborIndexRangeTestCase ()
+  : MobilityIndexTestCase ("Check the range queries of a NeighborIndex against its mobility models")
+{
+}
+
+void
+NeighborIndexRangeTestCase::CheckNeighbors (const Vector &position, double range, uint32_t self,
+                                            const std::vector<uint32_t> &neighbors)
+{
+  double now = Simulator::Now ().GetSeconds ();
+  for (uint32_t k = 1; k < neighbors.size (); k++)
+    {
+      NS_TEST_ASSERT_MSG_LT (neighbors[k - 1], neighbors[k], "neighbors not sorted at " << now);
+    }
+  for (uint32_t j = 0; j < m_models.size (); j++)
+    {
+      bool found = std::binary_search (neighbors.begin (), neighbors.end (), j);
+      double distance = CalculateDistance (m_models[j]->GetPosition (), position);
+      if (j == self)
+        {
+          NS_TEST_ASSERT_MSG_EQ (found, false, "model " << j << " is its own neighbor at " << now);
+        }
+      // do not check the models at the boundary of the range, where
+      // rounding errors matter
+      else if (distance < range - 1e-6)
+        {
+          NS_TEST_ASSERT_MSG_EQ (found, true, "model " << j << " at " << distance << " m not within "
+                                 << range << " m at " << now);
+        }
+      else if (distance > range + 1e-6)
+        {
+          NS_TEST_ASSERT_MSG_EQ (found, false, "model " << j << " at " << distance << " m within "
+                                 << range << " m at " << now);
+        }
+    }
+}
+
+void
+NeighborIndexRangeTestCase::Check (void)
+{
+  MobilityIndexTestCase::Check ();
+  Ptr<NeighborIndex> index = DynamicCast<NeighborIndex> (m_index);
+  // the cells change size half way through
+  DoubleValue cellSize;
+  index->GetAttribute ("CellSize", cellSize);
+  if (Simulator::Now () >= Seconds (20) && cellSize.Get () != 45)
+    {
+      index->SetAttribute ("CellSize", DoubleValue (45));
+    }
+  double ranges[] = { 0, 10, 45, 150, 1000 };
+  std::vector<uint32_t> neighbors;
+  for (uint32_t r = 0; r < sizeof (ranges) / sizeof (ranges[0]); r++)
+    {
+      Vector position (17, -23, 0);
+      index->GetNeighbors (position, ranges[r], neighbors);
+      CheckNeighbors (position, ranges[r], m_models.size (), neighbors);
+      for (uint32_t i = 0; i < m_models.size (); i++)
+        {
+          index->GetNeighbors (i, ranges[r], neighbors);
+          CheckNeighbors (m_models[i]->GetPosition (), ranges[r], i, neighbors);
+        }
+    }
+}
+
+void
+NeighborIndexRangeTestCase::DoRun (void)
+{
+  for (uint32_t i = 0; i < 25; i++)
+    {
+      Ptr<MobilityModel> position = CreateObject<ConstantPositionMobilityModel> ();
+      position->SetPosition (Vector ((i * 37) % 300 - 150.0, (i * 53) % 300 - 150.0, i % 3));
+      m_models.push_back (position);
+    }
+  for (uint32_t i = 0; i < 20; i++)
+    {
+      Ptr<ConstantVelocityMobilityModel> velocity = CreateObject<ConstantVelocityMobilityModel> ();
+      velocity->SetPosition (Vector ((i * 71) % 300 - 150.0, (i * 29) % 300 - 150.0, 0));
+      velocity->SetVelocity (Vector ((i % 7) * 3.0 - 9, (i % 5) * 4.0 - 8, 0));
+      Simulator::Schedule (Seconds (3.1 * i), &ConstantVelocityMobilityModel::SetVelocity, velocity,
+                           Vector ((i % 3) * 10.0 - 10, (i % 4) * -5.0, 0));
+      m_models.push_back (velocity);
+    }
+  Ptr<ConstantAccelerationMobilityModel> acceleration = CreateObject<ConstantAccelerationMobilityModel> ();
+  acceleration->SetVelocityAndAcceleration (Vector (-10, 0, 0), Vector (0.5, 1, 0));
+  m_models.push_back (acceleration);
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      Ptr<MobilityModel> randomWaypoint = CreateRandomWaypointModel (-150, 150, i % 2, 10 + 4 * i);
+      randomWaypoint->Initialize ();
+      m_models.push_back (randomWaypoint);
+    }
+
+  Ptr<NeighborIndex> index = CreateObject<NeighborIndex> ();
+  index->SetAttribute ("CellSize", DoubleValue (30));
+  Run (index);
+}
+
+class NeighborIndexProximityTestCase : public TestCase
+{
+public:
+  /**
+   * \param late whether ProximityRange is set after the models are added
+   */
+  NeighborIndexProximityTestCase (bool late);
+  virtual ~NeighborIndexProximityTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void EnterRange (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b);
+  void LeaveRange (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b);
+
+  bool m_late;               //!< whether ProximityRange is set after the models are added
+  std::vector<Time> m_enter; //!< the times of the EnterRange events
+  std::vector<Time> m_leave; //!< the times of the LeaveRange events
+};
+
+NeighborIndexProximityTestCase::NeighborIndexProximityTestCase (bool late)
+  : TestCase (late ? "Check the proximity events of a NeighborIndex, range set after the models are added"
+              : "Check the proximity events of a NeighborIndex"),
+    m_late (late)
+{
+}
+
+NeighborIndexProximityTestCase::~NeighborIndexProximityTestCase ()
+{
+}
+
+void
+NeighborIndexProximityTestCase::EnterRange (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b)
+{
+  NS_TEST_EXPECT_MSG_LT (a->GetPosition ().x, b->GetPosition ().x, "wrong pair entering the range");
+  m_enter.push_back (Simulator::Now ());
+}
+
+void
+NeighborIndexProximityTestCase::LeaveRange (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b)
+{
+  NS_TEST_EXPECT_MSG_GT (a->GetPosition ().x, b->GetPosition ().x, "wrong pair leaving the range");
+  m_leave.push_back (Simulator::Now ());
+}
+
+void
+NeighborIndexProximityTestCase::DoRun (void)
+{
+  // a model crossing a fixed one at 10 m/s, in range between 3 s and 7 s
+  Ptr<ConstantVelocityMobilityModel> moving = CreateObject<ConstantVelocityMobilityModel> ();
+  moving->SetPosition (Vector (-50, 0, 0));
+  moving->SetVelocity (Vector (10, 0, 0));
+  Ptr<MobilityModel> fixed = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> far = CreateObject<ConstantPositionMobilityModel> ();
+  far->SetPosition (Vector (0, 500, 0));
+
+  Ptr<NeighborIndex> index = CreateObject<NeighborIndex> ();
+  index->SetAttribute ("CellSize", DoubleValue (25));
+  index->SetAttribute ("ProximityInterval", TimeValue (Seconds (0.5)));
+  index->TraceConnectWithoutContext ("EnterRange", MakeCallback (&NeighborIndexProximityTestCase::EnterRange, this));
+  index->TraceConnectWithoutContext ("LeaveRange", MakeCallback (&NeighborIndexProximityTestCase::LeaveRange, this));
+  if (!m_late)
+    {
+      index->SetAttribute ("ProximityRange", DoubleValue (20));
+    }
+  index->Add (moving);
+  index->Add (fixed);
+  index->Add (far);
+  if (m_late)
+    {
+      index->SetAttribute ("ProximityRange", DoubleValue (20));
+    }
+
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+  index->Dispose ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_enter.size (), 1, "wrong number of EnterRange events");
+  NS_TEST_ASSERT_MSG_EQ (m_leave.size (), 1, "wrong number of LeaveRange events");
+  if (m_enter.size () != 1 || m_leave.size () != 1)
+    {
+      return;
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_enter[0], Seconds (3), "wrong time of the EnterRange event");
+  NS_TEST_ASSERT_MSG_EQ (m_leave[0], Seconds (7.5), "wrong time of the LeaveRange event");
+}
+
+class NeighborIndexTestSuite : public TestSuite
+{
+public:
+  NeighborIndexTestSuite ();
+};
+
+NeighborIndexTestSuite::NeighborIndexTestSuite ()
+  : TestSuite ("neighbor-index", UNIT)
+{
+  AddTestCase (new NeighborIndexRangeTestCase, TestCase::QUICK);
+  AddTestCase (new NeighborIndexProximityTestCase (false), TestCase::QUICK);
+  AddTestCase (new NeighborIndexProximityTestCase (true), TestCase::QUICK);
+}
+
+static NeighborIndexTestSuite g_neighborIndexTestSuite;
@@ -110,11 +110,13 @@ public:
    * \param name        Short description
    * \param timeLimit   Test time limit
    * \param nodes       Number of nodes used in the test trace, 1 by default
+   * \param window      Streaming window of the helper, none by default
    */
-  Ns2MobilityHelperTest (std::string const & name, Time timeLimit, uint32_t nodes = 1)
-    : TestCase (name),
+  Ns2MobilityHelperTest (std::string const & name, Time timeLimit, uint32_t nodes = 1, Time window = Seconds (0))
+    : TestCase (window.IsZero () ? name : name + " (streamed)"),
       m_timeLimit (timeLimit),
       m_nodeCount (nodes),
+      m_window (window),
       m_nextRefPoint (0)
   {
   }
@@ -143,6 +145,8 @@ private:
   Time m_timeLimit;
   /// Number of nodes used in the test
   uint32_t m_nodeCount;
+  /// Streaming window of the helper
+  Time m_window;
   /// Trace as string
   std::string m_trace;
   /// Reference mobility
@@ -151,6 +155,8 @@ private:
   size_t m_nextRefPoint;
   /// TMP trace file name
   std::string m_traceFile;
+  /// TMP trace index file name
+  std::string m_indexFile;
 
 private:
   /// Dump NS-2 trace to tmp file
@@ -161,6 +167,7 @@ private:
     NS_TEST_ASSERT_MSG_EQ_RETURNS_BOOL (of.is_open (), true, "Need to write tmp. file");
     of << m_trace;
     of.close ();
+    m_indexFile = m_traceFile + ".idx";
     return false; // no errors
   }
   /// Create and name nodes
@@ -233,6 +240,8 @@ private:
       {
         NS_LOG_ERROR ("Failed to delete file " << m_traceFile);
       }
+    // there is no index when the trace was not streamed
+    std::remove (m_indexFile.c_str ());
     Simulator::Destroy ();
   }
 
@@ -247,6 +256,14 @@ private:
         return;
       }
     Ns2MobilityHelper mobility (m_traceFile);
+    if (!m_window.IsZero ())
+      {
+        mobility.SetStreamingWindow (m_window);
+        mobility.SetIndexFile (m_indexFile);
+        // the first installation writes the index, the second one reads it
+        std::vector<Ptr<Node> > none;
+        mobility.Install (none.begin (), none.end ());
+      }
     mobility.Install ();
     if (CheckInitialPositions ())
       {
@@ -266,13 +283,26 @@ public:
   Ns2MobilityHelperTestSuite () : TestSuite ("mobility-ns2-trace-helper", UNIT)
   {
     SetDataDir (NS_TEST_SOURCEDIR);
+    AddTestCases (Seconds (0));
+    // streamed in windows of 1.5 s, so that some statements of the
+    // traces are read during the simulation
+    AddTestCases (Seconds (1.5));
+  }
 
+private:
+  /**
+   * Add all the test cases
+   *
+   * \param window the streaming window of the helper
+   */
+  void AddTestCases (Time window)
+  {
     // to be used as temporary variable for test cases.
     // Note that test suite takes care of deleting all test cases.
     Ns2MobilityHelperTest * t (0);
 
     // Initial position
-    t = new Ns2MobilityHelperTest ("initial position", Seconds (1));
+    t = new Ns2MobilityHelperTest ("initial position", Seconds (1), 1, window);
     t->SetTrace ("$node_(0) set X_ 1.0\n"
                  "$node_(0) set Y_ 2.0\n"
                  "$node_(0) set Z_ 3.0\n"
@@ -281,7 +311,7 @@ public:
     AddTestCase (t, TestCase::QUICK);
 
     // Check parsing comments, empty lines and no EOF at the end of file
-    t = new Ns2MobilityHelperTest ("comments", Seconds (1));
+    t = new Ns2MobilityHelperTest ("comments", Seconds (1), 1, window);
     t->SetTrace ("# comment\n"
                  "\n\n" // empty lines
                  "$node_(0) set X_ 1.0 # comment \n"
@@ -293,7 +323,7 @@ public:
     AddTestCase (t, TestCase::QUICK);
 
     // Simple setdest. Arguments are interpreted as x, y, speed by default
-    t = new Ns2MobilityHelperTest ("simple setdest", Seconds (10));
+    t = new Ns2MobilityHelperTest ("simple setdest", Seconds (10), 1, window);
     t->SetTrace ("$ns_ at 1.0 \"$node_(0) setdest 25 0 5\"");
     //                     id  t  position         velocity
     t->AddReferencePoint ("0", 0, Vector (0, 0, 0), Vector (0, 0, 0));
@@ -302,7 +332,7 @@ public:
     AddTestCase (t, TestCase::QUICK);
 
     // Several set and setdest. Arguments are interpreted as x, y, speed by default
-    t = new Ns2MobilityHelperTest ("square setdest", Seconds (6));
+    t = new Ns2MobilityHelperTest ("square setdest", Seconds (6), 1, window);
     t->SetTrace ("$node_(0) set X_ 0.0\n"
                  "$node_(0) set Y_ 0.0\n"
                  "$ns_ at 1.0 \"$node_(0) setdest 5  0  5\"\n"
@@ -326,7 +356,7 @@ public:
     // the end of the trace rather than at the beginning.
     //
     // Several set and setdest. Arguments are interpreted as x, y, speed by default
-    t = new Ns2MobilityHelperTest ("square setdest (initial positions at end)", Seconds (6));
+    t = new Ns2MobilityHelperTest ("square setdest (initial positions at end)", Seconds (6), 1, window);
     t->SetTrace ("$ns_ at 1.0 \"$node_(0) setdest 15  10  5\"\n"
                  "$ns_ at 2.0 \"$node_(0) setdest 15  15  5\"\n"
                  "$ns_ at 3.0 \"$node_(0) setdest 10  15  5\"\n"
@@ -347,7 +377,7 @@ public:
     AddTestCase (t, TestCase::QUICK);
 
     // Scheduled set position
-    t = new Ns2MobilityHelperTest ("scheduled set position", Seconds (2));
+    t = new Ns2MobilityHelperTest ("scheduled set position", Seconds (2), 1, window);
     t->SetTrace ("$ns_ at 1.0 \"$node_(0) set X_ 10\"\n"
                  "$ns_ at 1.0 \"$node_(0) set Z_ 10\"\n"
                  "$ns_ at 1.0 \"$node_(0) set Y_ 10\"");
@@ -358,7 +388,7 @@ public:
     AddTestCase (t, TestCase::QUICK);
 
     // Malformed lines
-    t = new Ns2MobilityHelperTest ("malformed lines", Seconds (2));
+    t = new Ns2MobilityHelperTest ("malformed lines", Seconds (2), 1, window);
     t->SetTrace ("$node() set X_ 1 # node id is not present\n"
                  "$node # incoplete line\"\n"
                  "$node this line is not correct\n"
@@ -374,7 +404,7 @@ public:
     AddTestCase (t, TestCase::QUICK);
 
     // Non possible values
-    t = new Ns2MobilityHelperTest ("non possible values", Seconds (2));
+    t = new Ns2MobilityHelperTest ("non possible values", Seconds (2), 1, window);
     t->SetTrace ("$node_(0) set X_ 1 # line OK \n"
                  "$node_(0) set Y_ 2 # line OK \n"
                  "$node_(0) set Z_ 3 # line OK \n"
@@ -394,7 +424,7 @@ public:
     AddTestCase (t, TestCase::QUICK);
 
     // More than one node
-    t = new Ns2MobilityHelperTest ("few nodes, combinations of set and setdest", Seconds (10), 3);
+    t = new Ns2MobilityHelperTest ("few nodes, combinations of set and setdest", Seconds (10), 3, window);
     t->SetTrace ("$node_(0) set X_ 1.0\n"
                  "$node_(0) set Y_ 2.0\n"
                  "$node_(0) set Z_ 3.0\n"
@@ -422,7 +452,7 @@ public:
     AddTestCase (t, TestCase::QUICK);
 
     // Test for Speed == 0, that acts as stop the node.
-    t = new Ns2MobilityHelperTest ("setdest with speed cero", Seconds (10));
+    t = new Ns2MobilityHelperTest ("setdest with speed cero", Seconds (10), 1, window);
     t->SetTrace ("$ns_ at 1.0 \"$node_(0) setdest 25 0 5\"\n"
                  "$ns_ at 7.0 \"$node_(0) setdest 11  22  0\"\n");
     //                     id  t  position         velocity
@@ -434,7 +464,7 @@ public:
 
 
     // Test negative positions
-    t = new Ns2MobilityHelperTest ("test negative positions", Seconds (10));
+    t = new Ns2MobilityHelperTest ("test negative positions", Seconds (10), 1, window);
     t->SetTrace ("$node_(0) set X_ -1.0\n"
                  "$node_(0) set Y_ 0\n"
                  "$ns_ at 1.0 \"$node_(0) setdest 0 0 1\"\n"
@@ -448,7 +478,7 @@ public:
     AddTestCase (t, TestCase::QUICK);
 
     // Sqare setdest with values in the form 1.0e+2
-    t = new Ns2MobilityHelperTest ("Foalt numbers in 1.0e+2 format", Seconds (6));
+    t = new Ns2MobilityHelperTest ("Foalt numbers in 1.0e+2 format", Seconds (6), 1, window);
     t->SetTrace ("$node_(0) set X_ 0.0\n"
                  "$node_(0) set Y_ 0.0\n"
                  "$ns_ at 1.0 \"$node_(0) setdest 1.0e+2  0       1.0e+2\"\n"
@@ -466,7 +496,7 @@ public:
     t->AddReferencePoint ("0", 4, Vector (0, 100, 0), Vector (0, -100, 0));
     t->AddReferencePoint ("0", 5, Vector (0, 0, 0), Vector (0,  0, 0));
     AddTestCase (t, TestCase::QUICK);
-    t = new Ns2MobilityHelperTest ("Bug 1219 testcase", Seconds (16));
+    t = new Ns2MobilityHelperTest ("Bug 1219 testcase", Seconds (16), 1, window);
     t->SetTrace ("$node_(0) set X_ 0.0\n"
                  "$node_(0) set Y_ 0.0\n"
                  "$ns_ at 1.0 \"$node_(0) setdest 0  10       1\"\n"
@@ -478,14 +508,14 @@ public:
     t->AddReferencePoint ("0", 6, Vector (0, 5, 0), Vector (0,  -1, 0));
     t->AddReferencePoint ("0", 16, Vector (0, -10, 0), Vector (0, 0, 0));
     AddTestCase (t, TestCase::QUICK);
-    t = new Ns2MobilityHelperTest ("Bug 1059 testcase", Seconds (16));
+    t = new Ns2MobilityHelperTest ("Bug 1059 testcase", Seconds (16), 1, window);
     t->SetTrace ("$node_(0) set X_ 10.0\r\n"
                  "$node_(0) set Y_ 0.0\r\n"
                  );
     //                     id  t  position         velocity
     t->AddReferencePoint ("0", 0, Vector (10, 0, 0), Vector (0,  0, 0));
     AddTestCase (t, TestCase::QUICK);
-    t = new Ns2MobilityHelperTest ("Bug 1301 testcase", Seconds (16));
+    t = new Ns2MobilityHelperTest ("Bug 1301 testcase", Seconds (16), 1, window);
     t->SetTrace ("$node_(0) set X_ 10.0\n"
                  "$node_(0) set Y_ 0.0\n"
                  "$ns_ at 1.0 \"$node_(0) setdest 10  0       1\"\n"
@@ -496,7 +526,7 @@ public:
     t->AddReferencePoint ("0", 0, Vector (10, 0, 0), Vector (0,  0, 0));
     AddTestCase (t, TestCase::QUICK);
 
-    t = new Ns2MobilityHelperTest ("Bug 1316 testcase", Seconds (1000));
+    t = new Ns2MobilityHelperTest ("Bug 1316 testcase", Seconds (1000), 1, window);
     t->SetTrace ("$node_(0) set X_ 350.00000000000000\n"
                  "$node_(0) set Y_ 50.00000000000000\n"
                  "$ns_ at 50.00000000000000  \"$node_(0) setdest 400.00000000000000 50.00000000000000 1.00000000000000\"\n"
@@ -520,5 +550,17 @@ public:
     t->AddReferencePoint ("0", 920.000, Vector (300.000,  650.000, 0.000), Vector (0.000, 0.000, 0.000));
     AddTestCase (t, TestCase::QUICK);
 
+    // Statements which are not sorted by time window are not streamed
+    t = new Ns2MobilityHelperTest ("unsorted statements", Seconds (4), 2, window);
+    t->SetTrace ("$ns_ at 2.0 \"$node_(0) setdest 5 0 5\"\n"
+                 "$ns_ at 1.0 \"$node_(1) setdest 0 5 5\"\n");
+    //                     id  t  position         velocity
+    t->AddReferencePoint ("0", 0, Vector (0, 0, 0), Vector (0, 0, 0));
+    t->AddReferencePoint ("1", 0, Vector (0, 0, 0), Vector (0, 0, 0));
+    t->AddReferencePoint ("1", 1, Vector (0, 0, 0), Vector (0, 5, 0));
+    t->AddReferencePoint ("0", 2, Vector (0, 0, 0), Vector (5, 0, 0));
+    t->AddReferencePoint ("1", 2, Vector (0, 5, 0), Vector (0, 0, 0));
+    t->AddReferencePoint ("0", 3, Vector (5, 0, 0), Vector (0, 0, 0));
+    AddTestCase (t, TestCase::QUICK);
   }
 } g_ns2TransmobilityHelperTestSuite;
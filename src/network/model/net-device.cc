@@ -43,4 +43,11 @@ NetDevice::~NetDevice ()
   NS_LOG_FUNCTION (this);
 }
 
+bool
+NetDevice::SupportsSegmentationOffload (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return false;
+}
+
 } // namespace ns3
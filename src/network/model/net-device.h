@@ -331,6 +331,17 @@ public:
    */
   virtual bool SupportsSendFrom (void) const = 0;
 
+  /**
+   * \return true if this interface accepts packets larger than its MTU
+   *         which carry a SegmentationOffloadTag and accounts for the
+   *         segment train on the wire, false otherwise.
+   *
+   * The default implementation returns false; such super-segments
+   * are then segmented in software by the sending transport protocol,
+   * or IP-fragmented when a router forwards them onto this device.
+   */
+  virtual bool SupportsSegmentationOffload (void) const;
+
 };
 
 } // namespace ns3
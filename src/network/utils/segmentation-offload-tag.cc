@@ -0,0 +1,126 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "segmentation-offload-tag.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("SegmentationOffloadTag");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (SegmentationOffloadTag)
+  ;
+
+TypeId
+SegmentationOffloadTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SegmentationOffloadTag")
+    .SetParent<Tag> ()
+    .AddConstructor<SegmentationOffloadTag> ()
+  ;
+  return tid;
+}
+TypeId
+SegmentationOffloadTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+uint32_t
+SegmentationOffloadTag::GetSerializedSize (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return 8;
+}
+void
+SegmentationOffloadTag::Serialize (TagBuffer buf) const
+{
+  NS_LOG_FUNCTION (this << &buf);
+  buf.WriteU32 (m_segmentSize);
+  buf.WriteU32 (m_payloadSize);
+}
+void
+SegmentationOffloadTag::Deserialize (TagBuffer buf)
+{
+  NS_LOG_FUNCTION (this << &buf);
+  m_segmentSize = buf.ReadU32 ();
+  m_payloadSize = buf.ReadU32 ();
+}
+void
+SegmentationOffloadTag::Print (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this << &os);
+  os << "SegmentSize=" << m_segmentSize << " PayloadSize=" << m_payloadSize;
+}
+SegmentationOffloadTag::SegmentationOffloadTag ()
+  : Tag (),
+    m_segmentSize (0),
+    m_payloadSize (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+SegmentationOffloadTag::SegmentationOffloadTag (uint32_t segmentSize, uint32_t payloadSize)
+  : Tag (),
+    m_segmentSize (segmentSize),
+    m_payloadSize (payloadSize)
+{
+  NS_LOG_FUNCTION (this << segmentSize << payloadSize);
+}
+
+void
+SegmentationOffloadTag::SetSegmentSize (uint32_t segmentSize)
+{
+  NS_LOG_FUNCTION (this << segmentSize);
+  m_segmentSize = segmentSize;
+}
+uint32_t
+SegmentationOffloadTag::GetSegmentSize (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_segmentSize;
+}
+void
+SegmentationOffloadTag::SetPayloadSize (uint32_t payloadSize)
+{
+  NS_LOG_FUNCTION (this << payloadSize);
+  m_payloadSize = payloadSize;
+}
+uint32_t
+SegmentationOffloadTag::GetPayloadSize (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_payloadSize;
+}
+uint32_t
+SegmentationOffloadTag::GetSegmentCount (void) const
+{
+  NS_LOG_FUNCTION (this);
+  if (m_segmentSize == 0 || m_payloadSize == 0)
+    {
+      return 1;
+    }
+  return (m_payloadSize + m_segmentSize - 1) / m_segmentSize;
+}
+uint32_t
+SegmentationOffloadTag::GetWireSize (uint32_t frameSize) const
+{
+  NS_LOG_FUNCTION (this << frameSize);
+  NS_ASSERT (frameSize >= m_payloadSize);
+  uint32_t overhead = frameSize - m_payloadSize;
+  return frameSize + (GetSegmentCount () - 1) * overhead;
+}
+
+} // namespace ns3
+
@@ -0,0 +1,90 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef SEGMENTATION_OFFLOAD_TAG_H
+#define SEGMENTATION_OFFLOAD_TAG_H
+
+#include "ns3/tag.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ *
+ * \brief Marks a packet as a transport super-segment (TSO/GSO).
+ *
+ * A transport protocol which hands down a payload larger than its
+ * segment size attaches this tag to the payload before adding its
+ * own header.  The tag records the segment size and the payload size,
+ * which is enough for a NetDevice that supports segmentation offload
+ * (see NetDevice::SupportsSegmentationOffload) to compute the number
+ * of bytes the equivalent train of segments would occupy on the wire:
+ * every segment carries a copy of all the headers found in front of
+ * the payload.  The packet itself is never split; the receiver sees a
+ * single coalesced segment.
+ */
+class SegmentationOffloadTag : public Tag
+{
+public:
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer buf) const;
+  virtual void Deserialize (TagBuffer buf);
+  virtual void Print (std::ostream &os) const;
+  SegmentationOffloadTag ();
+
+  /**
+   * \param segmentSize the maximum payload carried by one segment
+   * \param payloadSize the total payload of the super-segment
+   */
+  SegmentationOffloadTag (uint32_t segmentSize, uint32_t payloadSize);
+
+  /**
+   * \param segmentSize the maximum payload carried by one segment
+   */
+  void SetSegmentSize (uint32_t segmentSize);
+  /**
+   * \returns the maximum payload carried by one segment
+   */
+  uint32_t GetSegmentSize (void) const;
+  /**
+   * \param payloadSize the total payload of the super-segment
+   */
+  void SetPayloadSize (uint32_t payloadSize);
+  /**
+   * \returns the total payload of the super-segment
+   */
+  uint32_t GetPayloadSize (void) const;
+  /**
+   * \returns the number of segments the payload is split into on the wire
+   */
+  uint32_t GetSegmentCount (void) const;
+  /**
+   * \param frameSize the size of the super-segment once all the headers
+   *        (and trailers) of the sending device have been added
+   * \returns the number of bytes the segment train occupies on the wire
+   *
+   * The per-segment overhead is frameSize minus the payload size.
+   */
+  uint32_t GetWireSize (uint32_t frameSize) const;
+private:
+  uint32_t m_segmentSize;
+  uint32_t m_payloadSize;
+};
+
+} // namespace ns3
+
+#endif /* SEGMENTATION_OFFLOAD_TAG_H */
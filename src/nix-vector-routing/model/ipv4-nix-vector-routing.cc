@@ -25,6 +25,12 @@
 #include "ns3/abort.h"
 #include "ns3/names.h"
 #include "ns3/ipv4-list-routing.h"
+#include "ns3/global-value.h"
+#include "ns3/uinteger.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
 
 #include "ipv4-nix-vector-routing.h"
 
@@ -35,6 +41,111 @@ namespace ns3 {
 NS_OBJECT_ENSURE_REGISTERED (Ipv4NixVectorRouting)
   ;
 
+static GlobalValue g_nixVectorCacheSize ("NixVectorCacheSize",
+                                         "The maximum number of source/destination entries "
+                                         "of the nix-vector cache shared by all the nodes, 0 for no limit",
+                                         UintegerValue (0),
+                                         MakeUintegerChecker<uint32_t> ());
+
+Ipv4NixVectorRouting::NixCache_t Ipv4NixVectorRouting::g_nixCache;
+Ipv4NixVectorRouting::NixCacheLru_t Ipv4NixVectorRouting::g_nixCacheLru;
+std::map<Ipv4Address, uint32_t> Ipv4NixVectorRouting::g_addressToNode;
+uint32_t Ipv4NixVectorRouting::g_epoch = 0;
+
+/**
+ * \internal
+ * Plain copy of the topology, enough to run the nix-vector BFS
+ * without touching any Ptr, so that it can be run in parallel.
+ */
+struct NixTopologySnapshot
+{
+  /* neighbors of each node, in the order BFS visits them
+   * (down interfaces and links are left out) */
+  std::vector<std::vector<uint32_t> > bfsNeighbors;
+  /* neighbors of each node, in nix index order */
+  std::vector<std::vector<uint32_t> > nixNeighbors;
+};
+
+/**
+ * \internal
+ * Computes, for a range of sources, the hops of the nix-vectors to
+ * every other node: pairs of (neighbor index, number of neighbors),
+ * from the destination back to the source, as BuildNixVector adds them.
+ */
+class NixPrecomputeWorker
+{
+public:
+  typedef std::vector<std::pair<uint32_t, uint32_t> > Hops_t;
+
+  NixPrecomputeWorker (const NixTopologySnapshot *topology, uint32_t begin, uint32_t end)
+    : m_topology (topology),
+      m_begin (begin),
+      m_end (end)
+  {
+  }
+
+  void Run (void)
+  {
+    uint32_t nNodes = m_topology->bfsNeighbors.size ();
+    m_hops.resize ((m_end - m_begin) * nNodes);
+    std::vector<uint32_t> parent (nNodes);
+    std::vector<uint32_t> queue;
+    queue.reserve (nNodes);
+    for (uint32_t source = m_begin; source < m_end; source++)
+      {
+        std::fill (parent.begin (), parent.end (), nNodes);
+        queue.clear ();
+        queue.push_back (source);
+        parent[source] = source;
+        for (uint32_t head = 0; head < queue.size (); head++)
+          {
+            const std::vector<uint32_t> &neighbors = m_topology->bfsNeighbors[queue[head]];
+            for (std::vector<uint32_t>::const_iterator i = neighbors.begin (); i != neighbors.end (); i++)
+              {
+                if (parent[*i] == nNodes)
+                  {
+                    parent[*i] = queue[head];
+                    queue.push_back (*i);
+                  }
+              }
+          }
+        for (uint32_t dest = 0; dest < nNodes; dest++)
+          {
+            if (dest == source || parent[dest] == nNodes)
+              {
+                continue;
+              }
+            Hops_t &hops = m_hops[(source - m_begin) * nNodes + dest];
+            for (uint32_t node = dest; node != source; node = parent[node])
+              {
+                // the last neighbor index matching wins, as in BuildNixVector
+                const std::vector<uint32_t> &neighbors = m_topology->nixNeighbors[parent[node]];
+                uint32_t index = 0;
+                for (uint32_t j = 0; j < neighbors.size (); j++)
+                  {
+                    if (neighbors[j] == node)
+                      {
+                        index = j;
+                      }
+                  }
+                hops.push_back (std::make_pair (index, static_cast<uint32_t> (neighbors.size ())));
+              }
+          }
+      }
+  }
+
+  const Hops_t & GetHops (uint32_t source, uint32_t dest) const
+  {
+    return m_hops[(source - m_begin) * m_topology->bfsNeighbors.size () + dest];
+  }
+
+private:
+  const NixTopologySnapshot *m_topology;
+  uint32_t m_begin;
+  uint32_t m_end;
+  std::vector<Hops_t> m_hops;
+};
+
 TypeId 
 Ipv4NixVectorRouting::GetTypeId (void)
 {
@@ -46,7 +157,8 @@ Ipv4NixVectorRouting::GetTypeId (void)
 }
 
 Ipv4NixVectorRouting::Ipv4NixVectorRouting ()
-  : m_totalNeighbors (0)
+  : m_epoch (g_epoch),
+    m_totalNeighbors (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -73,6 +185,8 @@ Ipv4NixVectorRouting::DoDispose ()
 
   m_node = 0;
   m_ipv4 = 0;
+  // the shared caches refer to the nodes of this simulation
+  FlushGlobalNixRoutingCache ();
 
   Ipv4RoutingProtocol::DoDispose ();
 }
@@ -90,26 +204,219 @@ void
 Ipv4NixVectorRouting::FlushGlobalNixRoutingCache ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
+  NS_LOG_LOGIC ("Flushing Nix caches.");
+  g_nixCache.clear ();
+  g_nixCacheLru.clear ();
+  g_addressToNode.clear ();
+  // the per node caches notice the epoch change on their next use
+  g_epoch++;
+}
+
+void
+Ipv4NixVectorRouting::CheckCacheStateAndFlush ()
+{
+  if (m_epoch != g_epoch)
     {
-      Ptr<Node> node = *i;
-      Ptr<Ipv4NixVectorRouting> rp = node->GetObject<Ipv4NixVectorRouting> ();
-      if (!rp)
+      FlushIpv4RouteCache ();
+      m_totalNeighbors = 0;
+      m_epoch = g_epoch;
+    }
+}
+
+uint32_t
+Ipv4NixVectorRouting::GetNixCacheSize ()
+{
+  return g_nixCache.size ();
+}
+
+bool
+Ipv4NixVectorRouting::InsertNixVectorInCache (uint32_t source, Ipv4Address address, Ptr<NixVector> nixVector, bool evict)
+{
+  UintegerValue maxSize;
+  g_nixVectorCacheSize.GetValue (maxSize);
+  if (maxSize.Get () != 0)
+    {
+      while (g_nixCache.size () >= maxSize.Get ())
         {
-          continue;
+          if (!evict)
+            {
+              return false;
+            }
+          NS_LOG_LOGIC ("Evicting least recently used nix-vector");
+          g_nixCache.erase (g_nixCacheLru.front ());
+          g_nixCacheLru.pop_front ();
         }
-      NS_LOG_LOGIC ("Flushing Nix caches.");
-      rp->FlushNixCache ();
-      rp->FlushIpv4RouteCache ();
     }
+
+  NixCacheKey_t key (source, address);
+  std::pair<NixCache_t::iterator, bool> inserted = g_nixCache.insert (NixCache_t::value_type (key, NixCacheEntry_t ()));
+  if (inserted.second)
+    {
+      inserted.first->second.lru = g_nixCacheLru.insert (g_nixCacheLru.end (), key);
+    }
+  else
+    {
+      g_nixCacheLru.splice (g_nixCacheLru.end (), g_nixCacheLru, inserted.first->second.lru);
+    }
+  inserted.first->second.nixVector = nixVector;
+  return true;
 }
 
 void
-Ipv4NixVectorRouting::FlushNixCache ()
+Ipv4NixVectorRouting::PrecomputeNixVectors (uint32_t nThreads)
 {
-  NS_LOG_FUNCTION_NOARGS ();
-  m_nixCache.clear ();
+  NS_LOG_FUNCTION (nThreads);
+
+  uint32_t nNodes = NodeList::GetNNodes ();
+  NixTopologySnapshot topology;
+  topology.bfsNeighbors.resize (nNodes);
+  topology.nixNeighbors.resize (nNodes);
+  std::vector<std::vector<Ipv4Address> > addresses (nNodes);
+  std::vector<bool> hasNixRouting (nNodes, false);
+
+  // take a snapshot of the topology, following the same rules
+  // as BFS and BuildNixVector
+  for (uint32_t n = 0; n < nNodes; n++)
+    {
+      Ptr<Node> node = NodeList::GetNode (n);
+      Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+      hasNixRouting[n] = (node->GetObject<Ipv4NixVectorRouting> () != 0);
+      for (uint32_t i = 0; i < node->GetNDevices (); i++)
+        {
+          Ptr<NetDevice> localNetDevice = node->GetDevice (i);
+          Ptr<Channel> channel = localNetDevice->GetChannel ();
+          if (channel == 0)
+            {
+              continue;
+            }
+          NetDeviceContainer netDeviceContainer;
+          GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
+
+          bool usable = localNetDevice->IsLinkUp ();
+          if (ipv4)
+            {
+              usable = usable && ipv4->IsUp (ipv4->GetInterfaceForDevice (localNetDevice));
+            }
+          for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
+            {
+              uint32_t remote = (*iter)->GetNode ()->GetId ();
+              if (usable)
+                {
+                  topology.bfsNeighbors[n].push_back (remote);
+                }
+              if (!localNetDevice->IsBridge ())
+                {
+                  topology.nixNeighbors[n].push_back (remote);
+                }
+            }
+        }
+      if (ipv4)
+        {
+          for (uint32_t i = 0; i < ipv4->GetNInterfaces (); i++)
+            {
+              for (uint32_t j = 0; j < ipv4->GetNAddresses (i); j++)
+                {
+                  Ipv4Address address = ipv4->GetAddress (i, j).GetLocal ();
+                  if (address != Ipv4Address::GetLoopback ()
+                      && GetNodeByIp (address) == node)
+                    {
+                      addresses[n].push_back (address);
+                    }
+                }
+            }
+        }
+    }
+
+  if (nThreads == 0)
+    {
+      nThreads = 1;
+    }
+#ifndef HAVE_PTHREAD_H
+  nThreads = 1;
+#endif
+
+  // process the sources in rounds, to bound the memory used by the
+  // results waiting to be inserted in the cache
+  const uint32_t sourcesPerThread = 4;
+  for (uint32_t first = 0; first < nNodes; first += nThreads * sourcesPerThread)
+    {
+      std::vector<NixPrecomputeWorker *> workers;
+      for (uint32_t t = 0; t < nThreads; t++)
+        {
+          uint32_t begin = std::min (nNodes, first + t * sourcesPerThread);
+          uint32_t end = std::min (nNodes, begin + sourcesPerThread);
+          if (begin < end)
+            {
+              workers.push_back (new NixPrecomputeWorker (&topology, begin, end));
+            }
+        }
+#ifdef HAVE_PTHREAD_H
+      if (workers.size () > 1)
+        {
+          std::vector<Ptr<SystemThread> > threads;
+          for (uint32_t t = 0; t < workers.size (); t++)
+            {
+              threads.push_back (Create<SystemThread> (MakeCallback (&NixPrecomputeWorker::Run, workers[t])));
+              threads.back ()->Start ();
+            }
+          for (uint32_t t = 0; t < threads.size (); t++)
+            {
+              threads[t]->Join ();
+            }
+        }
+      else
+#endif
+        {
+          for (uint32_t t = 0; t < workers.size (); t++)
+            {
+              workers[t]->Run ();
+            }
+        }
+
+      bool full = false;
+      uint32_t source = first;
+      for (uint32_t t = 0; t < workers.size () && !full; t++)
+        {
+          for (uint32_t s = 0; s < sourcesPerThread && source < nNodes && !full; s++, source++)
+            {
+              if (!hasNixRouting[source])
+                {
+                  continue;
+                }
+              for (uint32_t dest = 0; dest < nNodes && !full; dest++)
+                {
+                  const NixPrecomputeWorker::Hops_t &hops = workers[t]->GetHops (source, dest);
+                  if (hops.empty () || addresses[dest].empty ())
+                    {
+                      continue;
+                    }
+                  Ptr<NixVector> nixVector = Create<NixVector> ();
+                  for (NixPrecomputeWorker::Hops_t::const_iterator h = hops.begin (); h != hops.end (); h++)
+                    {
+                      nixVector->AddNeighborIndex (h->first, nixVector->BitCount (h->second));
+                    }
+                  // all the addresses of a node share the same nix-vector
+                  for (std::vector<Ipv4Address>::const_iterator a = addresses[dest].begin (); a != addresses[dest].end (); a++)
+                    {
+                      if (!InsertNixVectorInCache (source, *a, nixVector, false))
+                        {
+                          NS_LOG_WARN ("Nix-vector cache full, precomputation stopped");
+                          full = true;
+                          break;
+                        }
+                    }
+                }
+            }
+        }
+      for (uint32_t t = 0; t < workers.size (); t++)
+        {
+          delete workers[t];
+        }
+      if (full)
+        {
+          break;
+        }
+    }
 }
 
 void
@@ -169,11 +476,13 @@ Ipv4NixVectorRouting::GetNixVectorInCache (Ipv4Address address)
 {
   NS_LOG_FUNCTION_NOARGS ();
 
-  NixMap_t::iterator iter = m_nixCache.find (address);
-  if (iter != m_nixCache.end ())
+  NixCache_t::iterator iter = g_nixCache.find (NixCacheKey_t (m_node->GetId (), address));
+  if (iter != g_nixCache.end ())
     {
       NS_LOG_LOGIC ("Found Nix-vector in cache.");
-      return iter->second;
+      // most recently used goes last
+      g_nixCacheLru.splice (g_nixCacheLru.end (), g_nixCacheLru, iter->second.lru);
+      return iter->second.nixVector;
     }
 
   // not in cache
@@ -341,27 +650,37 @@ Ipv4NixVectorRouting::GetNodeByIp (Ipv4Address dest)
 { 
   NS_LOG_FUNCTION_NOARGS ();
 
-  NodeContainer allNodes = NodeContainer::GetGlobal ();
-  Ptr<Node> destNode;
-
-  for (NodeContainer::Iterator i = allNodes.Begin (); i != allNodes.End (); ++i)
+  // index the addresses of all the nodes once, the index is
+  // flushed along with the caches when addresses change
+  if (g_addressToNode.empty ())
     {
-      Ptr<Node> node = *i;
-      Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-      if (ipv4->GetInterfaceForAddress (dest) != -1)
+      NodeContainer allNodes = NodeContainer::GetGlobal ();
+      for (NodeContainer::Iterator i = allNodes.Begin (); i != allNodes.End (); ++i)
         {
-          destNode = node;
-          break;
+          Ptr<Ipv4> ipv4 = (*i)->GetObject<Ipv4> ();
+          if (!ipv4)
+            {
+              continue;
+            }
+          for (uint32_t j = 0; j < ipv4->GetNInterfaces (); j++)
+            {
+              for (uint32_t k = 0; k < ipv4->GetNAddresses (j); k++)
+                {
+                  // the first node owning an address wins
+                  g_addressToNode.insert (std::make_pair (ipv4->GetAddress (j, k).GetLocal (), (*i)->GetId ()));
+                }
+            }
         }
     }
 
-  if (!destNode)
+  std::map<Ipv4Address, uint32_t>::const_iterator it = g_addressToNode.find (dest);
+  if (it == g_addressToNode.end ())
     {
       NS_LOG_ERROR ("Couldn't find dest node given the IP" << dest);
       return 0;
     }
 
-  return destNode;
+  return NodeList::GetNode (it->second);
 }
 
 uint32_t
@@ -396,7 +715,7 @@ Ipv4NixVectorRouting::FindTotalNeighbors ()
 }
 
 Ptr<BridgeNetDevice>
-Ipv4NixVectorRouting::NetDeviceIsBridged (Ptr<NetDevice> nd) const
+Ipv4NixVectorRouting::NetDeviceIsBridged (Ptr<NetDevice> nd)
 {
   NS_LOG_FUNCTION (nd);
 
@@ -490,6 +809,7 @@ Ipv4NixVectorRouting::RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<
   Ptr<NixVector> nixVectorForPacket;
 
   NS_LOG_DEBUG ("Dest IP from header: " << header.GetDestination ());
+  CheckCacheStateAndFlush ();
   // check if cache
   nixVectorInCache = GetNixVectorInCache (header.GetDestination ());
 
@@ -502,7 +822,7 @@ Ipv4NixVectorRouting::RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<
       nixVectorInCache = GetNixVector (m_node, header.GetDestination (), oif);
 
       // cache it
-      m_nixCache.insert (NixMap_t::value_type (header.GetDestination (), nixVectorInCache));
+      InsertNixVectorInCache (m_node->GetId (), header.GetDestination (), nixVectorInCache, true);
     }
 
   // path exists
@@ -617,6 +937,8 @@ Ipv4NixVectorRouting::RouteInput (Ptr<const Packet> p, const Ipv4Header &header,
   // If nixVector isn't in packet, something went wrong
   NS_ASSERT (nixVector);
 
+  CheckCacheStateAndFlush ();
+
   // Get the interface number that we go out of, by extracting
   // from the nix-vector
   if (m_totalNeighbors == 0)
@@ -666,19 +988,25 @@ Ipv4NixVectorRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream) const
 
   std::ostream* os = stream->GetStream ();
   *os << "NixCache:" << std::endl;
-  if (m_nixCache.size () > 0)
+  // the entries of this node are contiguous in the shared cache
+  NixCache_t::const_iterator it = g_nixCache.lower_bound (NixCacheKey_t (m_node->GetId (), Ipv4Address ((uint32_t) 0)));
+  if (it != g_nixCache.end () && it->first.first == m_node->GetId ())
     {
       *os << "Destination     NixVector" << std::endl;
-      for (NixMap_t::const_iterator it = m_nixCache.begin (); it != m_nixCache.end (); it++)
+      for (; it != g_nixCache.end () && it->first.first == m_node->GetId (); it++)
         {
           std::ostringstream dest;
-          dest << it->first;
+          dest << it->first.second;
           *os << std::setiosflags (std::ios::left) << std::setw (16) << dest.str ();
-          *os << *(it->second) << std::endl;
+          if (it->second.nixVector)
+            {
+              *os << *(it->second.nixVector);
+            }
+          *os << std::endl;
         }
     }
   *os << "Ipv4RouteCache:" << std::endl;
-  if (m_ipv4RouteCache.size () > 0)
+  if (m_epoch == g_epoch && m_ipv4RouteCache.size () > 0)
     {
       *os << "Destination     Gateway         Source            OutputDevice" << std::endl;
       for (Ipv4RouteMap_t::const_iterator it = m_ipv4RouteCache.begin (); it != m_ipv4RouteCache.end (); it++)
@@ -738,8 +1066,8 @@ Ipv4NixVectorRouting::BFS (uint32_t numberOfNodes, Ptr<Node> source,
 
   // reset the parent vector
   parentVector.clear ();
-  parentVector.reserve (sizeof (Ptr<Node>)*numberOfNodes);
-  parentVector.insert (parentVector.begin (), sizeof (Ptr<Node>)*numberOfNodes, 0); // initialize to 0
+  parentVector.reserve (numberOfNodes);
+  parentVector.insert (parentVector.begin (), numberOfNodes, 0); // initialize to 0
 
   // Add the source node to the queue, set its parent to itself 
   greyNodeList.push (source);
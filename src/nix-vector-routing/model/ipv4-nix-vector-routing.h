@@ -22,6 +22,8 @@
 #define IPV4_NIX_VECTOR_ROUTING_H
 
 #include <map>
+#include <list>
+#include <vector>
 
 #include "ns3/channel.h"
 #include "ns3/node-container.h"
@@ -48,6 +50,13 @@ typedef std::map<Ipv4Address, Ptr<Ipv4Route> > Ipv4RouteMap_t;
 /**
  * \ingroup nix-vector-routing
  * Nix-vector routing protocol
+ *
+ * Nix-vectors are cached in a single cache shared by all the nodes and
+ * keyed by (source node, destination address).  The cache holds at most
+ * NixVectorCacheSize entries (a GlobalValue, 0 meaning no limit), the
+ * least recently used entry being evicted first.  The Ipv4Route caches
+ * remain per node; all caches are invalidated at once, in constant
+ * time, on any topology change.
  */
 class Ipv4NixVectorRouting : public Ipv4RoutingProtocol
 {
@@ -70,26 +79,73 @@ public:
 
   /**
    * @brief Called when run-time link topology change occurs
-   * which iterates through the node list and flushes any
-   * nix vector caches
+   * which flushes the shared nix-vector cache and invalidates
+   * the Ipv4Route caches of all the nodes; also called when the
+   * protocol is disposed, so that the cache does not outlive the
+   * simulation
    *
    */
   void FlushGlobalNixRoutingCache (void);
 
+  /**
+   * @brief Compute the nix-vectors of all the source/destination pairs
+   * and store them in the shared cache.
+   *
+   * To be called once addresses have been assigned, typically just
+   * before Simulator::Run: any later topology change flushes the
+   * cache.  The breadth-first searches run in nThreads threads when
+   * threading is available.  Precomputation stops when the cache is
+   * full.
+   *
+   * @param nThreads the number of threads to use
+   */
+  static void PrecomputeNixVectors (uint32_t nThreads);
+
+  /**
+   * @returns the number of entries in the shared nix-vector cache
+   */
+  static uint32_t GetNixCacheSize (void);
+
 private:
-  /* flushes the cache which stores nix-vector based on
-   * destination IP */
-  void FlushNixCache (void);
+  /* key of the shared nix-vector cache: source node id and
+   * destination address */
+  typedef std::pair<uint32_t, Ipv4Address> NixCacheKey_t;
+
+  /* least recently used keys first */
+  typedef std::list<NixCacheKey_t> NixCacheLru_t;
+
+  struct NixCacheEntry_t
+  {
+    Ptr<NixVector> nixVector;
+    NixCacheLru_t::iterator lru;
+  };
+
+  typedef std::map<NixCacheKey_t, NixCacheEntry_t> NixCache_t;
+
+  /* the nix-vector cache shared by all the nodes */
+  static NixCache_t g_nixCache;
+  static NixCacheLru_t g_nixCacheLru;
+
+  /* destination address to node id, built on first use */
+  static std::map<Ipv4Address, uint32_t> g_addressToNode;
+
+  /* incremented on every topology change; per node state computed
+   * under another epoch is stale */
+  static uint32_t g_epoch;
+
+  /* inserts a nix-vector in the shared cache, evicting the least
+   * recently used entries if needed; returns false if the cache is full
+   * and evict is false */
+  static bool InsertNixVectorInCache (uint32_t source, Ipv4Address address, Ptr<NixVector> nixVector, bool evict);
+
+  /* flushes the per node state if the topology changed since
+   * it was computed */
+  void CheckCacheStateAndFlush (void);
 
   /* flushes the cache which stores the Ipv4 route
    * based on the destination IP */
   void FlushIpv4RouteCache (void);
 
-  /* upon a run-time topology change caches are
-   * flushed and the total number of neighbors is
-   * reset to zero */
-  void ResetTotalNeighbors (void);
-
   /*  takes in the source node and dest IP and calls GetNodeByIp,
    *  BFS, accounting for any output interface specified, and finally
    *  BuildNixVector to return the built nix-vector */
@@ -103,11 +159,10 @@ private:
 
   /* given a net-device returns all the adjacent net-devices,
    * essentially getting the neighbors on that channel */
-  void GetAdjacentNetDevices (Ptr<NetDevice>, Ptr<Channel>, NetDeviceContainer &);
+  static void GetAdjacentNetDevices (Ptr<NetDevice>, Ptr<Channel>, NetDeviceContainer &);
 
-  /* iterates through the node list and finds the one
-   * corresponding to the given Ipv4Address */
-  Ptr<Node> GetNodeByIp (Ipv4Address);
+  /* finds the node corresponding to the given Ipv4Address */
+  static Ptr<Node> GetNodeByIp (Ipv4Address);
 
   /* Recurses the parent vector, created by BFS and actually builds the nixvector */
   bool BuildNixVector (const std::vector< Ptr<Node> > & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector);
@@ -120,7 +175,7 @@ private:
   uint32_t FindTotalNeighbors (void);
 
   /* determine if the netdevice is bridged */
-  Ptr<BridgeNetDevice> NetDeviceIsBridged (Ptr<NetDevice> nd) const;
+  static Ptr<BridgeNetDevice> NetDeviceIsBridged (Ptr<NetDevice> nd);
 
 
   /* Nix index is with respect to the neighbors.  The net-device index must be
@@ -156,12 +211,12 @@ private:
   virtual void PrintRoutingTable (Ptr<OutputStreamWrapper> stream) const;
 
 
-  /* cache stores nix-vectors based on destination ip */
-  NixMap_t m_nixCache;
-
   /* cache stores Ipv4Routes based on destination ip */
   Ipv4RouteMap_t m_ipv4RouteCache;
 
+  /* value of g_epoch when the route cache was last flushed */
+  uint32_t m_epoch;
+
   Ptr<Ipv4> m_ipv4;
   Ptr<Node> m_node;
 
@@ -0,0 +1,393 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sstream>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/uinteger.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/bridge-net-device.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-nix-vector-helper.h"
+#include "ns3/ipv4-nix-vector-routing.h"
+
+using namespace ns3;
+
+/**
+ * Connect some nodes to a new channel
+ *
+ * \param nodes the nodes to connect
+ * \return the devices added to the nodes
+ */
+static NetDeviceContainer
+AddChannel (NodeContainer nodes)
+{
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  NetDeviceContainer devices;
+  for (NodeContainer::Iterator i = nodes.Begin (); i != nodes.End (); ++i)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      device->SetChannel (channel);
+      (*i)->AddDevice (device);
+      devices.Add (device);
+    }
+  return devices;
+}
+
+/**
+ * Build a topology with several shortest paths between most nodes:
+ * a 4x4 grid of routers (nodes 0 to 15) with a shared channel across
+ * its diagonal, two parallel links and a link down, a bridge (node 16)
+ * without IP joining node 3 to nodes 17 to 19, and a node (20) which
+ * cannot be reached.
+ *
+ * \return the nodes, with nix-vector routing and addresses
+ */
+static NodeContainer
+BuildTopology (void)
+{
+  NodeContainer nodes;
+  nodes.Create (21);
+  NodeContainer routers;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      if (i != 16)
+        {
+          routers.Add (nodes.Get (i));
+        }
+    }
+  Ipv4NixVectorHelper nixRouting;
+  InternetStackHelper internet;
+  internet.SetRoutingHelper (nixRouting);
+  internet.Install (routers);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.0.0.0", "255.255.255.0");
+  Ptr<NetDevice> downDevice;
+  for (uint32_t row = 0; row < 4; row++)
+    {
+      for (uint32_t col = 0; col < 4; col++)
+        {
+          uint32_t n = row * 4 + col;
+          if (col < 3)
+            {
+              NetDeviceContainer devices = AddChannel (NodeContainer (nodes.Get (n), nodes.Get (n + 1)));
+              address.Assign (devices);
+              address.NewNetwork ();
+              if (n == 5)
+                {
+                  downDevice = devices.Get (0);
+                }
+            }
+          if (row < 3)
+            {
+              address.Assign (AddChannel (NodeContainer (nodes.Get (n), nodes.Get (n + 4))));
+              address.NewNetwork ();
+            }
+        }
+    }
+  address.Assign (AddChannel (NodeContainer (nodes.Get (0), nodes.Get (5), nodes.Get (10), nodes.Get (15))));
+  address.NewNetwork ();
+  address.Assign (AddChannel (NodeContainer (nodes.Get (12), nodes.Get (13))));
+  address.NewNetwork ();
+
+  Ptr<Ipv4> ipv4 = downDevice->GetNode ()->GetObject<Ipv4> ();
+  ipv4->SetDown (ipv4->GetInterfaceForDevice (downDevice));
+
+  NetDeviceContainer left = AddChannel (NodeContainer (nodes.Get (3), nodes.Get (16), nodes.Get (17)));
+  NetDeviceContainer right = AddChannel (NodeContainer (nodes.Get (16), nodes.Get (18), nodes.Get (19)));
+  Ptr<BridgeNetDevice> bridge = CreateObject<BridgeNetDevice> ();
+  nodes.Get (16)->AddDevice (bridge);
+  bridge->AddBridgePort (left.Get (1));
+  bridge->AddBridgePort (right.Get (0));
+  NetDeviceContainer lan;
+  lan.Add (left.Get (0));
+  lan.Add (left.Get (2));
+  lan.Add (right.Get (1));
+  lan.Add (right.Get (2));
+  address.Assign (lan);
+  address.NewNetwork ();
+
+  address.Assign (AddChannel (NodeContainer (nodes.Get (20))));
+  return nodes;
+}
+
+/**
+ * Route a packet as a socket would
+ *
+ * \param source the sending node
+ * \param dest the destination address
+ * \return the route, or 0 if there is none
+ */
+static Ptr<Ipv4Route>
+Route (Ptr<Node> source, Ipv4Address dest)
+{
+  Ipv4Header header;
+  header.SetDestination (dest);
+  Socket::SocketErrno sockerr;
+  return source->GetObject<Ipv4> ()->GetRoutingProtocol ()->RouteOutput (Create<Packet> (), header, 0, sockerr);
+}
+
+/**
+ * \param node a node
+ * \return the nix-vectors cached for node, as printed in its routing table
+ */
+static std::string
+GetNixCache (Ptr<Node> node)
+{
+  std::ostringstream oss;
+  node->GetObject<Ipv4> ()->GetRoutingProtocol ()->PrintRoutingTable (Create<OutputStreamWrapper> (&oss));
+  std::string table = oss.str ();
+  return table.substr (0, table.find ("Ipv4RouteCache:"));
+}
+
+/**
+ * \param node a node
+ * \return the address of the first interface of node
+ */
+static Ipv4Address
+GetAddress (Ptr<Node> node)
+{
+  return node->GetObject<Ipv4> ()->GetAddress (1, 0).GetLocal ();
+}
+
+/**
+ * \ingroup nix-vector-routing
+ * Check that the shared nix-vector cache evicts its least recently used
+ * entry when it holds NixVectorCacheSize entries, and is cleared by
+ * Simulator::Destroy
+ */
+class Ipv4NixVectorCacheTestCase : public TestCase
+{
+public:
+  Ipv4NixVectorCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param dest a destination node
+   * \return true if the nix-vector from node 0 to dest is in the cache
+   */
+  bool IsCached (uint32_t dest) const;
+
+  NodeContainer m_nodes;  //!< the nodes of the topology
+};
+
+Ipv4NixVectorCacheTestCase::Ipv4NixVectorCacheTestCase ()
+  : TestCase ("Check the LRU eviction of the nix-vector cache")
+{
+}
+
+bool
+Ipv4NixVectorCacheTestCase::IsCached (uint32_t dest) const
+{
+  std::ostringstream entry;
+  entry << "\n" << GetAddress (m_nodes.Get (dest)) << " ";
+  return GetNixCache (m_nodes.Get (0)).find (entry.str ()) != std::string::npos;
+}
+
+void
+Ipv4NixVectorCacheTestCase::DoRun (void)
+{
+  Config::SetGlobal ("NixVectorCacheSize", UintegerValue (3));
+  m_nodes = BuildTopology ();
+
+  for (uint32_t dest = 1; dest <= 3; dest++)
+    {
+      NS_TEST_EXPECT_MSG_NE (Route (m_nodes.Get (0), GetAddress (m_nodes.Get (dest))), 0,
+                             "no route from node 0 to node " << dest);
+    }
+  NS_TEST_EXPECT_MSG_EQ (Ipv4NixVectorRouting::GetNixCacheSize (), 3, "the cache should be full");
+  // node 1 becomes the most recently used, node 2 the least
+  Route (m_nodes.Get (0), GetAddress (m_nodes.Get (1)));
+  Route (m_nodes.Get (0), GetAddress (m_nodes.Get (4)));
+  NS_TEST_EXPECT_MSG_EQ (Ipv4NixVectorRouting::GetNixCacheSize (), 3, "the cache should not grow beyond its size");
+  NS_TEST_EXPECT_MSG_EQ (IsCached (2), false, "the least recently used entry should have been evicted");
+  NS_TEST_EXPECT_MSG_EQ (IsCached (1), true, "a recently used entry should not have been evicted");
+  NS_TEST_EXPECT_MSG_EQ (IsCached (3), true, "a recently used entry should not have been evicted");
+  NS_TEST_EXPECT_MSG_EQ (IsCached (4), true, "the new entry should be in the cache");
+  Route (m_nodes.Get (0), GetAddress (m_nodes.Get (5)));
+  NS_TEST_EXPECT_MSG_EQ (IsCached (3), false, "the least recently used entry should have been evicted");
+  NS_TEST_EXPECT_MSG_EQ (IsCached (1), true, "a recently used entry should not have been evicted");
+
+  m_nodes = NodeContainer ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ (Ipv4NixVectorRouting::GetNixCacheSize (), 0, "the cache should not outlive the simulation");
+  Config::SetGlobal ("NixVectorCacheSize", UintegerValue (0));
+}
+
+/**
+ * \ingroup nix-vector-routing
+ * Check that PrecomputeNixVectors fills the cache with the nix-vectors
+ * computed on demand by RouteOutput, and stops when the cache is full
+ */
+class Ipv4NixVectorPrecomputeTestCase : public TestCase
+{
+public:
+  /**
+   * \param nThreads the number of threads of the precomputation
+   * \param cacheSize the size of the cache, 0 for no limit
+   */
+  Ipv4NixVectorPrecomputeTestCase (uint32_t nThreads, uint32_t cacheSize);
+
+private:
+  /**
+   * \param nThreads the number of threads of the precomputation
+   * \param cacheSize the size of the cache, 0 for no limit
+   * \return the name of the test case
+   */
+  static std::string BuildNameString (uint32_t nThreads, uint32_t cacheSize);
+  virtual void DoRun (void);
+  /**
+   * Route a packet from every node to every address
+   *
+   * \return the number of routes found
+   */
+  uint32_t RouteAll (void) const;
+  /**
+   * \return the routing tables of all the nodes
+   */
+  std::string PrintAll (void) const;
+
+  uint32_t m_nThreads;   //!< the number of threads of the precomputation
+  uint32_t m_cacheSize;  //!< the size of the cache, 0 for no limit
+  NodeContainer m_nodes; //!< the nodes of the topology
+};
+
+Ipv4NixVectorPrecomputeTestCase::Ipv4NixVectorPrecomputeTestCase (uint32_t nThreads, uint32_t cacheSize)
+  : TestCase (BuildNameString (nThreads, cacheSize)),
+    m_nThreads (nThreads),
+    m_cacheSize (cacheSize)
+{
+}
+
+std::string
+Ipv4NixVectorPrecomputeTestCase::BuildNameString (uint32_t nThreads, uint32_t cacheSize)
+{
+  std::ostringstream oss;
+  oss << "Check the nix-vectors precomputed in " << nThreads << " thread(s) against the on-demand ones";
+  if (cacheSize != 0)
+    {
+      oss << ", cache size " << cacheSize;
+    }
+  return oss.str ();
+}
+
+uint32_t
+Ipv4NixVectorPrecomputeTestCase::RouteAll (void) const
+{
+  uint32_t nRoutes = 0;
+  for (uint32_t source = 0; source < m_nodes.GetN (); source++)
+    {
+      if (m_nodes.Get (source)->GetObject<Ipv4NixVectorRouting> () == 0)
+        {
+          continue;
+        }
+      for (uint32_t dest = 0; dest < m_nodes.GetN (); dest++)
+        {
+          Ptr<Ipv4> ipv4 = m_nodes.Get (dest)->GetObject<Ipv4> ();
+          if (ipv4 == 0)
+            {
+              continue;
+            }
+          for (uint32_t i = 1; i < ipv4->GetNInterfaces (); i++)
+            {
+              if (Route (m_nodes.Get (source), ipv4->GetAddress (i, 0).GetLocal ()) != 0)
+                {
+                  nRoutes++;
+                }
+            }
+        }
+    }
+  return nRoutes;
+}
+
+std::string
+Ipv4NixVectorPrecomputeTestCase::PrintAll (void) const
+{
+  std::ostringstream oss;
+  for (uint32_t n = 0; n < m_nodes.GetN (); n++)
+    {
+      Ptr<Ipv4> ipv4 = m_nodes.Get (n)->GetObject<Ipv4> ();
+      if (ipv4 != 0)
+        {
+          oss << "Node " << n << "\n";
+          ipv4->GetRoutingProtocol ()->PrintRoutingTable (Create<OutputStreamWrapper> (&oss));
+        }
+    }
+  return oss.str ();
+}
+
+void
+Ipv4NixVectorPrecomputeTestCase::DoRun (void)
+{
+  Config::SetGlobal ("NixVectorCacheSize", UintegerValue (m_cacheSize));
+  m_nodes = BuildTopology ();
+  Ptr<Ipv4NixVectorRouting> routing = m_nodes.Get (0)->GetObject<Ipv4NixVectorRouting> ();
+
+  if (m_cacheSize == 0)
+    {
+      // every route computed on demand, unreachable ones included
+      uint32_t nRoutes = RouteAll ();
+      std::string onDemand = PrintAll ();
+
+      // the same, after the precomputation: no route should be computed
+      // again, and all of them should be identical
+      routing->FlushGlobalNixRoutingCache ();
+      Ipv4NixVectorRouting::PrecomputeNixVectors (m_nThreads);
+      NS_TEST_EXPECT_MSG_EQ (Ipv4NixVectorRouting::GetNixCacheSize (), nRoutes,
+                             "the precomputation should cache every route, and only them");
+      NS_TEST_EXPECT_MSG_EQ (RouteAll (), nRoutes, "the precomputed routes should be usable");
+      NS_TEST_EXPECT_MSG_EQ (PrintAll (), onDemand, "the precomputed routes should be the on-demand ones");
+    }
+  else
+    {
+      Ipv4NixVectorRouting::PrecomputeNixVectors (m_nThreads);
+      NS_TEST_EXPECT_MSG_EQ (Ipv4NixVectorRouting::GetNixCacheSize (), m_cacheSize,
+                             "the precomputation should stop when the cache is full");
+    }
+
+  m_nodes = NodeContainer ();
+  Simulator::Destroy ();
+  Config::SetGlobal ("NixVectorCacheSize", UintegerValue (0));
+}
+
+/**
+ * \ingroup nix-vector-routing
+ * Nix-vector routing test suite
+ */
+static class Ipv4NixVectorRoutingTestSuite : public TestSuite
+{
+public:
+  Ipv4NixVectorRoutingTestSuite ()
+    : TestSuite ("ipv4-nix-vector-routing", UNIT)
+  {
+    AddTestCase (new Ipv4NixVectorCacheTestCase (), TestCase::QUICK);
+    AddTestCase (new Ipv4NixVectorPrecomputeTestCase (1, 0), TestCase::QUICK);
+    AddTestCase (new Ipv4NixVectorPrecomputeTestCase (3, 0), TestCase::QUICK);
+    AddTestCase (new Ipv4NixVectorPrecomputeTestCase (4, 0), TestCase::QUICK);
+    AddTestCase (new Ipv4NixVectorPrecomputeTestCase (4, 50), TestCase::QUICK);
+  }
+} g_ipv4NixVectorRoutingTestSuite;
@@ -0,0 +1,48 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/abort.h"
+#include "ns3/point-to-point-net-device.h"
+#include "point-to-point-background-helper.h"
+
+namespace ns3 {
+
+PointToPointBackgroundHelper::PointToPointBackgroundHelper (DataRate rate)
+{
+  m_factory.SetTypeId ("ns3::PointToPointBackgroundFlow");
+  m_factory.Set ("DataRate", DataRateValue (rate));
+}
+
+void
+PointToPointBackgroundHelper::SetAttribute (std::string name, const AttributeValue &value)
+{
+  m_factory.Set (name, value);
+}
+
+Ptr<PointToPointBackgroundFlow>
+PointToPointBackgroundHelper::Install (NetDeviceContainer path) const
+{
+  Ptr<PointToPointBackgroundFlow> flow = m_factory.Create<PointToPointBackgroundFlow> ();
+  for (NetDeviceContainer::Iterator i = path.Begin (); i != path.End (); ++i)
+    {
+      Ptr<PointToPointNetDevice> device = (*i)->GetObject<PointToPointNetDevice> ();
+      NS_ABORT_MSG_IF (device == 0, "PointToPointBackgroundHelper::Install(): not a PointToPointNetDevice");
+      flow->AddDevice (device);
+    }
+  return flow;
+}
+
+} // namespace ns3
@@ -0,0 +1,65 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef POINT_TO_POINT_BACKGROUND_HELPER_H
+#define POINT_TO_POINT_BACKGROUND_HELPER_H
+
+#include <string>
+
+#include "ns3/object-factory.h"
+#include "ns3/net-device-container.h"
+#include "ns3/data-rate.h"
+#include "ns3/point-to-point-background-flow.h"
+
+namespace ns3 {
+
+/**
+ * \brief Create fluid background flows over point-to-point paths
+ *
+ * This helper plays, for fluid background traffic, the role the
+ * OnOffHelper plays for packet-level traffic.  Each flow created by
+ * Install offers its rate to every PointToPointNetDevice of the path,
+ * see PointToPointBackgroundFlow.
+ */
+class PointToPointBackgroundHelper
+{
+public:
+  /**
+   * \param rate the rate offered by each flow in the 'On' state
+   */
+  PointToPointBackgroundHelper (DataRate rate);
+
+  /**
+   * Helper function used to set the underlying flow attributes.
+   *
+   * \param name the name of the flow attribute to set
+   * \param value the value of the flow attribute to set
+   */
+  void SetAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * \param path the devices the flow goes through, in transmit direction;
+   *        all of them must be PointToPointNetDevice instances
+   * \returns the new flow, which still has to be started
+   */
+  Ptr<PointToPointBackgroundFlow> Install (NetDeviceContainer path) const;
+
+private:
+  ObjectFactory m_factory;
+};
+
+} // namespace ns3
+
+#endif /* POINT_TO_POINT_BACKGROUND_HELPER_H */
@@ -0,0 +1,191 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/pointer.h"
+#include "point-to-point-background-flow.h"
+#include "point-to-point-net-device.h"
+
+NS_LOG_COMPONENT_DEFINE ("PointToPointBackgroundFlow");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (PointToPointBackgroundFlow)
+  ;
+
+TypeId
+PointToPointBackgroundFlow::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PointToPointBackgroundFlow")
+    .SetParent<Object> ()
+    .AddConstructor<PointToPointBackgroundFlow> ()
+    .AddAttribute ("DataRate", "The rate offered in the 'On' state.",
+                   DataRateValue (DataRate ("500kb/s")),
+                   MakeDataRateAccessor (&PointToPointBackgroundFlow::m_rate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("OnTime", "A RandomVariableStream used to pick the duration of the 'On' state.",
+                   StringValue ("ns3::ConstantRandomVariable[Constant=1.0]"),
+                   MakePointerAccessor (&PointToPointBackgroundFlow::m_onTime),
+                   MakePointerChecker <RandomVariableStream>())
+    .AddAttribute ("OffTime", "A RandomVariableStream used to pick the duration of the 'Off' state.",
+                   StringValue ("ns3::ConstantRandomVariable[Constant=1.0]"),
+                   MakePointerAccessor (&PointToPointBackgroundFlow::m_offTime),
+                   MakePointerChecker <RandomVariableStream>())
+  ;
+  return tid;
+}
+
+PointToPointBackgroundFlow::PointToPointBackgroundFlow ()
+  : m_on (false),
+    m_running (false),
+    m_offered (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PointToPointBackgroundFlow::~PointToPointBackgroundFlow ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+PointToPointBackgroundFlow::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_startEvent.Cancel ();
+  m_stopEvent.Cancel ();
+  m_switchEvent.Cancel ();
+  m_devices.clear ();
+  Object::DoDispose ();
+}
+
+void
+PointToPointBackgroundFlow::AddDevice (Ptr<PointToPointNetDevice> device)
+{
+  NS_LOG_FUNCTION (this << device);
+  NS_ASSERT_MSG (!m_on, "Cannot change the path of a flow in the 'On' state");
+  m_devices.push_back (device);
+}
+
+void
+PointToPointBackgroundFlow::Start (Time start)
+{
+  NS_LOG_FUNCTION (this << start);
+  m_startEvent.Cancel ();
+  m_startEvent = Simulator::Schedule (start, &PointToPointBackgroundFlow::StartFlow,
+                                      Ptr<PointToPointBackgroundFlow> (this));
+}
+
+void
+PointToPointBackgroundFlow::Stop (Time stop)
+{
+  NS_LOG_FUNCTION (this << stop);
+  m_stopEvent.Cancel ();
+  m_stopEvent = Simulator::Schedule (stop, &PointToPointBackgroundFlow::StopFlow,
+                                     Ptr<PointToPointBackgroundFlow> (this));
+}
+
+bool
+PointToPointBackgroundFlow::IsOn (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_on;
+}
+
+int64_t
+PointToPointBackgroundFlow::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_onTime->SetStream (stream);
+  m_offTime->SetStream (stream + 1);
+  return 2;
+}
+
+void
+PointToPointBackgroundFlow::StartFlow (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_running)
+    {
+      return;
+    }
+  m_running = true;
+  SwitchOn ();
+}
+
+void
+PointToPointBackgroundFlow::StopFlow (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_running = false;
+  m_switchEvent.Cancel ();
+  if (m_on)
+    {
+      Offer (false);
+    }
+}
+
+void
+PointToPointBackgroundFlow::SwitchOn (void)
+{
+  NS_LOG_FUNCTION (this);
+  Offer (true);
+  m_switchEvent = Simulator::Schedule (Seconds (m_onTime->GetValue ()),
+                                       &PointToPointBackgroundFlow::SwitchOff,
+                                       Ptr<PointToPointBackgroundFlow> (this));
+}
+
+void
+PointToPointBackgroundFlow::SwitchOff (void)
+{
+  NS_LOG_FUNCTION (this);
+  Offer (false);
+  m_switchEvent = Simulator::Schedule (Seconds (m_offTime->GetValue ()),
+                                       &PointToPointBackgroundFlow::SwitchOn,
+                                       Ptr<PointToPointBackgroundFlow> (this));
+}
+
+void
+PointToPointBackgroundFlow::Offer (bool on)
+{
+  NS_LOG_FUNCTION (this << on);
+  NS_ASSERT (m_on != on);
+  m_on = on;
+  if (on)
+    {
+      // remember what we offered, in case DataRate changes meanwhile
+      m_offered = m_rate.GetBitRate ();
+    }
+  for (std::vector<Ptr<PointToPointNetDevice> >::const_iterator i = m_devices.begin ();
+       i != m_devices.end (); ++i)
+    {
+      uint64_t rate = (*i)->GetBackgroundRate ().GetBitRate ();
+      if (on)
+        {
+          rate += m_offered;
+        }
+      else
+        {
+          NS_ASSERT (rate >= m_offered);
+          rate -= m_offered;
+        }
+      (*i)->SetBackgroundRate (DataRate (rate));
+    }
+}
+
+} // namespace ns3
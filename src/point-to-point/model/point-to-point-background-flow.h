@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef POINT_TO_POINT_BACKGROUND_FLOW_H
+#define POINT_TO_POINT_BACKGROUND_FLOW_H
+
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "ns3/random-variable-stream.h"
+
+namespace ns3 {
+
+class PointToPointNetDevice;
+
+/**
+ * \ingroup point-to-point
+ * \class PointToPointBackgroundFlow
+ * \brief An on/off source of fluid background traffic.
+ *
+ * This is the fluid counterpart of an OnOffApplication: while in the
+ * 'On' state, the flow offers DataRate bits per second of background
+ * traffic to every PointToPointNetDevice along its path, and nothing
+ * while in the 'Off' state.  No packet is ever created, so the cost of
+ * a flow is two events per on/off cycle, whatever its rate.
+ *
+ * The flow is offered at the same rate to every hop: losses and
+ * queueing delay upstream are not reflected downstream.  Background
+ * traffic interacts with packet-level (foreground) traffic only
+ * through the backlog of each device, see
+ * PointToPointNetDevice::SetBackgroundRate.
+ *
+ * Pending events hold a reference to the flow, so a started flow
+ * stays alive until it is stopped.
+ */
+class PointToPointBackgroundFlow : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+
+  PointToPointBackgroundFlow ();
+  virtual ~PointToPointBackgroundFlow ();
+
+  /**
+   * \param device a device the flow goes through, in transmit direction
+   */
+  void AddDevice (Ptr<PointToPointNetDevice> device);
+
+  /**
+   * \param start time at which the flow starts, relative to now
+   */
+  void Start (Time start);
+
+  /**
+   * \param stop time at which the flow stops, relative to now
+   */
+  void Stop (Time stop);
+
+  /**
+   * \returns true if the flow is currently in the 'On' state
+   */
+  bool IsOn (void) const;
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.  Return the number of streams (possibly zero) that
+   * have been assigned.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  void StartFlow (void);
+  void StopFlow (void);
+  void SwitchOn (void);
+  void SwitchOff (void);
+  /**
+   * \param on true to add the rate of the flow to the devices, false to
+   *        remove it
+   */
+  void Offer (bool on);
+
+  std::vector<Ptr<PointToPointNetDevice> > m_devices;
+  DataRate m_rate;
+  Ptr<RandomVariableStream> m_onTime;
+  Ptr<RandomVariableStream> m_offTime;
+  bool m_on;
+  bool m_running;
+  uint64_t m_offered;
+  EventId m_startEvent;
+  EventId m_stopEvent;
+  EventId m_switchEvent;
+};
+
+} // namespace ns3
+
+#endif /* POINT_TO_POINT_BACKGROUND_FLOW_H */
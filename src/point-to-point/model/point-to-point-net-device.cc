@@ -25,6 +25,7 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
 #include "ns3/pointer.h"
+#include "ns3/segmentation-offload-tag.h"
 #include "point-to-point-net-device.h"
 #include "point-to-point-channel.h"
 #include "ppp-header.h"
@@ -67,6 +68,12 @@ PointToPointNetDevice::GetTypeId (void)
                    TimeValue (Seconds (0.0)),
                    MakeTimeAccessor (&PointToPointNetDevice::m_tInterframeGap),
                    MakeTimeChecker ())
+    .AddAttribute ("BackgroundQueueLimit", 
+                   "The maximum number of bytes of fluid background traffic plus queued "
+                   "packets, beyond which background fluid and packets are dropped",
+                   UintegerValue (150000),
+                   MakeUintegerAccessor (&PointToPointNetDevice::m_backgroundQueueLimit),
+                   MakeUintegerChecker<uint32_t> ())
 
     //
     // Transmit queueing discipline for the device which includes its own set
@@ -148,6 +155,11 @@ PointToPointNetDevice::PointToPointNetDevice ()
   :
     m_txMachineState (READY),
     m_channel (0),
+    m_backgroundRate (0),
+    m_backgroundBacklog (0),
+    m_backgroundUpdate (Seconds (0)),
+    m_backgroundDropped (0),
+    m_backgroundQueueLimit (0),
     m_linkUp (false),
     m_currentPkt (0)
 {
@@ -215,6 +227,7 @@ PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
   // schedule an event that will be executed when the transmission is complete.
   //
   NS_ASSERT_MSG (m_txMachineState == READY, "Must be READY to transmit");
+  UpdateBackground ();
   m_txMachineState = BUSY;
   m_currentPkt = p;
   m_phyTxBeginTrace (m_currentPkt);
@@ -222,6 +235,34 @@ PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
   Time txTime = Seconds (m_bps.CalculateTxTime (p->GetSize ()));
   Time txCompleteTime = txTime + m_tInterframeGap;
 
+  //
+  // A super-segment occupies the wire for as long as the train of segments
+  // it stands for, each of them carrying its own copy of the headers and
+  // followed by an interframe gap.
+  //
+  SegmentationOffloadTag offloadTag;
+  if (p->PeekPacketTag (offloadTag))
+    {
+      uint32_t nSegments = offloadTag.GetSegmentCount ();
+      txTime = Seconds (m_bps.CalculateTxTime (offloadTag.GetWireSize (p->GetSize ())))
+        + TimeStep (m_tInterframeGap.GetTimeStep () * (nSegments - 1));
+      txCompleteTime = txTime + m_tInterframeGap;
+    }
+
+  //
+  // The background fluid which is already waiting goes out first.  We do
+  // not model the wire going idle in between, so the packet simply takes
+  // that much longer to reach the other end.
+  //
+  if (m_backgroundBacklog > 0)
+    {
+      Time wait = Seconds (m_backgroundBacklog * 8 / m_bps.GetBitRate ());
+      NS_LOG_LOGIC ("Background backlog of " << m_backgroundBacklog << " bytes delays packet by " << wait);
+      m_backgroundBacklog = 0;
+      txTime += wait;
+      txCompleteTime += wait;
+    }
+
   NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << txCompleteTime.GetSeconds () << "sec");
   Simulator::Schedule (txCompleteTime, &PointToPointNetDevice::TransmitComplete, this);
 
@@ -245,6 +286,7 @@ PointToPointNetDevice::TransmitComplete (void)
   // next packet.
   //
   NS_ASSERT_MSG (m_txMachineState == BUSY, "Must be BUSY if transmitting");
+  UpdateBackground ();
   m_txMachineState = READY;
 
   NS_ASSERT_MSG (m_currentPkt != 0, "PointToPointNetDevice::TransmitComplete(): m_currentPkt zero");
@@ -345,6 +387,77 @@ PointToPointNetDevice::Receive (Ptr<Packet> packet)
     }
 }
 
+void
+PointToPointNetDevice::SetBackgroundRate (DataRate rate)
+{
+  NS_LOG_FUNCTION (this << rate);
+  UpdateBackground ();
+  m_backgroundRate = rate;
+}
+
+DataRate
+PointToPointNetDevice::GetBackgroundRate (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_backgroundRate;
+}
+
+double
+PointToPointNetDevice::GetBackgroundBacklog (void)
+{
+  NS_LOG_FUNCTION (this);
+  UpdateBackground ();
+  return m_backgroundBacklog;
+}
+
+double
+PointToPointNetDevice::GetBackgroundBytesDropped (void)
+{
+  NS_LOG_FUNCTION (this);
+  UpdateBackground ();
+  return m_backgroundDropped;
+}
+
+void
+PointToPointNetDevice::UpdateBackground (void)
+{
+  NS_LOG_FUNCTION (this);
+  Time now = Simulator::Now ();
+  double elapsed = (now - m_backgroundUpdate).GetSeconds ();
+  m_backgroundUpdate = now;
+  if (elapsed <= 0 || (m_backgroundRate.GetBitRate () == 0 && m_backgroundBacklog == 0))
+    {
+      return;
+    }
+
+  //
+  // The rates are constant since the last update, and the transmitter only
+  // drains the fluid while it is not busy sending a packet, so the backlog
+  // evolves linearly and clipping it at both ends is exact.
+  //
+  double backlog = m_backgroundBacklog + m_backgroundRate.GetBitRate () * elapsed / 8;
+  if (m_txMachineState == READY)
+    {
+      backlog -= m_bps.GetBitRate () * elapsed / 8;
+    }
+  if (backlog < 0)
+    {
+      backlog = 0;
+    }
+  uint32_t queued = m_queue ? m_queue->GetNBytes () : 0;
+  double limit = 0;
+  if (m_backgroundQueueLimit > queued)
+    {
+      limit = m_backgroundQueueLimit - queued;
+    }
+  if (backlog > limit)
+    {
+      m_backgroundDropped += backlog - limit;
+      backlog = limit;
+    }
+  m_backgroundBacklog = backlog;
+}
+
 Ptr<Queue>
 PointToPointNetDevice::GetQueue (void) const
 { 
@@ -487,6 +600,18 @@ PointToPointNetDevice::Send (
 
   m_macTxTrace (packet);
 
+  //
+  // Packets share the buffer with the background fluid.
+  //
+  UpdateBackground ();
+  if (m_backgroundBacklog > 0
+      && m_backgroundBacklog + m_queue->GetNBytes () + packet->GetSize () > m_backgroundQueueLimit)
+    {
+      NS_LOG_LOGIC ("Buffer full of background traffic, dropping packet");
+      m_macTxDropTrace (packet);
+      return false;
+    }
+
   //
   // If there's a transmission in progress, we enque the packet for later
   // transmission; otherwise we send it now.
@@ -562,6 +687,12 @@ PointToPointNetDevice::SupportsSendFrom (void) const
   return false;
 }
 
+bool
+PointToPointNetDevice::SupportsSegmentationOffload (void) const
+{
+  return true;
+}
+
 void
 PointToPointNetDevice::DoMpiReceive (Ptr<Packet> p)
 {
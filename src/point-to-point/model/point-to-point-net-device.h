@@ -144,6 +144,40 @@ public:
    */
   void Receive (Ptr<Packet> p);
 
+  /**
+   * Set the aggregate rate of the fluid background traffic offered to
+   * this device.
+   *
+   * Background traffic is not made of packets: it is a fluid which
+   * fills a backlog at the background rate and is drained at the device
+   * data rate whenever the transmitter is idle.  A packet which starts
+   * transmission first waits for the backlog in front of it to be
+   * drained, and a packet is dropped if the backlog and the queued
+   * packets would exceed the BackgroundQueueLimit attribute.  Fluid in
+   * excess of that limit is dropped.
+   *
+   * @see PointToPointBackgroundFlow
+   * @param rate the background rate
+   */
+  void SetBackgroundRate (DataRate rate);
+
+  /**
+   * @returns the aggregate rate of the fluid background traffic
+   */
+  DataRate GetBackgroundRate (void) const;
+
+  /**
+   * @returns the number of bytes of background fluid currently waiting
+   * for transmission
+   */
+  double GetBackgroundBacklog (void);
+
+  /**
+   * @returns the number of bytes of background fluid dropped so far
+   * because the backlog exceeded the BackgroundQueueLimit
+   */
+  double GetBackgroundBytesDropped (void);
+
   // The remaining methods are documented in ns3::NetDevice*
 
   virtual void SetIfIndex (const uint32_t index);
@@ -185,6 +219,13 @@ public:
   virtual void SetPromiscReceiveCallback (PromiscReceiveCallback cb);
   virtual bool SupportsSendFrom (void) const;
 
+  /**
+   * Is this device able to transmit transport super-segments?
+   *
+   * \returns True, a point-to-point link carries frames of any size.
+   */
+  virtual bool SupportsSegmentationOffload (void) const;
+
 protected:
   void DoMpiReceive (Ptr<Packet> p);
 
@@ -246,6 +287,12 @@ private:
    */
   void TransmitComplete (void);
 
+  /**
+   * Bring the background backlog up to date, given the background rate
+   * and the state of the transmitter since the last update.
+   */
+  void UpdateBackground (void);
+
   void NotifyLinkUp (void);
 
   /**
@@ -297,6 +344,31 @@ private:
    */
   Ptr<ErrorModel> m_receiveErrorModel;
 
+  /**
+   * The aggregate rate of the fluid background traffic
+   */
+  DataRate m_backgroundRate;
+
+  /**
+   * The background fluid waiting for transmission, in bytes
+   */
+  double m_backgroundBacklog;
+
+  /**
+   * The time m_backgroundBacklog was last brought up to date
+   */
+  Time m_backgroundUpdate;
+
+  /**
+   * The number of bytes of background fluid dropped so far
+   */
+  double m_backgroundDropped;
+
+  /**
+   * The limit, in bytes, of the background backlog plus the queued packets
+   */
+  uint32_t m_backgroundQueueLimit;
+
   /**
    * The trace source fired when packets come into the "top" of the device
    * at the L3/L2 transition, before being queued for transmission.
@@ -3,6 +3,11 @@
 #include "ns3/simulator.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
+#include "ns3/segmentation-offload-tag.h"
+#include "ns3/data-rate.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/point-to-point-background-helper.h"
 
 using namespace ns3;
 
@@ -56,6 +61,160 @@ PointToPointTest::DoRun (void)
   Simulator::Destroy ();
 }
 //-----------------------------------------------------------------------------
+class PointToPointSegmentationOffloadTest : public TestCase
+{
+public:
+  PointToPointSegmentationOffloadTest ();
+
+  virtual void DoRun (void);
+
+private:
+  void SendSuperSegment (Ptr<PointToPointNetDevice> device);
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from);
+
+  Time m_rxTime;
+  uint32_t m_rxSize;
+};
+
+PointToPointSegmentationOffloadTest::PointToPointSegmentationOffloadTest ()
+  : TestCase ("PointToPoint super-segment serialization time"),
+    m_rxSize (0)
+{
+}
+
+void
+PointToPointSegmentationOffloadTest::SendSuperSegment (Ptr<PointToPointNetDevice> device)
+{
+  // 4000 bytes of payload standing for four segments of 1000 bytes
+  Ptr<Packet> p = Create<Packet> (4000);
+  p->AddPacketTag (SegmentationOffloadTag (1000, 4000));
+  device->Send (p, device->GetBroadcast (), 0x800);
+}
+
+bool
+PointToPointSegmentationOffloadTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> p,
+                                              uint16_t protocol, const Address &from)
+{
+  m_rxTime = Simulator::Now ();
+  m_rxSize = p->GetSize ();
+  return true;
+}
+
+void
+PointToPointSegmentationOffloadTest::DoRun (void)
+{
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue> ());
+  devA->SetDataRate (DataRate ("8Mbps"));
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue> ());
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+  devB->SetReceiveCallback (MakeCallback (&PointToPointSegmentationOffloadTest::Receive, this));
+
+  NS_TEST_ASSERT_MSG_EQ (devA->SupportsSegmentationOffload (), true, "point-to-point devices segment super-segments");
+
+  Simulator::Schedule (Seconds (1.0), &PointToPointSegmentationOffloadTest::SendSuperSegment, this, devA);
+
+  Simulator::Run ();
+
+  // The super-segment is delivered in one piece, once the four 1002-byte
+  // PPP frames it stands for have been serialized at one byte per microsecond
+  NS_TEST_ASSERT_MSG_EQ (m_rxSize, 4000, "super-segment delivered as a single packet");
+  NS_TEST_ASSERT_MSG_EQ (m_rxTime, Seconds (1.0) + MicroSeconds (4008), "super-segment serialized as four frames");
+
+  Simulator::Destroy ();
+}
+//-----------------------------------------------------------------------------
+class PointToPointBackgroundTest : public TestCase
+{
+public:
+  PointToPointBackgroundTest ();
+
+  virtual void DoRun (void);
+
+private:
+  void SendPacket (Ptr<PointToPointNetDevice> device);
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from);
+
+  double m_backlog;
+  Time m_rxTime;
+};
+
+PointToPointBackgroundTest::PointToPointBackgroundTest ()
+  : TestCase ("PointToPoint fluid background traffic"),
+    m_backlog (0)
+{
+}
+
+void
+PointToPointBackgroundTest::SendPacket (Ptr<PointToPointNetDevice> device)
+{
+  m_backlog = device->GetBackgroundBacklog ();
+  Ptr<Packet> p = Create<Packet> (1000);
+  device->Send (p, device->GetBroadcast (), 0x800);
+}
+
+bool
+PointToPointBackgroundTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> p,
+                                     uint16_t protocol, const Address &from)
+{
+  m_rxTime = Simulator::Now ();
+  return true;
+}
+
+void
+PointToPointBackgroundTest::DoRun (void)
+{
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue> ());
+  devA->SetDataRate (DataRate ("8Mbps"));
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue> ());
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+  devB->SetReceiveCallback (MakeCallback (&PointToPointBackgroundTest::Receive, this));
+
+  // 12 Mbps of background traffic during 10 ms overloads the 8 Mbps link
+  PointToPointBackgroundHelper background (DataRate ("12Mbps"));
+  background.SetAttribute ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=0.01]"));
+  background.SetAttribute ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=100]"));
+  Ptr<PointToPointBackgroundFlow> flow = background.Install (NetDeviceContainer (devA));
+  flow->Start (Seconds (1.0));
+  flow->Stop (Seconds (2.0));
+
+  Simulator::Schedule (Seconds (1.01), &PointToPointBackgroundTest::SendPacket, this, devA);
+
+  Simulator::Run ();
+
+  // 4 Mbps in excess during 10 ms leave 5000 bytes of backlog, which take
+  // 5 ms to drain before the 1002-byte PPP frame is serialized
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_backlog, 5000, 1e-6, "backlog built up by the overload");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_rxTime.GetSeconds (), 1.016002, 1e-9, "packet waits for the backlog");
+  NS_TEST_ASSERT_MSG_EQ (devA->GetBackgroundBytesDropped (), 0, "backlog below the queue limit");
+  NS_TEST_ASSERT_MSG_EQ (devA->GetBackgroundRate ().GetBitRate (), 0, "flow stopped");
+
+  Simulator::Destroy ();
+}
+//-----------------------------------------------------------------------------
 class PointToPointTestSuite : public TestSuite
 {
 public:
@@ -66,6 +225,8 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointSegmentationOffloadTest, TestCase::QUICK);
+  AddTestCase (new PointToPointBackgroundTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite;
@@ -0,0 +1,135 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "cached-propagation-loss-model.h"
+#include "ns3/log.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/mobility-model.h"
+
+NS_LOG_COMPONENT_DEFINE ("CachedPropagationLossModel");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (CachedPropagationLossModel)
+  ;
+
+TypeId
+CachedPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CachedPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .AddConstructor<CachedPropagationLossModel> ()
+    .AddAttribute ("PropagationLossModel",
+                   "The deterministic loss model whose losses are stored.",
+                   StringValue ("ns3::LogDistancePropagationLossModel"),
+                   MakePointerAccessor (&CachedPropagationLossModel::m_model),
+                   MakePointerChecker<PropagationLossModel> ())
+  ;
+  return tid;
+}
+
+CachedPropagationLossModel::CachedPropagationLossModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+CachedPropagationLossModel::~CachedPropagationLossModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+CachedPropagationLossModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<Ptr<MobilityModel> >::const_iterator i = m_mobilities.begin ();
+       i != m_mobilities.end (); ++i)
+    {
+      (*i)->TraceDisconnectWithoutContext ("CourseChange",
+                                           MakeCallback (&CachedPropagationLossModel::NotifyCourseChange, this));
+    }
+  m_mobilities.clear ();
+  m_versions.clear ();
+  m_losses.clear ();
+  m_model = 0;
+  PropagationLossModel::DoDispose ();
+}
+
+uint32_t
+CachedPropagationLossModel::GetVersion (Ptr<MobilityModel> mobility) const
+{
+  Versions::const_iterator it = m_versions.find (PeekPointer (mobility));
+  if (it != m_versions.end ())
+    {
+      return it->second;
+    }
+  mobility->TraceConnectWithoutContext ("CourseChange",
+                                        MakeCallback (&CachedPropagationLossModel::NotifyCourseChange, this));
+  m_mobilities.push_back (mobility);
+  m_versions[PeekPointer (mobility)] = 0;
+  return 0;
+}
+
+void
+CachedPropagationLossModel::NotifyCourseChange (Ptr<const MobilityModel> mobility) const
+{
+  NS_LOG_FUNCTION (this << mobility);
+  // the stored losses of mobility are left in place, and recomputed
+  // when they are used again
+  m_versions[PeekPointer (mobility)]++;
+}
+
+double
+CachedPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                           Ptr<MobilityModel> a,
+                                           Ptr<MobilityModel> b) const
+{
+  uint32_t aVersion = GetVersion (a);
+  uint32_t bVersion = GetVersion (b);
+  std::pair<const MobilityModel *, const MobilityModel *> key (PeekPointer (a), PeekPointer (b));
+  Losses::const_iterator it = m_losses.find (key);
+  if (it != m_losses.end ()
+      && it->second.aVersion == aVersion
+      && it->second.bVersion == bVersion)
+    {
+      return txPowerDbm - it->second.loss;
+    }
+
+  double rxPowerDbm = m_model->CalcRxPower (txPowerDbm, a, b);
+  // a node which moves without a course change must not be stored
+  Vector aVelocity = a->GetVelocity ();
+  Vector bVelocity = b->GetVelocity ();
+  if (aVelocity.x == 0 && aVelocity.y == 0 && aVelocity.z == 0
+      && bVelocity.x == 0 && bVelocity.y == 0 && bVelocity.z == 0)
+    {
+      Loss loss;
+      loss.aVersion = aVersion;
+      loss.bVersion = bVersion;
+      loss.loss = txPowerDbm - rxPowerDbm;
+      m_losses[key] = loss;
+    }
+  return rxPowerDbm;
+}
+
+int64_t
+CachedPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  return m_model->AssignStreams (stream);
+}
+
+} // namespace ns3
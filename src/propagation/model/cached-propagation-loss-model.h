@@ -0,0 +1,104 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CACHED_PROPAGATION_LOSS_MODEL_H
+#define CACHED_PROPAGATION_LOSS_MODEL_H
+
+#include <map>
+#include <vector>
+#include "propagation-loss-model.h"
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Remember the loss of a deterministic loss model between two
+ * nodes which do not move
+ *
+ * The loss computed by the wrapped model (set with the
+ * PropagationLossModel attribute, possibly a chain of models) is stored
+ * for each (source, destination) pair of mobility models, and reused
+ * until one of them notifies a course change.  A loss is stored only if
+ * both nodes have a null velocity, so that nodes which move without
+ * notifying course changes (e.g., with a constant velocity) are always
+ * handed to the wrapped model.
+ *
+ * The wrapped model must thus be deterministic, and its loss must not
+ * depend on the transmission power.  Stochastic models (e.g., Nakagami
+ * fading or a random loss) must not be wrapped, but chained after this
+ * model with SetNext, so that they are evaluated for each transmission:
+ *
+ * \code
+ * Ptr<CachedPropagationLossModel> loss = CreateObject<CachedPropagationLossModel> ();
+ * loss->SetAttribute ("PropagationLossModel", PointerValue (CreateObject<LogDistancePropagationLossModel> ()));
+ * loss->SetNext (CreateObject<NakagamiPropagationLossModel> ());
+ * \endcode
+ */
+class CachedPropagationLossModel : public PropagationLossModel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  CachedPropagationLossModel ();
+  virtual ~CachedPropagationLossModel ();
+
+private:
+  CachedPropagationLossModel (const CachedPropagationLossModel &o);
+  CachedPropagationLossModel & operator = (const CachedPropagationLossModel &o);
+  virtual void DoDispose (void);
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+
+  /**
+   * \param mobility a mobility model
+   * \return the number of course changes of mobility since it was first
+   * seen by this model
+   */
+  uint32_t GetVersion (Ptr<MobilityModel> mobility) const;
+  /**
+   * Invalidate the losses stored for a mobility model.
+   *
+   * \param mobility the mobility model which changed its course
+   */
+  void NotifyCourseChange (Ptr<const MobilityModel> mobility) const;
+
+  /// a stored loss, with the versions of the mobility models it was computed with
+  struct Loss
+  {
+    uint32_t aVersion; //!< version of the source
+    uint32_t bVersion; //!< version of the destination
+    double loss;       //!< loss (dB)
+  };
+  /// the stored losses, indexed by source and destination
+  typedef std::map<std::pair<const MobilityModel *, const MobilityModel *>, Loss> Losses;
+  /// the versions of the mobility models seen so far
+  typedef std::map<const MobilityModel *, uint32_t> Versions;
+
+  Ptr<PropagationLossModel> m_model; //!< the wrapped loss model
+  mutable Losses m_losses;
+  mutable Versions m_versions;
+  /// the mobility models whose course changes are traced
+  mutable std::vector<Ptr<MobilityModel> > m_mobilities;
+};
+
+} // namespace ns3
+
+#endif /* CACHED_PROPAGATION_LOSS_MODEL_H */
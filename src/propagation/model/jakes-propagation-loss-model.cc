@@ -20,6 +20,7 @@
 
 #include "jakes-propagation-loss-model.h"
 #include "ns3/double.h"
+#include "ns3/uinteger.h"
 #include "ns3/log.h"
 
 NS_LOG_COMPONENT_DEFINE ("Jakes");
@@ -33,6 +34,7 @@ NS_OBJECT_ENSURE_REGISTERED (JakesPropagationLossModel)
 const double JakesPropagationLossModel::PI = 3.14159265358979323846;
 
 JakesPropagationLossModel::JakesPropagationLossModel()
+  : m_cacheSize (0)
 {
   m_uniformVariable = CreateObject<UniformRandomVariable> ();
   m_uniformVariable->SetAttribute ("Min", DoubleValue (-1.0 * PI));
@@ -48,6 +50,13 @@ JakesPropagationLossModel::GetTypeId ()
   static TypeId tid = TypeId ("ns3::JakesPropagationLossModel")
     .SetParent<PropagationLossModel> ()
     .AddConstructor<JakesPropagationLossModel> ()
+    .AddAttribute ("CacheSize",
+                   "The maximum number of paths whose fading process is kept, zero for no limit. "
+                   "The least recently used path is forgotten first, and gets a new fading process.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&JakesPropagationLossModel::SetCacheSize,
+                                         &JakesPropagationLossModel::GetCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -67,6 +76,19 @@ JakesPropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm + pathData->GetChannelGainDb ();
 }
 
+void
+JakesPropagationLossModel::SetCacheSize (uint32_t cacheSize)
+{
+  m_cacheSize = cacheSize;
+  m_propagationCache.SetMaxSize (cacheSize);
+}
+
+uint32_t
+JakesPropagationLossModel::GetCacheSize (void) const
+{
+  return m_cacheSize;
+}
+
 Ptr<UniformRandomVariable>
 JakesPropagationLossModel::GetUniformRandomVariable () const
 {
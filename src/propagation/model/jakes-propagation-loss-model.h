@@ -49,10 +49,18 @@ private:
                         Ptr<MobilityModel> b) const;
   virtual int64_t DoAssignStreams (int64_t stream);
   Ptr<UniformRandomVariable> GetUniformRandomVariable () const;
+  /**
+   * \param cacheSize the maximum number of paths whose fading process is
+   * kept, or zero for no limit
+   */
+  void SetCacheSize (uint32_t cacheSize);
+  /// \return the maximum number of paths whose fading process is kept
+  uint32_t GetCacheSize (void) const;
 
   Ptr<UniformRandomVariable> m_uniformVariable;
 private:
   mutable PropagationCache<JakesProcess> m_propagationCache;
+  uint32_t m_cacheSize;
 };
 
 } // namespace ns3
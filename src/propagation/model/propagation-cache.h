@@ -21,6 +21,9 @@
 #define PROPAGATION_CACHE_H_
 
 #include "ns3/mobility-model.h"
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
 #include <map>
 
 namespace ns3
@@ -30,61 +33,329 @@ namespace ns3
  * \brief Constructs a cache of objects, where each obect is responsible for a single propagation path loss calculations.
  * Propagation path a-->b and b-->a is the same thing. Propagation path is identified by
  * a couple of MobilityModels and a spectrum model UID
+ *
+ * The paths are stored in an open addressing hash table, so that looking
+ * a path up does not depend on the number of paths.  The number of paths
+ * can be bounded with SetMaxSize, in which case the least recently used
+ * path is evicted to make room for a new one.  The paths of the mobility
+ * models which are only referenced by the cache (e.g., because their node
+ * was destroyed) are removed when the table grows, or with Purge.
  */
 template<class T>
 class PropagationCache
 {
 public:
-  PropagationCache () {};
+  PropagationCache ()
+    : m_size (0),
+      m_maxSize (0),
+      m_mru (NONE),
+      m_lru (NONE),
+      m_hits (0),
+      m_misses (0),
+      m_evictions (0)
+  {
+  };
   ~PropagationCache () {};
   Ptr<T> GetPathData (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid)
   {
-    PropagationPathIdentifier key = PropagationPathIdentifier (a, b, modelUid);
-    typename PathCache::iterator it = m_pathCache.find (key);
-    if (it == m_pathCache.end ())
+    uint32_t slot = Find (PeekPointer (a), PeekPointer (b), modelUid);
+    if (slot == NONE)
       {
+        m_misses++;
         return 0;
       }
-    return it->second;
+    m_hits++;
+    uint32_t index = m_slots[slot];
+    if (m_maxSize != 0)
+      {
+        Unlink (index);
+        LinkFirst (index);
+      }
+    return m_entries[index].data;
   };
   void AddPathData (Ptr<T> data, Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid)
   {
-    PropagationPathIdentifier key = PropagationPathIdentifier (a, b, modelUid);
-    NS_ASSERT (m_pathCache.find (key) == m_pathCache.end ());
-    m_pathCache.insert (std::make_pair (key, data)); 
+    NS_ASSERT (Find (PeekPointer (a), PeekPointer (b), modelUid) == NONE);
+    if (m_maxSize != 0 && m_size >= m_maxSize)
+      {
+        m_evictions++;
+        RemoveEntry (m_lru);
+      }
+    if (2 * (m_size + 1) > m_slots.size ())
+      {
+        Purge ();
+        if (2 * (m_size + 1) > m_slots.size ())
+          {
+            Rehash (m_slots.empty () ? 16 : 2 * m_slots.size ());
+          }
+      }
+    uint32_t index;
+    if (m_free.empty ())
+      {
+        index = m_entries.size ();
+        m_entries.push_back (Entry ());
+      }
+    else
+      {
+        index = m_free.back ();
+        m_free.pop_back ();
+      }
+    Entry &entry = m_entries[index];
+    entry.a = std::min (PeekPointer (a), PeekPointer (b));
+    entry.b = std::max (PeekPointer (a), PeekPointer (b));
+    entry.uid = modelUid;
+    entry.data = data;
+    LinkFirst (index);
+    Reference (a);
+    Reference (b);
+    uint32_t slot = Hash (entry.a, entry.b, entry.uid) & (m_slots.size () - 1);
+    while (m_slots[slot] != NONE)
+      {
+        slot = (slot + 1) & (m_slots.size () - 1);
+      }
+    m_slots[slot] = index;
+    m_size++;
+  };
+  /**
+   * Remove all the paths of a mobility model.
+   *
+   * \param mobility the mobility model
+   */
+  void RemovePathData (Ptr<const MobilityModel> mobility)
+  {
+    const MobilityModel *key = PeekPointer (mobility);
+    for (uint32_t i = 0; i < m_entries.size (); i++)
+      {
+        if (m_entries[i].data != 0 && (m_entries[i].a == key || m_entries[i].b == key))
+          {
+            RemoveEntry (i);
+          }
+      }
+  };
+  /**
+   * Remove the paths of the mobility models which are only referenced by
+   * this cache.
+   */
+  void Purge (void)
+  {
+    std::vector<Ptr<const MobilityModel> > unused;
+    for (typename Mobilities::const_iterator i = m_mobilities.begin (); i != m_mobilities.end (); ++i)
+      {
+        if (i->second.first->GetReferenceCount () == 1)
+          {
+            unused.push_back (i->second.first);
+          }
+      }
+    for (typename std::vector<Ptr<const MobilityModel> >::const_iterator i = unused.begin (); i != unused.end (); ++i)
+      {
+        RemovePathData (*i);
+      }
+  };
+  /**
+   * \param maxSize the maximum number of paths, or zero for no limit
+   *
+   * If more than maxSize paths are stored, the least recently used ones
+   * are removed.
+   */
+  void SetMaxSize (uint32_t maxSize)
+  {
+    m_maxSize = maxSize;
+    while (m_maxSize != 0 && m_size > m_maxSize)
+      {
+        m_evictions++;
+        RemoveEntry (m_lru);
+      }
+  };
+  /// \return the number of paths
+  uint32_t GetSize (void) const
+  {
+    return m_size;
+  };
+  /// \return the number of lookups which found their path
+  uint64_t GetHits (void) const
+  {
+    return m_hits;
+  };
+  /// \return the number of lookups which did not find their path
+  uint64_t GetMisses (void) const
+  {
+    return m_misses;
+  };
+  /// \return the number of paths removed to honor the maximum size
+  uint64_t GetEvictions (void) const
+  {
+    return m_evictions;
+  };
+  /// \return the memory used by the cache itself, in bytes, not counting the path data
+  uint64_t GetMemoryUsage (void) const
+  {
+    return m_entries.capacity () * sizeof (Entry)
+           + m_slots.capacity () * sizeof (uint32_t)
+           + m_free.capacity () * sizeof (uint32_t)
+           + m_mobilities.size () * (sizeof (typename Mobilities::value_type) + 4 * sizeof (void *));
   };
 private:
-  /// Each path is identified by
-  struct PropagationPathIdentifier
-  {
-    PropagationPathIdentifier (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid) :
-      m_srcMobility (a), m_dstMobility (b), m_spectrumModelUid (modelUid)
-    {};
-    Ptr<const MobilityModel> m_srcMobility;
-    Ptr<const MobilityModel> m_dstMobility;
-    uint32_t m_spectrumModelUid;
-    bool operator < (const PropagationPathIdentifier & other) const
-    {
-      if (m_spectrumModelUid != other.m_spectrumModelUid)
-        {
-          return m_spectrumModelUid < other.m_spectrumModelUid;
-        }
-      /// Links are supposed to be symmetrical!
-      if (std::min (m_dstMobility, m_srcMobility) != std::min (other.m_dstMobility, other.m_srcMobility))
-        {
-          return std::min (m_dstMobility, m_srcMobility) < std::min (other.m_dstMobility, other.m_srcMobility);
-        }
-      if (std::max (m_dstMobility, m_srcMobility) != std::max (other.m_dstMobility, other.m_srcMobility))
-        {
-          return std::max (m_dstMobility, m_srcMobility) < std::max (other.m_dstMobility, other.m_srcMobility);
-        }
-      return false;
-    }
-  };
-  typedef std::map<PropagationPathIdentifier, Ptr<T> > PathCache;
-private:
-  PathCache m_pathCache;
+  /// a stored path
+  struct Entry
+  {
+    const MobilityModel *a; //!< the lower mobility model of the path
+    const MobilityModel *b; //!< the higher mobility model of the path
+    uint32_t uid;           //!< the spectrum model uid
+    Ptr<T> data;            //!< the path data, null for a free entry
+    uint32_t prev;          //!< the previous entry in the use order
+    uint32_t next;          //!< the next entry in the use order
+  };
+  /// the mobility models of the paths, with the number of paths of each
+  typedef std::map<const MobilityModel *, std::pair<Ptr<const MobilityModel>, uint32_t> > Mobilities;
+
+  static const uint32_t NONE = 0xffffffff;
+
+  static uint32_t Hash (const MobilityModel *a, const MobilityModel *b, uint32_t uid)
+  {
+    uint64_t h = reinterpret_cast<uintptr_t> (a);
+    h = (h ^ (h >> 29)) * 0x9e3779b97f4a7c15ULL;
+    h ^= reinterpret_cast<uintptr_t> (b) + uid;
+    h = (h ^ (h >> 31)) * 0xbf58476d1ce4e5b9ULL;
+    return static_cast<uint32_t> (h ^ (h >> 32));
+  };
+  /// \return the slot of a path, or NONE
+  uint32_t Find (const MobilityModel *a, const MobilityModel *b, uint32_t uid) const
+  {
+    if (m_slots.empty ())
+      {
+        return NONE;
+      }
+    const MobilityModel *low = std::min (a, b);
+    const MobilityModel *high = std::max (a, b);
+    uint32_t mask = m_slots.size () - 1;
+    for (uint32_t slot = Hash (low, high, uid) & mask; m_slots[slot] != NONE; slot = (slot + 1) & mask)
+      {
+        const Entry &entry = m_entries[m_slots[slot]];
+        if (entry.a == low && entry.b == high && entry.uid == uid)
+          {
+            return slot;
+          }
+      }
+    return NONE;
+  };
+  void Rehash (uint32_t nSlots)
+  {
+    m_slots.assign (nSlots, NONE);
+    for (uint32_t i = 0; i < m_entries.size (); i++)
+      {
+        if (m_entries[i].data == 0)
+          {
+            continue;
+          }
+        uint32_t slot = Hash (m_entries[i].a, m_entries[i].b, m_entries[i].uid) & (nSlots - 1);
+        while (m_slots[slot] != NONE)
+          {
+            slot = (slot + 1) & (nSlots - 1);
+          }
+        m_slots[slot] = i;
+      }
+  };
+  void RemoveEntry (uint32_t index)
+  {
+    Entry &entry = m_entries[index];
+    uint32_t mask = m_slots.size () - 1;
+    uint32_t slot = Hash (entry.a, entry.b, entry.uid) & mask;
+    while (m_slots[slot] != index)
+      {
+        slot = (slot + 1) & mask;
+      }
+    // shift back the next entries of the probe sequence, so that no
+    // tombstone is needed
+    m_slots[slot] = NONE;
+    for (uint32_t next = (slot + 1) & mask; m_slots[next] != NONE; next = (next + 1) & mask)
+      {
+        const Entry &moved = m_entries[m_slots[next]];
+        uint32_t home = Hash (moved.a, moved.b, moved.uid) & mask;
+        if (((next - home) & mask) >= ((next - slot) & mask))
+          {
+            m_slots[slot] = m_slots[next];
+            m_slots[next] = NONE;
+            slot = next;
+          }
+      }
+    Unlink (index);
+    Unreference (entry.a);
+    Unreference (entry.b);
+    entry.data = 0;
+    m_free.push_back (index);
+    m_size--;
+  };
+  void LinkFirst (uint32_t index)
+  {
+    m_entries[index].prev = NONE;
+    m_entries[index].next = m_mru;
+    if (m_mru != NONE)
+      {
+        m_entries[m_mru].prev = index;
+      }
+    m_mru = index;
+    if (m_lru == NONE)
+      {
+        m_lru = index;
+      }
+  };
+  void Unlink (uint32_t index)
+  {
+    Entry &entry = m_entries[index];
+    if (entry.prev != NONE)
+      {
+        m_entries[entry.prev].next = entry.next;
+      }
+    else
+      {
+        m_mru = entry.next;
+      }
+    if (entry.next != NONE)
+      {
+        m_entries[entry.next].prev = entry.prev;
+      }
+    else
+      {
+        m_lru = entry.prev;
+      }
+  };
+  void Reference (Ptr<const MobilityModel> mobility)
+  {
+    typename Mobilities::iterator it = m_mobilities.find (PeekPointer (mobility));
+    if (it == m_mobilities.end ())
+      {
+        m_mobilities.insert (std::make_pair (PeekPointer (mobility), std::make_pair (mobility, 1)));
+      }
+    else
+      {
+        it->second.second++;
+      }
+  };
+  void Unreference (const MobilityModel *mobility)
+  {
+    typename Mobilities::iterator it = m_mobilities.find (mobility);
+    NS_ASSERT (it != m_mobilities.end ());
+    if (--it->second.second == 0)
+      {
+        m_mobilities.erase (it);
+      }
+  };
+
+  std::vector<Entry> m_entries;    //!< the paths, and the free entries
+  std::vector<uint32_t> m_free;    //!< the indices of the free entries
+  std::vector<uint32_t> m_slots;   //!< the hash table of entry indices
+  Mobilities m_mobilities;         //!< the mobility models of the paths
+  uint32_t m_size;                 //!< the number of paths
+  uint32_t m_maxSize;              //!< the maximum number of paths, zero for no limit
+  uint32_t m_mru;                  //!< the most recently used entry
+  uint32_t m_lru;                  //!< the least recently used entry
+  uint64_t m_hits;                 //!< the number of lookups which found their path
+  uint64_t m_misses;               //!< the number of lookups which did not find their path
+  uint64_t m_evictions;            //!< the number of paths removed to honor the maximum size
 };
+
+template<class T>
+const uint32_t PropagationCache<T>::NONE;
 } // namespace ns3
 
 #endif // PROPAGATION_CACHE_H_
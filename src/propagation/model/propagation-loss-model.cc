@@ -34,6 +34,24 @@ NS_LOG_COMPONENT_DEFINE ("PropagationLossModel");
 
 namespace ns3 {
 
+/**
+ * Compute the distance from a to each of b, as a->GetDistanceFrom (b[i])
+ * does, so that the distance-based models can apply their loss in a
+ * single loop.
+ */
+static void
+GetDistances (Ptr<MobilityModel> a,
+              const std::vector<Ptr<MobilityModel> > &b,
+              std::vector<double> &distances)
+{
+  Vector position = a->GetPosition ();
+  distances.resize (b.size ());
+  for (uint32_t i = 0; i < b.size (); i++)
+    {
+      distances[i] = CalculateDistance (position, b[i]->GetPosition ());
+    }
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (PropagationLossModel)
@@ -82,6 +100,30 @@ PropagationLossModel::CalcRxPower (double txPowerDbm,
   return self;
 }
 
+void
+PropagationLossModel::CalcRxPowers (double txPowerDbm,
+                                    Ptr<MobilityModel> a,
+                                    const std::vector<Ptr<MobilityModel> > &b,
+                                    std::vector<double> &rxPowerDbm) const
+{
+  rxPowerDbm.assign (b.size (), txPowerDbm);
+  for (const PropagationLossModel *model = this; model != 0; model = PeekPointer (model->m_next))
+    {
+      model->DoCalcRxPowers (a, b, rxPowerDbm);
+    }
+}
+
+void
+PropagationLossModel::DoCalcRxPowers (Ptr<MobilityModel> a,
+                                      const std::vector<Ptr<MobilityModel> > &b,
+                                      std::vector<double> &rxPowerDbm) const
+{
+  for (uint32_t i = 0; i < b.size (); i++)
+    {
+      rxPowerDbm[i] = DoCalcRxPower (rxPowerDbm[i], a, b[i]);
+    }
+}
+
 int64_t
 PropagationLossModel::AssignStreams (int64_t stream)
 {
@@ -269,6 +311,25 @@ FriisPropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm + pr;
 }
 
+void
+FriisPropagationLossModel::DoCalcRxPowers (Ptr<MobilityModel> a,
+                                           const std::vector<Ptr<MobilityModel> > &b,
+                                           std::vector<double> &rxPowerDbm) const
+{
+  std::vector<double> distances;
+  GetDistances (a, b, distances);
+  double numerator = m_lambda * m_lambda;
+  for (uint32_t i = 0; i < distances.size (); i++)
+    {
+      double distance = distances[i];
+      if (distance > m_minDistance)
+        {
+          double denominator = 16 * PI * PI * distance * distance * m_systemLoss;
+          rxPowerDbm[i] += 10 * std::log10 (numerator / denominator);
+        }
+    }
+}
+
 int64_t
 FriisPropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -445,6 +506,49 @@ TwoRayGroundPropagationLossModel::DoCalcRxPower (double txPowerDbm,
     }
 }
 
+void
+TwoRayGroundPropagationLossModel::DoCalcRxPowers (Ptr<MobilityModel> a,
+                                                  const std::vector<Ptr<MobilityModel> > &b,
+                                                  std::vector<double> &rxPowerDbm) const
+{
+  Vector position = a->GetPosition ();
+  double txAntHeight = position.z + m_heightAboveZ;
+  std::vector<double> distances (b.size ());
+  std::vector<double> rxAntHeights (b.size ());
+  for (uint32_t i = 0; i < b.size (); i++)
+    {
+      Vector rxPosition = b[i]->GetPosition ();
+      distances[i] = CalculateDistance (position, rxPosition);
+      rxAntHeights[i] = rxPosition.z + m_heightAboveZ;
+    }
+  // see DoCalcRxPower for the formulas
+  double numerator = m_lambda * m_lambda;
+  for (uint32_t i = 0; i < distances.size (); i++)
+    {
+      double distance = distances[i];
+      if (distance <= m_minDistance)
+        {
+          continue;
+        }
+      double dCross = (4 * PI * txAntHeight * rxAntHeights[i]) / m_lambda;
+      double tmp;
+      if (distance <= dCross)
+        {
+          tmp = PI * distance;
+          double denominator = 16 * tmp * tmp * m_systemLoss;
+          rxPowerDbm[i] += 10 * std::log10 (numerator / denominator);
+        }
+      else
+        {
+          tmp = txAntHeight * rxAntHeights[i];
+          double rayNumerator = tmp * tmp;
+          tmp = distance * distance;
+          double rayDenominator = tmp * tmp * m_systemLoss;
+          rxPowerDbm[i] += 10 * std::log10 (rayNumerator / rayDenominator);
+        }
+    }
+}
+
 int64_t
 TwoRayGroundPropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -534,6 +638,24 @@ LogDistancePropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm + rxc;
 }
 
+void
+LogDistancePropagationLossModel::DoCalcRxPowers (Ptr<MobilityModel> a,
+                                                 const std::vector<Ptr<MobilityModel> > &b,
+                                                 std::vector<double> &rxPowerDbm) const
+{
+  std::vector<double> distances;
+  GetDistances (a, b, distances);
+  for (uint32_t i = 0; i < distances.size (); i++)
+    {
+      double distance = distances[i];
+      if (distance > m_referenceDistance)
+        {
+          double pathLossDb = 10 * m_exponent * std::log10 (distance / m_referenceDistance);
+          rxPowerDbm[i] += -m_referenceLoss - pathLossDb;
+        }
+    }
+}
+
 int64_t
 LogDistancePropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -636,6 +758,40 @@ ThreeLogDistancePropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm - pathLossDb;
 }
 
+void
+ThreeLogDistancePropagationLossModel::DoCalcRxPowers (Ptr<MobilityModel> a,
+                                                      const std::vector<Ptr<MobilityModel> > &b,
+                                                      std::vector<double> &rxPowerDbm) const
+{
+  std::vector<double> distances;
+  GetDistances (a, b, distances);
+  // the losses at the start of the second and third fields
+  double loss1 = m_referenceLoss + 10 * m_exponent0 * std::log10 (m_distance1 / m_distance0);
+  double loss2 = loss1 + 10 * m_exponent1 * std::log10 (m_distance2 / m_distance1);
+  for (uint32_t i = 0; i < distances.size (); i++)
+    {
+      double distance = distances[i];
+      double pathLossDb;
+      if (distance < m_distance0)
+        {
+          pathLossDb = 0;
+        }
+      else if (distance < m_distance1)
+        {
+          pathLossDb = m_referenceLoss + 10 * m_exponent0 * std::log10 (distance / m_distance0);
+        }
+      else if (distance < m_distance2)
+        {
+          pathLossDb = loss1 + 10 * m_exponent1 * std::log10 (distance / m_distance1);
+        }
+      else
+        {
+          pathLossDb = loss2 + 10 * m_exponent2 * std::log10 (distance / m_distance2);
+        }
+      rxPowerDbm[i] -= pathLossDb;
+    }
+}
+
 int64_t
 ThreeLogDistancePropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -924,6 +1080,22 @@ RangePropagationLossModel::DoCalcRxPower (double txPowerDbm,
     }
 }
 
+void
+RangePropagationLossModel::DoCalcRxPowers (Ptr<MobilityModel> a,
+                                           const std::vector<Ptr<MobilityModel> > &b,
+                                           std::vector<double> &rxPowerDbm) const
+{
+  std::vector<double> distances;
+  GetDistances (a, b, distances);
+  for (uint32_t i = 0; i < distances.size (); i++)
+    {
+      if (distances[i] > m_range)
+        {
+          rxPowerDbm[i] = -1000;
+        }
+    }
+}
+
 int64_t
 RangePropagationLossModel::DoAssignStreams (int64_t stream)
 {
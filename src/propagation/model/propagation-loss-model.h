@@ -28,6 +28,7 @@
 #include "ns3/object.h"
 #include "ns3/random-variable-stream.h"
 #include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -85,6 +86,23 @@ public:
                       Ptr<MobilityModel> a,
                       Ptr<MobilityModel> b) const;
 
+  /**
+   * \param txPowerDbm current transmission power (in dBm)
+   * \param a the mobility model of the source
+   * \param b the mobility models of the destinations
+   * \param rxPowerDbm the reception powers after adding/multiplying
+   *        propagation loss (in dBm), one per destination
+   *
+   * This gives the same results as calling CalcRxPower for each
+   * destination, but each model of the chain processes all the
+   * destinations at once, and the distance-based models do so in a single
+   * loop over the distances.
+   */
+  void CalcRxPowers (double txPowerDbm,
+                     Ptr<MobilityModel> a,
+                     const std::vector<Ptr<MobilityModel> > &b,
+                     std::vector<double> &rxPowerDbm) const;
+
   /**
    * If this loss model uses objects of type RandomVariableStream,
    * set the stream numbers to the integers starting with the offset
@@ -104,6 +122,19 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const = 0;
+  /**
+   * Apply the loss of this model, but not of the next ones, to the
+   * reception powers of several destinations.  The default implementation
+   * calls DoCalcRxPower for each destination.
+   *
+   * \param a the mobility model of the source
+   * \param b the mobility models of the destinations
+   * \param rxPowerDbm the reception powers (in dBm), one per destination,
+   *        updated in place
+   */
+  virtual void DoCalcRxPowers (Ptr<MobilityModel> a,
+                               const std::vector<Ptr<MobilityModel> > &b,
+                               std::vector<double> &rxPowerDbm) const;
 
   /**
    * Subclasses must implement this; those not using random variables
@@ -224,6 +255,9 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowers (Ptr<MobilityModel> a,
+                               const std::vector<Ptr<MobilityModel> > &b,
+                               std::vector<double> &rxPowerDbm) const;
   virtual int64_t DoAssignStreams (int64_t stream);
   double DbmToW (double dbm) const;
   double DbmFromW (double w) const;
@@ -317,6 +351,9 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowers (Ptr<MobilityModel> a,
+                               const std::vector<Ptr<MobilityModel> > &b,
+                               std::vector<double> &rxPowerDbm) const;
   virtual int64_t DoAssignStreams (int64_t stream);
   double DbmToW (double dbm) const;
   double DbmFromW (double w) const;
@@ -373,6 +410,9 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowers (Ptr<MobilityModel> a,
+                               const std::vector<Ptr<MobilityModel> > &b,
+                               std::vector<double> &rxPowerDbm) const;
   virtual int64_t DoAssignStreams (int64_t stream);
   static Ptr<PropagationLossModel> CreateDefaultReference (void);
 
@@ -436,6 +476,9 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowers (Ptr<MobilityModel> a,
+                               const std::vector<Ptr<MobilityModel> > &b,
+                               std::vector<double> &rxPowerDbm) const;
   virtual int64_t DoAssignStreams (int64_t stream);
 
   double m_distance0;
@@ -598,6 +641,9 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowers (Ptr<MobilityModel> a,
+                               const std::vector<Ptr<MobilityModel> > &b,
+                               std::vector<double> &rxPowerDbm) const;
   virtual int64_t DoAssignStreams (int64_t stream);
 private:
   double m_range;
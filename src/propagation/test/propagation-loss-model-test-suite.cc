@@ -23,6 +23,11 @@
 #include "ns3/double.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/cached-propagation-loss-model.h"
+#include "ns3/propagation-cache.h"
+#include "ns3/string.h"
+#include "ns3/pointer.h"
 #include "ns3/simulator.h"
 
 using namespace ns3;
@@ -436,6 +441,221 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class CachedPropagationLossModelTestCase : public TestCase
+{
+public:
+  CachedPropagationLossModelTestCase ();
+  virtual ~CachedPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+CachedPropagationLossModelTestCase::CachedPropagationLossModelTestCase ()
+  : TestCase ("Test CachedPropagationLossModel")
+{
+}
+
+CachedPropagationLossModelTestCase::~CachedPropagationLossModelTestCase ()
+{
+}
+
+void
+CachedPropagationLossModelTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0,0,0));
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (10,0,0));
+  Ptr<ConstantVelocityMobilityModel> c = CreateObject<ConstantVelocityMobilityModel> ();
+  c->SetVelocity (Vector (1,0,0));
+
+  // the wrapped model gives a new loss each time it is evaluated
+  Ptr<RandomPropagationLossModel> wrapped = CreateObject<RandomPropagationLossModel> ();
+  wrapped->SetAttribute ("Variable", StringValue ("ns3::SequentialRandomVariable[Min=1|Max=100]"));
+  Ptr<CachedPropagationLossModel> lossModel = CreateObject<CachedPropagationLossModel> ();
+  lossModel->SetAttribute ("PropagationLossModel", PointerValue (wrapped));
+
+  NS_TEST_EXPECT_MSG_EQ (lossModel->CalcRxPower (0, a, b), -1, "Got unexpected rcv power");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->CalcRxPower (10, a, b), 9, "Loss should be reused");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->CalcRxPower (0, b, a), -2, "Each direction has its own loss");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->CalcRxPower (0, b, a), -2, "Loss should be reused");
+  b->SetPosition (Vector (20,0,0));
+  NS_TEST_EXPECT_MSG_EQ (lossModel->CalcRxPower (0, a, b), -3, "Loss should be recomputed after a course change");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->CalcRxPower (0, b, a), -4, "Loss should be recomputed after a course change");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->CalcRxPower (0, a, b), -3, "Loss should be reused");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->CalcRxPower (0, a, c), -5, "Got unexpected rcv power");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->CalcRxPower (0, a, c), -6, "Loss of a moving node should not be reused");
+
+  // the next models of the chain are evaluated for each transmission
+  Ptr<RandomPropagationLossModel> next = CreateObject<RandomPropagationLossModel> ();
+  next->SetAttribute ("Variable", StringValue ("ns3::SequentialRandomVariable[Min=10|Max=100]"));
+  lossModel->SetNext (next);
+  NS_TEST_EXPECT_MSG_EQ (lossModel->CalcRxPower (0, a, b), -13, "Got unexpected rcv power");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->CalcRxPower (0, a, b), -14, "Chained loss should not be reused");
+  lossModel->Dispose ();
+  Simulator::Destroy ();
+}
+
+class PropagationCacheTestCase : public TestCase
+{
+public:
+  PropagationCacheTestCase ();
+  virtual ~PropagationCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PropagationCacheTestCase::PropagationCacheTestCase ()
+  : TestCase ("Test PropagationCache")
+{
+}
+
+PropagationCacheTestCase::~PropagationCacheTestCase ()
+{
+}
+
+void
+PropagationCacheTestCase::DoRun (void)
+{
+  uint32_t n = 100;
+  std::vector<Ptr<MobilityModel> > m;
+  std::vector<Ptr<Object> > data;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      m.push_back (CreateObject<ConstantPositionMobilityModel> ());
+    }
+  PropagationCache<Object> cache;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      for (uint32_t j = i + 1; j < n; ++j)
+        {
+          data.push_back (CreateObject<Object> ());
+          cache.AddPathData (data.back (), m[i], m[j], 0);
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (cache.GetSize (), n * (n - 1) / 2, "Wrong number of paths");
+  uint32_t k = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      for (uint32_t j = i + 1; j < n; ++j)
+        {
+          NS_TEST_ASSERT_MSG_EQ (cache.GetPathData (m[i], m[j], 0), data[k], "Wrong path data");
+          NS_TEST_ASSERT_MSG_EQ (cache.GetPathData (m[j], m[i], 0), data[k], "Paths should be symmetrical");
+          ++k;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (cache.GetPathData (m[0], m[1], 1), 0, "Paths of another spectrum model should be distinct");
+  NS_TEST_EXPECT_MSG_EQ (cache.GetPathData (m[0], m[0], 0), 0, "Unknown path should not be found");
+  NS_TEST_EXPECT_MSG_EQ (cache.GetHits (), n * (n - 1), "Wrong number of hits");
+  NS_TEST_EXPECT_MSG_EQ (cache.GetMisses (), 2, "Wrong number of misses");
+
+  // removal of the paths of one mobility model
+  cache.RemovePathData (m[0]);
+  NS_TEST_EXPECT_MSG_EQ (cache.GetSize (), (n - 1) * (n - 2) / 2, "Paths of m[0] should be removed");
+  NS_TEST_EXPECT_MSG_EQ (cache.GetPathData (m[0], m[1], 0), 0, "Paths of m[0] should be removed");
+  NS_TEST_EXPECT_MSG_EQ (cache.GetPathData (m[2], m[1], 0), data[n - 1], "Other paths should be kept");
+  k = n - 1;
+  for (uint32_t i = 1; i < n; ++i)
+    {
+      for (uint32_t j = i + 1; j < n; ++j)
+        {
+          NS_TEST_ASSERT_MSG_EQ (cache.GetPathData (m[i], m[j], 0), data[k], "Wrong path data after removal");
+          ++k;
+        }
+    }
+
+  // removal of the paths of a mobility model which is only referenced by the cache
+  Ptr<MobilityModel> unused = CreateObject<ConstantPositionMobilityModel> ();
+  cache.AddPathData (CreateObject<Object> (), unused, m[1], 0);
+  cache.AddPathData (CreateObject<Object> (), unused, m[2], 0);
+  cache.Purge ();
+  NS_TEST_EXPECT_MSG_EQ (cache.GetSize (), (n - 1) * (n - 2) / 2 + 2, "Referenced paths should be kept");
+  unused = 0;
+  cache.Purge ();
+  NS_TEST_EXPECT_MSG_EQ (cache.GetSize (), (n - 1) * (n - 2) / 2, "Unreferenced paths should be removed");
+
+  // least recently used eviction
+  PropagationCache<Object> bounded;
+  bounded.SetMaxSize (3);
+  bounded.AddPathData (data[0], m[0], m[1], 0);
+  bounded.AddPathData (data[1], m[0], m[2], 0);
+  bounded.AddPathData (data[2], m[0], m[3], 0);
+  NS_TEST_EXPECT_MSG_EQ (bounded.GetPathData (m[1], m[0], 0), data[0], "Wrong path data");
+  bounded.AddPathData (data[3], m[0], m[4], 0);
+  NS_TEST_EXPECT_MSG_EQ (bounded.GetSize (), 3, "Cache should be bounded");
+  NS_TEST_EXPECT_MSG_EQ (bounded.GetEvictions (), 1, "Wrong number of evictions");
+  NS_TEST_EXPECT_MSG_EQ (bounded.GetPathData (m[0], m[2], 0), 0, "Least recently used path should be evicted");
+  NS_TEST_EXPECT_MSG_EQ (bounded.GetPathData (m[0], m[1], 0), data[0], "Recently used path should be kept");
+  NS_TEST_EXPECT_MSG_EQ (bounded.GetPathData (m[0], m[3], 0), data[2], "Recent path should be kept");
+  NS_TEST_EXPECT_MSG_EQ (bounded.GetPathData (m[0], m[4], 0), data[3], "Recent path should be kept");
+  bounded.SetMaxSize (1);
+  NS_TEST_EXPECT_MSG_EQ (bounded.GetSize (), 1, "Cache should be bounded");
+  NS_TEST_EXPECT_MSG_EQ (bounded.GetPathData (m[0], m[4], 0), data[3], "Most recently used path should be kept");
+  Simulator::Destroy ();
+}
+
+class BatchedPropagationLossModelTestCase : public TestCase
+{
+public:
+  BatchedPropagationLossModelTestCase ();
+  virtual ~BatchedPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BatchedPropagationLossModelTestCase::BatchedPropagationLossModelTestCase ()
+  : TestCase ("Test CalcRxPowers against CalcRxPower")
+{
+}
+
+BatchedPropagationLossModelTestCase::~BatchedPropagationLossModelTestCase ()
+{
+}
+
+void
+BatchedPropagationLossModelTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0, 0, 1.5));
+  std::vector<Ptr<MobilityModel> > b;
+  for (uint32_t i = 0; i < 200; i++)
+    {
+      // distances from 0 to about 2 km, and various heights
+      Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (0.05 * i * i, 0.1 * i, 1.0 + (i % 7)));
+      b.push_back (mobility);
+    }
+  Ptr<ThreeLogDistancePropagationLossModel> threeLog = CreateObject<ThreeLogDistancePropagationLossModel> ();
+  Ptr<RangePropagationLossModel> range = CreateObject<RangePropagationLossModel> ();
+  range->SetAttribute ("MaxRange", DoubleValue (300));
+  threeLog->SetNext (range);
+  Ptr<MatrixPropagationLossModel> matrix = CreateObject<MatrixPropagationLossModel> ();
+  matrix->SetDefaultLoss (3);
+  matrix->SetLoss (a, b[10], 20);
+  range->SetNext (matrix);
+
+  std::vector<Ptr<PropagationLossModel> > models;
+  models.push_back (CreateObject<FriisPropagationLossModel> ());
+  models.push_back (CreateObject<TwoRayGroundPropagationLossModel> ());
+  models.push_back (CreateObject<LogDistancePropagationLossModel> ());
+  models.push_back (threeLog);
+  for (uint32_t k = 0; k < models.size (); k++)
+    {
+      std::vector<double> rxPowerDbm;
+      models[k]->CalcRxPowers (20, a, b, rxPowerDbm);
+      NS_TEST_ASSERT_MSG_EQ (rxPowerDbm.size (), b.size (), "Wrong number of rx powers");
+      for (uint32_t i = 0; i < b.size (); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (rxPowerDbm[i], models[k]->CalcRxPower (20, a, b[i]),
+                                 "CalcRxPowers should give the same power as CalcRxPower");
+        }
+    }
+  Simulator::Destroy ();
+}
+
 class PropagationLossModelsTestSuite : public TestSuite
 {
 public:
@@ -450,6 +670,9 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new MatrixPropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new RangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new CachedPropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new PropagationCacheTestCase, TestCase::QUICK);
+  AddTestCase (new BatchedPropagationLossModelTestCase, TestCase::QUICK);
 }
 
 static PropagationLossModelsTestSuite propagationLossModelsTestSuite;
@@ -20,6 +20,7 @@
 
 #include <ns3/mobility-model.h>
 #include <ns3/friis-spectrum-propagation-loss.h>
+#include <ns3/uinteger.h>
 #include <cmath> // for M_PI
 
 
@@ -30,6 +31,7 @@ NS_OBJECT_ENSURE_REGISTERED (FriisSpectrumPropagationLossModel)
 
 
 FriisSpectrumPropagationLossModel::FriisSpectrumPropagationLossModel ()
+  : m_cacheSize (0)
 {
 }
 
@@ -44,6 +46,13 @@ FriisSpectrumPropagationLossModel::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::FriisSpectrumPropagationLossModel")
     .SetParent<SpectrumPropagationLossModel> ()
     .AddConstructor<FriisSpectrumPropagationLossModel> ()
+    .AddAttribute ("CacheSize",
+                   "The maximum number of paths whose losses are kept, "
+                   "the least recently used being dropped first. 0 for no limit.",
+                   UintegerValue (1000),
+                   MakeUintegerAccessor (&FriisSpectrumPropagationLossModel::SetCacheSize,
+                                         &FriisSpectrumPropagationLossModel::GetCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -55,22 +64,60 @@ FriisSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity (Ptr<const Spect
                                                                  Ptr<const MobilityModel> b) const
 {
   Ptr<SpectrumValue> rxPsd = Copy<SpectrumValue> (txPsd);
-  Values::iterator vit = rxPsd->ValuesBegin ();
-  Bands::const_iterator fit = rxPsd->ConstBandsBegin ();
+  DoCalcRxPowerSpectralDensityInPlace (rxPsd, a, b);
+  return rxPsd;
+}
 
+void
+FriisSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensityInPlace (Ptr<SpectrumValue> psd,
+                                                                        Ptr<const MobilityModel> a,
+                                                                        Ptr<const MobilityModel> b) const
+{
   NS_ASSERT (a);
   NS_ASSERT (b);
 
   double d = a->GetDistanceFrom (b);
 
-  while (vit != rxPsd->ValuesEnd ())
+  uint32_t uid = psd->GetSpectrumModelUid ();
+  Ptr<PathLoss> pathLoss = m_propagationCache.GetPathData (a, b, uid);
+  if (pathLoss == 0)
     {
-      NS_ASSERT (fit != rxPsd->ConstBandsEnd ());
-      *vit /= CalculateLoss (fit->fc, d); // Prx = Ptx / loss
-      ++vit;
-      ++fit;
+      pathLoss = Create<PathLoss> ();
+      pathLoss->losses.resize (psd->GetSpectrumModel ()->GetNumBands ());
+      pathLoss->distance = -1;
+      m_propagationCache.AddPathData (pathLoss, a, b, uid);
     }
-  return rxPsd;
+  if (pathLoss->distance != d)
+    {
+      std::vector<double>::iterator lit = pathLoss->losses.begin ();
+      for (Bands::const_iterator fit = psd->ConstBandsBegin (); fit != psd->ConstBandsEnd (); ++fit)
+        {
+          *lit++ = CalculateLoss (fit->fc, d);
+        }
+      pathLoss->distance = d;
+    }
+
+  // Prx = Ptx / loss; dividing rather than multiplying by a cached gain
+  // gives the same values as computing each loss on the fly
+  Values::iterator vit = psd->ValuesBegin ();
+  const std::vector<double> &losses = pathLoss->losses;
+  for (size_t i = 0; i < losses.size (); i++)
+    {
+      vit[i] /= losses[i];
+    }
+}
+
+void
+FriisSpectrumPropagationLossModel::SetCacheSize (uint32_t cacheSize)
+{
+  m_cacheSize = cacheSize;
+  m_propagationCache.SetMaxSize (cacheSize);
+}
+
+uint32_t
+FriisSpectrumPropagationLossModel::GetCacheSize (void) const
+{
+  return m_cacheSize;
 }
 
 
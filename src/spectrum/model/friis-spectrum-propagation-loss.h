@@ -23,6 +23,8 @@
 
 
 #include <ns3/spectrum-propagation-loss-model.h>
+#include <ns3/propagation-cache.h>
+#include <vector>
 
 
 namespace ns3 {
@@ -33,6 +35,10 @@ class MobilityModel;
 /**
  * \ingroup spectrum
  *
+ * The losses of each band are kept for each path and spectrum model,
+ * and are only computed again when the distance between the two ends
+ * of the path changes. The number of paths kept is bounded by the
+ * CacheSize attribute.
  */
 class FriisSpectrumPropagationLossModel : public SpectrumPropagationLossModel
 {
@@ -48,6 +54,10 @@ public:
                                                            Ptr<const MobilityModel> a,
                                                            Ptr<const MobilityModel> b) const;
 
+  virtual void DoCalcRxPowerSpectralDensityInPlace (Ptr<SpectrumValue> psd,
+                                                    Ptr<const MobilityModel> a,
+                                                    Ptr<const MobilityModel> b) const;
+
 
   /**
    * Return the propagation loss L according to a simplified version of Friis'
@@ -67,9 +77,28 @@ public:
    */
   double CalculateLoss (double f, double d) const;
 
+  /**
+   * \param cacheSize the maximum number of paths whose losses are kept,
+   * 0 for no limit
+   */
+  void SetCacheSize (uint32_t cacheSize);
+  /// \return the maximum number of paths whose losses are kept
+  uint32_t GetCacheSize (void) const;
+
 protected:
   double m_propagationSpeed;
 
+private:
+  /// the losses of each band of a path, at a given distance
+  struct PathLoss : public SimpleRefCount<PathLoss>
+  {
+    double distance;            //!< the distance of the losses (m)
+    std::vector<double> losses; //!< the loss of each band
+  };
+
+  mutable PropagationCache<PathLoss> m_propagationCache;
+  uint32_t m_cacheSize;
+
 };
 
 
@@ -282,6 +282,51 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
           convertedTxPowerSpectrum = rxConverterIterator->second.Convert (txParams->psd);
         }
 
+      // the parameters the receivers of this spectrum model get a copy of
+      Ptr<SpectrumSignalParameters> rxModelParams = txParams;
+      if (convertedTxPowerSpectrum != txParams->psd)
+        {
+          rxModelParams = txParams->Copy ();
+          rxModelParams->psd = convertedTxPowerSpectrum;
+        }
+
+      // the propagation gains and the transmit antenna gains of all the
+      // receivers are computed at once
+      std::vector<double> propagationGainsDb;
+      std::vector<double> txAntennaGainsDb;
+      if (txMobility && (m_propagationLoss || txParams->txAntenna))
+        {
+          std::vector<Ptr<MobilityModel> > receiverMobilities;
+          std::vector<Vector> txDirections;
+          Vector txPosition = txMobility->GetPosition ();
+          for (std::set<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxInfoIterator->second.m_rxPhySet.begin ();
+               rxPhyIterator != rxInfoIterator->second.m_rxPhySet.end ();
+               ++rxPhyIterator)
+            {
+              Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
+              if ((*rxPhyIterator) != txParams->txPhy && receiverMobility)
+                {
+                  receiverMobilities.push_back (receiverMobility);
+                  if (txParams->txAntenna != 0)
+                    {
+                      Vector rxPosition = receiverMobility->GetPosition ();
+                      txDirections.push_back (Vector (rxPosition.x - txPosition.x,
+                                                      rxPosition.y - txPosition.y,
+                                                      rxPosition.z - txPosition.z));
+                    }
+                }
+            }
+          if (txParams->txAntenna != 0)
+            {
+              txParams->txAntenna->GetGainsDbInDirections (txDirections, txAntennaGainsDb);
+            }
+          if (m_propagationLoss)
+            {
+              m_propagationLoss->CalcRxPowers (0, txMobility, receiverMobilities, propagationGainsDb);
+            }
+        }
+      std::vector<double>::const_iterator propagationGainDb = propagationGainsDb.begin ();
+      std::vector<double>::const_iterator txAntennaGainDb = txAntennaGainsDb.begin ();
 
       for (std::set<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxInfoIterator->second.m_rxPhySet.begin ();
            rxPhyIterator != rxInfoIterator->second.m_rxPhySet.end ();
@@ -292,36 +337,35 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
           if ((*rxPhyIterator) != txParams->txPhy)
             {
-              NS_LOG_LOGIC (" copying signal parameters " << txParams);
-              Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
-              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
               Time delay = MicroSeconds (0);
+              double pathGainLinear = 1.0;
 
               Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
 
               if (txMobility && receiverMobility)
                 {
                   double pathLossDb = 0;
-                  if (rxParams->txAntenna != 0)
+                  if (txParams->txAntenna != 0)
                     {
-                      Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
-                      double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
+                      double txAntennaGain = *txAntennaGainDb++;
                       NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
                       pathLossDb -= txAntennaGain;
                     }
                   Ptr<AntennaModel> rxAntenna = (*rxPhyIterator)->GetRxAntenna ();
                   if (rxAntenna != 0)
                     {
-                      Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
-                      double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
+                      Vector txPosition = txMobility->GetPosition ();
+                      Vector rxPosition = receiverMobility->GetPosition ();
+                      double rxAntennaGain = rxAntenna->GetGainDbInDirection (Vector (txPosition.x - rxPosition.x,
+                                                                                      txPosition.y - rxPosition.y,
+                                                                                      txPosition.z - rxPosition.z));
                       NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
                       pathLossDb -= rxAntennaGain;
                     }
                   if (m_propagationLoss)
                     {
-                      double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
-                      NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
-                      pathLossDb -= propagationGainDb;
+                      NS_LOG_LOGIC ("propagationGainDb = " << *propagationGainDb << " dB");
+                      pathLossDb -= *propagationGainDb++;
                     }                    
                   NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");    
                   m_pathLossTrace (txParams->txPhy, *rxPhyIterator, pathLossDb);
@@ -330,12 +374,21 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                       // beyond range
                       continue;
                     }
-                  double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+                  pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+                }
+
+              // the signal parameters, and their psd, are only copied
+              // for the receivers in range
+              NS_LOG_LOGIC (" copying signal parameters " << rxModelParams);
+              Ptr<SpectrumSignalParameters> rxParams = rxModelParams->Copy ();
+
+              if (txMobility && receiverMobility)
+                {
                   *(rxParams->psd) *= pathGainLinear;              
 
                   if (m_spectrumPropagationLoss)
                     {
-                      rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
+                      m_spectrumPropagationLoss->CalcRxPowerSpectralDensityInPlace (rxParams->psd, txMobility, receiverMobility);
                     }
 
                   if (m_propagationDelay)
@@ -437,6 +490,13 @@ MultiModelSpectrumChannel::SetPropagationDelayModel (Ptr<PropagationDelayModel>
   m_propagationDelay = delay;
 }
 
+Ptr<PropagationLossModel>
+MultiModelSpectrumChannel::GetPropagationLossModel (void)
+{
+  NS_LOG_FUNCTION (this);
+  return m_propagationLoss;
+}
+
 Ptr<SpectrumPropagationLossModel>
 MultiModelSpectrumChannel::GetSpectrumPropagationLossModel (void)
 {
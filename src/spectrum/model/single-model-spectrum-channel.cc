@@ -33,6 +33,7 @@
 #include <ns3/propagation-delay-model.h>
 #include <ns3/antenna-model.h>
 #include <ns3/angles.h>
+#include <algorithm>
 
 
 #include "single-model-spectrum-channel.h"
@@ -102,7 +103,12 @@ void
 SingleModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
 {
   NS_LOG_FUNCTION (this << phy);
-  m_phyList.push_back (phy);
+  // as in MultiModelSpectrumChannel, a phy which changed its
+  // SpectrumModel calls AddRx again, and must not be added twice
+  if (std::find (m_phyList.begin (), m_phyList.end (), phy) == m_phyList.end ())
+    {
+      m_phyList.push_back (phy);
+    }
 }
 
 
@@ -130,6 +136,44 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
   Ptr<MobilityModel> senderMobility = txParams->txPhy->GetMobility ();
 
+  // the propagation gains and the transmit antenna gains of all the
+  // receivers are computed at once
+  std::vector<double> propagationGainsDb;
+  std::vector<double> txAntennaGainsDb;
+  if (senderMobility && (m_propagationLoss || txParams->txAntenna))
+    {
+      std::vector<Ptr<MobilityModel> > receiverMobilities;
+      std::vector<Vector> txDirections;
+      Vector txPosition = senderMobility->GetPosition ();
+      for (PhyList::const_iterator rxPhyIterator = m_phyList.begin ();
+           rxPhyIterator != m_phyList.end ();
+           ++rxPhyIterator)
+        {
+          Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
+          if ((*rxPhyIterator) != txParams->txPhy && receiverMobility)
+            {
+              receiverMobilities.push_back (receiverMobility);
+              if (txParams->txAntenna != 0)
+                {
+                  Vector rxPosition = receiverMobility->GetPosition ();
+                  txDirections.push_back (Vector (rxPosition.x - txPosition.x,
+                                                  rxPosition.y - txPosition.y,
+                                                  rxPosition.z - txPosition.z));
+                }
+            }
+        }
+      if (txParams->txAntenna != 0)
+        {
+          txParams->txAntenna->GetGainsDbInDirections (txDirections, txAntennaGainsDb);
+        }
+      if (m_propagationLoss)
+        {
+          m_propagationLoss->CalcRxPowers (0, senderMobility, receiverMobilities, propagationGainsDb);
+        }
+    }
+  std::vector<double>::const_iterator propagationGainDb = propagationGainsDb.begin ();
+  std::vector<double>::const_iterator txAntennaGainDb = txAntennaGainsDb.begin ();
+
   for (PhyList::const_iterator rxPhyIterator = m_phyList.begin ();
        rxPhyIterator != m_phyList.end ();
        ++rxPhyIterator)
@@ -137,34 +181,34 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
       if ((*rxPhyIterator) != txParams->txPhy)
         {
           Time delay  = MicroSeconds (0);
+          double pathGainLinear = 1.0;
 
           Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
-          NS_LOG_LOGIC ("copying signal parameters " << txParams);
-          Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
 
           if (senderMobility && receiverMobility)
             {
               double pathLossDb = 0;
-              if (rxParams->txAntenna != 0)
+              if (txParams->txAntenna != 0)
                 {
-                  Angles txAngles (receiverMobility->GetPosition (), senderMobility->GetPosition ());
-                  double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
+                  double txAntennaGain = *txAntennaGainDb++;
                   NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
                   pathLossDb -= txAntennaGain;
                 }
               Ptr<AntennaModel> rxAntenna = (*rxPhyIterator)->GetRxAntenna ();
               if (rxAntenna != 0)
                 {
-                  Angles rxAngles (senderMobility->GetPosition (), receiverMobility->GetPosition ());
-                  double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
+                  Vector txPosition = senderMobility->GetPosition ();
+                  Vector rxPosition = receiverMobility->GetPosition ();
+                  double rxAntennaGain = rxAntenna->GetGainDbInDirection (Vector (txPosition.x - rxPosition.x,
+                                                                                  txPosition.y - rxPosition.y,
+                                                                                  txPosition.z - rxPosition.z));
                   NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
                   pathLossDb -= rxAntennaGain;
                 }
               if (m_propagationLoss)
                 {
-                  double propagationGainDb = m_propagationLoss->CalcRxPower (0, senderMobility, receiverMobility);
-                  NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
-                  pathLossDb -= propagationGainDb;
+                  NS_LOG_LOGIC ("propagationGainDb = " << *propagationGainDb << " dB");
+                  pathLossDb -= *propagationGainDb++;
                 }                    
               NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");    
               m_pathLossTrace (txParams->txPhy, *rxPhyIterator, pathLossDb);
@@ -173,12 +217,20 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                   // beyond range
                   continue;
                 }
-              double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+              pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+            }
+
+          // the signal parameters are only copied for the receivers in range
+          NS_LOG_LOGIC ("copying signal parameters " << txParams);
+          Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
+
+          if (senderMobility && receiverMobility)
+            {
               *(rxParams->psd) *= pathGainLinear;              
 
               if (m_spectrumPropagationLoss)
                 {
-                  rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, senderMobility, receiverMobility);
+                  m_spectrumPropagationLoss->CalcRxPowerSpectralDensityInPlace (rxParams->psd, senderMobility, receiverMobility);
                 }
 
               if (m_propagationDelay)
@@ -257,6 +309,13 @@ SingleModelSpectrumChannel::SetPropagationDelayModel (Ptr<PropagationDelayModel>
 }
 
 
+Ptr<PropagationLossModel>
+SingleModelSpectrumChannel::GetPropagationLossModel (void)
+{
+  NS_LOG_FUNCTION (this);
+  return m_propagationLoss;
+}
+
 Ptr<SpectrumPropagationLossModel>
 SingleModelSpectrumChannel::GetSpectrumPropagationLossModel (void)
 {
@@ -61,6 +61,7 @@ public:
 
   typedef std::vector<Ptr<SpectrumPhy> > PhyList;
 
+  virtual Ptr<PropagationLossModel> GetPropagationLossModel (void);
   virtual Ptr<SpectrumPropagationLossModel> GetSpectrumPropagationLossModel (void);
 
 private:
@@ -70,6 +70,18 @@ public:
    */
   virtual void SetPropagationDelayModel (Ptr<PropagationDelayModel> delay) = 0;
 
+  /**
+   * \return the single-frequency propagation loss model used by the
+   * channel, or 0 if none
+   */
+  virtual Ptr<PropagationLossModel> GetPropagationLossModel (void);
+
+  /**
+   * \return the frequency-dependent propagation loss model used by the
+   * channel, or 0 if none
+   */
+  virtual Ptr<SpectrumPropagationLossModel> GetSpectrumPropagationLossModel (void);
+
 
   /**
    * Used by attached PHY instances to transmit signals on the channel
@@ -88,7 +100,9 @@ public:
    * the channel.
    *
    * This method is to be implemented by all classes inheriting from
-   * SpectrumChannel.
+   * SpectrumChannel. A SpectrumPhy whose SpectrumModel changes calls
+   * it again, so an implementation must not add the same SpectrumPhy
+   * twice.
    *
    * @param phy the SpectrumPhy instance to be added to the channel as
    * a receiver.
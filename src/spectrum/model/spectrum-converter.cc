@@ -42,18 +42,36 @@ SpectrumConverter::SpectrumConverter (Ptr<const SpectrumModel> fromSpectrumModel
   for (Bands::const_iterator toit = toSpectrumModel->Begin (); toit != toSpectrumModel->End (); ++toit)
     {
       std::vector<double> coeffs;
+      size_t start = 0;
+      size_t end = 0;
+      size_t j = 0;
 
-      for (Bands::const_iterator fromit = fromSpectrumModel->Begin (); fromit != fromSpectrumModel->End (); ++fromit)
+      for (Bands::const_iterator fromit = fromSpectrumModel->Begin (); fromit != fromSpectrumModel->End (); ++fromit, ++j)
         {
           double c = GetCoefficient (*fromit, *toit);
           NS_LOG_LOGIC ("(" << fromit->fl << ","  << fromit->fh << ")"
                             << " --> " <<
                         "(" << toit->fl << "," << toit->fh << ")"
                             << " = " << c);
-          coeffs.push_back (c);
+          if (c != 0)
+            {
+              if (coeffs.empty ())
+                {
+                  start = j;
+                }
+              coeffs.push_back (c);
+              end = coeffs.size ();
+            }
+          else if (!coeffs.empty ())
+            {
+              coeffs.push_back (c);
+            }
         }
+      // drop the null coefficients after the last non-null one
+      coeffs.resize (end);
 
       m_conversionMatrix.push_back (coeffs);
+      m_conversionStart.push_back (start);
     }
 
 }
@@ -78,14 +96,14 @@ SpectrumConverter::Convert (Ptr<const SpectrumValue> fvvf) const
   Ptr<SpectrumValue> tvvf = Create<SpectrumValue> (m_toSpectrumModel);
 
   Values::iterator tvit = tvvf->ValuesBegin ();
-
+  std::vector<size_t>::const_iterator startit = m_conversionStart.begin ();
 
   for (std::vector<std::vector<double> >::const_iterator toit = m_conversionMatrix.begin ();
        toit != m_conversionMatrix.end ();
-       ++toit)
+       ++toit, ++startit)
     {
       NS_ASSERT (tvit != tvvf->ValuesEnd ());
-      Values::const_iterator fvit = fvvf->ConstValuesBegin ();
+      Values::const_iterator fvit = fvvf->ConstValuesBegin () + *startit;
 
       double sum = 0;
       for (std::vector<double>::const_iterator fromit = toit->begin ();
@@ -78,7 +78,13 @@ private:
    */
   double GetCoefficient (const BandInfo& from, const BandInfo& to) const;
 
+  /**
+   * Rows of the conversion matrix only hold the coefficients from
+   * the first to the last non-null one, since a band of the "to"
+   * SpectrumModel usually overlaps a few bands of the "from" one.
+   */
   std::vector<std::vector<double> > m_conversionMatrix; // /< matrix of conversion coefficients
+  std::vector<size_t> m_conversionStart; // /< index of the "from" band of the first coefficient of each row
   Ptr<const SpectrumModel> m_fromSpectrumModel;  // /<  the SpectrumModel this SpectrumConverter instance can convert from
   Ptr<const SpectrumModel> m_toSpectrumModel;    // /<  the SpectrumModel this SpectrumConverter instance can convert to
 
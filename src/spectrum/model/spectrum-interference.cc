@@ -121,7 +121,12 @@ SpectrumInterference::ConditionallyEvaluateChunk ()
   NS_LOG_LOGIC ("if condition: " << condition);
   if (condition)
     {
-      SpectrumValue sinr = (*m_rxSignal) / ((*m_allSignals) - (*m_rxSignal) + (*m_noise));
+      // build the SINR in place rather than through temporaries
+      SpectrumValue interference = *m_allSignals;
+      interference -= *m_rxSignal;
+      interference += *m_noise;
+      SpectrumValue sinr = *m_rxSignal;
+      sinr /= interference;
       Time duration = Now () - m_lastChangeTime;
       NS_LOG_LOGIC ("calling m_errorModel->EvaluateChunk (sinr, duration)");
       m_errorModel->EvaluateChunk (sinr, duration);
@@ -66,11 +66,31 @@ SpectrumPropagationLossModel::CalcRxPowerSpectralDensity (Ptr<const SpectrumValu
                                                           Ptr<const MobilityModel> b) const
 {
   Ptr<SpectrumValue> rxPsd = DoCalcRxPowerSpectralDensity (txPsd, a, b);
-  if (m_next != 0)
+  for (Ptr<SpectrumPropagationLossModel> next = m_next; next != 0; next = next->m_next)
     {
-      rxPsd = m_next->DoCalcRxPowerSpectralDensity (rxPsd, a, b);
+      next->DoCalcRxPowerSpectralDensityInPlace (rxPsd, a, b);
     }
   return rxPsd;
 }
 
+void
+SpectrumPropagationLossModel::CalcRxPowerSpectralDensityInPlace (Ptr<SpectrumValue> psd,
+                                                                 Ptr<const MobilityModel> a,
+                                                                 Ptr<const MobilityModel> b) const
+{
+  DoCalcRxPowerSpectralDensityInPlace (psd, a, b);
+  for (Ptr<SpectrumPropagationLossModel> next = m_next; next != 0; next = next->m_next)
+    {
+      next->DoCalcRxPowerSpectralDensityInPlace (psd, a, b);
+    }
+}
+
+void
+SpectrumPropagationLossModel::DoCalcRxPowerSpectralDensityInPlace (Ptr<SpectrumValue> psd,
+                                                                   Ptr<const MobilityModel> a,
+                                                                   Ptr<const MobilityModel> b) const
+{
+  *psd = *DoCalcRxPowerSpectralDensity (psd, a, b);
+}
+
 } // namespace ns3
@@ -75,6 +75,21 @@ public:
                                                  Ptr<const MobilityModel> a,
                                                  Ptr<const MobilityModel> b) const;
 
+  /**
+   * Same as CalcRxPowerSpectralDensity, but the received power spectral
+   * density overwrites the transmitted one instead of being allocated.
+   * This is meant for the channels, which already own a copy of the
+   * transmitted power spectral density for each receiver.
+   *
+   * @param psd the power spectral density of the transmission, replaced
+   * by the power spectral density of the reception
+   * @param a sender mobility
+   * @param b receiver mobility
+   */
+  void CalcRxPowerSpectralDensityInPlace (Ptr<SpectrumValue> psd,
+                                          Ptr<const MobilityModel> a,
+                                          Ptr<const MobilityModel> b) const;
+
 protected:
   virtual void DoDispose ();
 
@@ -95,6 +110,20 @@ private:
                                                            Ptr<const MobilityModel> a,
                                                            Ptr<const MobilityModel> b) const = 0;
 
+  /**
+   * The default implementation assigns the result of
+   * DoCalcRxPowerSpectralDensity to psd. Subclasses can override it
+   * to avoid allocating a new SpectrumValue.
+   *
+   * @param psd set of values vs frequency representing the
+   * transmission power, replaced by the received power.
+   * @param a sender mobility
+   * @param b receiver mobility
+   */
+  virtual void DoCalcRxPowerSpectralDensityInPlace (Ptr<SpectrumValue> psd,
+                                                    Ptr<const MobilityModel> a,
+                                                    Ptr<const MobilityModel> b) const;
+
   Ptr<SpectrumPropagationLossModel> m_next;
 };
 
@@ -22,6 +22,7 @@
 #include <ns3/spectrum-value.h>
 #include <ns3/math.h>
 #include <ns3/log.h>
+#include <algorithm>
 
 NS_LOG_COMPONENT_DEFINE ("SpectrumValue");
 
@@ -102,17 +103,19 @@ SpectrumValue::ConstBandsEnd () const
 void
 SpectrumValue::Add (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  size_t n = m_values.size ();
+  if (n == 0)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 += *it2;
-      ++it1;
-      ++it2;
+      return;
+    }
+  // plain loops over the raw arrays, which the compiler can vectorize
+  double *v = &m_values[0];
+  const double *w = &x.m_values[0];
+  for (size_t i = 0; i < n; ++i)
+    {
+      v[i] += w[i];
     }
 }
 
@@ -120,12 +123,15 @@ SpectrumValue::Add (const SpectrumValue& x)
 void
 SpectrumValue::Add (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  size_t n = m_values.size ();
+  if (n == 0)
     {
-      *it1 += s;
-      ++it1;
+      return;
+    }
+  double *v = &m_values[0];
+  for (size_t i = 0; i < n; ++i)
+    {
+      v[i] += s;
     }
 }
 
@@ -134,17 +140,18 @@ SpectrumValue::Add (double s)
 void
 SpectrumValue::Subtract (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  size_t n = m_values.size ();
+  if (n == 0)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 -= *it2;
-      ++it1;
-      ++it2;
+      return;
+    }
+  double *v = &m_values[0];
+  const double *w = &x.m_values[0];
+  for (size_t i = 0; i < n; ++i)
+    {
+      v[i] -= w[i];
     }
 }
 
@@ -160,17 +167,18 @@ SpectrumValue::Subtract (double s)
 void
 SpectrumValue::Multiply (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  size_t n = m_values.size ();
+  if (n == 0)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 *= *it2;
-      ++it1;
-      ++it2;
+      return;
+    }
+  double *v = &m_values[0];
+  const double *w = &x.m_values[0];
+  for (size_t i = 0; i < n; ++i)
+    {
+      v[i] *= w[i];
     }
 }
 
@@ -178,12 +186,15 @@ SpectrumValue::Multiply (const SpectrumValue& x)
 void
 SpectrumValue::Multiply (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  size_t n = m_values.size ();
+  if (n == 0)
     {
-      *it1 *= s;
-      ++it1;
+      return;
+    }
+  double *v = &m_values[0];
+  for (size_t i = 0; i < n; ++i)
+    {
+      v[i] *= s;
     }
 }
 
@@ -193,17 +204,18 @@ SpectrumValue::Multiply (double s)
 void
 SpectrumValue::Divide (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  size_t n = m_values.size ();
+  if (n == 0)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 /= *it2;
-      ++it1;
-      ++it2;
+      return;
+    }
+  double *v = &m_values[0];
+  const double *w = &x.m_values[0];
+  for (size_t i = 0; i < n; ++i)
+    {
+      v[i] /= w[i];
     }
 }
 
@@ -212,27 +224,31 @@ void
 SpectrumValue::Divide (double s)
 {
   NS_LOG_FUNCTION (this << s);
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  size_t n = m_values.size ();
+  if (n == 0)
     {
-      *it1 /= s;
-      ++it1;
+      return;
+    }
+  double *v = &m_values[0];
+  for (size_t i = 0; i < n; ++i)
+    {
+      v[i] /= s;
     }
 }
 
 
-
-
 void
 SpectrumValue::ChangeSign ()
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  size_t n = m_values.size ();
+  if (n == 0)
     {
-      *it1 = -(*it1);
-      ++it1;
+      return;
+    }
+  double *v = &m_values[0];
+  for (size_t i = 0; i < n; ++i)
+    {
+      v[i] = -v[i];
     }
 }
 
@@ -344,11 +360,10 @@ double
 Norm (const SpectrumValue& x)
 {
   double s = 0;
-  Values::const_iterator it1 = x.ConstValuesBegin ();
-  while (it1 != x.ConstValuesEnd ())
+  size_t n = x.m_values.size ();
+  for (size_t i = 0; i < n; ++i)
     {
-      s += (*it1) * (*it1);
-      ++it1;
+      s += x.m_values[i] * x.m_values[i];
     }
   return std::sqrt (s);
 }
@@ -358,11 +373,10 @@ double
 Sum (const SpectrumValue& x)
 {
   double s = 0;
-  Values::const_iterator it1 = x.ConstValuesBegin ();
-  while (it1 != x.ConstValuesEnd ())
+  size_t n = x.m_values.size ();
+  for (size_t i = 0; i < n; ++i)
     {
-      s += (*it1);
-      ++it1;
+      s += x.m_values[i];
     }
   return s;
 }
@@ -457,9 +471,8 @@ operator+ (double lhs, const SpectrumValue& rhs)
 SpectrumValue
 operator- (const SpectrumValue& lhs, const SpectrumValue& rhs)
 {
-  SpectrumValue res = rhs;
-  res.ChangeSign ();
-  res.Add (lhs);
+  SpectrumValue res = lhs;
+  res.Subtract (rhs);
   return res;
 }
 
@@ -654,13 +667,7 @@ SpectrumValue:: operator/= (double rhs)
 SpectrumValue&
 SpectrumValue:: operator= (double rhs)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
-    {
-      *it1 = rhs;
-      ++it1;
-    }
+  std::fill (m_values.begin (), m_values.end (), rhs);
   return *this;
 }
 
@@ -0,0 +1,146 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include <ns3/object.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/friis-spectrum-propagation-loss.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/uinteger.h>
+#include <ns3/test.h>
+
+using namespace ns3;
+
+/**
+ * Check that the in-place computation of FriisSpectrumPropagationLossModel
+ * gives the same values as the per band Friis formula, when the paths
+ * are evicted from its cache or move, and when several models are chained.
+ */
+class FriisSpectrumPropagationLossTestCase : public TestCase
+{
+public:
+  FriisSpectrumPropagationLossTestCase ();
+  virtual ~FriisSpectrumPropagationLossTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check psd against txPsd divided n times by the Friis loss of each band.
+   */
+  void CheckRxPsd (Ptr<SpectrumValue> txPsd, Ptr<SpectrumValue> psd,
+                   Ptr<FriisSpectrumPropagationLossModel> model, double d, uint32_t n);
+};
+
+FriisSpectrumPropagationLossTestCase::FriisSpectrumPropagationLossTestCase ()
+  : TestCase ("Check the cached per band losses of FriisSpectrumPropagationLossModel")
+{
+}
+
+FriisSpectrumPropagationLossTestCase::~FriisSpectrumPropagationLossTestCase ()
+{
+}
+
+void
+FriisSpectrumPropagationLossTestCase::CheckRxPsd (Ptr<SpectrumValue> txPsd, Ptr<SpectrumValue> psd,
+                                                  Ptr<FriisSpectrumPropagationLossModel> model, double d, uint32_t n)
+{
+  Bands::const_iterator fit = txPsd->ConstBandsBegin ();
+  for (uint32_t i = 0; i < txPsd->GetSpectrumModel ()->GetNumBands (); i++, ++fit)
+    {
+      double expected = (*txPsd)[i];
+      for (uint32_t j = 0; j < n; j++)
+        {
+          expected /= model->CalculateLoss (fit->fc, d);
+        }
+      NS_TEST_ASSERT_MSG_EQ ((*psd)[i], expected, "wrong received power in band " << i << " at " << d << " m");
+    }
+}
+
+void
+FriisSpectrumPropagationLossTestCase::DoRun (void)
+{
+  std::vector<double> freqs;
+  for (uint32_t i = 0; i < 25; i++)
+    {
+      freqs.push_back (2.1e9 + i * 180e3);
+    }
+  Ptr<SpectrumModel> sm = Create<SpectrumModel> (freqs);
+  Ptr<SpectrumValue> txPsd = Create<SpectrumValue> (sm);
+  for (uint32_t i = 0; i < freqs.size (); i++)
+    {
+      (*txPsd)[i] = 1e-3 * (i + 1);
+    }
+
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0, 0, 0));
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (100, 0, 0));
+  Ptr<MobilityModel> c = CreateObject<ConstantPositionMobilityModel> ();
+  c->SetPosition (Vector (0, 30, 40));
+
+  Ptr<FriisSpectrumPropagationLossModel> friis = CreateObject<FriisSpectrumPropagationLossModel> ();
+  friis->SetAttribute ("CacheSize", UintegerValue (1));
+
+  // alternate two paths so that each one evicts the other from the cache
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Ptr<SpectrumValue> psd = Copy<SpectrumValue> (txPsd);
+      friis->CalcRxPowerSpectralDensityInPlace (psd, a, b);
+      CheckRxPsd (txPsd, psd, friis, 100, 1);
+      psd = friis->CalcRxPowerSpectralDensity (txPsd, c, a);
+      CheckRxPsd (txPsd, psd, friis, 50, 1);
+    }
+
+  // the losses of a path are computed again when the distance changes
+  friis->SetAttribute ("CacheSize", UintegerValue (0));
+  Ptr<SpectrumValue> psd = friis->CalcRxPowerSpectralDensity (txPsd, a, b);
+  CheckRxPsd (txPsd, psd, friis, 100, 1);
+  b->SetPosition (Vector (200, 0, 0));
+  psd = Copy<SpectrumValue> (txPsd);
+  friis->CalcRxPowerSpectralDensityInPlace (psd, b, a);
+  CheckRxPsd (txPsd, psd, friis, 200, 1);
+  b->SetPosition (Vector (0, 0, 0));
+  psd = friis->CalcRxPowerSpectralDensity (txPsd, a, b);
+  CheckRxPsd (txPsd, psd, friis, 0, 1);
+
+  // every model of a chain is applied
+  b->SetPosition (Vector (100, 0, 0));
+  Ptr<FriisSpectrumPropagationLossModel> second = CreateObject<FriisSpectrumPropagationLossModel> ();
+  Ptr<FriisSpectrumPropagationLossModel> third = CreateObject<FriisSpectrumPropagationLossModel> ();
+  friis->SetNext (second);
+  second->SetNext (third);
+  psd = friis->CalcRxPowerSpectralDensity (txPsd, a, b);
+  CheckRxPsd (txPsd, psd, friis, 100, 3);
+  psd = Copy<SpectrumValue> (txPsd);
+  friis->CalcRxPowerSpectralDensityInPlace (psd, a, b);
+  CheckRxPsd (txPsd, psd, friis, 100, 3);
+  friis->SetNext (0);
+  second->SetNext (0);
+}
+
+class SpectrumPropagationLossTestSuite : public TestSuite
+{
+public:
+  SpectrumPropagationLossTestSuite ();
+};
+
+SpectrumPropagationLossTestSuite::SpectrumPropagationLossTestSuite ()
+  : TestSuite ("spectrum-propagation-loss", UNIT)
+{
+  AddTestCase (new FriisSpectrumPropagationLossTestCase, TestCase::QUICK);
+}
+
+static SpectrumPropagationLossTestSuite g_spectrumPropagationLossTestSuite;
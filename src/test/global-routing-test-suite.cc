@@ -42,6 +42,10 @@
 #include "ns3/test.h"
 #include "ns3/uinteger.h"
 #include "ns3/ipv4-packet-info-tag.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/spectrum-helper.h"
+#include "ns3/spectrum-wifi-helper.h"
+#include "ns3/nqos-wifi-mac-helper.h"
 
 using namespace ns3;
 
@@ -385,6 +389,95 @@ GlobalRoutingSlash32TestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class GlobalRoutingSpectrumWifiTestCase : public TestCase
+{
+public:
+  GlobalRoutingSpectrumWifiTestCase ();
+  virtual ~GlobalRoutingSpectrumWifiTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+// Routes over the devices installed by SpectrumWifiPhyHelper, whose
+// channel is a SpectrumChannel
+GlobalRoutingSpectrumWifiTestCase::GlobalRoutingSpectrumWifiTestCase ()
+  : TestCase ("Global routing over SpectrumWifiPhy devices")
+{
+}
+
+GlobalRoutingSpectrumWifiTestCase::~GlobalRoutingSpectrumWifiTestCase ()
+{
+}
+
+// Test program for this 3-router scenario, using global routing
+//
+// A<--10.1.1.0/30 (point-to-point)-->B<--10.1.2.0/24 (wifi)-->C
+//
+// C only learns the route to A if B is seen as a router on the wifi link
+void
+GlobalRoutingSpectrumWifiTestCase::DoRun (void)
+{
+  Ptr<Node> nA = CreateObject<Node> ();
+  Ptr<Node> nB = CreateObject<Node> ();
+  Ptr<Node> nC = CreateObject<Node> ();
+
+  NodeContainer c = NodeContainer (nA, nB, nC);
+
+  InternetStackHelper internet;
+  internet.Install (c);
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("2ms"));
+  NetDeviceContainer dAdB = p2p.Install (NodeContainer (nA, nB));
+
+  NodeContainer nBnC = NodeContainer (nB, nC);
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  positions->Add (Vector (0.0, 0.0, 0.0));
+  positions->Add (Vector (10.0, 0.0, 0.0));
+  mobility.SetPositionAllocator (positions);
+  mobility.Install (nBnC);
+
+  SpectrumWifiPhyHelper phy = SpectrumWifiPhyHelper::Default ();
+  phy.SetChannel (SpectrumChannelHelper::Default ().Create ());
+  NqosWifiMacHelper mac = NqosWifiMacHelper::Default ();
+  mac.SetType ("ns3::AdhocWifiMac");
+  WifiHelper wifi = WifiHelper::Default ();
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211a);
+  NetDeviceContainer dBdC = wifi.Install (phy, mac, nBnC);
+  NS_TEST_ASSERT_MSG_NE (dBdC.Get (0)->GetChannel (), 0, "SpectrumWifiPhy device without a channel");
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.252");
+  Ipv4InterfaceContainer iAiB = ipv4.Assign (dAdB);
+  ipv4.SetBase ("10.1.2.0", "255.255.255.0");
+  ipv4.Assign (dBdC);
+
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  uint16_t port = 9;   // Discard port (RFC 863)
+  OnOffHelper onoff ("ns3::UdpSocketFactory",
+                     Address (InetSocketAddress (iAiB.GetAddress (0), port)));
+  onoff.SetConstantRate (DataRate (6000));
+  ApplicationContainer apps = onoff.Install (nC);
+  apps.Start (Seconds (1.0));
+  apps.Stop (Seconds (10.0));
+
+  PacketSinkHelper sink ("ns3::UdpSocketFactory",
+                         Address (InetSocketAddress (Ipv4Address::GetAny (), port)));
+  apps = sink.Install (nA);
+  apps.Start (Seconds (1.0));
+  apps.Stop (Seconds (10.0));
+
+  Simulator::Run ();
+  // Check that we received 13 * 512 = 6656 bytes
+  Ptr<PacketSink> sinkPtr = DynamicCast <PacketSink> (apps.Get (0));
+  NS_TEST_ASSERT_MSG_EQ (sinkPtr->GetTotalRx (), 6656, "Global routing over SpectrumWifiPhy did not deliver all packets");
+  Simulator::Destroy ();
+}
+
 
 class GlobalRoutingTestSuite : public TestSuite
 {
@@ -397,6 +490,7 @@ GlobalRoutingTestSuite::GlobalRoutingTestSuite ()
 {
   AddTestCase (new DynamicGlobalRoutingTestCase, TestCase::QUICK);
   AddTestCase (new GlobalRoutingSlash32TestCase, TestCase::QUICK);
+  AddTestCase (new GlobalRoutingSpectrumWifiTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -0,0 +1,358 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <list>
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/pointer.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/mac48-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/packet-sink.h"
+#include "ns3/bulk-send-helper.h"
+#include "ns3/bulk-send-application.h"
+#include "ns3/node-container.h"
+#include "ns3/simulator.h"
+#include "ns3/error-model.h"
+#include "ns3/segmentation-offload-tag.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("Ns3TcpOffloadTest");
+
+// ===========================================================================
+// Tests of TCP segmentation offload over devices which carry super-segments
+// ===========================================================================
+//
+// BULK:   n0 ---- p2p ---- n1, the same bulk transfer with and without
+//         offload.  Checks that every byte is delivered with fewer frames,
+//         that the receiver acknowledges a super-segment as the segments it
+//         carries and that the sender grows its window as fast as in the
+//         segmented flow.
+// LOSS:   the same topology, one super-segment is lost.  The sender must
+//         recover with fast retransmit / fast recovery, not a timeout.
+// ROUTER: n0 ---- p2p ---- r1 ---- simple ---- r2 ---- p2p ---- n3
+//         The SimpleNetDevice link cannot carry super-segments, so r1
+//         fragments them at the IP layer; n3 reassembles them.
+//
+
+class Ns3TcpOffloadTestCase : public TestCase
+{
+public:
+  enum Scenario
+  {
+    BULK,
+    LOSS,
+    ROUTER
+  };
+  Ns3TcpOffloadTestCase (enum Scenario scenario);
+  virtual ~Ns3TcpOffloadTestCase () {}
+
+private:
+  virtual void DoRun (void);
+  static std::string BuildNameString (enum Scenario scenario);
+  void RunTransfer (bool offload);
+  void SenderTx (Ptr<const Packet> p);
+  void ReceiverRx (Ptr<const Packet> p);
+  void ReceiverTx (Ptr<const Packet> p);
+  void RouterTx (Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface);
+  void SinkRx (Ptr<const Packet> p, const Address &from);
+  void ConnectCwnd (Ptr<BulkSendApplication> source);
+  void CwndChange (uint32_t oldCwnd, uint32_t newCwnd);
+
+  enum Scenario m_scenario;
+  uint32_t m_rxBytes;
+  uint32_t m_dataPackets;
+  uint32_t m_superSegments;
+  uint32_t m_acks;
+  uint32_t m_fragments;
+  uint32_t m_cwndReductions;
+  uint32_t m_minCwndAfterLoss;
+  Time m_lastRx;
+};
+
+static const uint32_t TRANSFER_SIZE = 2000000;
+static const uint32_t SEGMENT_SIZE = 536;
+// A frame smaller than this carries no TCP payload
+static const uint32_t PURE_ACK_SIZE = 100;
+
+Ns3TcpOffloadTestCase::Ns3TcpOffloadTestCase (enum Scenario scenario)
+  : TestCase (BuildNameString (scenario)),
+    m_scenario (scenario)
+{
+}
+
+std::string
+Ns3TcpOffloadTestCase::BuildNameString (enum Scenario scenario)
+{
+  switch (scenario)
+    {
+    case BULK:
+      return "Check a bulk transfer over offload-enabled point-to-point devices";
+    case LOSS:
+      return "Check fast recovery of a lost super-segment";
+    case ROUTER:
+      return "Check super-segments forwarded onto a device without offload";
+    }
+  return "";
+}
+
+void
+Ns3TcpOffloadTestCase::SenderTx (Ptr<const Packet> p)
+{
+  if (p->GetSize () > PURE_ACK_SIZE)
+    {
+      m_dataPackets++;
+    }
+}
+
+void
+Ns3TcpOffloadTestCase::ReceiverRx (Ptr<const Packet> p)
+{
+  SegmentationOffloadTag offloadTag;
+  if (p->PeekPacketTag (offloadTag) && offloadTag.GetSegmentCount () > 1)
+    {
+      m_superSegments++;
+    }
+}
+
+void
+Ns3TcpOffloadTestCase::ReceiverTx (Ptr<const Packet> p)
+{
+  if (p->GetSize () < PURE_ACK_SIZE)
+    {
+      m_acks++;
+    }
+}
+
+void
+Ns3TcpOffloadTestCase::RouterTx (Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  Ipv4Header ipHeader;
+  p->PeekHeader (ipHeader);
+  if (ipHeader.IsLastFragment () == false || ipHeader.GetFragmentOffset () > 0)
+    {
+      m_fragments++;
+    }
+}
+
+void
+Ns3TcpOffloadTestCase::SinkRx (Ptr<const Packet> p, const Address &from)
+{
+  m_rxBytes += p->GetSize ();
+  m_lastRx = Simulator::Now ();
+}
+
+void
+Ns3TcpOffloadTestCase::ConnectCwnd (Ptr<BulkSendApplication> source)
+{
+  source->GetSocket ()->TraceConnectWithoutContext ("CongestionWindow",
+                                                    MakeCallback (&Ns3TcpOffloadTestCase::CwndChange, this));
+}
+
+void
+Ns3TcpOffloadTestCase::CwndChange (uint32_t oldCwnd, uint32_t newCwnd)
+{
+  if (newCwnd < oldCwnd)
+    {
+      m_cwndReductions++;
+    }
+  if (m_cwndReductions > 0)
+    {
+      m_minCwndAfterLoss = std::min (m_minCwndAfterLoss, newCwnd);
+    }
+}
+
+void
+Ns3TcpOffloadTestCase::RunTransfer (bool offload)
+{
+  m_rxBytes = 0;
+  m_dataPackets = 0;
+  m_superSegments = 0;
+  m_acks = 0;
+  m_fragments = 0;
+  m_cwndReductions = 0;
+  m_minCwndAfterLoss = 0xffffffff;
+  m_lastRx = Seconds (0);
+
+  Config::SetDefault ("ns3::TcpSocketBase::SegmentationOffload", BooleanValue (offload));
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (SEGMENT_SIZE));
+
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("20ms"));
+
+  InternetStackHelper stack;
+  Ipv4AddressHelper address;
+  Ptr<Node> sender;
+  Ptr<Node> receiver;
+  Ptr<NetDevice> senderDevice;
+  Ptr<NetDevice> receiverDevice;
+  Ipv4Address receiverAddress;
+
+  if (m_scenario == ROUTER)
+    {
+      NodeContainer nodes;
+      nodes.Create (4);
+      stack.Install (nodes);
+
+      NetDeviceContainer first = pointToPoint.Install (nodes.Get (0), nodes.Get (1));
+      Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+      NetDeviceContainer second;
+      for (uint32_t i = 1; i <= 2; i++)
+        {
+          Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+          device->SetAddress (Mac48Address::Allocate ());
+          device->SetMtu (1500);
+          device->SetChannel (channel);
+          nodes.Get (i)->AddDevice (device);
+          second.Add (device);
+        }
+      NetDeviceContainer third = pointToPoint.Install (nodes.Get (2), nodes.Get (3));
+
+      address.SetBase ("10.1.1.0", "255.255.255.0");
+      address.Assign (first);
+      address.SetBase ("10.1.2.0", "255.255.255.0");
+      address.Assign (second);
+      address.SetBase ("10.1.3.0", "255.255.255.0");
+      Ipv4InterfaceContainer interfaces = address.Assign (third);
+      Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+      nodes.Get (1)->GetObject<Ipv4L3Protocol> ()->TraceConnectWithoutContext ("Tx",
+                                                                               MakeCallback (&Ns3TcpOffloadTestCase::RouterTx, this));
+      sender = nodes.Get (0);
+      receiver = nodes.Get (3);
+      senderDevice = first.Get (0);
+      receiverDevice = third.Get (1);
+      receiverAddress = interfaces.GetAddress (1);
+    }
+  else
+    {
+      NodeContainer nodes;
+      nodes.Create (2);
+      stack.Install (nodes);
+
+      NetDeviceContainer devices = pointToPoint.Install (nodes);
+      address.SetBase ("10.1.1.0", "255.255.255.0");
+      Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+      sender = nodes.Get (0);
+      receiver = nodes.Get (1);
+      senderDevice = devices.Get (0);
+      receiverDevice = devices.Get (1);
+      receiverAddress = interfaces.GetAddress (1);
+    }
+
+  if (m_scenario == LOSS)
+    {
+      std::list<uint32_t> sampleList;
+      sampleList.push_back (20);
+      Ptr<ReceiveListErrorModel> pem = CreateObject<ReceiveListErrorModel> ();
+      pem->SetList (sampleList);
+      receiverDevice->SetAttribute ("ReceiveErrorModel", PointerValue (pem));
+    }
+
+  senderDevice->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&Ns3TcpOffloadTestCase::SenderTx, this));
+  receiverDevice->TraceConnectWithoutContext ("PhyRxEnd", MakeCallback (&Ns3TcpOffloadTestCase::ReceiverRx, this));
+  receiverDevice->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&Ns3TcpOffloadTestCase::ReceiverTx, this));
+
+  uint16_t port = 50000;
+  PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApps = sinkHelper.Install (receiver);
+  sinkApps.Get (0)->TraceConnectWithoutContext ("Rx", MakeCallback (&Ns3TcpOffloadTestCase::SinkRx, this));
+  sinkApps.Start (Seconds (0.0));
+
+  BulkSendHelper sourceHelper ("ns3::TcpSocketFactory", InetSocketAddress (receiverAddress, port));
+  sourceHelper.SetAttribute ("MaxBytes", UintegerValue (TRANSFER_SIZE));
+  ApplicationContainer sourceApps = sourceHelper.Install (sender);
+  sourceApps.Start (Seconds (1.0));
+  Simulator::Schedule (Seconds (1.0) + NanoSeconds (1), &Ns3TcpOffloadTestCase::ConnectCwnd, this,
+                       DynamicCast<BulkSendApplication> (sourceApps.Get (0)));
+
+  Simulator::Stop (Seconds (30));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+Ns3TcpOffloadTestCase::DoRun (void)
+{
+  switch (m_scenario)
+    {
+    case BULK:
+      {
+        RunTransfer (false);
+        uint32_t segmentedPackets = m_dataPackets;
+        Time segmentedDuration = m_lastRx;
+        NS_TEST_ASSERT_MSG_EQ (m_rxBytes, TRANSFER_SIZE, "Segmented transfer incomplete");
+
+        RunTransfer (true);
+        NS_TEST_ASSERT_MSG_EQ (m_rxBytes, TRANSFER_SIZE, "Offloaded transfer incomplete");
+        NS_TEST_ASSERT_MSG_LT (m_dataPackets * 4, segmentedPackets, "Super-segments were not sent");
+        NS_TEST_ASSERT_MSG_GT (m_superSegments, 0, "No super-segment received");
+        // Every super-segment is worth at least two segments: none waits for a delayed ACK
+        NS_TEST_ASSERT_MSG_GT (m_acks + 1, m_superSegments, "Super-segment counted as a single segment");
+        // The sender splits each ACK of a super-segment, its window opens as fast
+        NS_TEST_ASSERT_MSG_LT (m_lastRx.GetSeconds (), segmentedDuration.GetSeconds () * 1.1,
+                               "Offloaded transfer much slower than the segmented one");
+        break;
+      }
+    case LOSS:
+      RunTransfer (true);
+      NS_TEST_ASSERT_MSG_EQ (m_rxBytes, TRANSFER_SIZE, "Transfer incomplete");
+      NS_TEST_ASSERT_MSG_GT (m_cwndReductions, 0, "The loss was not detected");
+      NS_TEST_ASSERT_MSG_GT (m_minCwndAfterLoss, SEGMENT_SIZE, "The loss was recovered by a timeout");
+      break;
+    case ROUTER:
+      RunTransfer (true);
+      NS_TEST_ASSERT_MSG_EQ (m_rxBytes, TRANSFER_SIZE, "Transfer incomplete");
+      NS_TEST_ASSERT_MSG_GT (m_fragments, 0, "Super-segments were not fragmented by the router");
+      break;
+    }
+
+  Config::SetDefault ("ns3::TcpSocketBase::SegmentationOffload", BooleanValue (false));
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (536));
+}
+
+class Ns3TcpOffloadTestSuite : public TestSuite
+{
+public:
+  Ns3TcpOffloadTestSuite ();
+};
+
+Ns3TcpOffloadTestSuite::Ns3TcpOffloadTestSuite ()
+  : TestSuite ("ns3-tcp-offload", SYSTEM)
+{
+  AddTestCase (new Ns3TcpOffloadTestCase (Ns3TcpOffloadTestCase::BULK), TestCase::QUICK);
+  AddTestCase (new Ns3TcpOffloadTestCase (Ns3TcpOffloadTestCase::LOSS), TestCase::QUICK);
+  AddTestCase (new Ns3TcpOffloadTestCase (Ns3TcpOffloadTestCase::ROUTER), TestCase::QUICK);
+}
+
+static Ns3TcpOffloadTestSuite ns3TcpOffloadTestSuite;
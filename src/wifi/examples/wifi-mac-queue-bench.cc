@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Time the WifiMacQueue of an AP which aggregates the frames of many
+// associated stations: each TXOP dequeues the frame at the head of the
+// queue, then all the frames of the same receiver and TID, as the
+// A-MSDU aggregation and the Block Ack agreements of EdcaTxopN do.
+//
+// ./waf --run "wifi-mac-queue-bench --nStations=200 --nTxops=100000"
+
+#include "ns3/wifi-mac-queue.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/mac48-address.h"
+#include "ns3/packet.h"
+#include "ns3/uinteger.h"
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+static void
+EnqueueOne (Ptr<WifiMacQueue> queue, Mac48Address ap, Mac48Address sta, uint8_t tid)
+{
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetAddr1 (sta);
+  hdr.SetAddr2 (ap);
+  hdr.SetAddr3 (ap);
+  hdr.SetQosTid (tid);
+  queue->Enqueue (Create<Packet> (1000), hdr);
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nStations = 200;
+  uint32_t nTids = 2;
+  uint32_t nPackets = 20;
+  uint32_t maxAggregate = 8;
+  uint32_t nTxops = 100000;
+
+  CommandLine cmd;
+  cmd.AddValue ("nStations", "Number of stations associated to the AP", nStations);
+  cmd.AddValue ("nTids", "Number of TIDs used by each station", nTids);
+  cmd.AddValue ("nPackets", "Number of packets queued per station and TID", nPackets);
+  cmd.AddValue ("maxAggregate", "Maximum number of packets sent per TXOP", maxAggregate);
+  cmd.AddValue ("nTxops", "Number of TXOPs", nTxops);
+  cmd.Parse (argc, argv);
+
+  Mac48Address ap = Mac48Address::Allocate ();
+  std::vector<Mac48Address> stations;
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      stations.push_back (Mac48Address::Allocate ());
+    }
+
+  Ptr<WifiMacQueue> queue = CreateObject<WifiMacQueue> ();
+  queue->SetAttribute ("MaxPacketNumber", UintegerValue (nStations * nTids * nPackets));
+  // interleave the stations and the TIDs, as traffic arrives
+  for (uint32_t p = 0; p < nPackets; p++)
+    {
+      for (uint32_t i = 0; i < nStations; i++)
+        {
+          for (uint32_t tid = 0; tid < nTids; tid++)
+            {
+              EnqueueOne (queue, ap, stations[i], tid);
+            }
+        }
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  uint64_t nSent = 0;
+  for (uint32_t t = 0; t < nTxops; t++)
+    {
+      WifiMacHeader hdr;
+      Ptr<const Packet> packet = queue->Dequeue (&hdr);
+      Mac48Address sta = hdr.GetAddr1 ();
+      uint8_t tid = hdr.GetQosTid ();
+      uint32_t n = 1;
+      while (n < maxAggregate
+             && queue->GetNPacketsByTidAndAddress (tid, WifiMacHeader::ADDR1, sta) > 0)
+        {
+          WifiMacHeader peekedHdr;
+          queue->PeekByTidAndAddress (&peekedHdr, tid, WifiMacHeader::ADDR1, sta);
+          queue->DequeueByTidAndAddress (&peekedHdr, tid, WifiMacHeader::ADDR1, sta);
+          n++;
+        }
+      nSent += n;
+      // new traffic for the station keeps the queue full
+      for (uint32_t i = 0; i < n; i++)
+        {
+          EnqueueOne (queue, ap, sta, tid);
+        }
+    }
+  int64_t ms = clock.End ();
+
+  std::cout << nStations << " stations, " << queue->GetSize () << " queued packets: "
+            << nTxops << " TXOPs, " << nSent << " packets in " << ms << " ms" << std::endl;
+  return 0;
+}
@@ -19,6 +19,7 @@
  */
 #include "qos-wifi-mac-helper.h"
 #include "ns3/msdu-aggregator.h"
+#include "ns3/mpdu-aggregator.h"
 #include "ns3/wifi-mac.h"
 #include "ns3/edca-txop-n.h"
 #include "ns3/pointer.h"
@@ -100,6 +101,21 @@ QosWifiMacHelper::SetMsduAggregatorForAc (AcIndex ac, std::string type,
     }
 }
 
+void
+QosWifiMacHelper::SetMpduAggregatorForAc (AcIndex ac, std::string type,
+                                          std::string n0, const AttributeValue &v0,
+                                          std::string n1, const AttributeValue &v1,
+                                          std::string n2, const AttributeValue &v2,
+                                          std::string n3, const AttributeValue &v3)
+{
+  ObjectFactory &factory = m_mpduAggregators[ac];
+  factory.SetTypeId (type);
+  factory.Set (n0, v0);
+  factory.Set (n1, v1);
+  factory.Set (n2, v2);
+  factory.Set (n3, v3);
+}
+
 void
 QosWifiMacHelper::SetBlockAckThresholdForAc (enum AcIndex ac, uint8_t threshold)
 {
@@ -126,6 +142,11 @@ QosWifiMacHelper::Setup (Ptr<WifiMac> mac, enum AcIndex ac, std::string dcaAttrN
       Ptr<MsduAggregator> aggregator = factory.Create<MsduAggregator> ();
       edca->SetMsduAggregator (aggregator);
     }
+  std::map<AcIndex, ObjectFactory>::const_iterator mpduIt = m_mpduAggregators.find (ac);
+  if (mpduIt != m_mpduAggregators.end ())
+    {
+      edca->SetMpduAggregator (mpduIt->second.Create<MpduAggregator> ());
+    }
   if (m_bAckThresholds.find (ac) != m_bAckThresholds.end ())
     {
       edca->SetBlockAckThreshold (m_bAckThresholds.find (ac)->second);
@@ -0,0 +1,64 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "spectrum-wifi-helper.h"
+#include "ns3/error-rate-model.h"
+#include "ns3/spectrum-wifi-phy.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/names.h"
+
+namespace ns3 {
+
+SpectrumWifiPhyHelper::SpectrumWifiPhyHelper ()
+  : m_channel (0)
+{
+  m_phy.SetTypeId ("ns3::SpectrumWifiPhy");
+}
+
+SpectrumWifiPhyHelper
+SpectrumWifiPhyHelper::Default (void)
+{
+  SpectrumWifiPhyHelper helper;
+  helper.SetErrorRateModel ("ns3::NistErrorRateModel");
+  return helper;
+}
+
+void
+SpectrumWifiPhyHelper::SetChannel (Ptr<SpectrumChannel> channel)
+{
+  m_channel = channel;
+}
+
+void
+SpectrumWifiPhyHelper::SetChannel (std::string channelName)
+{
+  Ptr<SpectrumChannel> channel = Names::Find<SpectrumChannel> (channelName);
+  m_channel = channel;
+}
+
+Ptr<WifiPhy>
+SpectrumWifiPhyHelper::Create (Ptr<Node> node, Ptr<WifiNetDevice> device) const
+{
+  Ptr<SpectrumWifiPhy> phy = m_phy.Create<SpectrumWifiPhy> ();
+  Ptr<ErrorRateModel> error = m_errorRateModel.Create<ErrorRateModel> ();
+  phy->SetErrorRateModel (error);
+  phy->SetMobility (node);
+  phy->SetDevice (device);
+  phy->SetChannel (m_channel);
+  return phy;
+}
+
+} // namespace ns3
@@ -244,7 +244,7 @@ public:
    */
   void SetPcapDataLinkType (enum SupportedPcapDataLinkTypes dlt);
 
-private:
+protected:
   /**
    * \param node the node on which we wish to create a wifi PHY
    * \param device the device within which this PHY will be created
@@ -254,6 +254,10 @@ private:
    */
   virtual Ptr<WifiPhy> Create (Ptr<Node> node, Ptr<WifiNetDevice> device) const;
 
+  ObjectFactory m_phy;            //!< PHY object factory
+  ObjectFactory m_errorRateModel; //!< error rate model object factory
+
+private:
   /**
    * @brief Enable pcap output the indicated net device.
    *
@@ -287,8 +291,6 @@ private:
                                     Ptr<NetDevice> nd,
                                     bool explicitFilename);
 
-  ObjectFactory m_phy;
-  ObjectFactory m_errorRateModel;
   Ptr<YansWifiChannel> m_channel;
   uint32_t m_pcapDlt;
 };
@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ampdu-subframe-header.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("AmpduSubframeHeader");
+
+namespace ns3 {
+
+/// the signature of an MPDU delimiter, the ASCII 'N'
+static const uint8_t AMPDU_DELIMITER_SIGNATURE = 0x4e;
+
+NS_OBJECT_ENSURE_REGISTERED (AmpduSubframeHeader)
+  ;
+
+TypeId
+AmpduSubframeHeader::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::AmpduSubframeHeader")
+    .SetParent<Header> ()
+    .AddConstructor<AmpduSubframeHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+AmpduSubframeHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+AmpduSubframeHeader::AmpduSubframeHeader ()
+  : m_length (0),
+    m_crc (0),
+    m_signature (AMPDU_DELIMITER_SIGNATURE)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+AmpduSubframeHeader::~AmpduSubframeHeader ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint32_t
+AmpduSubframeHeader::GetSerializedSize () const
+{
+  NS_LOG_FUNCTION (this);
+  return (2 + 1 + 1);
+}
+
+void
+AmpduSubframeHeader::Serialize (Buffer::Iterator i) const
+{
+  NS_LOG_FUNCTION (this << &i);
+  // 4 reserved bits and the 12 bits of the length
+  i.WriteHtolsbU16 (m_length << 4);
+  i.WriteU8 (m_crc);
+  i.WriteU8 (m_signature);
+}
+
+uint32_t
+AmpduSubframeHeader::Deserialize (Buffer::Iterator start)
+{
+  NS_LOG_FUNCTION (this << &start);
+  Buffer::Iterator i = start;
+  m_length = i.ReadLsbtohU16 () >> 4;
+  m_crc = i.ReadU8 ();
+  m_signature = i.ReadU8 ();
+  return i.GetDistanceFrom (start);
+}
+
+void
+AmpduSubframeHeader::Print (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this << &os);
+  os << "length = " << m_length << ", CRC = " << (uint32_t) m_crc
+     << ", signature = " << (uint32_t) m_signature;
+}
+
+void
+AmpduSubframeHeader::SetLength (uint16_t length)
+{
+  NS_LOG_FUNCTION (this << length);
+  NS_ASSERT (length < 4096);
+  m_length = length;
+}
+
+uint16_t
+AmpduSubframeHeader::GetLength (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_length;
+}
+
+bool
+AmpduSubframeHeader::IsSignatureValid (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_signature == AMPDU_DELIMITER_SIGNATURE;
+}
+
+} // namespace ns3
@@ -0,0 +1,85 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "ampdu-tag.h"
+#include "ns3/tag.h"
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (AmpduTag)
+  ;
+
+TypeId
+AmpduTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::AmpduTag")
+    .SetParent<Tag> ()
+    .AddConstructor<AmpduTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+AmpduTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+AmpduTag::AmpduTag ()
+  : m_corrupted (0)
+{
+}
+
+uint32_t
+AmpduTag::GetSerializedSize (void) const
+{
+  return sizeof (uint64_t);
+}
+
+void
+AmpduTag::Serialize (TagBuffer i) const
+{
+  i.WriteU64 (m_corrupted);
+}
+
+void
+AmpduTag::Deserialize (TagBuffer i)
+{
+  m_corrupted = i.ReadU64 ();
+}
+
+void
+AmpduTag::Print (std::ostream &os) const
+{
+  os << "Corrupted=0x" << std::hex << m_corrupted << std::dec;
+}
+
+void
+AmpduTag::SetCorrupted (uint32_t index)
+{
+  NS_ASSERT (index < 64);
+  m_corrupted |= static_cast<uint64_t> (1) << index;
+}
+
+bool
+AmpduTag::IsCorrupted (uint32_t index) const
+{
+  return index < 64 && ((m_corrupted >> index) & 1) != 0;
+}
+
+} // namespace ns3
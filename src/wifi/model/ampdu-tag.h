@@ -0,0 +1,67 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef AMPDU_TAG_H
+#define AMPDU_TAG_H
+
+#include "ns3/packet.h"
+
+namespace ns3 {
+
+class Tag;
+
+/**
+ * \ingroup wifi
+ *
+ * The packet tag which marks a PSDU as an A-MPDU.  The receiving PHY
+ * records in it which subframes of the A-MPDU are corrupted, so that
+ * MacLow drops them and receives the others.
+ */
+class AmpduTag : public Tag
+{
+public:
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  /**
+   * Create an AmpduTag with no corrupted subframe
+   */
+  AmpduTag ();
+
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer i) const;
+  virtual void Deserialize (TagBuffer i);
+  virtual void Print (std::ostream &os) const;
+
+  /**
+   * Mark a subframe as corrupted.
+   *
+   * \param index the index of the subframe in the A-MPDU, lower than 64
+   */
+  void SetCorrupted (uint32_t index);
+  /**
+   * \param index the index of the subframe in the A-MPDU
+   * \return true if the subframe is corrupted
+   */
+  bool IsCorrupted (uint32_t index) const;
+
+private:
+  uint64_t m_corrupted; //!< one bit per subframe, set if the subframe is corrupted
+};
+
+} // namespace ns3
+
+#endif /* AMPDU_TAG_H */
@@ -140,4 +140,10 @@ BlockAckCache::FillBlockAckBitmap (CtrlBAckResponseHeader *blockAckHeader)
     }
 }
 
+uint16_t
+BlockAckCache::GetWinStart (void) const
+{
+  return m_winStart;
+}
+
 } // namespace ns3
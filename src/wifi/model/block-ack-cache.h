@@ -41,6 +41,10 @@ public:
   void UpdateWithBlockAckReq (uint16_t startingSeq);
 
   void FillBlockAckBitmap (CtrlBAckResponseHeader *blockAckHeader);
+  /**
+   * \return the starting sequence number of the window
+   */
+  uint16_t GetWinStart (void) const;
 private:
   void ResetPortionOfBitmap (uint16_t start, uint16_t end);
   bool IsInWindow (uint16_t seq);
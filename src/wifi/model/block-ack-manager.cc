@@ -256,6 +256,62 @@ BlockAckManager::GetNextPacket (WifiMacHeader &hdr)
   return packet;
 }
 
+Ptr<const Packet>
+BlockAckManager::PeekNextPacketByTidAndAddress (WifiMacHeader &hdr, Mac48Address recipient, uint8_t tid) const
+{
+  NS_LOG_FUNCTION (this << &hdr << recipient << static_cast<uint32_t> (tid));
+  for (std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin (); it != m_retryPackets.end (); it++)
+    {
+      if ((*it)->hdr.GetAddr1 () == recipient && (*it)->hdr.GetQosTid () == tid)
+        {
+          hdr = (*it)->hdr;
+          hdr.SetRetry ();
+          return (*it)->packet;
+        }
+    }
+  return 0;
+}
+
+bool
+BlockAckManager::RemovePacket (uint8_t tid, Mac48Address recipient, uint16_t seqnumber)
+{
+  NS_LOG_FUNCTION (this << static_cast<uint32_t> (tid) << recipient << seqnumber);
+  for (std::list<PacketQueueI>::iterator it = m_retryPackets.begin (); it != m_retryPackets.end (); it++)
+    {
+      if ((*it)->hdr.GetAddr1 () == recipient && (*it)->hdr.GetQosTid () == tid
+          && (*it)->hdr.GetSequenceNumber () == seqnumber)
+        {
+          m_retryPackets.erase (it);
+          return true;
+        }
+    }
+  return false;
+}
+
+bool
+BlockAckManager::IsInWindow (Mac48Address recipient, uint8_t tid, uint16_t seqnumber) const
+{
+  NS_LOG_FUNCTION (this << recipient << static_cast<uint32_t> (tid) << seqnumber);
+  AgreementsCI it = m_agreements.find (std::make_pair (recipient, tid));
+  if (it == m_agreements.end ()
+      || !it->second.first.IsEstablished ())
+    {
+      return false;
+    }
+  uint16_t winSize = std::min<uint16_t> (it->second.first.GetBufferSize (), 64);
+  return ((seqnumber - it->second.first.GetStartingSequence () + 4096) % 4096) < winSize;
+}
+
+void
+BlockAckManager::ScheduleBlockAckReq (Mac48Address recipient, uint8_t tid)
+{
+  NS_LOG_FUNCTION (this << recipient << static_cast<uint32_t> (tid));
+  AgreementsI it = m_agreements.find (std::make_pair (recipient, tid));
+  NS_ASSERT (it != m_agreements.end ());
+  Bar request (CreateBlockAckReq (it->second.first), recipient, tid, it->second.first.IsImmediateBlockAck ());
+  m_bars.push_back (request);
+}
+
 bool
 BlockAckManager::HasBar (struct Bar &bar)
 {
@@ -322,6 +378,10 @@ BlockAckManager::GetNRetryNeededPackets (Mac48Address recipient, uint8_t tid) co
                   it++;
                 }
             }
+          else
+            {
+              it++;
+            }
         }
     }
   return nPackets;
@@ -360,6 +420,20 @@ BlockAckManager::NotifyGotBlockAck (const CtrlBAckResponseHeader *blockAck, Mac4
                                                                         this,
                                                                         recipient, tid);
             }
+          /* the unacknowledged packets are queued again below: packets which were
+             waiting for a retransmission when the block ack was solicited must not
+             be queued twice */
+          for (std::list<PacketQueueI>::iterator retryIt = m_retryPackets.begin (); retryIt != m_retryPackets.end ();)
+            {
+              if ((*retryIt)->hdr.GetAddr1 () == recipient && (*retryIt)->hdr.GetQosTid () == tid)
+                {
+                  retryIt = m_retryPackets.erase (retryIt);
+                }
+              else
+                {
+                  retryIt++;
+                }
+            }
           if (blockAck->IsBasic ())
             {
               for (PacketQueueI queueIt = it->second.second.begin (); queueIt != queueEnd;)
@@ -446,31 +520,37 @@ BlockAckManager::ScheduleBlockAckReqIfNeeded (Mac48Address recipient, uint8_t ti
       || (GetNRetryNeededPackets (recipient, tid) == 0
           && m_queue->GetNPacketsByTidAndAddress (tid, WifiMacHeader::ADDR1, recipient) == 0))
     {
-      OriginatorBlockAckAgreement &agreement = (*it).second.first;
-      agreement.CompleteExchange ();
-
-      CtrlBAckRequestHeader reqHdr;
-      if (m_blockAckType == BASIC_BLOCK_ACK || m_blockAckType == COMPRESSED_BLOCK_ACK)
-        {
-          reqHdr.SetType (m_blockAckType);
-          reqHdr.SetTidInfo (agreement.GetTid ());
-          reqHdr.SetStartingSequence (agreement.GetStartingSequence ());
-        }
-      else if (m_blockAckType == MULTI_TID_BLOCK_ACK)
-        {
-          NS_FATAL_ERROR ("Multi-tid block ack is not supported.");
-        }
-      else
-        {
-          NS_FATAL_ERROR ("Invalid block ack type.");
-        }
-      Ptr<Packet> bar = Create<Packet> ();
-      bar->AddHeader (reqHdr);
-      return bar;
+      return CreateBlockAckReq ((*it).second.first);
     }
   return 0;
 }
 
+Ptr<Packet>
+BlockAckManager::CreateBlockAckReq (OriginatorBlockAckAgreement &agreement)
+{
+  NS_LOG_FUNCTION (this << &agreement);
+  agreement.CompleteExchange ();
+
+  CtrlBAckRequestHeader reqHdr;
+  if (m_blockAckType == BASIC_BLOCK_ACK || m_blockAckType == COMPRESSED_BLOCK_ACK)
+    {
+      reqHdr.SetType (m_blockAckType);
+      reqHdr.SetTidInfo (agreement.GetTid ());
+      reqHdr.SetStartingSequence (agreement.GetStartingSequence ());
+    }
+  else if (m_blockAckType == MULTI_TID_BLOCK_ACK)
+    {
+      NS_FATAL_ERROR ("Multi-tid block ack is not supported.");
+    }
+  else
+    {
+      NS_FATAL_ERROR ("Invalid block ack type.");
+    }
+  Ptr<Packet> bar = Create<Packet> ();
+  bar->AddHeader (reqHdr);
+  return bar;
+}
+
 void
 BlockAckManager::InactivityTimeout (Mac48Address recipient, uint8_t tid)
 {
@@ -502,9 +582,10 @@ BlockAckManager::NotifyAgreementUnsuccessful (Mac48Address recipient, uint8_t ti
 }
 
 void
-BlockAckManager::NotifyMpduTransmission (Mac48Address recipient, uint8_t tid, uint16_t nextSeqNumber)
+BlockAckManager::NotifyMpduTransmission (Mac48Address recipient, uint8_t tid, uint16_t nextSeqNumber,
+                                         WifiMacHeader::QosAckPolicy policy)
 {
-  NS_LOG_FUNCTION (this << recipient << static_cast<uint32_t> (tid) << nextSeqNumber);
+  NS_LOG_FUNCTION (this << recipient << static_cast<uint32_t> (tid) << nextSeqNumber << policy);
   Ptr<Packet> bar = 0;
   AgreementsI it = m_agreements.find (std::make_pair (recipient, tid));
   NS_ASSERT (it != m_agreements.end ());
@@ -519,14 +600,26 @@ BlockAckManager::NotifyMpduTransmission (Mac48Address recipient, uint8_t tid, ui
       nextSeq = nextSeqNumber;
     }
   it->second.first.NotifyMpduTransmission (nextSeq);
-  bar = ScheduleBlockAckReqIfNeeded (recipient, tid);
-  if (bar != 0)
+  if (policy == WifiMacHeader::BLOCK_ACK)
     {
-      Bar request (bar, recipient, tid, it->second.first.IsImmediateBlockAck ());
-      m_bars.push_back (request);
+      bar = ScheduleBlockAckReqIfNeeded (recipient, tid);
+      if (bar != 0)
+        {
+          Bar request (bar, recipient, tid, it->second.first.IsImmediateBlockAck ());
+          m_bars.push_back (request);
+        }
     }
 }
 
+void
+BlockAckManager::CompleteAmpduExchange (Mac48Address recipient, uint8_t tid)
+{
+  NS_LOG_FUNCTION (this << recipient << static_cast<uint32_t> (tid));
+  AgreementsI it = m_agreements.find (std::make_pair (recipient, tid));
+  NS_ASSERT (it != m_agreements.end ());
+  it->second.first.CompleteExchange ();
+}
+
 void
 BlockAckManager::SetQueue (Ptr<WifiMacQueue> queue)
 {
@@ -676,6 +769,7 @@ BlockAckManager::GetSeqNumOfNextRetryPacket (Mac48Address recipient, uint8_t tid
         {
           return (*it)->hdr.GetSequenceNumber ();
         }
+      it++;
     }
   return 4096;
 }
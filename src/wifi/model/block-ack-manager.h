@@ -139,6 +139,50 @@ public:
    * corresponding block ack bitmap.
    */
   Ptr<const Packet> GetNextPacket (WifiMacHeader &hdr);
+  /**
+   * \param hdr 802.11 header of returned packet (if exists).
+   * \param recipient Address of peer station involved in block ack mechanism.
+   * \param tid Traffic ID.
+   * \return the packet
+   *
+   * Returns the first packet (if exists) sent to <i>recipient</i> for <i>tid</i>
+   * and indicated as not received in a block ack bitmap. The packet is not
+   * removed from the retransmission queue: see RemovePacket.
+   */
+  Ptr<const Packet> PeekNextPacketByTidAndAddress (WifiMacHeader &hdr, Mac48Address recipient, uint8_t tid) const;
+  /**
+   * \param tid Traffic ID.
+   * \param recipient Address of peer station involved in block ack mechanism.
+   * \param seqnumber Sequence number of the packet.
+   * \return true if the packet was found in the retransmission queue
+   *
+   * Removes from the retransmission queue the packet sent to <i>recipient</i> for
+   * <i>tid</i> with sequence number <i>seqnumber</i>, typically because it is
+   * retransmitted in an A-MPDU. The packet remains stored until a block ack
+   * indicates it as received.
+   */
+  bool RemovePacket (uint8_t tid, Mac48Address recipient, uint16_t seqnumber);
+  /**
+   * \param recipient Address of peer station involved in block ack mechanism.
+   * \param tid Traffic ID.
+   * \param seqnumber Sequence number of an MPDU.
+   * \return true if an MPDU with sequence number <i>seqnumber</i> can be sent
+   * to <i>recipient</i> for <i>tid</i>
+   *
+   * An MPDU can be sent if it is within the window of the established agreement,
+   * which starts at the first MPDU not acknowledged yet and spans the minimum
+   * of the buffer size of the recipient and the 64 MPDUs of a compressed block ack.
+   */
+  bool IsInWindow (Mac48Address recipient, uint8_t tid, uint16_t seqnumber) const;
+  /**
+   * \param recipient Address of peer station involved in block ack mechanism.
+   * \param tid Traffic ID.
+   *
+   * Schedules a block ack request for the agreement with <i>recipient</i> for
+   * <i>tid</i>. Invoked when the block ack solicited by an A-MPDU was not
+   * received, to learn which of its MPDUs must be retransmitted.
+   */
+  void ScheduleBlockAckReq (Mac48Address recipient, uint8_t tid);
   bool HasBar (struct Bar &bar);
   /**
    * Returns true if there are packets that need of retransmission or at least a
@@ -198,12 +242,25 @@ public:
    * \param recipient Address of peer station involved in block ack mechanism.
    * \param tid Traffic ID of transmitted packet.
    * \param nextSeqNumber Sequence number of the next packet that would be trasmitted by EdcaTxopN.
+   * \param policy Ack policy of the transmitted packet.
    *
    * This method is typically invoked by ns3::EdcaTxopN object every time that a MPDU
-   * with ack policy subfield in Qos Control field set to Block Ack is transmitted.
+   * under block ack is transmitted, with ack policy subfield in Qos Control field set
+   * to Block Ack, or to Normal Ack when the MPDU is part of an A-MPDU.
    * The <i>nextSeqNumber</i> parameter is used to block transmission of packets that are out of bitmap.
+   * A block ack request is scheduled only for the Block Ack policy: an A-MPDU solicits
+   * the block ack itself.
    */
-  void NotifyMpduTransmission (Mac48Address recipient, uint8_t tid, uint16_t nextSeqNumber);
+  void NotifyMpduTransmission (Mac48Address recipient, uint8_t tid, uint16_t nextSeqNumber,
+                               WifiMacHeader::QosAckPolicy policy);
+  /**
+   * \param recipient Address of peer station involved in block ack mechanism.
+   * \param tid Traffic ID.
+   *
+   * Completes the exchange of the agreement with <i>recipient</i> for <i>tid</i>
+   * once an A-MPDU, which solicits an immediate block ack, has been sent.
+   */
+  void CompleteAmpduExchange (Mac48Address recipient, uint8_t tid);
   /**
    * \param nPackets Minimum number of packets for use of block ack.
    *
@@ -293,6 +350,14 @@ private:
    * <i>recipient</i>,<i>tid</i>) is needed.
    */
   Ptr<Packet> ScheduleBlockAckReqIfNeeded (Mac48Address recipient, uint8_t tid);
+  /**
+   * \param agreement the agreement the block ack request is for
+   * \return a block ack request for the agreement
+   *
+   * Completes the current exchange of the agreement and creates a block ack
+   * request starting at its starting sequence.
+   */
+  Ptr<Packet> CreateBlockAckReq (OriginatorBlockAckAgreement &agreement);
   /**
    * This method removes packets whose lifetime was exceeded.
    */
@@ -447,12 +447,13 @@ void
 DcfManager::DoGrantAccess (void)
 {
   NS_LOG_FUNCTION (this);
+  Time accessGrantStart = GetAccessGrantStart ();
   uint32_t k = 0;
   for (States::const_iterator i = m_states.begin (); i != m_states.end (); k++)
     {
       DcfState *state = *i;
       if (state->IsAccessRequested ()
-          && GetBackoffEndFor (state) <= Simulator::Now () )
+          && GetBackoffEndFor (state, accessGrantStart) <= Simulator::Now () )
         {
           /**
            * This is the first dcf we find with an expired backoff and which
@@ -466,7 +467,7 @@ DcfManager::DoGrantAccess (void)
             {
               DcfState *otherState = *j;
               if (otherState->IsAccessRequested ()
-                  && GetBackoffEndFor (otherState) <= Simulator::Now ())
+                  && GetBackoffEndFor (otherState, accessGrantStart) <= Simulator::Now ())
                 {
                   MY_DEBUG ("dcf " << k << " needs access. backoff expired. internal collision. slots=" <<
                             otherState->GetBackoffSlots ());
@@ -547,31 +548,30 @@ DcfManager::GetAccessGrantStart (void) const
 }
 
 Time
-DcfManager::GetBackoffStartFor (DcfState *state)
+DcfManager::GetBackoffStartFor (DcfState *state, Time accessGrantStart) const
 {
-  NS_LOG_FUNCTION (this << state);
-  Time mostRecentEvent = MostRecent (state->GetBackoffStart (),
-                                     GetAccessGrantStart () + MicroSeconds (state->GetAifsn () * m_slotTimeUs));
-
-  return mostRecentEvent;
+  return Max (state->GetBackoffStart (),
+              accessGrantStart + MicroSeconds (state->GetAifsn () * m_slotTimeUs));
 }
 
 Time
-DcfManager::GetBackoffEndFor (DcfState *state)
+DcfManager::GetBackoffEndFor (DcfState *state, Time accessGrantStart) const
 {
-  return GetBackoffStartFor (state) + MicroSeconds (state->GetBackoffSlots () * m_slotTimeUs);
+  return GetBackoffStartFor (state, accessGrantStart) + MicroSeconds (state->GetBackoffSlots () * m_slotTimeUs);
 }
 
 void
 DcfManager::UpdateBackoff (void)
 {
   NS_LOG_FUNCTION (this);
+  // the access grant start does not depend on the backoff of the states
+  Time accessGrantStart = GetAccessGrantStart ();
   uint32_t k = 0;
   for (States::const_iterator i = m_states.begin (); i != m_states.end (); i++, k++)
     {
       DcfState *state = *i;
 
-      Time backoffStart = GetBackoffStartFor (state);
+      Time backoffStart = GetBackoffStartFor (state, accessGrantStart);
       if (backoffStart <= Simulator::Now ())
         {
           uint32_t nus = (Simulator::Now () - backoffStart).GetMicroSeconds ();
@@ -591,15 +591,19 @@ DcfManager::DoRestartAccessTimeoutIfNeeded (void)
   /**
    * Is there a DcfState which needs to access the medium, and,
    * if there is one, how many slots for AIFS+backoff does it require ?
+   * Unless the state of the medium changes again, which restarts the
+   * access timeout, the backoffs count down slot after slot until the
+   * earliest of them ends: a single access timeout is scheduled then.
    */
   bool accessTimeoutNeeded = false;
   Time expectedBackoffEnd = Simulator::GetMaximumSimulationTime ();
+  Time accessGrantStart = GetAccessGrantStart ();
   for (States::const_iterator i = m_states.begin (); i != m_states.end (); i++)
     {
       DcfState *state = *i;
       if (state->IsAccessRequested ())
         {
-          Time tmp = GetBackoffEndFor (state);
+          Time tmp = GetBackoffEndFor (state, accessGrantStart);
           if (tmp > Simulator::Now ())
             {
               accessTimeoutNeeded = true;
@@ -607,21 +611,25 @@ DcfManager::DoRestartAccessTimeoutIfNeeded (void)
             }
         }
     }
-  if (accessTimeoutNeeded)
+  if (!accessTimeoutNeeded)
     {
-      MY_DEBUG ("expected backoff end=" << expectedBackoffEnd);
-      Time expectedBackoffDelay = expectedBackoffEnd - Simulator::Now ();
-      if (m_accessTimeout.IsRunning ()
-          && Simulator::GetDelayLeft (m_accessTimeout) > expectedBackoffDelay)
-        {
-          m_accessTimeout.Cancel ();
-        }
-      if (m_accessTimeout.IsExpired ())
-        {
-          m_accessTimeout = Simulator::Schedule (expectedBackoffDelay,
-                                                 &DcfManager::AccessTimeout, this);
-        }
+      m_accessTimeout.Cancel ();
+      return;
+    }
+  MY_DEBUG ("expected backoff end=" << expectedBackoffEnd);
+  Time expectedBackoffDelay = expectedBackoffEnd - Simulator::Now ();
+  /**
+   * A timeout which already expires at the expected backoff end keeps
+   * its place among the events scheduled at that time.
+   */
+  if (m_accessTimeout.IsRunning ()
+      && Simulator::GetDelayLeft (m_accessTimeout) == expectedBackoffDelay)
+    {
+      return;
     }
+  m_accessTimeout.Cancel ();
+  m_accessTimeout = Simulator::Schedule (expectedBackoffDelay,
+                                         &DcfManager::AccessTimeout, this);
 }
 
 void
@@ -633,6 +641,7 @@ DcfManager::NotifyRxStartNow (Time duration)
   m_lastRxStart = Simulator::Now ();
   m_lastRxDuration = duration;
   m_rxing = true;
+  DoRestartAccessTimeoutIfNeeded ();
 }
 void
 DcfManager::NotifyRxEndOkNow (void)
@@ -642,6 +651,7 @@ DcfManager::NotifyRxEndOkNow (void)
   m_lastRxEnd = Simulator::Now ();
   m_lastRxReceivedOk = true;
   m_rxing = false;
+  DoRestartAccessTimeoutIfNeeded ();
 }
 void
 DcfManager::NotifyRxEndErrorNow (void)
@@ -651,6 +661,7 @@ DcfManager::NotifyRxEndErrorNow (void)
   m_lastRxEnd = Simulator::Now ();
   m_lastRxReceivedOk = false;
   m_rxing = false;
+  DoRestartAccessTimeoutIfNeeded ();
 }
 void
 DcfManager::NotifyTxStartNow (Time duration)
@@ -671,6 +682,7 @@ DcfManager::NotifyTxStartNow (Time duration)
   UpdateBackoff ();
   m_lastTxStart = Simulator::Now ();
   m_lastTxDuration = duration;
+  DoRestartAccessTimeoutIfNeeded ();
 }
 void
 DcfManager::NotifyMaybeCcaBusyStartNow (Time duration)
@@ -680,6 +692,7 @@ DcfManager::NotifyMaybeCcaBusyStartNow (Time duration)
   UpdateBackoff ();
   m_lastBusyStart = Simulator::Now ();
   m_lastBusyDuration = duration;
+  DoRestartAccessTimeoutIfNeeded ();
 }
 
 
@@ -773,6 +786,7 @@ DcfManager::NotifyNavStartNow (Time duration)
     {
       m_lastNavStart = Simulator::Now ();
       m_lastNavDuration = duration;
+      DoRestartAccessTimeoutIfNeeded ();
     }
 }
 void
@@ -781,6 +795,7 @@ DcfManager::NotifyAckTimeoutStartNow (Time duration)
   NS_LOG_FUNCTION (this << duration);
   NS_ASSERT (m_lastAckTimeoutEnd < Simulator::Now ());
   m_lastAckTimeoutEnd = Simulator::Now () + duration;
+  DoRestartAccessTimeoutIfNeeded ();
 }
 void
 DcfManager::NotifyAckTimeoutResetNow ()
@@ -794,6 +809,7 @@ DcfManager::NotifyCtsTimeoutStartNow (Time duration)
 {
   NS_LOG_FUNCTION (this << duration);
   m_lastCtsTimeoutEnd = Simulator::Now () + duration;
+  DoRestartAccessTimeoutIfNeeded ();
 }
 void
 DcfManager::NotifyCtsTimeoutResetNow ()
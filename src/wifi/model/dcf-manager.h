@@ -436,17 +436,25 @@ private:
    * started for the given DcfState.
    *
    * \param state
+   * \param accessGrantStart the value returned by GetAccessGrantStart
    * \return the time when the backoff procedure started
    */
-  Time GetBackoffStartFor (DcfState *state);
+  Time GetBackoffStartFor (DcfState *state, Time accessGrantStart) const;
   /**
    * Return the time when the backoff procedure
    * ended (or will ended) for the given DcfState.
    *
    * \param state
+   * \param accessGrantStart the value returned by GetAccessGrantStart
    * \return the time when the backoff procedure ended (or will ended)
    */
-  Time GetBackoffEndFor (DcfState *state);
+  Time GetBackoffEndFor (DcfState *state, Time accessGrantStart) const;
+  /**
+   * Schedule the access timeout at the earliest backoff end of the
+   * DcfStates which requested access, if the medium stays idle until
+   * then, and cancel it otherwise.  Called each time the state of the
+   * medium changes.
+   */
   void DoRestartAccessTimeoutIfNeeded (void);
   /**
    * Called when access timeout should occur
@@ -29,9 +29,11 @@
 #include "mac-tx-middle.h"
 #include "wifi-mac-trailer.h"
 #include "wifi-mac.h"
+#include "wifi-phy.h"
 #include "random-stream.h"
 #include "wifi-mac-queue.h"
 #include "msdu-aggregator.h"
+#include "mpdu-aggregator.h"
 #include "mgt-headers.h"
 #include "qos-blocked-destinations.h"
 
@@ -172,6 +174,8 @@ EdcaTxopN::EdcaTxopN ()
   : m_manager (0),
     m_currentPacket (0),
     m_aggregator (0),
+    m_mpduAggregator (0),
+    m_isAmpdu (false),
     m_blockAckType (COMPRESSED_BLOCK_ACK)
 {
   NS_LOG_FUNCTION (this);
@@ -215,6 +219,7 @@ EdcaTxopN::DoDispose (void)
   m_blockAckListener = 0;
   m_txMiddle = 0;
   m_aggregator = 0;
+  m_mpduAggregator = 0;
 }
 
 void
@@ -342,6 +347,7 @@ EdcaTxopN::NotifyAccessGranted (void)
   NS_LOG_FUNCTION (this);
   if (m_currentPacket == 0)
     {
+      m_isAmpdu = false;
       if (m_queue->IsEmpty () && !m_baManager->HasPackets ())
         {
           NS_LOG_DEBUG ("queue is empty");
@@ -495,9 +501,17 @@ EdcaTxopN::NotifyAccessGranted (void)
               NS_LOG_DEBUG ("tx unicast");
             }
           params.DisableNextData ();
-          m_low->StartTransmission (m_currentPacket, &m_currentHdr,
-                                    params, m_transmissionListener);
-          CompleteTx ();
+          if (m_mpduAggregator != 0 && m_currentHdr.IsQosData () && m_currentHdr.IsQosBlockAck ()
+              && SendAmpdu (params))
+            {
+              NS_LOG_DEBUG ("tx unicast A-MPDU");
+            }
+          else
+            {
+              m_low->StartTransmission (m_currentPacket, &m_currentHdr,
+                                        params, m_transmissionListener);
+              CompleteTx ();
+            }
         }
     }
 }
@@ -544,6 +558,13 @@ EdcaTxopN::MissedCts (void)
     {
       m_dcf->UpdateFailedCw ();
     }
+  if (m_isAmpdu)
+    {
+      /* the MPDUs of the A-MPDU are stored by the block ack manager: the
+         block ack request tells which of them must be sent again */
+      m_baManager->ScheduleBlockAckReq (m_currentHdr.GetAddr1 (), m_currentHdr.GetQosTid ());
+      m_currentPacket = 0;
+    }
   m_dcf->StartBackoffNow (m_rng->GetNext (0, m_dcf->GetCw ()));
   RestartAccessIfNeeded ();
 }
@@ -646,9 +667,18 @@ EdcaTxopN::MissedBlockAck (void)
 {
   NS_LOG_FUNCTION (this);
   NS_LOG_DEBUG ("missed block ack");
-  //should i report this to station addressed by ADDR1?
-  NS_LOG_DEBUG ("Retransmit block ack request");
-  m_currentHdr.SetRetry ();
+  if (m_isAmpdu)
+    {
+      NS_LOG_DEBUG ("Request a block ack for the A-MPDU");
+      m_baManager->ScheduleBlockAckReq (m_currentHdr.GetAddr1 (), m_currentHdr.GetQosTid ());
+      m_currentPacket = 0;
+    }
+  else
+    {
+      //should i report this to station addressed by ADDR1?
+      NS_LOG_DEBUG ("Retransmit block ack request");
+      m_currentHdr.SetRetry ();
+    }
   m_dcf->UpdateFailedCw ();
 
   m_dcf->StartBackoffNow (m_rng->GetNext (0, m_dcf->GetCw ()));
@@ -661,6 +691,12 @@ EdcaTxopN::GetMsduAggregator (void) const
   return m_aggregator;
 }
 
+Ptr<MpduAggregator>
+EdcaTxopN::GetMpduAggregator (void) const
+{
+  return m_mpduAggregator;
+}
+
 void
 EdcaTxopN::RestartAccessIfNeeded (void)
 {
@@ -866,6 +902,13 @@ EdcaTxopN::SetMsduAggregator (Ptr<MsduAggregator> aggr)
   m_aggregator = aggr;
 }
 
+void
+EdcaTxopN::SetMpduAggregator (Ptr<MpduAggregator> aggr)
+{
+  NS_LOG_FUNCTION (this << aggr);
+  m_mpduAggregator = aggr;
+}
+
 void
 EdcaTxopN::PushFront (Ptr<const Packet> packet, const WifiMacHeader &hdr)
 {
@@ -920,6 +963,96 @@ EdcaTxopN::GotBlockAck (const CtrlBAckResponseHeader *blockAck, Mac48Address rec
   RestartAccessIfNeeded ();
 }
 
+bool
+EdcaTxopN::SendAmpdu (MacLowTransmissionParameters params)
+{
+  NS_LOG_FUNCTION (this << params);
+  Mac48Address recipient = m_currentHdr.GetAddr1 ();
+  uint8_t tid = m_currentHdr.GetQosTid ();
+  if (m_low->GetPhy ()->GetNMcs () == 0
+      || !m_stationManager->GetHtSupported (recipient))
+    {
+      // an A-MPDU is carried by an HT PPDU
+      return false;
+    }
+  WifiMacTrailer fcs;
+  uint32_t mpduSize = m_currentHdr.GetSize () + m_currentPacket->GetSize () + fcs.GetSerializedSize ();
+  if (!m_mpduAggregator->CanBeAggregated (mpduSize, 0))
+    {
+      return false;
+    }
+  uint32_t ampduSize = MpduAggregator::GetSizeIfAggregated (mpduSize, 0);
+  if (!m_currentHdr.IsRetry ())
+    {
+      m_baManager->StorePacket (m_currentPacket, m_currentHdr, m_currentPacketTimestamp);
+    }
+
+  /* the MPDUs of an A-MPDU with ack policy Normal Ack solicit an immediate
+     block ack, as if a block ack request followed them */
+  MacLow::Mpdus mpdus;
+  WifiMacHeader hdr = m_currentHdr;
+  hdr.SetQosAckPolicy (WifiMacHeader::NORMAL_ACK);
+  mpdus.push_back (std::make_pair (m_currentPacket, hdr));
+  m_baManager->NotifyMpduTransmission (recipient, tid, m_txMiddle->GetNextSeqNumberByTidAndAddress (tid, recipient),
+                                       WifiMacHeader::NORMAL_ACK);
+  // the retransmissions first, then the queued packets
+  while (mpdus.size () < 64)
+    {
+      bool retry = true;
+      Ptr<const Packet> packet = m_baManager->PeekNextPacketByTidAndAddress (hdr, recipient, tid);
+      if (packet == 0)
+        {
+          retry = false;
+          packet = m_queue->PeekByTidAndAddress (&hdr, tid, WifiMacHeader::ADDR1, recipient);
+          if (packet == 0
+              || !m_baManager->IsInWindow (recipient, tid, m_txMiddle->GetNextSeqNumberByTidAndAddress (tid, recipient)))
+            {
+              break;
+            }
+        }
+      mpduSize = hdr.GetSize () + packet->GetSize () + fcs.GetSerializedSize ();
+      if (!m_mpduAggregator->CanBeAggregated (mpduSize, ampduSize))
+        {
+          break;
+        }
+      ampduSize = MpduAggregator::GetSizeIfAggregated (mpduSize, ampduSize);
+      if (retry)
+        {
+          m_baManager->RemovePacket (tid, recipient, hdr.GetSequenceNumber ());
+        }
+      else
+        {
+          Time tStamp;
+          packet = m_queue->DequeueByTidAndAddress (&hdr, tStamp, tid, WifiMacHeader::ADDR1, recipient);
+          hdr.SetSequenceNumber (m_txMiddle->GetNextSequenceNumberfor (&hdr));
+          hdr.SetFragmentNumber (0);
+          hdr.SetNoMoreFragments ();
+          hdr.SetNoRetry ();
+          hdr.SetQosAckPolicy (WifiMacHeader::BLOCK_ACK);
+          m_baManager->StorePacket (packet, hdr, tStamp);
+        }
+      hdr.SetQosAckPolicy (WifiMacHeader::NORMAL_ACK);
+      mpdus.push_back (std::make_pair (packet, hdr));
+      m_baManager->NotifyMpduTransmission (recipient, tid, m_txMiddle->GetNextSeqNumberByTidAndAddress (tid, recipient),
+                                           WifiMacHeader::NORMAL_ACK);
+    }
+  NS_LOG_DEBUG ("A-MPDU of " << mpdus.size () << " MPDUs, size=" << ampduSize);
+  // the block ack solicited by the A-MPDU completes the exchange
+  m_baManager->CompleteAmpduExchange (recipient, tid);
+
+  if (m_blockAckType == BASIC_BLOCK_ACK)
+    {
+      params.EnableBasicBlockAck ();
+    }
+  else
+    {
+      params.EnableCompressedBlockAck ();
+    }
+  m_isAmpdu = true;
+  m_low->StartAmpduTransmission (mpdus, m_mpduAggregator, params, m_transmissionListener);
+  return true;
+}
+
 void
 EdcaTxopN::VerifyBlockAck (void)
 {
@@ -949,7 +1082,8 @@ EdcaTxopN::CompleteTx (void)
         }
       m_baManager->NotifyMpduTransmission (m_currentHdr.GetAddr1 (), m_currentHdr.GetQosTid (),
                                            m_txMiddle->GetNextSeqNumberByTidAndAddress (m_currentHdr.GetQosTid (),
-                                                                                        m_currentHdr.GetAddr1 ()));
+                                                                                        m_currentHdr.GetAddr1 ()),
+                                           WifiMacHeader::BLOCK_ACK);
     }
 }
 
@@ -42,6 +42,7 @@ namespace ns3 {
 class DcfState;
 class DcfManager;
 class MacLow;
+class MacLowTransmissionParameters;
 class MacTxMiddle;
 class WifiMac;
 class WifiMacParameters;
@@ -49,6 +50,7 @@ class WifiMacQueue;
 class RandomStream;
 class QosBlockedDestinations;
 class MsduAggregator;
+class MpduAggregator;
 class MgtAddBaResponseHeader;
 class BlockAckManager;
 class MgtDelBaHeader;
@@ -162,6 +164,7 @@ public:
    */
   Ptr<MacLow> Low (void);
   Ptr<MsduAggregator> GetMsduAggregator (void) const;
+  Ptr<MpduAggregator> GetMpduAggregator (void) const;
 
   /* dcf notifications forwarded here */
   /**
@@ -327,6 +330,13 @@ public:
    */
   void Queue (Ptr<const Packet> packet, const WifiMacHeader &hdr);
   void SetMsduAggregator (Ptr<MsduAggregator> aggr);
+  /**
+   * \param aggr the MPDU aggregator
+   *
+   * Once set, the MPDUs sent with ack policy Block Ack are aggregated into
+   * A-MPDUs with the other MPDUs for the same receiver and TID.
+   */
+  void SetMpduAggregator (Ptr<MpduAggregator> aggr);
   /**
    * \param packet packet to send
    * \param hdr header of packet to send.
@@ -420,6 +430,17 @@ private:
    * if an established block ack agreement exists with the receiver.
    */
   void VerifyBlockAck (void);
+  /**
+   * \param params the transmission parameters of the current packet
+   * \return true if the current packet was sent in an A-MPDU
+   *
+   * Aggregates into an A-MPDU the current packet, which has ack policy Block Ack,
+   * with the packets waiting for a retransmission and then with the queued packets
+   * for the same receiver and TID, within the window of the block ack agreement,
+   * and starts its transmission. The A-MPDU solicits an immediate block ack.
+   * Returns false, sending nothing, if the current packet cannot be aggregated.
+   */
+  bool SendAmpdu (MacLowTransmissionParameters params);
 
   AcIndex m_ac;
   class Dcf;
@@ -447,6 +468,8 @@ private:
 
   WifiMacHeader m_currentHdr;
   Ptr<MsduAggregator> m_aggregator;
+  Ptr<MpduAggregator> m_mpduAggregator;
+  bool m_isAmpdu; //!< true if the current packet was sent in an A-MPDU
   TypeOfStation m_typeOfStation;
   QosBlockedDestinations *m_qosBlockedDestinations;
   BlockAckManager *m_baManager;
@@ -144,6 +144,12 @@ HtCapabilities::GetShortGuardInterval20(void) const
   return m_shortGuardInterval20;
 }
 
+uint8_t
+HtCapabilities::GetHtSupported (void) const
+{
+  return m_htSupported;
+}
+
 uint8_t
 HtCapabilities::GetInformationFieldSize () const
 {
@@ -303,6 +309,7 @@ HtCapabilities::DeserializeInformationField (Buffer::Iterator start,
   uint8_t ampduparam = i.ReadU8 ();
   uint64_t mcsset1=i.ReadLsbtohU64 ();
   uint64_t mcsset2 = i.ReadLsbtohU64 ();
+  SetHtSupported (1);
   SetHtCapabilitiesInfo(htinfo);
   SetAmpduParameters(ampduparam);
   SetSupportedMcsSet(mcsset1,mcsset2);
@@ -64,6 +64,8 @@ public:
   uint8_t GetLdpc (void) const;
   uint8_t GetGreenfield (void) const;
   uint8_t GetShortGuardInterval20 (void) const;
+  //returns whether the element was present, i.e. whether the station supports HT
+  uint8_t GetHtSupported (void) const;
   uint8_t GetSupportedChannelWidth (void) const; //2040 supported or not
   uint8_t* GetRxMcsBitmask();
   
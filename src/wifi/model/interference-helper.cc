@@ -124,7 +124,12 @@ InterferenceHelper::NiChange::operator < (const InterferenceHelper::NiChange& o)
 InterferenceHelper::InterferenceHelper ()
   : m_errorRateModel (0),
     m_firstPower (0.0),
-    m_rxing (false)
+    m_rxing (false),
+    m_cursor (0),
+    m_cursorPower (0.0),
+    m_abstraction (false),
+    m_power (0.0),
+    m_energy (0.0)
 {
 }
 InterferenceHelper::~InterferenceHelper ()
@@ -175,21 +180,48 @@ InterferenceHelper::GetErrorRateModel (void) const
   return m_errorRateModel;
 }
 
+void
+InterferenceHelper::SetAbstraction (bool enable)
+{
+  EraseEvents ();
+  m_abstraction = enable;
+}
+
+bool
+InterferenceHelper::GetAbstraction (void) const
+{
+  return m_abstraction;
+}
+
 Time
 InterferenceHelper::GetEnergyDuration (double energyW)
 {
   Time now = Simulator::Now ();
-  double noiseInterferenceW = 0.0;
+  if (m_abstraction)
+    {
+      UpdateEnergy ();
+      double powerW = m_power;
+      Time end = now;
+      for (SignalEnds::const_iterator i = m_ends.begin (); i != m_ends.end (); i++)
+        {
+          powerW -= i->second;
+          end = i->first;
+          if (powerW < energyW)
+            {
+              break;
+            }
+        }
+      return end - now;
+    }
+  // the changes in the past only matter through their sum, which is
+  // maintained incrementally: only look at the ones still to come.
+  AdvanceCursor (now);
+  double noiseInterferenceW = m_cursorPower;
   Time end = now;
-  noiseInterferenceW = m_firstPower;
-  for (NiChanges::const_iterator i = m_niChanges.begin (); i != m_niChanges.end (); i++)
+  for (NiChanges::const_iterator i = m_niChanges.begin () + m_cursor; i != m_niChanges.end (); i++)
     {
       noiseInterferenceW += i->GetDelta ();
       end = i->GetTime ();
-      if (end < now)
-        {
-          continue;
-        }
       if (noiseInterferenceW < energyW)
         {
           break;
@@ -201,15 +233,16 @@ InterferenceHelper::GetEnergyDuration (double energyW)
 void
 InterferenceHelper::AppendEvent (Ptr<InterferenceHelper::Event> event)
 {
-  Time now = Simulator::Now ();
+  if (m_abstraction)
+    {
+      UpdateEnergy ();
+      m_power += event->GetRxPowerW ();
+      m_ends.insert (std::make_pair (event->GetEndTime (), event->GetRxPowerW ()));
+      return;
+    }
   if (!m_rxing)
     {
-      NiChanges::iterator nowIterator = GetPosition (now);
-      for (NiChanges::iterator i = m_niChanges.begin (); i != nowIterator; i++)
-        {
-          m_firstPower += i->GetDelta ();
-        }
-      m_niChanges.erase (m_niChanges.begin (), nowIterator);
+      PruneNiChanges ();
       m_niChanges.insert (m_niChanges.begin (), NiChange (event->GetStartTime (), event->GetRxPowerW ()));
     }
   else
@@ -236,21 +269,10 @@ InterferenceHelper::CalculateSnr (double signal, double noiseInterference, WifiM
 }
 
 double
-InterferenceHelper::CalculateNoiseInterferenceW (Ptr<InterferenceHelper::Event> event, NiChanges *ni) const
+InterferenceHelper::CalculateNoiseInterferenceW (Ptr<InterferenceHelper::Event> event) const
 {
-  double noiseInterference = m_firstPower;
   NS_ASSERT (m_rxing);
-  for (NiChanges::const_iterator i = m_niChanges.begin () + 1; i != m_niChanges.end (); i++)
-    {
-      if ((event->GetEndTime () == i->GetTime ()) && event->GetRxPowerW () == -i->GetDelta ())
-        {
-          break;
-        }
-      ni->push_back (*i);
-    }
-  ni->insert (ni->begin (), NiChange (event->GetStartTime (), noiseInterference));
-  ni->push_back (NiChange (event->GetEndTime (), 0));
-  return noiseInterference;
+  return m_firstPower;
 }
 
 double
@@ -267,294 +289,193 @@ InterferenceHelper::CalculateChunkSuccessRate (double snir, Time duration, WifiM
 }
 
 double
-InterferenceHelper::CalculatePer (Ptr<const InterferenceHelper::Event> event, NiChanges *ni) const
+InterferenceHelper::CalculatePsr (Ptr<const InterferenceHelper::Event> event, double noiseInterferenceW,
+                                  const PlcpSection *sections, uint32_t nSections) const
 {
-  double psr = 1.0; /* Packet Success Rate */
-  NiChanges::iterator j = ni->begin ();
-  Time previous = (*j).GetTime ();
-  WifiMode payloadMode = event->GetPayloadMode ();
-  WifiPreamble preamble = event->GetPreambleType ();
- WifiMode MfHeaderMode ;
- if (preamble==WIFI_PREAMBLE_HT_MF)
-   {
-    MfHeaderMode = WifiPhy::GetMFPlcpHeaderMode (payloadMode, preamble); //return L-SIG mode
+  // nothing before the earliest section is subject to errors
+  Time firstStart = sections[0].start;
+  for (uint32_t k = 1; k < nSections; k++)
+    {
+      firstStart = std::min (firstStart, sections[k].start);
+    }
 
-   }
-  WifiMode headerMode = WifiPhy::GetPlcpHeaderMode (payloadMode, preamble);
-  Time plcpHeaderStart = (*j).GetTime () + MicroSeconds (WifiPhy::GetPlcpPreambleDurationMicroSeconds (payloadMode, preamble)); //packet start time+ preamble
-  Time plcpHsigHeaderStart=plcpHeaderStart+ MicroSeconds (WifiPhy::GetPlcpHeaderDurationMicroSeconds (payloadMode, preamble));//packet start time+ preamble+L SIG
-  Time plcpHtTrainingSymbolsStart = plcpHsigHeaderStart + MicroSeconds (WifiPhy::GetPlcpHtSigHeaderDurationMicroSeconds (payloadMode, preamble));//packet start time+ preamble+L SIG+HT SIG
-  Time plcpPayloadStart =plcpHtTrainingSymbolsStart + MicroSeconds (WifiPhy::GetPlcpHtTrainingSymbolDurationMicroSeconds (payloadMode, preamble,event->GetTxVector())); //packet start time+ preamble+L SIG+HT SIG+Training
-  double noiseInterferenceW = (*j).GetDelta ();
+  double psr = 1.0; /* Packet Success Rate */
   double powerW = event->GetRxPowerW ();
-    j++;
-  while (ni->end () != j)
+  Time previous = event->GetStartTime ();
+  // the first change is the start of the event itself
+  NiChanges::const_iterator j = m_niChanges.begin () + 1;
+  while (true)
     {
-      Time current = (*j).GetTime ();
+      // the chunks end at the end of the event itself
+      bool last = j == m_niChanges.end ()
+        || ((event->GetEndTime () == j->GetTime ()) && powerW == -j->GetDelta ());
+      Time current = last ? event->GetEndTime () : j->GetTime ();
       NS_ASSERT (current >= previous);
-      //Case 1: Both prev and curr point to the payload
-      if (previous >= plcpPayloadStart)
-        {
-          psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                          noiseInterferenceW,
-                                                          payloadMode),
-                                            current - previous,
-                                            payloadMode);
-        }
-      //Case 2: previous is before payload
-      else if (previous >= plcpHtTrainingSymbolsStart)
-        {
-          //Case 2a: current is after payload
-          if (current >= plcpPayloadStart)
-            { 
-               //Case 2ai and 2aii: All formats
-               psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                              noiseInterferenceW,
-                                                              payloadMode),
-                                                current - plcpPayloadStart,
-                                                payloadMode);
-                
-              }
-        }
-      //Case 3: previous is in HT-SIG: Non HT will not enter here since it didn't enter in the last two and they are all the same for non HT
-      else if (previous >=plcpHsigHeaderStart)
+      if (current > firstStart)
         {
-          //Case 3a: cuurent after payload start
-          if (current >=plcpPayloadStart)
-             {
-                   psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                              noiseInterferenceW,
-                                                              payloadMode),
-                                                current - plcpPayloadStart,
-                                                payloadMode);
-                 
-                    psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                              noiseInterferenceW,
-                                                              headerMode),
-                                               plcpHtTrainingSymbolsStart - previous,
-                                                headerMode);
-              }
-          //case 3b: current after HT training symbols start
-          else if (current >=plcpHtTrainingSymbolsStart)
-             {
-                psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                                noiseInterferenceW,
-                                                                headerMode),
-                                                   plcpHtTrainingSymbolsStart - previous,
-                                                   headerMode);  
-                   
-             }
-         //Case 3c: current is with previous in HT sig
-         else
+          for (uint32_t k = 0; k < nSections; k++)
             {
-                psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                                noiseInterferenceW,
-                                                                headerMode),
-                                                   current- previous,
-                                                   headerMode);  
-                   
-            }
-      }
-      //Case 4: previous in L-SIG: GF will not reach here because it will execute the previous if and exit
-      else if (previous >= plcpHeaderStart)
-        {
-          //Case 4a: current after payload start  
-          if (current >=plcpPayloadStart)
-             {
-                   psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                              noiseInterferenceW,
-                                                              payloadMode),
-                                                      current - plcpPayloadStart,
-                                                      payloadMode);
-                    //Case 4ai: Non HT format (No HT-SIG or Training Symbols)
-              if (preamble == WIFI_PREAMBLE_LONG || preamble == WIFI_PREAMBLE_SHORT) //plcpHtTrainingSymbolsStart==plcpHeaderStart)
-                {
-                    psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                              noiseInterferenceW,
-                                                              headerMode),
-                                                plcpPayloadStart - previous,
-                                                headerMode);
-                }
-
-               else{
-                    psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                              noiseInterferenceW,
-                                                              headerMode),
-                                                      plcpHtTrainingSymbolsStart - plcpHsigHeaderStart,
-                                                      headerMode);
-                    psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                                    noiseInterferenceW,
-                                                                    MfHeaderMode),
-                                                      plcpHsigHeaderStart - previous,
-                                                      MfHeaderMode);
-                 }
-              }
-           //Case 4b: current in HT training symbol. non HT will not come here since it went in previous if or if the previous ifis not true this will be not true        
-          else if (current >=plcpHtTrainingSymbolsStart)
-             {
-                psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                              noiseInterferenceW,
-                                                              headerMode),
-                                                  plcpHtTrainingSymbolsStart - plcpHsigHeaderStart,
-                                                  headerMode);
-                psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                                noiseInterferenceW,
-                                                                MfHeaderMode),
-                                                   plcpHsigHeaderStart - previous,
-                                                   MfHeaderMode);
-              }
-          //Case 4c: current in H sig.non HT will not come here since it went in previous if or if the previous ifis not true this will be not true
-          else if (current >=plcpHsigHeaderStart)
-             {
-                psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                                noiseInterferenceW,
-                                                                headerMode),
-                                                  current - plcpHsigHeaderStart,
-                                                  headerMode);
-                 psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                                 noiseInterferenceW,
-                                                                 MfHeaderMode),
-                                                   plcpHsigHeaderStart - previous,
-                                                   MfHeaderMode);
-
-             }
-         //Case 4d: Current with prev in L SIG
-         else 
-            {
-                //Case 4di: Non HT format (No HT-SIG or Training Symbols)
-              if (preamble == WIFI_PREAMBLE_LONG || preamble == WIFI_PREAMBLE_SHORT) //plcpHtTrainingSymbolsStart==plcpHeaderStart)
-                {
-                    psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                              noiseInterferenceW,
-                                                              headerMode),
-                                                current - previous,
-                                                headerMode);
-                }
-               else
+              Time start = std::max (previous, sections[k].start);
+              Time end = std::min (current, sections[k].end);
+              if (end > start)
                 {
-                psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                               noiseInterferenceW,
-                                                               MfHeaderMode),
-                                                 current - previous,
-                                                 MfHeaderMode);
+                  psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
+                                                                  noiseInterferenceW,
+                                                                  sections[k].mode),
+                                                    end - start,
+                                                    sections[k].mode);
                 }
             }
         }
-      //Case 5: previous is in the preamble works for all cases
-      else
+      if (last)
         {
-          if (current >= plcpPayloadStart)
-            {
-              //for all
-              psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                              noiseInterferenceW,
-                                                              payloadMode),
-                                                current - plcpPayloadStart,
-                                                payloadMode); 
-             
-               // Non HT format (No HT-SIG or Training Symbols)
-              if (preamble == WIFI_PREAMBLE_LONG || preamble == WIFI_PREAMBLE_SHORT)
-                 psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                                 noiseInterferenceW,
-                                                                  headerMode),
-                                                    plcpPayloadStart - plcpHeaderStart,
-                                                    headerMode);
-              else
-              // Greenfield or Mixed format
-                psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                                noiseInterferenceW,
-                                                                headerMode),
-                                                  plcpHtTrainingSymbolsStart - plcpHsigHeaderStart,
-                                                  headerMode);
-              if (preamble == WIFI_PREAMBLE_HT_MF)
-                 psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                                 noiseInterferenceW,
-                                                                 MfHeaderMode),
-                                                   plcpHsigHeaderStart-plcpHeaderStart,
-                                                   MfHeaderMode);             
-            }
-          else if (current >=plcpHtTrainingSymbolsStart )
-          { 
-              // Non HT format will not come here since it will execute prev if
-              // Greenfield or Mixed format
-                psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                                noiseInterferenceW,
-                                                                headerMode),
-                                                  plcpHtTrainingSymbolsStart - plcpHsigHeaderStart,
-                                                  headerMode);
-              if (preamble == WIFI_PREAMBLE_HT_MF)
-                 psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                                 noiseInterferenceW,
-                                                                 MfHeaderMode),
-                                                   plcpHsigHeaderStart-plcpHeaderStart,
-                                                   MfHeaderMode);       
-           }
-          //non HT will not come here     
-          else if (current >=plcpHsigHeaderStart)
-             { 
-                psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                                noiseInterferenceW,
-                                                                headerMode),
-                                                  current- plcpHsigHeaderStart,
-                                                  headerMode); 
-                if  (preamble != WIFI_PREAMBLE_HT_GF)
-                 {
-                   psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                                   noiseInterferenceW,
-                                                                   MfHeaderMode),
-                                                     plcpHsigHeaderStart-plcpHeaderStart,
-                                                     MfHeaderMode);    
-                  }          
-             }
-          // GF will not come here
-          else if (current >= plcpHeaderStart)
-            {
-               if (preamble == WIFI_PREAMBLE_LONG || preamble == WIFI_PREAMBLE_SHORT)
-                 {
-                 psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                                 noiseInterferenceW,
-                                                                  headerMode),
-                                                    current - plcpHeaderStart,
-                                                    headerMode);
-                 }
-              else
-                 {
-              psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                              noiseInterferenceW,
-                                                             MfHeaderMode),
-                                               current - plcpHeaderStart,
-                                               MfHeaderMode);
-                       }
-            }
+          break;
         }
-
-      noiseInterferenceW += (*j).GetDelta ();
-      previous = (*j).GetTime ();
+      noiseInterferenceW += j->GetDelta ();
+      previous = current;
       j++;
     }
+  return psr;
+}
 
-  double per = 1 - psr;
-  return per;
+double
+InterferenceHelper::CalculateAbstractPsr (Ptr<const InterferenceHelper::Event> event, double interferenceW,
+                                          const PlcpSection *sections, uint32_t nSections) const
+{
+  double powerW = event->GetRxPowerW ();
+  double psr = 1.0;
+  for (uint32_t k = 0; k < nSections; k++)
+    {
+      if (sections[k].end > sections[k].start)
+        {
+          psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
+                                                          interferenceW,
+                                                          sections[k].mode),
+                                            sections[k].end - sections[k].start,
+                                            sections[k].mode);
+        }
+    }
+  return psr;
+}
+
+uint32_t
+InterferenceHelper::GetPlcpSections (Ptr<const InterferenceHelper::Event> event, PlcpSection *sections) const
+{
+  uint32_t nSections = 0;
+  WifiMode payloadMode = event->GetPayloadMode ();
+  WifiPreamble preamble = event->GetPreambleType ();
+  WifiMode headerMode = WifiPhy::GetPlcpHeaderMode (payloadMode, preamble);
+  Time plcpHeaderStart = event->GetStartTime () + MicroSeconds (WifiPhy::GetPlcpPreambleDurationMicroSeconds (payloadMode, preamble)); //packet start time+ preamble
+  Time plcpHsigHeaderStart = plcpHeaderStart + MicroSeconds (WifiPhy::GetPlcpHeaderDurationMicroSeconds (payloadMode, preamble)); //packet start time+ preamble+L SIG
+  Time plcpHtTrainingSymbolsStart = plcpHsigHeaderStart + MicroSeconds (WifiPhy::GetPlcpHtSigHeaderDurationMicroSeconds (payloadMode, preamble)); //packet start time+ preamble+L SIG+HT SIG
+  Time plcpPayloadStart = plcpHtTrainingSymbolsStart + MicroSeconds (WifiPhy::GetPlcpHtTrainingSymbolDurationMicroSeconds (payloadMode, preamble, event->GetTxVector ())); //packet start time+ preamble+L SIG+HT SIG+Training
+
+  sections[nSections].start = plcpPayloadStart;
+  sections[nSections].end = event->GetEndTime ();
+  sections[nSections].mode = payloadMode;
+  nSections++;
+  if (preamble == WIFI_PREAMBLE_LONG || preamble == WIFI_PREAMBLE_SHORT)
+    {
+      // Non HT format: the PLCP header is sent in the header mode
+      sections[nSections].start = plcpHeaderStart;
+      sections[nSections].end = plcpPayloadStart;
+      sections[nSections].mode = headerMode;
+      nSections++;
+    }
+  else
+    {
+      // Greenfield or Mixed format: HT-SIG in the header mode, the
+      // training symbols are not subject to errors
+      sections[nSections].start = plcpHsigHeaderStart;
+      sections[nSections].end = plcpHtTrainingSymbolsStart;
+      sections[nSections].mode = headerMode;
+      nSections++;
+      if (preamble == WIFI_PREAMBLE_HT_MF)
+        {
+          // L-SIG, which Greenfield does not have
+          sections[nSections].start = plcpHeaderStart;
+          sections[nSections].end = plcpHsigHeaderStart;
+          sections[nSections].mode = WifiPhy::GetMFPlcpHeaderMode (payloadMode, preamble);
+          nSections++;
+        }
+    }
+  return nSections;
 }
 
+double
+InterferenceHelper::CalculateAverageInterferenceW (Ptr<const InterferenceHelper::Event> event)
+{
+  NS_ASSERT (m_rxing);
+  UpdateEnergy ();
+  double duration = event->GetDuration ().GetSeconds ();
+  // m_energy includes the energy of the frame itself
+  return std::max ((m_energy - event->GetRxPowerW () * duration) / duration, 0.0);
+}
 
 struct InterferenceHelper::SnrPer
 InterferenceHelper::CalculateSnrPer (Ptr<InterferenceHelper::Event> event)
 {
-  NiChanges ni;
-  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
-  double snr = CalculateSnr (event->GetRxPowerW (),
+  double noiseInterferenceW = m_abstraction ? CalculateAverageInterferenceW (event)
+    : CalculateNoiseInterferenceW (event);
+  PlcpSection sections[3];
+  uint32_t nSections = GetPlcpSections (event, sections);
+
+  struct SnrPer snrPer;
+  snrPer.snr = CalculateSnr (event->GetRxPowerW (),
                              noiseInterferenceW,
                              event->GetPayloadMode ());
+  if (m_abstraction)
+    {
+      snrPer.per = 1 - CalculateAbstractPsr (event, noiseInterferenceW, sections, nSections);
+    }
+  else
+    {
+      snrPer.per = 1 - CalculatePsr (event, noiseInterferenceW, sections, nSections);
+    }
+  return snrPer;
+}
 
-  /* calculate the SNIR at the start of the packet and accumulate
-   * all SNIR changes in the snir vector.
-   */
-  double per = CalculatePer (event, &ni);
+struct InterferenceHelper::SnrPer
+InterferenceHelper::CalculateAmpduSnrPer (Ptr<InterferenceHelper::Event> event,
+                                          const std::vector<uint32_t> &subframeSizes,
+                                          std::vector<double> &subframePers)
+{
+  double noiseInterferenceW = m_abstraction ? CalculateAverageInterferenceW (event)
+    : CalculateNoiseInterferenceW (event);
+  PlcpSection sections[3];
+  uint32_t nSections = GetPlcpSections (event, sections);
 
+  // the PLCP header sections follow the payload section
   struct SnrPer snrPer;
-  snrPer.snr = snr;
-  snrPer.per = per;
+  snrPer.snr = CalculateSnr (event->GetRxPowerW (),
+                             noiseInterferenceW,
+                             event->GetPayloadMode ());
+  snrPer.per = 1 - (m_abstraction ? CalculateAbstractPsr (event, noiseInterferenceW, sections + 1, nSections - 1)
+                    : CalculatePsr (event, noiseInterferenceW, sections + 1, nSections - 1));
+
+  // the payload duration is shared by the subframes in proportion to
+  // their sizes
+  uint64_t totalSize = 0;
+  for (std::vector<uint32_t>::const_iterator i = subframeSizes.begin (); i != subframeSizes.end (); ++i)
+    {
+      totalSize += *i;
+    }
+  NS_ASSERT (totalSize > 0);
+  int64_t payloadNs = (sections[0].end - sections[0].start).GetNanoSeconds ();
+  subframePers.clear ();
+  subframePers.reserve (subframeSizes.size ());
+  PlcpSection subframe;
+  subframe.mode = sections[0].mode;
+  subframe.end = sections[0].start;
+  uint64_t offset = 0;
+  for (std::vector<uint32_t>::const_iterator i = subframeSizes.begin (); i != subframeSizes.end (); ++i)
+    {
+      offset += *i;
+      subframe.start = subframe.end;
+      subframe.end = sections[0].start + NanoSeconds (payloadNs * static_cast<int64_t> (offset) / static_cast<int64_t> (totalSize));
+      subframePers.push_back (1 - (m_abstraction ? CalculateAbstractPsr (event, noiseInterferenceW, &subframe, 1)
+                                   : CalculatePsr (event, noiseInterferenceW, &subframe, 1)));
+    }
   return snrPer;
 }
 
@@ -564,6 +485,12 @@ InterferenceHelper::EraseEvents (void)
   m_niChanges.clear ();
   m_rxing = false;
   m_firstPower = 0.0;
+  m_cursor = 0;
+  m_cursorPower = 0.0;
+  m_ends.clear ();
+  m_power = 0.0;
+  m_energy = 0.0;
+  m_energyTime = Simulator::Now ();
 }
 InterferenceHelper::NiChanges::iterator
 InterferenceHelper::GetPosition (Time moment)
@@ -574,16 +501,72 @@ InterferenceHelper::GetPosition (Time moment)
 void
 InterferenceHelper::AddNiChangeEvent (NiChange change)
 {
+  // never before m_cursor, since change is not in the past
   m_niChanges.insert (GetPosition (change.GetTime ()), change);
 }
 void
+InterferenceHelper::AdvanceCursor (Time moment)
+{
+  while (m_cursor < m_niChanges.size () && m_niChanges[m_cursor].GetTime () < moment)
+    {
+      m_cursorPower += m_niChanges[m_cursor].GetDelta ();
+      m_cursor++;
+    }
+}
+void
+InterferenceHelper::PruneNiChanges (void)
+{
+  NS_ASSERT (!m_rxing);
+  Time now = Simulator::Now ();
+  AdvanceCursor (now);
+  while (m_cursor < m_niChanges.size () && m_niChanges[m_cursor].GetTime () == now)
+    {
+      m_cursorPower += m_niChanges[m_cursor].GetDelta ();
+      m_cursor++;
+    }
+  m_niChanges.erase (m_niChanges.begin (), m_niChanges.begin () + m_cursor);
+  m_firstPower = m_cursorPower;
+  m_cursor = 0;
+}
+void
 InterferenceHelper::NotifyRxStart ()
 {
   m_rxing = true;
+  if (m_abstraction)
+    {
+      // only the energy received during the reception matters
+      UpdateEnergy ();
+      m_energy = 0.0;
+    }
 }
 void
 InterferenceHelper::NotifyRxEnd ()
 {
   m_rxing = false;
+  if (!m_abstraction)
+    {
+      // the changes which happened during the reception are no longer needed
+      PruneNiChanges ();
+    }
+}
+void
+InterferenceHelper::UpdateEnergy (void)
+{
+  Time now = Simulator::Now ();
+  while (!m_ends.empty () && m_ends.begin ()->first <= now)
+    {
+      SignalEnds::iterator i = m_ends.begin ();
+      m_energy += m_power * (i->first - m_energyTime).GetSeconds ();
+      m_energyTime = i->first;
+      m_power -= i->second;
+      m_ends.erase (i);
+    }
+  if (m_ends.empty ())
+    {
+      // do not let rounding errors accumulate once the medium is idle
+      m_power = 0.0;
+    }
+  m_energy += m_power * (now - m_energyTime).GetSeconds ();
+  m_energyTime = now;
 }
 } // namespace ns3
@@ -23,6 +23,7 @@
 #include <stdint.h>
 #include <vector>
 #include <list>
+#include <map>
 #include "wifi-mode.h"
 #include "wifi-preamble.h"
 #include "wifi-phy-standard.h"
@@ -156,7 +157,29 @@ private:
    * \return Error rate model
    */
   Ptr<ErrorRateModel> GetErrorRateModel (void) const;
-
+  /**
+   * Enable or disable the abstraction mode.
+   *
+   * In abstraction mode, the interference is not followed chunk by
+   * chunk: only the energy received since the start of the current
+   * reception and the end times of the signals on the medium are
+   * tracked, and no NiChange is recorded.  At the end of a reception,
+   * the effective SINR of the frame is the ratio of its power to the
+   * noise plus the interference power averaged over the frame, and
+   * the PER is the one of the error rate model for the whole frame at
+   * that SINR.  With a table based error rate model, such as the
+   * TableErrorRateModel, the cost of a reception does not depend on the
+   * number of overlapping signals.
+   *
+   * Changing the mode erases all the events.
+   *
+   * \param enable true to enable the abstraction mode
+   */
+  void SetAbstraction (bool enable);
+  /**
+   * \return true if the abstraction mode is enabled
+   */
+  bool GetAbstraction (void) const;
 
   /**
    * \param energyW the minimum energy (W) requested
@@ -189,6 +212,19 @@ private:
    * \return struct of SNR and PER
    */
   struct InterferenceHelper::SnrPer CalculateSnrPer (Ptr<InterferenceHelper::Event> event);
+  /**
+   * Calculate the SNR of the given A-MPDU, the error rate of its PLCP
+   * header, and the error rate of each of its subframes.  The payload
+   * duration is shared by the subframes in proportion to their sizes.
+   *
+   * \param event the event corresponding to the first time the A-MPDU arrives
+   * \param subframeSizes the sizes of the subframes of the A-MPDU, in order
+   * \param subframePers filled with the error rates of the subframes
+   * \return struct of SNR and PER of the PLCP header
+   */
+  struct InterferenceHelper::SnrPer CalculateAmpduSnrPer (Ptr<InterferenceHelper::Event> event,
+                                                          const std::vector<uint32_t> &subframeSizes,
+                                                          std::vector<double> &subframePers);
   /**
    * Notify that RX has started.
    */
@@ -246,6 +282,21 @@ private:
    * typedef for a list of Events
    */
   typedef std::list<Ptr<Event> > Events;
+  /**
+   * A section of a PLCP frame which is sent in a single mode and is
+   * subject to errors.
+   */
+  struct PlcpSection
+  {
+    Time start;    //!< start of the section
+    Time end;      //!< end of the section
+    WifiMode mode; //!< mode of the section
+  };
+  /**
+   * typedef for the end times of the signals and their powers, in
+   * abstraction mode
+   */
+  typedef std::multimap<Time, double> SignalEnds;
 
   //InterferenceHelper (const InterferenceHelper &o);
   //InterferenceHelper &operator = (const InterferenceHelper &o);
@@ -256,13 +307,13 @@ private:
    */
   void AppendEvent (Ptr<Event> event);
   /**
-   * Calculate noise and interference power in W.
+   * Calculate noise and interference power in W at the start of the
+   * event being received.
    *
    * \param event
-   * \param ni
    * \return noise and interference power
    */
-  double CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const;
+  double CalculateNoiseInterferenceW (Ptr<Event> event) const;
   /**
    * Calculate SNR (linear ratio) from the given signal power and noise+interference power.
    * (Mode is not currently used)
@@ -284,14 +335,57 @@ private:
    */
   double CalculateChunkSuccessRate (double snir, Time duration, WifiMode mode) const;
   /**
-   * Calculate the error rate of the given packet. The packet can be divided into
-   * multiple chunks (e.g. due to interference from other transmissions).
+   * Calculate the success rate of the given sections of a packet. The
+   * sections can be divided into multiple chunks (e.g. due to
+   * interference from other transmissions).
+   *
+   * The chunks are read directly from the NiChanges recorded since the
+   * start of the reception: each of them is intersected with the given
+   * sections of the packet, and the SNIR of a chunk is computed once
+   * per section it overlaps.
+   *
+   * \param event
+   * \param noiseInterferenceW noise and interference power at the start of the event
+   * \param sections the sections of the packet which are subject to errors
+   * \param nSections the number of sections
+   * \return the success rate of the sections
+   */
+  double CalculatePsr (Ptr<const Event> event, double noiseInterferenceW,
+                       const PlcpSection *sections, uint32_t nSections) const;
+  /**
+   * Calculate the success rate of the given sections of a packet in
+   * abstraction mode.
+   *
+   * \param event
+   * \param interferenceW average interference power during the event
+   * \param sections the sections of the packet which are subject to errors
+   * \param nSections the number of sections
+   * \return the success rate of the sections
+   */
+  double CalculateAbstractPsr (Ptr<const Event> event, double interferenceW,
+                               const PlcpSection *sections, uint32_t nSections) const;
+  /**
+   * Compute the PLCP header and payload sections of the given packet,
+   * in the order in which their success rates are accumulated.
+   *
+   * \param event
+   * \param sections array to fill, of at least 3 sections
+   * \return the number of sections
+   */
+  uint32_t GetPlcpSections (Ptr<const Event> event, PlcpSection *sections) const;
+  /**
+   * Calculate the average interference power during the given event,
+   * in abstraction mode.
    *
    * \param event
-   * \param ni
-   * \return the error rate of the packet
+   * \return the average interference power (W)
    */
-  double CalculatePer (Ptr<const Event> event, NiChanges *ni) const;
+  double CalculateAverageInterferenceW (Ptr<const Event> event);
+  /**
+   * Integrate the power received up to now into m_energy, in
+   * abstraction mode, and forget the signals which ended.
+   */
+  void UpdateEnergy (void);
 
   double m_noiseFigure; /**< noise figure (linear) */
   Ptr<ErrorRateModel> m_errorRateModel;
@@ -299,8 +393,36 @@ private:
   NiChanges m_niChanges;
   double m_firstPower;
   bool m_rxing;
+  /**
+   * Index of the first NiChange of m_niChanges which is not yet
+   * accounted for in m_cursorPower.  All the changes before it are in
+   * the past, so that new changes are always inserted after it.
+   */
+  uint32_t m_cursor;
+  /// m_firstPower plus the deltas of all the NiChanges before m_cursor
+  double m_cursorPower;
   /// Returns an iterator to the first nichange, which is later than moment
   NiChanges::iterator GetPosition (Time moment);
+  /**
+   * Move m_cursor past all the NiChanges strictly earlier than moment,
+   * accumulating their deltas in m_cursorPower.
+   *
+   * \param moment
+   */
+  void AdvanceCursor (Time moment);
+  /**
+   * Fold all the NiChanges up to now into m_firstPower and remove
+   * them from m_niChanges.  Must not be called while receiving, since
+   * CalculateSnrPer needs all the changes since the start of the
+   * reception.
+   */
+  void PruneNiChanges (void);
+
+  bool m_abstraction;     //!< true in abstraction mode
+  SignalEnds m_ends;      //!< the signals on the medium, in abstraction mode
+  double m_power;         //!< power (W) of the signals on the medium, in abstraction mode
+  double m_energy;        //!< energy (J) received since the last reception started, in abstraction mode
+  Time m_energyTime;      //!< time up to which m_energy is integrated
   /**
    * Add NiChange to the list at the appropriate position.
    *
@@ -34,6 +34,7 @@
 #include "qos-utils.h"
 #include "edca-txop-n.h"
 #include "snr-tag.h"
+#include "ampdu-tag.h"
 
 NS_LOG_COMPONENT_DEFINE ("MacLow");
 
@@ -298,6 +299,8 @@ MacLow::MacLow ()
     m_waitSifsEvent (),
     m_endTxNoAckEvent (),
     m_currentPacket (0),
+    m_receivingAmpdu (false),
+    m_ampduBlockAckNeeded (false),
     m_listener (0),
     m_phyMacLowListener (0),
     m_ctsToSelfSupported (false)
@@ -426,6 +429,11 @@ MacLow::SetPhy (Ptr<WifiPhy> phy)
   m_phy->SetReceiveErrorCallback (MakeCallback (&MacLow::ReceiveError, this));
   SetupPhyMacLowListener (phy);
 }
+Ptr<WifiPhy>
+MacLow::GetPhy (void) const
+{
+  return m_phy;
+}
 void
 MacLow::SetWifiRemoteStationManager (Ptr<WifiRemoteStationManager> manager)
 {
@@ -588,15 +596,44 @@ MacLow::StartTransmission (Ptr<const Packet> packet,
    */
   m_currentPacket = packet->Copy ();
   m_currentHdr = *hdr;
+  m_ampdu.clear ();
   CancelAllEvents ();
   m_listener = listener;
   m_txParams = params;
 
   //NS_ASSERT (m_phy->IsStateIdle ());
 
-  NS_LOG_DEBUG ("startTx size=" << GetSize (m_currentPacket, &m_currentHdr) <<
+  NS_LOG_DEBUG ("startTx size=" << GetCurrentPsduSize () <<
+                ", to=" << m_currentHdr.GetAddr1 () << ", listener=" << m_listener);
+
+  StartCurrentTransmission ();
+}
+
+void
+MacLow::StartAmpduTransmission (const Mpdus &mpdus,
+                                Ptr<MpduAggregator> aggregator,
+                                MacLowTransmissionParameters params,
+                                MacLowTransmissionListener *listener)
+{
+  NS_LOG_FUNCTION (this << mpdus.size () << aggregator << params << listener);
+  NS_ASSERT (!mpdus.empty ());
+  m_currentPacket = mpdus.front ().first->Copy ();
+  m_currentHdr = mpdus.front ().second;
+  m_ampdu = mpdus;
+  m_mpduAggregator = aggregator;
+  CancelAllEvents ();
+  m_listener = listener;
+  m_txParams = params;
+
+  NS_LOG_DEBUG ("startTx A-MPDU of " << m_ampdu.size () << " MPDUs, size=" << GetCurrentPsduSize () <<
                 ", to=" << m_currentHdr.GetAddr1 () << ", listener=" << m_listener);
 
+  StartCurrentTransmission ();
+}
+
+void
+MacLow::StartCurrentTransmission (void)
+{
   if (m_txParams.MustSendRts ())
     {
       SendRtsForPacket ();
@@ -656,6 +693,12 @@ void
 MacLow::ReceiveOk (Ptr<Packet> packet, double rxSnr, WifiMode txMode, WifiPreamble preamble)
 {
   NS_LOG_FUNCTION (this << packet << rxSnr << txMode << preamble);
+  AmpduTag ampduTag;
+  if (packet->RemovePacketTag (ampduTag))
+    {
+      ReceiveAmpdu (packet, ampduTag, rxSnr, txMode, preamble);
+      return;
+    }
   /* A packet is received from the PHY.
    * When we have handled this packet,
    * we handle any packet present in the
@@ -825,7 +868,14 @@ MacLow::ReceiveOk (Ptr<Packet> packet, double rxSnr, WifiMode txMode, WifiPreamb
              the Block Ack agreement exists, the recipient shall buffer the MSDU
              regardless of the value of the Ack Policy subfield within the
              QoS Control field of the QoS data frame. */
-          if (hdr.IsQosAck ())
+          if (hdr.IsQosAck () && m_receivingAmpdu)
+            {
+              /* an MPDU of an A-MPDU with ack policy Normal Ack solicits a block ack,
+                 which is sent once all the MPDUs of the A-MPDU are received */
+              m_ampduBlockAckNeeded = true;
+              m_ampduBlockAckHdr = hdr;
+            }
+          else if (hdr.IsQosAck ())
             {
               AgreementsI it = m_bAckAgreements.find (std::make_pair (hdr.GetAddr2 (), hdr.GetQosTid ()));
               RxCompleteBufferedPacketsWithSmallerSequence (it->second.first.GetStartingSequence (),
@@ -865,6 +915,10 @@ MacLow::ReceiveOk (Ptr<Packet> packet, double rxSnr, WifiMode txMode, WifiPreamb
         {
           NS_LOG_DEBUG ("rx unicast/noAck from=" << hdr.GetAddr2 ());
         }
+      else if (m_receivingAmpdu)
+        {
+          NS_LOG_DEBUG ("rx unicast in A-MPDU without block ack agreement from=" << hdr.GetAddr2 ());
+        }
       else if (hdr.IsData () || hdr.IsMgt ())
         {
           NS_LOG_DEBUG ("rx unicast/sendAck from=" << hdr.GetAddr2 ());
@@ -910,6 +964,57 @@ rxPacket:
   return;
 }
 
+void
+MacLow::ReceiveAmpdu (Ptr<Packet> ampdu, const AmpduTag &tag, double rxSnr,
+                      WifiMode txMode, WifiPreamble preamble)
+{
+  NS_LOG_FUNCTION (this << ampdu << rxSnr << txMode << preamble);
+  MpduAggregator::DeaggregatedMpdus mpdus = MpduAggregator::Deaggregate (ampdu);
+  m_receivingAmpdu = true;
+  m_ampduBlockAckNeeded = false;
+  uint32_t index = 0;
+  for (MpduAggregator::DeaggregatedMpdusCI i = mpdus.begin (); i != mpdus.end (); ++i, ++index)
+    {
+      if (tag.IsCorrupted (index))
+        {
+          NS_LOG_DEBUG ("rx drop corrupted MPDU " << index << " of A-MPDU");
+          continue;
+        }
+      ReceiveOk (i->first, rxSnr, txMode, preamble);
+    }
+  m_receivingAmpdu = false;
+  if (!m_ampduBlockAckNeeded)
+    {
+      return;
+    }
+  /* the A-MPDU is acknowledged as if it was followed by a block ack
+     request starting at the window of the recipient */
+  Mac48Address originator = m_ampduBlockAckHdr.GetAddr2 ();
+  uint8_t tid = m_ampduBlockAckHdr.GetQosTid ();
+  AgreementsI it = m_bAckAgreements.find (std::make_pair (originator, tid));
+  NS_ASSERT (it != m_bAckAgreements.end ());
+  BlockAckCachesI i = m_bAckCaches.find (std::make_pair (originator, tid));
+  NS_ASSERT (i != m_bAckCaches.end ());
+  /* See section 11.5.3 in IEEE802.11 for mean of this timer */
+  ResetBlockAckInactivityTimerIfNeeded (it->second.first);
+  if (!it->second.first.IsImmediateBlockAck ())
+    {
+      NS_FATAL_ERROR ("Delayed block ack not supported.");
+    }
+  CtrlBAckRequestHeader reqHdr;
+  reqHdr.SetType (COMPRESSED_BLOCK_ACK);
+  reqHdr.SetTidInfo (tid);
+  reqHdr.SetStartingSequence (i->second.GetWinStart ());
+  NS_LOG_DEBUG ("rx A-MPDU/sendImmediateBlockAck from=" << originator);
+  NS_ASSERT (m_sendAckEvent.IsExpired ());
+  m_sendAckEvent = Simulator::Schedule (GetSifs (),
+                                        &MacLow::SendBlockAckAfterBlockAckRequest, this,
+                                        reqHdr,
+                                        originator,
+                                        m_ampduBlockAckHdr.GetDuration (),
+                                        txMode);
+}
+
 uint32_t
 MacLow::GetAckSize (void) const
 {
@@ -1361,7 +1466,7 @@ MacLow::SendRtsForPacket (void)
       duration += GetSifs ();
       duration += GetCtsDuration (m_currentHdr.GetAddr1 (), rtsTxVector);
       duration += GetSifs ();
-      duration += m_phy->CalculateTxDuration (GetSize (m_currentPacket, &m_currentHdr),
+      duration += m_phy->CalculateTxDuration (GetCurrentPsduSize (),
                                               dataTxVector, preamble);
       duration += GetSifs ();
       duration += GetAckDuration (m_currentHdr.GetAddr1 (), dataTxVector);
@@ -1396,7 +1501,7 @@ MacLow::StartDataTxTimers (WifiTxVector dataTxVector)
   else
     preamble=WIFI_PREAMBLE_LONG;
  
-  Time txDuration = m_phy->CalculateTxDuration (GetSize (m_currentPacket, &m_currentHdr), dataTxVector, preamble);
+  Time txDuration = m_phy->CalculateTxDuration (GetCurrentPsduSize (), dataTxVector, preamble);
   if (m_txParams.MustWaitNormalAck ())
     {
       Time timerDelay = txDuration + GetAckTimeout ();
@@ -1507,14 +1612,59 @@ MacLow::SendDataPacket (void)
     }
   m_currentHdr.SetDuration (duration);
 
-  m_currentPacket->AddHeader (m_currentHdr);
-  WifiMacTrailer fcs;
-  m_currentPacket->AddTrailer (fcs);
+  if (m_ampdu.empty ())
+    {
+      m_currentPacket->AddHeader (m_currentHdr);
+      WifiMacTrailer fcs;
+      m_currentPacket->AddTrailer (fcs);
+    }
+  else
+    {
+      m_currentPacket = BuildAmpdu (duration);
+    }
 
   ForwardDown (m_currentPacket, &m_currentHdr, dataTxVector,preamble);
   m_currentPacket = 0;
 }
 
+Ptr<Packet>
+MacLow::BuildAmpdu (Time duration)
+{
+  NS_LOG_FUNCTION (this << duration);
+  Ptr<Packet> ampdu = Create<Packet> ();
+  for (Mpdus::const_iterator i = m_ampdu.begin (); i != m_ampdu.end (); ++i)
+    {
+      WifiMacHeader hdr = i->second;
+      hdr.SetDuration (duration);
+      Ptr<Packet> mpdu = i->first->Copy ();
+      mpdu->AddHeader (hdr);
+      WifiMacTrailer fcs;
+      mpdu->AddTrailer (fcs);
+      if (!m_mpduAggregator->Aggregate (mpdu, ampdu))
+        {
+          NS_FATAL_ERROR ("MPDU does not fit in the A-MPDU");
+        }
+    }
+  m_ampdu.clear ();
+  ampdu->AddPacketTag (AmpduTag ());
+  return ampdu;
+}
+
+uint32_t
+MacLow::GetCurrentPsduSize (void) const
+{
+  if (m_ampdu.empty ())
+    {
+      return GetSize (m_currentPacket, &m_currentHdr);
+    }
+  uint32_t size = 0;
+  for (Mpdus::const_iterator i = m_ampdu.begin (); i != m_ampdu.end (); ++i)
+    {
+      size = MpduAggregator::GetSizeIfAggregated (GetSize (i->first, &i->second), size);
+    }
+  return size;
+}
+
 bool
 MacLow::IsNavZero (void) const
 {
@@ -1556,7 +1706,7 @@ MacLow::SendCtsToSelf (void)
     {
       WifiTxVector dataTxVector = GetDataTxVector (m_currentPacket, &m_currentHdr);
       duration += GetSifs ();
-      duration += m_phy->CalculateTxDuration (GetSize (m_currentPacket,&m_currentHdr),
+      duration += m_phy->CalculateTxDuration (GetCurrentPsduSize (),
                                               dataTxVector, preamble);
       if (m_txParams.MustWaitBasicBlockAck ())
         {
@@ -1671,7 +1821,7 @@ MacLow::SendDataAfterCts (Mac48Address source, Time duration, WifiMode txMode)
   Time newDuration = Seconds (0);
   newDuration += GetSifs ();
   newDuration += GetAckDuration (m_currentHdr.GetAddr1 (), dataTxVector);
-  Time txDuration = m_phy->CalculateTxDuration (GetSize (m_currentPacket, &m_currentHdr),
+  Time txDuration = m_phy->CalculateTxDuration (GetCurrentPsduSize (),
                                                 dataTxVector, preamble);
   duration -= txDuration;
   duration -= GetSifs ();
@@ -1680,9 +1830,16 @@ MacLow::SendDataAfterCts (Mac48Address source, Time duration, WifiMode txMode)
   NS_ASSERT (duration >= MicroSeconds (0));
   m_currentHdr.SetDuration (duration);
 
-  m_currentPacket->AddHeader (m_currentHdr);
-  WifiMacTrailer fcs;
-  m_currentPacket->AddTrailer (fcs);
+  if (m_ampdu.empty ())
+    {
+      m_currentPacket->AddHeader (m_currentHdr);
+      WifiMacTrailer fcs;
+      m_currentPacket->AddTrailer (fcs);
+    }
+  else
+    {
+      m_currentPacket = BuildAmpdu (duration);
+    }
 
   ForwardDown (m_currentPacket, &m_currentHdr, dataTxVector,preamble);
   m_currentPacket = 0;
@@ -1846,13 +2003,22 @@ MacLow::RxCompleteBufferedPacketsWithSmallerSequence (uint16_t seq, Mac48Address
   if (it != m_bAckAgreements.end ())
     {
       uint16_t endSequence = ((*it).second.first.GetStartingSequence () + 2047) % 4096;
-      uint16_t mappedStart = QosUtilsMapSeqControlToUniqueInteger (seq, endSequence);
+      uint16_t mappedStart = QosUtilsMapSeqControlToUniqueInteger (seq << 4, endSequence);
+      if (mappedStart > QosUtilsMapSeqControlToUniqueInteger ((*it).second.first.GetStartingSequence () << 4, endSequence))
+        {
+          /* the packets before seq are not waited for any more */
+          (*it).second.first.SetStartingSequence (seq);
+        }
+      if ((*it).second.second.empty ())
+        {
+          return;
+        }
       uint16_t guard = (*it).second.second.begin ()->second.GetSequenceControl () & 0xfff0;
       BufferedPacketI last = (*it).second.second.begin ();
 
       BufferedPacketI i = (*it).second.second.begin ();
       for (; i != (*it).second.second.end ()
-           && QosUtilsMapSeqControlToUniqueInteger ((*i).second.GetSequenceNumber (), endSequence) < mappedStart;)
+           && QosUtilsMapSeqControlToUniqueInteger ((*i).second.GetSequenceControl (), endSequence) < mappedStart;)
         {
           if (guard == (*i).second.GetSequenceControl ())
             {
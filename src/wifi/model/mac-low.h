@@ -42,10 +42,12 @@
 #include "qos-utils.h"
 #include "block-ack-cache.h"
 #include "wifi-tx-vector.h"
+#include "mpdu-aggregator.h"
 
 namespace ns3 {
 
 class WifiPhy;
+class AmpduTag;
 class WifiMac;
 class EdcaTxopN;
 
@@ -415,6 +417,10 @@ public:
    * typedef for a callback for MacLowRx
    */
   typedef Callback<void, Ptr<Packet>, const WifiMacHeader*> MacLowRxCallback;
+  /**
+   * typedef for the MPDUs of an A-MPDU: their payloads and MAC headers
+   */
+  typedef std::list<std::pair<Ptr<const Packet>, WifiMacHeader> > Mpdus;
 
   MacLow ();
   virtual ~MacLow ();
@@ -425,6 +431,10 @@ public:
    * \param phy WifiPhy associated with this MacLow
    */
   void SetPhy (Ptr<WifiPhy> phy);
+  /**
+   * \return the WifiPhy associated with this MacLow
+   */
+  Ptr<WifiPhy> GetPhy (void) const;
   /**
    * Set up WifiRemoteStationManager associated with this MacLow.
    *
@@ -615,6 +625,21 @@ public:
                           const WifiMacHeader* hdr,
                           MacLowTransmissionParameters parameters,
                           MacLowTransmissionListener *listener);
+  /**
+   * \param mpdus the MPDUs to send, which must be QoS data frames for the same
+   *        receiver and TID
+   * \param aggregator the aggregator of the MPDUs
+   * \param parameters the transmission parameters to use for the A-MPDU.
+   * \param listener listen to transmission events.
+   *
+   * Start the transmission of an A-MPDU made of the input MPDUs and notify the
+   * listener of transmission events. The first MPDU is used as the current
+   * packet, e.g. to select the transmission mode.
+   */
+  void StartAmpduTransmission (const Mpdus &mpdus,
+                               Ptr<MpduAggregator> aggregator,
+                               MacLowTransmissionParameters parameters,
+                               MacLowTransmissionListener *listener);
 
   /**
    * \param packet packet received
@@ -694,6 +719,11 @@ private:
    * or switching channel.
    */
   void CancelAllEvents (void);
+  /**
+   * Start the transmission of the current packet or A-MPDU, with an RTS,
+   * a CTS-to-self or directly, according to the transmission parameters.
+   */
+  void StartCurrentTransmission (void);
   /**
    * Return the total ACK size (including FCS trailer).
    *
@@ -728,6 +758,33 @@ private:
    * \return the total packet size
    */
   uint32_t GetSize (Ptr<const Packet> packet, const WifiMacHeader *hdr) const;
+  /**
+   * Return the size of the current PSDU: the current packet with its
+   * WifiMacHeader and FCS trailer, or the current A-MPDU.
+   *
+   * \return the size of the current PSDU
+   */
+  uint32_t GetCurrentPsduSize (void) const;
+  /**
+   * Build the current A-MPDU, with the given duration in the MAC
+   * header of each of its MPDUs.
+   *
+   * \param duration the duration/id of the MPDUs
+   * \return the A-MPDU, tagged with an AmpduTag
+   */
+  Ptr<Packet> BuildAmpdu (Time duration);
+  /**
+   * Receive the MPDUs of an A-MPDU which are not corrupted, and schedule the
+   * block ack solicited by the A-MPDU, if any.
+   *
+   * \param ampdu the A-MPDU
+   * \param tag the AmpduTag of the A-MPDU, which tells the corrupted subframes
+   * \param rxSnr snr of the A-MPDU
+   * \param txMode transmission mode of the A-MPDU
+   * \param preamble type of preamble used for the A-MPDU
+   */
+  void ReceiveAmpdu (Ptr<Packet> ampdu, const AmpduTag &tag, double rxSnr,
+                     WifiMode txMode, WifiPreamble preamble);
   /**
    * Forward the packet down to WifiPhy for transmission.
    *
@@ -1096,6 +1153,11 @@ private:
 
   Ptr<Packet> m_currentPacket;              //!< Current packet transmitted/to be transmitted
   WifiMacHeader m_currentHdr;               //!< Header of the current packet
+  Mpdus m_ampdu;                            //!< MPDUs of the current A-MPDU, empty if the current packet is not aggregated
+  Ptr<MpduAggregator> m_mpduAggregator;     //!< Aggregator of the current A-MPDU
+  bool m_receivingAmpdu;                    //!< True while the MPDUs of an A-MPDU are received
+  bool m_ampduBlockAckNeeded;               //!< True if the A-MPDU being received solicits a block ack
+  WifiMacHeader m_ampduBlockAckHdr;         //!< Header of an MPDU of the A-MPDU being received which solicits a block ack
   MacLowTransmissionParameters m_txParams;  //!< Transmission parameters of the current packet
   MacLowTransmissionListener *m_listener;   //!< Transmission listener for the current packet
   Mac48Address m_self;                      //!< Address of this MacLow (Mac48Address)
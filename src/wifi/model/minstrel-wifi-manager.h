@@ -163,8 +163,6 @@ private:
    * to transmit a reference packet.
    */
   typedef std::vector<std::pair<Time,WifiMode> > TxTime;
-  MinstrelRate m_minstrelTable;  ///< minstrel table
-  SampleRate m_sampleTable;  ///< sample table
 
 
   TxTime m_calcTxTime;  ///< to hold all the calculated TxTime for all modes
@@ -173,7 +171,6 @@ private:
   double m_ewmaLevel;  ///< exponential weighted moving average
   uint32_t m_sampleCol;  ///< number of sample columns
   uint32_t m_pktLen;  ///< packet length used  for calculate mode TxTime
-  uint32_t m_nsupported;  ///< modes supported
 
   /// Provides uniform random variables.
   Ptr<UniformRandomVariable> m_uniformRandomVariable;
@@ -0,0 +1,88 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+
+#include "mpdu-aggregator.h"
+
+NS_LOG_COMPONENT_DEFINE ("MpduAggregator");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (MpduAggregator)
+  ;
+
+TypeId
+MpduAggregator::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpduAggregator")
+    .SetParent<Object> ()
+  ;
+  return tid;
+}
+
+uint32_t
+MpduAggregator::GetSizeIfAggregated (uint32_t mpduSize, uint32_t ampduSize)
+{
+  // the previous subframe is padded to a multiple of 4 octets
+  uint32_t padding = (4 - (ampduSize % 4)) % 4;
+  return ampduSize + padding + 4 + mpduSize;
+}
+
+MpduAggregator::DeaggregatedMpdus
+MpduAggregator::Deaggregate (Ptr<Packet> ampdu)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  DeaggregatedMpdus set;
+
+  AmpduSubframeHeader hdr;
+  while (ampdu->GetSize () >= hdr.GetSerializedSize ())
+    {
+      ampdu->RemoveHeader (hdr);
+      uint32_t length = hdr.GetLength ();
+      NS_ASSERT (hdr.IsSignatureValid () && length <= ampdu->GetSize ());
+      Ptr<Packet> mpdu = ampdu->CreateFragment (0, length);
+      ampdu->RemoveAtStart (length);
+      uint32_t padding = (4 - ((length + 4) % 4)) % 4;
+      ampdu->RemoveAtStart (std::min (padding, ampdu->GetSize ()));
+      set.push_back (std::make_pair (mpdu, hdr));
+    }
+  NS_LOG_INFO ("Deaggregated A-MPDU: extracted " << set.size () << " MPDUs");
+  return set;
+}
+
+std::vector<uint32_t>
+MpduAggregator::GetSubframeSizes (Ptr<const Packet> ampdu)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  std::vector<uint32_t> sizes;
+  AmpduSubframeHeader hdr;
+  uint32_t size = ampdu->GetSize ();
+  uint32_t offset = 0;
+  while (size - offset >= hdr.GetSerializedSize ())
+    {
+      Ptr<Packet> delimiter = ampdu->CreateFragment (offset, hdr.GetSerializedSize ());
+      delimiter->RemoveHeader (hdr);
+      uint32_t subframeSize = std::min (GetSizeIfAggregated (hdr.GetLength (), 0), size - offset);
+      uint32_t padding = (4 - (subframeSize % 4)) % 4;
+      subframeSize = std::min (subframeSize + padding, size - offset);
+      sizes.push_back (subframeSize);
+      offset += subframeSize;
+    }
+  return sizes;
+}
+
+} // namespace ns3
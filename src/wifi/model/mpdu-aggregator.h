@@ -0,0 +1,82 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MPDU_AGGREGATOR_H
+#define MPDU_AGGREGATOR_H
+
+#include "ns3/ptr.h"
+#include "ns3/packet.h"
+#include "ns3/object.h"
+
+#include "ampdu-subframe-header.h"
+
+#include <list>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief Abstract class that concrete mpdu aggregators have to implement
+ * \ingroup wifi
+ *
+ * An A-MPDU is a sequence of subframes, each made of an MPDU delimiter
+ * (AmpduSubframeHeader) followed by an MPDU, with its MAC header and
+ * FCS, and padded to a multiple of 4 octets unless it is the last one.
+ */
+class MpduAggregator : public Object
+{
+public:
+  typedef std::list<std::pair<Ptr<Packet>, AmpduSubframeHeader> > DeaggregatedMpdus;
+  typedef std::list<std::pair<Ptr<Packet>, AmpduSubframeHeader> >::const_iterator DeaggregatedMpdusCI;
+
+  static TypeId GetTypeId (void);
+  /**
+   * \param mpdu the MPDU, with its MAC header and FCS, to add to <i>ampdu</i>
+   * \param ampdu the A-MPDU
+   * \return true if <i>mpdu</i> was added to <i>ampdu</i>, false otherwise
+   *
+   * In concrete aggregator's implementation is specified how and if
+   * <i>mpdu</i> can be added to <i>ampdu</i>.
+   */
+  virtual bool Aggregate (Ptr<const Packet> mpdu, Ptr<Packet> ampdu) = 0;
+  /**
+   * \param mpduSize the size of an MPDU, with its MAC header and FCS
+   * \param ampduSize the size of an A-MPDU, 0 if it is empty
+   * \return true if Aggregate would add the MPDU to the A-MPDU
+   */
+  virtual bool CanBeAggregated (uint32_t mpduSize, uint32_t ampduSize) const = 0;
+
+  /**
+   * \param mpduSize the size of an MPDU, with its MAC header and FCS
+   * \param ampduSize the size of an A-MPDU, 0 if it is empty
+   * \return the size of the A-MPDU once the MPDU is added to it
+   */
+  static uint32_t GetSizeIfAggregated (uint32_t mpduSize, uint32_t ampduSize);
+  /**
+   * \param ampdu the A-MPDU, which is emptied
+   * \return the MPDUs of the A-MPDU, with their MPDU delimiters
+   */
+  static DeaggregatedMpdus Deaggregate (Ptr<Packet> ampdu);
+  /**
+   * \param ampdu the A-MPDU
+   * \return the sizes of the subframes of the A-MPDU, in order
+   */
+  static std::vector<uint32_t> GetSubframeSizes (Ptr<const Packet> ampdu);
+};
+
+}  // namespace ns3
+
+#endif /* MPDU_AGGREGATOR_H */
@@ -0,0 +1,82 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+
+#include "ampdu-subframe-header.h"
+#include "mpdu-standard-aggregator.h"
+
+NS_LOG_COMPONENT_DEFINE ("MpduStandardAggregator");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (MpduStandardAggregator)
+  ;
+
+TypeId
+MpduStandardAggregator::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpduStandardAggregator")
+    .SetParent<MpduAggregator> ()
+    .AddConstructor<MpduStandardAggregator> ()
+    .AddAttribute ("MaxAmpduSize", "Max length in byte of an A-MPDU",
+                   UintegerValue (65535),
+                   MakeUintegerAccessor (&MpduStandardAggregator::m_maxAmpduLength),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+MpduStandardAggregator::MpduStandardAggregator ()
+{
+}
+
+MpduStandardAggregator::~MpduStandardAggregator ()
+{
+}
+
+bool
+MpduStandardAggregator::CanBeAggregated (uint32_t mpduSize, uint32_t ampduSize) const
+{
+  // the length field of the MPDU delimiter has 12 bits
+  return mpduSize < 4096
+         && GetSizeIfAggregated (mpduSize, ampduSize) <= m_maxAmpduLength;
+}
+
+bool
+MpduStandardAggregator::Aggregate (Ptr<const Packet> mpdu, Ptr<Packet> ampdu)
+{
+  NS_LOG_FUNCTION (this);
+  if (!CanBeAggregated (mpdu->GetSize (), ampdu->GetSize ()))
+    {
+      return false;
+    }
+  uint32_t padding = (4 - (ampdu->GetSize () % 4)) % 4;
+  if (padding)
+    {
+      Ptr<Packet> pad = Create<Packet> (padding);
+      ampdu->AddAtEnd (pad);
+    }
+  AmpduSubframeHeader hdr;
+  hdr.SetLength (mpdu->GetSize ());
+  Ptr<Packet> subframe = mpdu->Copy ();
+  subframe->AddHeader (hdr);
+  ampdu->AddAtEnd (subframe);
+  return true;
+}
+
+} // namespace ns3
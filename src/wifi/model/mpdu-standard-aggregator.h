@@ -0,0 +1,55 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MPDU_STANDARD_AGGREGATOR_H
+#define MPDU_STANDARD_AGGREGATOR_H
+
+#include "mpdu-aggregator.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * Standard MPDU aggregator
+ *
+ * Aggregates MPDUs of up to 4095 octets into A-MPDUs of at most
+ * MaxAmpduSize octets.
+ */
+class MpduStandardAggregator : public MpduAggregator
+{
+public:
+  static TypeId GetTypeId (void);
+  MpduStandardAggregator ();
+  ~MpduStandardAggregator ();
+  /**
+   * \param mpdu the MPDU, with its MAC header and FCS, to add to <i>ampdu</i>
+   * \param ampdu the A-MPDU
+   * \return true if <i>mpdu</i> was added to <i>ampdu</i>, false otherwise
+   *
+   * This method performs an MPDU aggregation: the last subframe of
+   * <i>ampdu</i> is padded, and <i>mpdu</i> is appended after its MPDU
+   * delimiter.
+   */
+  virtual bool Aggregate (Ptr<const Packet> mpdu, Ptr<Packet> ampdu);
+  virtual bool CanBeAggregated (uint32_t mpduSize, uint32_t ampduSize) const;
+
+private:
+  uint32_t m_maxAmpduLength; //!< maximum size of an A-MPDU, in octets
+};
+
+}  // namespace ns3
+
+#endif /* MPDU_STANDARD_AGGREGATOR_H */
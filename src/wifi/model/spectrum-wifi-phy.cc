@@ -0,0 +1,237 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <map>
+#include "ns3/log.h"
+#include "ns3/spectrum-value.h"
+#include "spectrum-wifi-phy.h"
+#include "wifi-spectrum-phy-interface.h"
+#include "wifi-spectrum-signal-parameters.h"
+
+NS_LOG_COMPONENT_DEFINE ("SpectrumWifiPhy");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (SpectrumWifiPhy)
+  ;
+
+TypeId
+SpectrumWifiPhy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SpectrumWifiPhy")
+    .SetParent<YansWifiPhy> ()
+    .AddConstructor<SpectrumWifiPhy> ()
+  ;
+  return tid;
+}
+
+SpectrumWifiPhy::SpectrumWifiPhy ()
+  : m_channelWidth (20)
+{
+  NS_LOG_FUNCTION (this);
+  m_wifiSpectrumPhyInterface = CreateObject<WifiSpectrumPhyInterface> ();
+  m_wifiSpectrumPhyInterface->SetSpectrumWifiPhy (this);
+}
+
+SpectrumWifiPhy::~SpectrumWifiPhy ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+SpectrumWifiPhy::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_channel = 0;
+  m_rxSpectrumModel = 0;
+  // break the reference cycle with the interface
+  m_wifiSpectrumPhyInterface->Dispose ();
+  m_wifiSpectrumPhyInterface = 0;
+  YansWifiPhy::DoDispose ();
+}
+
+void
+SpectrumWifiPhy::SetChannel (Ptr<SpectrumChannel> channel)
+{
+  NS_LOG_FUNCTION (this << channel);
+  UpdateRxSpectrumModel ();
+  m_channel = channel;
+  m_channel->AddRx (m_wifiSpectrumPhyInterface);
+}
+
+Ptr<SpectrumChannel>
+SpectrumWifiPhy::GetSpectrumChannel (void) const
+{
+  return m_channel;
+}
+
+Ptr<SpectrumPhy>
+SpectrumWifiPhy::GetSpectrumPhy (void) const
+{
+  return m_wifiSpectrumPhyInterface;
+}
+
+Ptr<Channel>
+SpectrumWifiPhy::GetChannel (void) const
+{
+  return m_channel;
+}
+
+void
+SpectrumWifiPhy::SetChannelNumber (uint16_t id)
+{
+  NS_LOG_FUNCTION (this << id);
+  YansWifiPhy::SetChannelNumber (id);
+  UpdateRxSpectrumModel ();
+}
+
+void
+SpectrumWifiPhy::ConfigureStandard (enum WifiPhyStandard standard)
+{
+  NS_LOG_FUNCTION (this << standard);
+  switch (standard)
+    {
+    case WIFI_PHY_STANDARD_80211b:
+      m_channelWidth = 22;
+      break;
+    case WIFI_PHY_STANDARD_80211_10MHZ:
+      m_channelWidth = 10;
+      break;
+    case WIFI_PHY_STANDARD_80211_5MHZ:
+      m_channelWidth = 5;
+      break;
+    default:
+      m_channelWidth = 20;
+      break;
+    }
+  YansWifiPhy::ConfigureStandard (standard);
+  UpdateRxSpectrumModel ();
+}
+
+void
+SpectrumWifiPhy::SetFrequency (uint32_t freq)
+{
+  NS_LOG_FUNCTION (this << freq);
+  YansWifiPhy::SetFrequency (freq);
+  UpdateRxSpectrumModel ();
+}
+
+void
+SpectrumWifiPhy::SetChannelBonding (bool channelbonding)
+{
+  NS_LOG_FUNCTION (this << channelbonding);
+  YansWifiPhy::SetChannelBonding (channelbonding);
+  UpdateRxSpectrumModel ();
+}
+
+uint32_t
+SpectrumWifiPhy::GetChannelWidth (void) const
+{
+  return GetChannelBonding () ? 40 : m_channelWidth;
+}
+
+Ptr<const SpectrumModel>
+SpectrumWifiPhy::GetRxSpectrumModel (void) const
+{
+  return m_rxSpectrumModel;
+}
+
+Ptr<const SpectrumModel>
+SpectrumWifiPhy::GetSpectrumModel (double centerFrequencyMhz, uint32_t channelWidthMhz)
+{
+  static std::map<std::pair<double, uint32_t>, Ptr<const SpectrumModel> > models;
+  std::pair<double, uint32_t> key = std::make_pair (centerFrequencyMhz, channelWidthMhz);
+  std::map<std::pair<double, uint32_t>, Ptr<const SpectrumModel> >::const_iterator it = models.find (key);
+  if (it != models.end ())
+    {
+      return it->second;
+    }
+  BandInfo band;
+  band.fc = centerFrequencyMhz * 1e6;
+  band.fl = band.fc - channelWidthMhz * 0.5e6;
+  band.fh = band.fc + channelWidthMhz * 0.5e6;
+  Bands bands;
+  bands.push_back (band);
+  Ptr<const SpectrumModel> model = Create<SpectrumModel> (bands);
+  models[key] = model;
+  return model;
+}
+
+void
+SpectrumWifiPhy::UpdateRxSpectrumModel (void)
+{
+  Ptr<const SpectrumModel> model = GetSpectrumModel (GetChannelFrequencyMhz (), GetChannelWidth ());
+  if (model == m_rxSpectrumModel)
+    {
+      return;
+    }
+  NS_LOG_DEBUG ("rx spectrum model " << model->GetUid () << " at " << GetChannelFrequencyMhz ()
+                << " MHz, " << GetChannelWidth () << " MHz wide");
+  m_rxSpectrumModel = model;
+  if (m_channel != 0)
+    {
+      // tell the channel, so that it creates the converters needed
+      m_channel->AddRx (m_wifiSpectrumPhyInterface);
+    }
+}
+
+void
+SpectrumWifiPhy::StartTx (Ptr<const Packet> packet, double txPowerDbm,
+                          WifiTxVector txVector, WifiPreamble preamble,
+                          Time txDuration)
+{
+  NS_LOG_FUNCTION (this << packet << txPowerDbm << preamble << txDuration);
+  double txPowerW = std::pow (10.0, txPowerDbm / 10.0) / 1000.0;
+  Ptr<SpectrumValue> psd = Create<SpectrumValue> (m_rxSpectrumModel);
+  // flat over the single band of the model
+  *psd = txPowerW / (GetChannelWidth () * 1e6);
+
+  Ptr<WifiSpectrumSignalParameters> txParams = Create<WifiSpectrumSignalParameters> ();
+  txParams->psd = psd;
+  txParams->duration = txDuration;
+  txParams->txPhy = m_wifiSpectrumPhyInterface;
+  txParams->packet = packet;
+  txParams->txVector = txVector;
+  txParams->preamble = preamble;
+  m_channel->StartTx (txParams);
+}
+
+void
+SpectrumWifiPhy::StartRx (Ptr<SpectrumSignalParameters> params)
+{
+  NS_LOG_FUNCTION (this << params);
+  double rxPowerW = Integral (*params->psd);
+  if (rxPowerW <= 0)
+    {
+      NS_LOG_LOGIC ("signal out of the band of the channel");
+      return;
+    }
+  double rxPowerDbm = 10.0 * std::log10 (rxPowerW) + 30.0;
+  Ptr<WifiSpectrumSignalParameters> wifiParams = DynamicCast<WifiSpectrumSignalParameters> (params);
+  if (wifiParams != 0
+      && wifiParams->txPhy->GetRxSpectrumModel () == m_rxSpectrumModel)
+    {
+      StartReceivePacket (wifiParams->packet, rxPowerDbm, wifiParams->txVector, wifiParams->preamble);
+    }
+  else
+    {
+      NS_LOG_LOGIC ("interference of " << rxPowerDbm << " dBm");
+      StartReceiveInterference (rxPowerDbm, params->duration);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,126 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef SPECTRUM_WIFI_PHY_H
+#define SPECTRUM_WIFI_PHY_H
+
+#include <stdint.h>
+#include "ns3/spectrum-channel.h"
+#include "ns3/spectrum-model.h"
+#include "ns3/spectrum-signal-parameters.h"
+#include "yans-wifi-phy.h"
+
+namespace ns3 {
+
+class WifiSpectrumPhyInterface;
+
+/**
+ * \brief 802.11 PHY layer model attached to a SpectrumChannel
+ * \ingroup wifi
+ *
+ * This PHY receives and decodes frames exactly like YansWifiPhy, but
+ * it is attached to a SpectrumChannel instead of a YansWifiChannel, so
+ * that the signals of other technologies (see for instance
+ * WaveformGenerator) add to the interference of Wi-Fi frames.
+ *
+ * Frames are sent with a flat power spectral density over the channel
+ * (a single band of the channel width, centered on the frequency of
+ * the channel). The power of every signal which reaches this PHY is
+ * integrated over the same band. Wi-Fi signals sent on the same band
+ * are received as frames, all the others only count as interference.
+ *
+ * The channel width is 20 MHz, or 40 MHz with channel bonding, 22 MHz
+ * for 802.11b, and 10 or 5 MHz for the corresponding standards.
+ * SpectrumWifiPhy instances on the same channel share the same
+ * SpectrumModel, so that the channel converts the PSD of a signal
+ * once for all of them.
+ */
+class SpectrumWifiPhy : public YansWifiPhy
+{
+public:
+  static TypeId GetTypeId (void);
+
+  SpectrumWifiPhy ();
+  virtual ~SpectrumWifiPhy ();
+
+  /**
+   * Set the SpectrumChannel this SpectrumWifiPhy is to be connected to.
+   *
+   * \param channel the SpectrumChannel this SpectrumWifiPhy is to be connected to
+   */
+  void SetChannel (Ptr<SpectrumChannel> channel);
+  /**
+   * \return the SpectrumChannel this SpectrumWifiPhy is connected to
+   */
+  Ptr<SpectrumChannel> GetSpectrumChannel (void) const;
+  /**
+   * \return the SpectrumPhy through which this SpectrumWifiPhy is
+   *         attached to the SpectrumChannel
+   */
+  Ptr<SpectrumPhy> GetSpectrumPhy (void) const;
+  /**
+   * \return the width of the channel (MHz)
+   */
+  uint32_t GetChannelWidth (void) const;
+  /**
+   * \return the SpectrumModel of the signals received by this PHY
+   */
+  Ptr<const SpectrumModel> GetRxSpectrumModel (void) const;
+  /**
+   * Start receiving a signal from the SpectrumChannel.
+   *
+   * \param params the parameters of the signal
+   */
+  void StartRx (Ptr<SpectrumSignalParameters> params);
+
+  /**
+   * \return the SpectrumChannel this SpectrumWifiPhy is connected to, as
+   * returned by GetSpectrumChannel
+   */
+  virtual Ptr<Channel> GetChannel (void) const;
+  virtual void SetChannelNumber (uint16_t id);
+  virtual void ConfigureStandard (enum WifiPhyStandard standard);
+  virtual void SetFrequency (uint32_t freq);
+  virtual void SetChannelBonding (bool channelbonding);
+
+protected:
+  virtual void DoDispose (void);
+  virtual void StartTx (Ptr<const Packet> packet, double txPowerDbm,
+                        WifiTxVector txVector, WifiPreamble preamble,
+                        Time txDuration);
+
+private:
+  /**
+   * Make the SpectrumModel follow the frequency and width of the
+   * channel, and register the new model with the SpectrumChannel.
+   */
+  void UpdateRxSpectrumModel (void);
+  /**
+   * \param centerFrequencyMhz the center frequency of the channel (MHz)
+   * \param channelWidthMhz the width of the channel (MHz)
+   * \return the SpectrumModel shared by all the PHYs on that channel
+   */
+  static Ptr<const SpectrumModel> GetSpectrumModel (double centerFrequencyMhz,
+                                                    uint32_t channelWidthMhz);
+
+  Ptr<SpectrumChannel> m_channel;         //!< SpectrumChannel that this SpectrumWifiPhy is connected to
+  Ptr<WifiSpectrumPhyInterface> m_wifiSpectrumPhyInterface; //!< SpectrumPhy attached to m_channel
+  Ptr<const SpectrumModel> m_rxSpectrumModel; //!< SpectrumModel of the current channel
+  uint32_t m_channelWidth;                //!< width of the channel without bonding (MHz)
+};
+
+} // namespace ns3
+
+#endif /* SPECTRUM_WIFI_PHY_H */
@@ -0,0 +1,240 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <limits>
+#include <set>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include "table-error-rate-model.h"
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/pointer.h"
+
+NS_LOG_COMPONENT_DEFINE ("TableErrorRateModel");
+
+namespace ns3 {
+
+/// the value of the tables for a null success rate
+static const double g_noSuccess = std::log (std::numeric_limits<double>::min ());
+/// the value of the tables for a success rate of one half
+static const double g_logHalf = std::log (0.5);
+
+NS_OBJECT_ENSURE_REGISTERED (TableErrorRateModel)
+  ;
+
+TypeId
+TableErrorRateModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TableErrorRateModel")
+    .SetParent<ErrorRateModel> ()
+    .AddConstructor<TableErrorRateModel> ()
+    .AddAttribute ("ErrorRateModel",
+                   "The error rate model whose success rates are tabulated.",
+                   StringValue ("ns3::NistErrorRateModel"),
+                   MakePointerAccessor (&TableErrorRateModel::m_model),
+                   MakePointerChecker<ErrorRateModel> ())
+    .AddAttribute ("MinSnr",
+                   "The lowest SNR (dB) of the tables. Lower SNRs are handed to the tabulated model.",
+                   DoubleValue (-10.0),
+                   MakeDoubleAccessor (&TableErrorRateModel::m_minSnrDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxSnr",
+                   "The highest SNR (dB) of the tables. Higher SNRs are handed to the tabulated model.",
+                   DoubleValue (50.0),
+                   MakeDoubleAccessor (&TableErrorRateModel::m_maxSnrDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("Resolution",
+                   "The SNR step (dB) between two entries of the tables.",
+                   DoubleValue (0.01),
+                   MakeDoubleAccessor (&TableErrorRateModel::m_resolutionDb),
+                   MakeDoubleChecker<double> (1e-6))
+    .AddAttribute ("TableFile",
+                   "The file the tables are loaded from and saved to. "
+                   "Empty to compute the tables in each simulation.",
+                   StringValue (""),
+                   MakeStringAccessor (&TableErrorRateModel::m_tableFile),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+TableErrorRateModel::TableErrorRateModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TableErrorRateModel::~TableErrorRateModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TableErrorRateModel::Tables *
+TableErrorRateModel::GetTables (void)
+{
+  static Tables tables;
+  return &tables;
+}
+
+double
+TableErrorRateModel::GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
+{
+  if (snr > 0
+      && (mode.GetModulationClass () == WIFI_MOD_CLASS_OFDM
+          || mode.GetModulationClass () == WIFI_MOD_CLASS_ERP_OFDM
+          || mode.GetModulationClass () == WIFI_MOD_CLASS_HT))
+    {
+      double x = (10.0 * std::log10 (snr) - m_minSnrDb) / m_resolutionDb;
+      if (x >= 0)
+        {
+          const Table *table;
+          std::map<uint32_t, const Table *>::const_iterator it = m_tables.find (mode.GetUid ());
+          if (it != m_tables.end ())
+            {
+              table = it->second;
+            }
+          else
+            {
+              table = GetTable (mode);
+              m_tables[mode.GetUid ()] = table;
+            }
+          if (x < table->size () - 1)
+            {
+              uint32_t i = static_cast<uint32_t> (x);
+              double low = (*table)[i];
+              double high = (*table)[i + 1];
+              if (low < g_logHalf)
+                {
+                  // the logarithm is far from linear for low success
+                  // rates, where only short chunks have a chance to be
+                  // received: interpolate the success rate itself
+                  double success = std::exp (low) + (x - i) * (std::exp (high) - std::exp (low));
+                  return std::pow (success, static_cast<double> (nbits));
+                }
+              return std::exp ((low + (x - i) * (high - low)) * nbits);
+            }
+        }
+    }
+  return m_model->GetChunkSuccessRate (mode, snr, nbits);
+}
+
+std::string
+TableErrorRateModel::GetTableKey (WifiMode mode) const
+{
+  std::ostringstream oss;
+  oss << std::setprecision (17)
+      << m_model->GetInstanceTypeId ().GetName () << " "
+      << mode.GetUniqueName () << " "
+      << m_minSnrDb << " " << m_maxSnrDb << " " << m_resolutionDb;
+  return oss.str ();
+}
+
+const TableErrorRateModel::Table *
+TableErrorRateModel::GetTable (WifiMode mode) const
+{
+  NS_LOG_FUNCTION (this << mode);
+  LoadTables ();
+  Tables *tables = GetTables ();
+  std::string key = GetTableKey (mode);
+  Tables::const_iterator it = tables->find (key);
+  if (it != tables->end ())
+    {
+      return &it->second;
+    }
+
+  NS_LOG_DEBUG ("computing table " << key);
+  uint32_t n = static_cast<uint32_t> ((m_maxSnrDb - m_minSnrDb) / m_resolutionDb + 0.5) + 1;
+  Table &table = (*tables)[key];
+  table.reserve (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double snr = std::pow (10.0, (m_minSnrDb + i * m_resolutionDb) / 10.0);
+      double success = m_model->GetChunkSuccessRate (mode, snr, 1);
+      // keep the logarithm finite so that it can be interpolated
+      table.push_back (success > 0 ? std::log (success) : g_noSuccess);
+    }
+  SaveTables ();
+  return &table;
+}
+
+void
+TableErrorRateModel::LoadTables (void) const
+{
+  static std::set<std::string> loaded;
+  if (m_tableFile.empty () || !loaded.insert (m_tableFile).second)
+    {
+      return;
+    }
+  std::ifstream file (m_tableFile.c_str ());
+  if (!file.is_open ())
+    {
+      NS_LOG_DEBUG ("no table file " << m_tableFile);
+      return;
+    }
+  Tables *tables = GetTables ();
+  std::string line;
+  while (std::getline (file, line))
+    {
+      // <model> <mode> <min> <max> <resolution> <size> <values...>
+      std::istringstream iss (line);
+      std::string model, modeName, minSnr, maxSnr, resolution;
+      uint32_t n = 0;
+      iss >> model >> modeName >> minSnr >> maxSnr >> resolution >> n;
+      Table table (n);
+      for (uint32_t i = 0; i < n && iss; i++)
+        {
+          iss >> table[i];
+        }
+      if (iss.fail ())
+        {
+          NS_LOG_WARN ("ignoring malformed line in " << m_tableFile);
+          continue;
+        }
+      std::string key = model + " " + modeName + " " + minSnr + " " + maxSnr + " " + resolution;
+      NS_LOG_DEBUG ("loaded table " << key);
+      tables->insert (std::make_pair (key, table));
+    }
+}
+
+void
+TableErrorRateModel::SaveTables (void) const
+{
+  if (m_tableFile.empty ())
+    {
+      return;
+    }
+  std::ofstream file (m_tableFile.c_str ());
+  if (!file.is_open ())
+    {
+      NS_LOG_WARN ("cannot write table file " << m_tableFile);
+      return;
+    }
+  file << std::setprecision (17);
+  Tables *tables = GetTables ();
+  for (Tables::const_iterator i = tables->begin (); i != tables->end (); ++i)
+    {
+      file << i->first << " " << i->second.size ();
+      for (Table::const_iterator j = i->second.begin (); j != i->second.end (); ++j)
+        {
+          file << " " << *j;
+        }
+      file << std::endl;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,105 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TABLE_ERROR_RATE_MODEL_H
+#define TABLE_ERROR_RATE_MODEL_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+#include "wifi-mode.h"
+#include "error-rate-model.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * An error rate model which looks up the success rates of another
+ * error rate model in precomputed tables.
+ *
+ * All the error rate models of this module compute the success rate of
+ * a chunk as the success rate of a single bit raised to the power of
+ * the number of bits of the chunk.  For each OFDM, ERP-OFDM and HT
+ * WifiMode, this model tabulates the logarithm of the single bit
+ * success rate of the wrapped model on a regular grid of SNR values
+ * (in dB), the first time the mode is used.  The success rate of a
+ * chunk is then obtained by linear interpolation in the table, and one
+ * exponential.  SNR values outside of the [MinSnr, MaxSnr] range, and
+ * DSSS modes, are handed to the wrapped model.
+ *
+ * With the default resolution of 0.01 dB, the chunk success rates of
+ * the NIST and YANS models are reproduced within 1e-4 (absolute) for
+ * chunks of 100 bits or more, and within 1e-2 for shorter chunks.
+ *
+ * Tables are shared by all the instances which wrap a model of the same
+ * TypeId with the same grid, so the wrapped model must not have any
+ * state or attribute which changes its results.  If TableFile is set,
+ * the tables found in that file are reused instead of being computed
+ * again, and the file is rewritten each time a new table is computed.
+ *
+ * The attributes must be set before the model is first used.
+ */
+class TableErrorRateModel : public ErrorRateModel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  TableErrorRateModel ();
+  virtual ~TableErrorRateModel ();
+
+  virtual double GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const;
+
+private:
+  /// a table of the logarithm of the single bit success rates
+  typedef std::vector<double> Table;
+  /// the tables of all the instances, indexed by GetTableKey
+  typedef std::map<std::string, Table> Tables;
+
+  /**
+   * \param mode the Wi-Fi mode of the table
+   * \return the key of the table of mode in the shared tables
+   */
+  std::string GetTableKey (WifiMode mode) const;
+  /**
+   * \param mode the Wi-Fi mode of the table
+   * \return the table of mode, computed if needed
+   */
+  const Table * GetTable (WifiMode mode) const;
+  /**
+   * Add the tables found in m_tableFile to the shared tables, once per
+   * file.
+   */
+  void LoadTables (void) const;
+  /**
+   * Write all the shared tables to m_tableFile.
+   */
+  void SaveTables (void) const;
+
+  static Tables * GetTables (void);
+
+  Ptr<ErrorRateModel> m_model; //!< the wrapped error rate model
+  double m_minSnrDb;           //!< SNR of the first entry of the tables (dB)
+  double m_maxSnrDb;           //!< maximum SNR of the tables (dB)
+  double m_resolutionDb;       //!< SNR step between two entries (dB)
+  std::string m_tableFile;     //!< file the tables are loaded from and saved to
+  /// the tables used by this instance so far, indexed by WifiMode uid
+  mutable std::map<uint32_t, const Table *> m_tables;
+};
+
+} // namespace ns3
+
+#endif /* TABLE_ERROR_RATE_MODEL_H */
@@ -20,6 +20,7 @@
  * Author: Mirko Banchi <mk.banchi@gmail.com>
  */
 
+#include "ns3/assert.h"
 #include "ns3/simulator.h"
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
@@ -41,6 +42,11 @@ WifiMacQueue::Item::Item (Ptr<const Packet> packet,
 {
 }
 
+WifiMacQueue::SubQueueInfo::SubQueueInfo ()
+  : size (0)
+{
+}
+
 TypeId
 WifiMacQueue::GetTypeId (void)
 {
@@ -94,41 +100,62 @@ WifiMacQueue::GetMaxDelay (void) const
 }
 
 void
-WifiMacQueue::Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
+WifiMacQueue::Insert (bool front, Ptr<const Packet> packet, const WifiMacHeader &hdr)
 {
-  Cleanup ();
-  if (m_size == m_maxSize)
+  Time now = Simulator::Now ();
+  PacketQueueI it = m_queue.insert (front ? m_queue.begin () : m_queue.end (),
+                                    Item (packet, hdr, now));
+  it->expiryIt = m_expiries.insert (std::make_pair (now, it));
+  if (hdr.IsQosData ())
     {
-      return;
+      // the packet goes to the same end of its sub queue
+      SubQueueInfo &info = m_subQueues[std::make_pair (hdr.GetAddr1 (), hdr.GetQosTid ())];
+      it->subQueueIt = info.packets.insert (front ? info.packets.begin () : info.packets.end (), it);
+      info.size++;
     }
-  Time now = Simulator::Now ();
-  m_queue.push_back (Item (packet, hdr, now));
   m_size++;
 }
 
 void
-WifiMacQueue::Cleanup (void)
+WifiMacQueue::Erase (PacketQueueI it)
 {
-  if (m_queue.empty ())
+  if (it->hdr.IsQosData ())
+    {
+      SubQueues::iterator info = m_subQueues.find (std::make_pair (it->hdr.GetAddr1 (), it->hdr.GetQosTid ()));
+      NS_ASSERT (info != m_subQueues.end ());
+      info->second.packets.erase (it->subQueueIt);
+      if (--info->second.size == 0)
+        {
+          m_subQueues.erase (info);
+        }
+    }
+  m_expiries.erase (it->expiryIt);
+  m_queue.erase (it);
+  m_size--;
+}
+
+void
+WifiMacQueue::Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
+{
+  Cleanup ();
+  if (m_size == m_maxSize)
     {
       return;
     }
+  Insert (false, packet, hdr);
+}
 
+void
+WifiMacQueue::Cleanup (void)
+{
+  // the expiries are sorted by timestamp: only the expired packets
+  // are visited
   Time now = Simulator::Now ();
-  uint32_t n = 0;
-  for (PacketQueueI i = m_queue.begin (); i != m_queue.end ();)
+  while (!m_expiries.empty ()
+         && m_expiries.begin ()->first + m_maxDelay <= now)
     {
-      if (i->tstamp + m_maxDelay > now)
-        {
-          i++;
-        }
-      else
-        {
-          i = m_queue.erase (i);
-          n++;
-        }
+      Erase (m_expiries.begin ()->second);
     }
-  m_size -= n;
 }
 
 Ptr<const Packet>
@@ -137,11 +164,10 @@ WifiMacQueue::Dequeue (WifiMacHeader *hdr)
   Cleanup ();
   if (!m_queue.empty ())
     {
-      Item i = m_queue.front ();
-      m_queue.pop_front ();
-      m_size--;
-      *hdr = i.hdr;
-      return i.packet;
+      Ptr<const Packet> packet = m_queue.front ().packet;
+      *hdr = m_queue.front ().hdr;
+      Erase (m_queue.begin ());
+      return packet;
     }
   return 0;
 }
@@ -152,38 +178,67 @@ WifiMacQueue::Peek (WifiMacHeader *hdr)
   Cleanup ();
   if (!m_queue.empty ())
     {
-      Item i = m_queue.front ();
-      *hdr = i.hdr;
-      return i.packet;
+      *hdr = m_queue.front ().hdr;
+      return m_queue.front ().packet;
     }
   return 0;
 }
 
+WifiMacQueue::PacketQueueI
+WifiMacQueue::FindByTidAndAddress (uint8_t tid, WifiMacHeader::AddressType type,
+                                   Mac48Address dest)
+{
+  if (type == WifiMacHeader::ADDR1)
+    {
+      SubQueues::iterator info = m_subQueues.find (std::make_pair (dest, tid));
+      if (info == m_subQueues.end ())
+        {
+          return m_queue.end ();
+        }
+      return info->second.packets.front ();
+    }
+  for (PacketQueueI it = m_queue.begin (); it != m_queue.end (); ++it)
+    {
+      if (it->hdr.IsQosData ()
+          && GetAddressForPacket (type, it) == dest
+          && it->hdr.GetQosTid () == tid)
+        {
+          return it;
+        }
+    }
+  return m_queue.end ();
+}
+
 Ptr<const Packet>
 WifiMacQueue::DequeueByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
                                       WifiMacHeader::AddressType type, Mac48Address dest)
 {
   Cleanup ();
-  Ptr<const Packet> packet = 0;
-  if (!m_queue.empty ())
+  PacketQueueI it = FindByTidAndAddress (tid, type, dest);
+  if (it == m_queue.end ())
     {
-      PacketQueueI it;
-      for (it = m_queue.begin (); it != m_queue.end (); ++it)
-        {
-          if (it->hdr.IsQosData ())
-            {
-              if (GetAddressForPacket (type, it) == dest
-                  && it->hdr.GetQosTid () == tid)
-                {
-                  packet = it->packet;
-                  *hdr = it->hdr;
-                  m_queue.erase (it);
-                  m_size--;
-                  break;
-                }
-            }
-        }
+      return 0;
+    }
+  Ptr<const Packet> packet = it->packet;
+  *hdr = it->hdr;
+  Erase (it);
+  return packet;
+}
+
+Ptr<const Packet>
+WifiMacQueue::DequeueByTidAndAddress (WifiMacHeader *hdr, Time &tStamp, uint8_t tid,
+                                      WifiMacHeader::AddressType type, Mac48Address dest)
+{
+  Cleanup ();
+  PacketQueueI it = FindByTidAndAddress (tid, type, dest);
+  if (it == m_queue.end ())
+    {
+      return 0;
     }
+  Ptr<const Packet> packet = it->packet;
+  *hdr = it->hdr;
+  tStamp = it->tstamp;
+  Erase (it);
   return packet;
 }
 
@@ -192,23 +247,13 @@ WifiMacQueue::PeekByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
                                    WifiMacHeader::AddressType type, Mac48Address dest)
 {
   Cleanup ();
-  if (!m_queue.empty ())
+  PacketQueueI it = FindByTidAndAddress (tid, type, dest);
+  if (it == m_queue.end ())
     {
-      PacketQueueI it;
-      for (it = m_queue.begin (); it != m_queue.end (); ++it)
-        {
-          if (it->hdr.IsQosData ())
-            {
-              if (GetAddressForPacket (type, it) == dest
-                  && it->hdr.GetQosTid () == tid)
-                {
-                  *hdr = it->hdr;
-                  return it->packet;
-                }
-            }
-        }
+      return 0;
     }
-  return 0;
+  *hdr = it->hdr;
+  return it->packet;
 }
 
 bool
@@ -228,6 +273,8 @@ void
 WifiMacQueue::Flush (void)
 {
   m_queue.erase (m_queue.begin (), m_queue.end ());
+  m_subQueues.clear ();
+  m_expiries.clear ();
   m_size = 0;
 }
 
@@ -257,8 +304,7 @@ WifiMacQueue::Remove (Ptr<const Packet> packet)
     {
       if (it->packet == packet)
         {
-          m_queue.erase (it);
-          m_size--;
+          Erase (it);
           return true;
         }
     }
@@ -273,9 +319,7 @@ WifiMacQueue::PushFront (Ptr<const Packet> packet, const WifiMacHeader &hdr)
     {
       return;
     }
-  Time now = Simulator::Now ();
-  m_queue.push_front (Item (packet, hdr, now));
-  m_size++;
+  Insert (true, packet, hdr);
 }
 
 uint32_t
@@ -283,18 +327,19 @@ WifiMacQueue::GetNPacketsByTidAndAddress (uint8_t tid, WifiMacHeader::AddressTyp
                                           Mac48Address addr)
 {
   Cleanup ();
+  if (type == WifiMacHeader::ADDR1)
+    {
+      SubQueues::const_iterator info = m_subQueues.find (std::make_pair (addr, tid));
+      return info == m_subQueues.end () ? 0 : info->second.size;
+    }
   uint32_t nPackets = 0;
-  if (!m_queue.empty ())
+  for (PacketQueueI it = m_queue.begin (); it != m_queue.end (); it++)
     {
-      PacketQueueI it;
-      for (it = m_queue.begin (); it != m_queue.end (); it++)
+      if (GetAddressForPacket (type, it) == addr)
         {
-          if (GetAddressForPacket (type, it) == addr)
+          if (it->hdr.IsQosData () && it->hdr.GetQosTid () == tid)
             {
-              if (it->hdr.IsQosData () && it->hdr.GetQosTid () == tid)
-                {
-                  nPackets++;
-                }
+              nPackets++;
             }
         }
     }
@@ -315,8 +360,7 @@ WifiMacQueue::DequeueFirstAvailable (WifiMacHeader *hdr, Time &timestamp,
           *hdr = it->hdr;
           timestamp = it->tstamp;
           packet = it->packet;
-          m_queue.erase (it);
-          m_size--;
+          Erase (it);
           return packet;
         }
     }
@@ -23,6 +23,7 @@
 #define WIFI_MAC_QUEUE_H
 
 #include <list>
+#include <map>
 #include <utility>
 #include "ns3/packet.h"
 #include "ns3/nstime.h"
@@ -46,6 +47,11 @@ class QosBlockedDestinations;
  * to verify whether or not it should be dropped. If
  * dot11EDCATableMSDULifetime has elapsed, it is dropped.
  * Otherwise, it is returned to the caller.
+ *
+ * Besides the FIFO order of the queue, the QoS data packets are
+ * indexed by receiver address (Address 1) and TID, and all the packets
+ * by timestamp, so that the lookups by TID and Address 1 and the
+ * removal of the expired packets do not scan the whole queue.
  */
 class WifiMacQueue : public Object
 {
@@ -124,6 +130,23 @@ public:
                                             uint8_t tid,
                                             WifiMacHeader::AddressType type,
                                             Mac48Address addr);
+  /**
+   * Same as DequeueByTidAndAddress above, and also returns the time at which
+   * the packet was enqueued.  Is typically used by ns3::EdcaTxopN in order to
+   * perform MPDU aggregation (A-MPDU).
+   *
+   * \param hdr the header of the dequeued packet
+   * \param tStamp the time at which the packet was enqueued
+   * \param tid the given TID
+   * \param type the given address type
+   * \param addr the given destination
+   * \return packet
+   */
+  Ptr<const Packet> DequeueByTidAndAddress (WifiMacHeader *hdr,
+                                            Time &tStamp,
+                                            uint8_t tid,
+                                            WifiMacHeader::AddressType type,
+                                            Mac48Address addr);
   /**
    * Searchs and returns, if is present in this queue, first packet having
    * address indicated by <i>type</i> equals to <i>addr</i>, and tid
@@ -225,6 +248,23 @@ protected:
    * typedef for packet (struct Item) queue iterator.
    */
   typedef std::list<struct Item>::iterator PacketQueueI;
+  /**
+   * typedef for the QoS data packets of a (receiver address, TID) pair,
+   * in the order of the packet queue.
+   */
+  typedef std::list<PacketQueueI> SubQueue;
+  /**
+   * typedef for sub queue iterator.
+   */
+  typedef std::list<PacketQueueI>::iterator SubQueueI;
+  /**
+   * typedef for the packets of the packet queue sorted by timestamp.
+   */
+  typedef std::multimap<Time, PacketQueueI> Expiries;
+  /**
+   * typedef for expiries iterator.
+   */
+  typedef std::multimap<Time, PacketQueueI>::iterator ExpiriesI;
   /**
    * Return the appropriate address for the given packet (given by PacketQueue iterator).
    *
@@ -233,6 +273,32 @@ protected:
    * \return the address
    */
   Mac48Address GetAddressForPacket (enum WifiMacHeader::AddressType type, PacketQueueI it);
+  /**
+   * Insert a packet in the queue and in the indices.
+   *
+   * \param front true to insert the packet at the front of the queue,
+   *        false at the end
+   * \param packet the packet
+   * \param hdr the header of the packet
+   */
+  void Insert (bool front, Ptr<const Packet> packet, const WifiMacHeader &hdr);
+  /**
+   * Remove a packet from the queue and from the indices.
+   *
+   * \param it the packet to remove
+   */
+  void Erase (PacketQueueI it);
+  /**
+   * Find the first QoS data packet of a given TID and address.
+   *
+   * \param tid the given TID
+   * \param type the given address type
+   * \param addr the given destination
+   * \return the packet, or the end of the queue if there is none
+   */
+  PacketQueueI FindByTidAndAddress (uint8_t tid,
+                                    WifiMacHeader::AddressType type,
+                                    Mac48Address addr);
 
   /**
    * A struct that holds information about a packet for putting
@@ -253,9 +319,28 @@ protected:
     Ptr<const Packet> packet; //!< Actual packet
     WifiMacHeader hdr; //!< Wifi MAC header associated with the packet
     Time tstamp; //!< timestamp when the packet arrived at the queue
+    SubQueueI subQueueIt; //!< position in its sub queue, for QoS data packets
+    ExpiriesI expiryIt; //!< position in the expiries
+  };
+
+  /**
+   * A sub queue, and its size which std::list does not give in
+   * constant time.
+   */
+  struct SubQueueInfo
+  {
+    SubQueueInfo ();
+    SubQueue packets; //!< the packets of the sub queue
+    uint32_t size; //!< the number of packets of the sub queue
   };
+  /**
+   * typedef for the sub queues, indexed by receiver address and TID.
+   */
+  typedef std::map<std::pair<Mac48Address, uint8_t>, SubQueueInfo> SubQueues;
 
   PacketQueue m_queue; //!< Packet (struct Item) queue
+  SubQueues m_subQueues; //!< QoS data packets of m_queue by receiver address and TID
+  Expiries m_expiries; //!< Packets of m_queue by timestamp
   uint32_t m_size; //!< Current queue size
   uint32_t m_maxSize; //!< Queue capacity
   Time m_maxDelay; //!< Time to live for packets in the queue
@@ -51,7 +51,7 @@ WifiNetDevice::GetTypeId (void)
     .AddAttribute ("Channel", "The channel attached to this device",
                    PointerValue (),
                    MakePointerAccessor (&WifiNetDevice::DoGetChannel),
-                   MakePointerChecker<WifiChannel> ())
+                   MakePointerChecker<Channel> ())
     .AddAttribute ("Phy", "The PHY layer attached to this device.",
                    PointerValue (),
                    MakePointerAccessor (&WifiNetDevice::GetPhy,
@@ -174,7 +174,7 @@ WifiNetDevice::GetChannel (void) const
 {
   return m_phy->GetChannel ();
 }
-Ptr<WifiChannel>
+Ptr<Channel>
 WifiNetDevice::DoGetChannel (void) const
 {
   return m_phy->GetChannel ();
@@ -35,7 +35,7 @@
 
 namespace ns3 {
 
-class WifiChannel;
+class Channel;
 class NetDevice;
 
 /**
@@ -470,11 +470,11 @@ public:
   virtual void ConfigureStandard (enum WifiPhyStandard standard) = 0;
 
   /**
-   * Return the WifiChannel this WifiPhy is connected to.
+   * Return the Channel this WifiPhy is connected to.
    *
-   * \return the WifiChannel this WifiPhy is connected to
+   * \return the Channel this WifiPhy is connected to
    */
-  virtual Ptr<WifiChannel> GetChannel (void) const = 0;
+  virtual Ptr<Channel> GetChannel (void) const = 0;
 
   /**
    * Return a WifiMode for DSSS at 1Mbps.
@@ -327,12 +327,12 @@ WifiRemoteStationManager::DoDispose (void)
 {
   for (StationStates::const_iterator i = m_states.begin (); i != m_states.end (); i++)
     {
-      delete (*i);
+      delete i->second;
     }
   m_states.clear ();
   for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
     {
-      delete (*i);
+      delete i->second;
     }
   m_stations.clear ();
 }
@@ -1136,12 +1136,10 @@ WifiRemoteStationManager::GetInfo (Mac48Address address)
 WifiRemoteStationState *
 WifiRemoteStationManager::LookupState (Mac48Address address) const
 {
-  for (StationStates::const_iterator i = m_states.begin (); i != m_states.end (); i++)
+  StationStates::const_iterator i = m_states.find (address);
+  if (i != m_states.end ())
     {
-      if ((*i)->m_address == address)
-        {
-          return (*i);
-        }
+      return i->second;
     }
   WifiRemoteStationState *state = new WifiRemoteStationState ();
   state->m_state = WifiRemoteStationState::BRAND_NEW;
@@ -1150,10 +1148,12 @@ WifiRemoteStationManager::LookupState (Mac48Address address) const
   state->m_operationalMcsSet.push_back(GetDefaultMcs());
   state->m_shortGuardInterval=m_wifiPhy->GetGuardInterval();
   state->m_greenfield=m_wifiPhy->GetGreenfield();
+  // until its capabilities are known, the station is assumed to support HT as we do
+  state->m_htSupported = m_htSupported;
   state->m_rx=1;
   state->m_tx=1;
   state->m_stbc=false;
-  const_cast<WifiRemoteStationManager *> (this)->m_states.push_back (state);
+  const_cast<WifiRemoteStationManager *> (this)->m_states[address] = state;
   return state;
 }
 WifiRemoteStation *
@@ -1173,13 +1173,10 @@ WifiRemoteStationManager::Lookup (Mac48Address address, const WifiMacHeader *hea
 WifiRemoteStation *
 WifiRemoteStationManager::Lookup (Mac48Address address, uint8_t tid) const
 {
-  for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
+  Stations::const_iterator i = m_stations.find (std::make_pair (address, tid));
+  if (i != m_stations.end ())
     {
-      if ((*i)->m_tid == tid
-          && (*i)->m_state->m_address == address)
-        {
-          return (*i);
-        }
+      return i->second;
     }
   WifiRemoteStationState *state = LookupState (address);
 
@@ -1189,7 +1186,7 @@ WifiRemoteStationManager::Lookup (Mac48Address address, uint8_t tid) const
   station->m_ssrc = 0;
   station->m_slrc = 0;
   // XXX
-  const_cast<WifiRemoteStationManager *> (this)->m_stations.push_back (station);
+  const_cast<WifiRemoteStationManager *> (this)->m_stations[std::make_pair (address, tid)] = station;
   return station;
 
 }
@@ -1201,6 +1198,7 @@ WifiRemoteStationManager::AddStationHtCapabilities (Mac48Address from, HtCapabil
   state=LookupState (from);
   state->m_shortGuardInterval=htcapabilities.GetShortGuardInterval20();
   state->m_greenfield=htcapabilities.GetGreenfield();
+  state->m_htSupported = htcapabilities.GetHtSupported ();
  
 }
 //Used by mac low to choose format used GF, MF or Non HT
@@ -1209,6 +1207,11 @@ WifiRemoteStationManager::GetGreenfieldSupported (Mac48Address address) const
 {
  return LookupState(address)->m_greenfield;
 }
+bool
+WifiRemoteStationManager::GetHtSupported (Mac48Address address) const
+{
+  return LookupState (address)->m_htSupported;
+}
 WifiMode
 WifiRemoteStationManager::GetDefaultMode (void) const
 {
@@ -1224,7 +1227,7 @@ WifiRemoteStationManager::Reset (void)
 {
   for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
     {
-      delete (*i);
+      delete i->second;
     }
   m_stations.clear ();
   m_bssBasicRateSet.clear ();
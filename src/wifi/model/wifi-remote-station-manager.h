@@ -21,6 +21,7 @@
 #define WIFI_REMOTE_STATION_MANAGER_H
 
 #include <vector>
+#include <map>
 #include <utility>
 #include "ns3/mac48-address.h"
 #include "ns3/traced-callback.h"
@@ -207,6 +208,14 @@ public:
    *          false otherwise
    */
   bool GetGreenfieldSupported (Mac48Address address) const;
+  /**
+   * Return whether the station supports HT or not.
+   *
+   * \param address the address of the station
+   * \return true if HT is supported by the station,
+   *          false otherwise
+   */
+  bool GetHtSupported (Mac48Address address) const;
   /**
    * Add a given Modulation and Coding Scheme (MCS) index to
    * the set of basic MCS.
@@ -875,13 +884,14 @@ private:
   uint32_t GetNFragments (const WifiMacHeader *header, Ptr<const Packet> packet);
 
   /**
-   * A vector of WifiRemoteStations
+   * A map of WifiRemoteStations, indexed by address and TID, so that
+   * looking a station up does not depend on the number of stations
    */
-  typedef std::vector <WifiRemoteStation *> Stations;
+  typedef std::map <std::pair<Mac48Address, uint8_t>, WifiRemoteStation *> Stations;
   /**
-   * A vector of WifiRemoteStationStates
+   * A map of WifiRemoteStationStates, indexed by address
    */
-  typedef std::vector <WifiRemoteStationState *> StationStates;
+  typedef std::map <Mac48Address, WifiRemoteStationState *> StationStates;
 
   StationStates m_states;  //!< States of known stations
   Stations m_stations;  //!< Information for each known stations
@@ -971,6 +981,7 @@ struct WifiRemoteStationState
   uint32_t m_tx;  //!< Number of TX antennae of the remote station
   bool m_stbc;  //!< Flag if STBC is used by the remote station
   bool m_greenfield;  //!< Flag if green field is used by the remote station
+  bool m_htSupported;  //!< Flag if HT is supported by the remote station
 
 };
 
@@ -0,0 +1,65 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef WIFI_SPECTRUM_PHY_INTERFACE_H
+#define WIFI_SPECTRUM_PHY_INTERFACE_H
+
+#include "ns3/spectrum-phy.h"
+
+namespace ns3 {
+
+class SpectrumWifiPhy;
+
+/**
+ * \ingroup wifi
+ *
+ * The SpectrumPhy through which a SpectrumWifiPhy is attached to a
+ * SpectrumChannel. WifiPhy and SpectrumPhy both define methods such
+ * as SetChannel or GetMobility with different signatures, so that
+ * SpectrumWifiPhy cannot derive from both: this class forwards the
+ * SpectrumPhy methods to the SpectrumWifiPhy instead.
+ */
+class WifiSpectrumPhyInterface : public SpectrumPhy
+{
+public:
+  static TypeId GetTypeId (void);
+
+  WifiSpectrumPhyInterface ();
+  virtual ~WifiSpectrumPhyInterface ();
+
+  /**
+   * \param phy the SpectrumWifiPhy the methods are forwarded to
+   */
+  void SetSpectrumWifiPhy (Ptr<SpectrumWifiPhy> phy);
+
+  // inherited from SpectrumPhy
+  virtual void SetDevice (Ptr<NetDevice> d);
+  virtual Ptr<NetDevice> GetDevice ();
+  virtual void SetMobility (Ptr<MobilityModel> m);
+  virtual Ptr<MobilityModel> GetMobility ();
+  virtual void SetChannel (Ptr<SpectrumChannel> c);
+  virtual Ptr<const SpectrumModel> GetRxSpectrumModel () const;
+  virtual Ptr<AntennaModel> GetRxAntenna ();
+  virtual void StartRx (Ptr<SpectrumSignalParameters> params);
+
+private:
+  virtual void DoDispose (void);
+
+  Ptr<SpectrumWifiPhy> m_spectrumWifiPhy; //!< the SpectrumWifiPhy the methods are forwarded to
+};
+
+} // namespace ns3
+
+#endif /* WIFI_SPECTRUM_PHY_INTERFACE_H */
@@ -0,0 +1,47 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "wifi-spectrum-signal-parameters.h"
+
+NS_LOG_COMPONENT_DEFINE ("WifiSpectrumSignalParameters");
+
+namespace ns3 {
+
+WifiSpectrumSignalParameters::WifiSpectrumSignalParameters ()
+  : preamble (WIFI_PREAMBLE_LONG)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+WifiSpectrumSignalParameters::WifiSpectrumSignalParameters (const WifiSpectrumSignalParameters& p)
+  : SpectrumSignalParameters (p),
+    packet (p.packet),
+    txVector (p.txVector),
+    preamble (p.preamble)
+{
+  NS_LOG_FUNCTION (this << &p);
+}
+
+Ptr<SpectrumSignalParameters>
+WifiSpectrumSignalParameters::Copy ()
+{
+  NS_LOG_FUNCTION (this);
+  return Create<WifiSpectrumSignalParameters> (*this);
+}
+
+} // namespace ns3
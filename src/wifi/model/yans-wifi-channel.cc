@@ -24,11 +24,15 @@
 #include "ns3/node.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
+#include "ns3/double.h"
 #include "ns3/object-factory.h"
 #include "yans-wifi-channel.h"
 #include "yans-wifi-phy.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
+#include <algorithm>
+#include <limits>
+#include <cmath>
 
 NS_LOG_COMPONENT_DEFINE ("YansWifiChannel");
 
@@ -51,16 +55,32 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("MaxRange", "The distance (m) beyond which the PHYs are not delivered the packets, "
+                   "0 for no limit.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("MinRxPower", "The received power (dBm) below which the PHYs are not delivered the packets.",
+                   DoubleValue (-std::numeric_limits<double>::max ()),
+                   MakeDoubleAccessor (&YansWifiChannel::m_minRxPowerDbm),
+                   MakeDoubleChecker<double> ())
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_cellSize (0.0)
 {
 }
 YansWifiChannel::~YansWifiChannel ()
 {
   NS_LOG_FUNCTION_NOARGS ();
+  for (std::vector<IndexEntry>::iterator i = m_index.begin (); i != m_index.end (); i++)
+    {
+      i->mobility->TraceDisconnectWithoutContext ("CourseChange",
+                                                  MakeCallback (&YansWifiChannel::CourseChanged, this));
+    }
+  m_index.clear ();
   m_phyList.clear ();
 }
 
@@ -81,42 +101,83 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
 {
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT (senderMobility != 0);
-  uint32_t j = 0;
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
+
+  // with a maximum range, only visit the PHYs of the cells around the sender,
+  // in the order of the PHY list so that events are scheduled as without it
+  // all the receivers share one read-only copy of the packet, the PHYs
+  // copy it again only if they pass it up
+  Ptr<const Packet> copy;
+  std::vector<uint32_t> receivers;
+  bool indexed = (m_maxRange > 0);
+  if (indexed)
+    {
+      UpdateIndex ();
+      Vector center = senderMobility->GetPosition ();
+      m_grid.Find (Box (center.x - m_cellSize, center.x + m_cellSize,
+                        center.y - m_cellSize, center.y + m_cellSize, 0, 0), receivers);
+      std::sort (receivers.begin (), receivers.end ());
+    }
+
+  // select the receivers first, so that the loss model chain processes
+  // all of them at once
+  std::vector<uint32_t> phys;
+  std::vector<Ptr<MobilityModel> > mobilities;
+  uint32_t nReceivers = indexed ? receivers.size () : m_phyList.size ();
+  for (uint32_t k = 0; k < nReceivers; k++)
+    {
+      uint32_t j = indexed ? receivers[k] : k;
+      Ptr<YansWifiPhy> receiver = m_phyList[j];
+      // For now don't account for inter channel interference
+      if (sender == receiver || receiver->GetChannelNumber () != sender->GetChannelNumber ())
+        {
+          continue;
+        }
+      Ptr<MobilityModel> receiverMobility = receiver->GetMobility ()->GetObject<MobilityModel> ();
+      if (indexed && senderMobility->GetDistanceFrom (receiverMobility) > m_maxRange)
+        {
+          continue;
+        }
+      phys.push_back (j);
+      mobilities.push_back (receiverMobility);
+    }
+  std::vector<double> rxPowersDbm;
+  m_loss->CalcRxPowers (txPowerDbm, senderMobility, mobilities, rxPowersDbm);
+
+  for (uint32_t k = 0; k < phys.size (); k++)
     {
-      if (sender != (*i))
+      uint32_t j = phys[k];
+      Ptr<MobilityModel> receiverMobility = mobilities[k];
+      double rxPowerDbm = rxPowersDbm[k];
+      Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
+      NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
+                    "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
+      if (rxPowerDbm < m_minRxPowerDbm)
+        {
+          NS_LOG_DEBUG ("rxPower below " << m_minRxPowerDbm << "dbm, not delivered");
+          continue;
+        }
+      if (copy == 0)
+        {
+          copy = packet->Copy ();
+        }
+      Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
+      uint32_t dstNode;
+      if (dstNetDevice == 0)
         {
-          // For now don't account for inter channel interference
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
-            {
-              continue;
-            }
-
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
-          NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
-                        "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<Packet> copy = packet->Copy ();
-          Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
-          uint32_t dstNode;
-          if (dstNetDevice == 0)
-            {
-              dstNode = 0xffffffff;
-            }
-          else
-            {
-              dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
-            }
-          Simulator::ScheduleWithContext (dstNode,
-                                          delay, &YansWifiChannel::Receive, this,
-                                          j, copy, rxPowerDbm, txVector, preamble);
+          dstNode = 0xffffffff;
         }
+      else
+        {
+          dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
+        }
+      Simulator::ScheduleWithContext (dstNode,
+                                      delay, &YansWifiChannel::Receive, this,
+                                      j, copy, rxPowerDbm, txVector, preamble);
     }
 }
 
 void
-YansWifiChannel::Receive (uint32_t i, Ptr<Packet> packet, double rxPowerDbm,
+YansWifiChannel::Receive (uint32_t i, Ptr<const Packet> packet, double rxPowerDbm,
                           WifiTxVector txVector, WifiPreamble preamble) const
 {
   m_phyList[i]->StartReceivePacket (packet, rxPowerDbm, txVector, preamble);
@@ -139,6 +200,96 @@ YansWifiChannel::Add (Ptr<YansWifiPhy> phy)
   m_phyList.push_back (phy);
 }
 
+void
+YansWifiChannel::UpdateIndex (void) const
+{
+  // the cells are large enough for a PHY to move by half the
+  // maximum range without leaving the cells around its index cell
+  double cellSize = 1.5 * m_maxRange;
+  if (cellSize != m_cellSize)
+    {
+      NS_LOG_DEBUG ("Building the spatial index with " << cellSize << "m cells");
+      m_cellSize = cellSize;
+      m_grid.SetCellSize (cellSize);
+      m_expirations.clear ();
+      for (uint32_t i = 0; i < m_index.size (); i++)
+        {
+          m_index[i].indexed = false;
+          m_index[i].moving = false;
+          IndexPhy (i);
+        }
+    }
+
+  // the PHYs may have been added before their mobility model was
+  // aggregated, so they are only indexed at the first transmission
+  while (m_index.size () < m_phyList.size ())
+    {
+      uint32_t i = m_index.size ();
+      IndexEntry entry;
+      entry.mobility = m_phyList[i]->GetMobility ()->GetObject<MobilityModel> ();
+      NS_ASSERT (entry.mobility != 0);
+      entry.indexed = false;
+      entry.moving = false;
+      m_index.push_back (entry);
+      m_mobilityPhys.insert (std::make_pair (PeekPointer (entry.mobility), i));
+      if (m_mobilityPhys.count (PeekPointer (entry.mobility)) == 1)
+        {
+          entry.mobility->TraceConnectWithoutContext ("CourseChange",
+                                                      MakeCallback (&YansWifiChannel::CourseChanged, this));
+        }
+      IndexPhy (i);
+    }
+
+  while (!m_expirations.empty () && m_expirations.begin ()->first <= Simulator::Now ())
+    {
+      IndexPhy (m_expirations.begin ()->second);
+    }
+}
+
+void
+YansWifiChannel::IndexPhy (uint32_t i) const
+{
+  IndexEntry &entry = m_index[i];
+  if (entry.indexed)
+    {
+      m_grid.Erase (entry.cell, i);
+    }
+  if (entry.moving)
+    {
+      m_expirations.erase (entry.expiration);
+      entry.moving = false;
+    }
+
+  entry.cell = m_grid.GetCell (entry.mobility->GetPosition ());
+  m_grid.Insert (entry.cell, i);
+  entry.indexed = true;
+
+  Vector velocity = entry.mobility->GetVelocity ();
+  double speed = std::sqrt (velocity.x * velocity.x + velocity.y * velocity.y);
+  if (speed > 0)
+    {
+      // bounded, to stay far from the Time range
+      Time expiration = Simulator::Now () + Seconds (std::min (0.5 * m_maxRange / speed, 1e6));
+      entry.expiration = m_expirations.insert (std::make_pair (expiration, i));
+      entry.moving = true;
+    }
+}
+
+void
+YansWifiChannel::CourseChanged (Ptr<const MobilityModel> mobility) const
+{
+  if (m_cellSize == 0)
+    {
+      return;
+    }
+  typedef std::multimap<const MobilityModel *, uint32_t>::const_iterator Iterator;
+  std::pair<Iterator, Iterator> phys = m_mobilityPhys.equal_range (PeekPointer (mobility));
+  for (Iterator i = phys.first; i != phys.second; i++)
+    {
+      IndexPhy (i->second);
+    }
+}
+
 int64_t
 YansWifiChannel::AssignStreams (int64_t stream)
 {
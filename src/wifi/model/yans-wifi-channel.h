@@ -21,8 +21,12 @@
 #define YANS_WIFI_CHANNEL_H
 
 #include <vector>
+#include <map>
 #include <stdint.h>
 #include "ns3/packet.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/spatial-grid.h"
 #include "wifi-channel.h"
 #include "wifi-mode.h"
 #include "wifi-preamble.h"
@@ -31,6 +35,7 @@
 namespace ns3 {
 
 class NetDevice;
+class MobilityModel;
 class PropagationLossModel;
 class PropagationDelayModel;
 class YansWifiPhy;
@@ -46,6 +51,16 @@ class YansWifiPhy;
  * class and contains a ns3::PropagationLossModel and a ns3::PropagationDelayModel.
  * By default, no propagation models are set so, it is the caller's responsability
  * to set them before using the channel.
+ *
+ * By default, every transmission is delivered to every other PHY of the
+ * channel, however weak.  In large scenarios, the MaxRange attribute
+ * makes the channel keep the PHYs in a grid indexed by position, and
+ * skip the PHYs further than MaxRange from the sender without computing
+ * anything for them.  The MinRxPower attribute drops the deliveries
+ * whose received power would be below it.  Both change the results when
+ * the skipped signals would have mattered, as interference for instance,
+ * so they should be set well below the energy detection threshold of
+ * the PHYs.
  */
 class YansWifiChannel : public WifiChannel
 {
@@ -114,18 +129,64 @@ private:
    * bit of the packet has arrived.
    *
    * \param i index of the corresponding YansWifiPhy in the PHY list
-   * \param packet the packet being sent
+   * \param packet the packet being sent, shared by all the receivers
    * \param rxPowerDbm the received power of the packet
    * \param txVector the TXVECTOR of the packet
    * \param preamble the type of preamble being used to send the packet
    */
-  void Receive (uint32_t i, Ptr<Packet> packet, double rxPowerDbm,
+  void Receive (uint32_t i, Ptr<const Packet> packet, double rxPowerDbm,
                 WifiTxVector txVector, WifiPreamble preamble) const;
 
+  /**
+   * The PHY indexes, by time at which they must be moved to their new cell
+   */
+  typedef std::multimap<Time, uint32_t> Expirations;
+
+  /**
+   * The state of a PHY in the spatial index
+   */
+  struct IndexEntry
+  {
+    Ptr<MobilityModel> mobility; //!< mobility model of the PHY
+    SpatialGrid::Cell cell; //!< cell the PHY is in
+    bool indexed; //!< true if cell is valid
+    bool moving; //!< true if expiration is valid
+    Expirations::iterator expiration; //!< when the PHY may have left the cell
+  };
+
+  /**
+   * Add the new PHYs to the spatial index and move the PHYs which may
+   * have drifted too far from the position they were indexed at.
+   */
+  void UpdateIndex (void) const;
+  /**
+   * (Re-)insert a PHY in the spatial index at its current position.
+   *
+   * \param i index of the PHY in the PHY list
+   */
+  void IndexPhy (uint32_t i) const;
+  /**
+   * Called when a PHY changes its velocity, to re-index it.
+   *
+   * \param mobility the mobility model of the PHY
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility) const;
 
   PhyList m_phyList; //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss; //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay; //!< Propagation delay model
+  double m_maxRange; //!< Distance beyond which PHYs are not delivered packets, 0 for no limit
+  double m_minRxPowerDbm; //!< Received power below which packets are not delivered
+
+  // The spatial index, only used if m_maxRange is not 0. A PHY is
+  // indexed in the cell of its position at the time it was indexed;
+  // a moving PHY is re-indexed before it may have gone further than
+  // half the maximum range from this position.
+  mutable std::vector<IndexEntry> m_index; //!< Index state of each PHY
+  mutable SpatialGrid m_grid; //!< The PHYs in each cell
+  mutable Expirations m_expirations; //!< When moving PHYs must be re-indexed
+  mutable std::multimap<const MobilityModel *, uint32_t> m_mobilityPhys; //!< PHYs of each mobility model
+  mutable double m_cellSize; //!< Size of the cells m_grid was built with
 };
 
 } // namespace ns3
@@ -25,6 +25,8 @@
 #include "wifi-preamble.h"
 #include "wifi-phy-state-helper.h"
 #include "error-rate-model.h"
+#include "ampdu-tag.h"
+#include "mpdu-aggregator.h"
 #include "ns3/simulator.h"
 #include "ns3/packet.h"
 #include "ns3/assert.h"
@@ -107,6 +109,14 @@ YansWifiPhy::GetTypeId (void)
                    MakeDoubleAccessor (&YansWifiPhy::SetRxNoiseFigure,
                                        &YansWifiPhy::GetRxNoiseFigure),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("Abstraction",
+                   "If true, the PER of a frame is computed from its effective SINR, given by the "
+                   "interference power averaged over the frame, instead of chunk by chunk. "
+                   "Best used with a table based error rate model, such as ns3::TableErrorRateModel.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiPhy::SetAbstraction,
+                                        &YansWifiPhy::GetAbstraction),
+                   MakeBooleanChecker ())
     .AddAttribute ("State", "The state of the PHY layer",
                    PointerValue (),
                    MakePointerAccessor (&YansWifiPhy::m_state),
@@ -304,6 +314,17 @@ YansWifiPhy::GetRxNoiseFigure (void) const
 {
   return RatioToDb (m_interference.GetNoiseFigure ());
 }
+void
+YansWifiPhy::SetAbstraction (bool enable)
+{
+  NS_LOG_FUNCTION (this << enable);
+  m_interference.SetAbstraction (enable);
+}
+bool
+YansWifiPhy::GetAbstraction (void) const
+{
+  return m_interference.GetAbstraction ();
+}
 double
 YansWifiPhy::GetTxPowerStart (void) const
 {
@@ -359,7 +380,7 @@ YansWifiPhy::CalculateSnr (WifiMode txMode, double ber) const
   return m_interference.GetErrorRateModel ()->CalculateSnr (txMode, ber);
 }
 
-Ptr<WifiChannel>
+Ptr<Channel>
 YansWifiPhy::GetChannel (void) const
 {
   return m_channel;
@@ -443,7 +464,7 @@ YansWifiPhy::SetReceiveErrorCallback (RxErrorCallback callback)
   m_state->SetReceiveErrorCallback (callback);
 }
 void
-YansWifiPhy::StartReceivePacket (Ptr<Packet> packet,
+YansWifiPhy::StartReceivePacket (Ptr<const Packet> packet,
                                  double rxPowerDbm,
                                  WifiTxVector txVector,
                                  enum WifiPreamble preamble)
@@ -567,7 +588,37 @@ YansWifiPhy::SendPacket (Ptr<const Packet> packet, WifiMode txMode, WifiPreamble
   bool isShortPreamble = (WIFI_PREAMBLE_SHORT == preamble);
   NotifyMonitorSniffTx (packet, (uint16_t)GetChannelFrequencyMhz (), GetChannelNumber (), dataRate500KbpsUnits, isShortPreamble, txVector.GetTxPowerLevel());
   m_state->SwitchToTx (txDuration, packet, txVector.GetMode(), preamble,  txVector.GetTxPowerLevel());
-  m_channel->Send (this, packet, GetPowerDbm ( txVector.GetTxPowerLevel()) + m_txGainDb, txVector, preamble);
+  StartTx (packet, GetPowerDbm ( txVector.GetTxPowerLevel()) + m_txGainDb, txVector, preamble, txDuration);
+}
+
+void
+YansWifiPhy::StartTx (Ptr<const Packet> packet, double txPowerDbm,
+                      WifiTxVector txVector, WifiPreamble preamble,
+                      Time txDuration)
+{
+  NS_LOG_FUNCTION (this << packet << txPowerDbm << preamble << txDuration);
+  m_channel->Send (this, packet, txPowerDbm, txVector, preamble);
+}
+
+void
+YansWifiPhy::StartReceiveInterference (double rxPowerDbm, Time duration)
+{
+  NS_LOG_FUNCTION (this << rxPowerDbm << duration);
+  rxPowerDbm += m_rxGainDb;
+  m_interference.Add (0, WifiMode (), WIFI_PREAMBLE_LONG, duration,
+                      DbmToW (rxPowerDbm), WifiTxVector ());
+  if (!m_state->IsStateIdle () && !m_state->IsStateCcaBusy ()
+      && duration <= m_state->GetDelayUntilIdle ())
+    {
+      // the signal ends before the current reception, transmission
+      // or channel switching
+      return;
+    }
+  Time delayUntilCcaEnd = m_interference.GetEnergyDuration (m_ccaMode1ThresholdW);
+  if (!delayUntilCcaEnd.IsZero ())
+    {
+      m_state->SwitchMaybeToCcaBusy (delayUntilCcaEnd);
+    }
 }
 
 uint32_t
@@ -785,19 +836,50 @@ YansWifiPhy::GetPowerDbm (uint8_t power) const
 }
 
 void
-YansWifiPhy::EndReceive (Ptr<Packet> packet, Ptr<InterferenceHelper::Event> event)
+YansWifiPhy::EndReceive (Ptr<const Packet> packet, Ptr<InterferenceHelper::Event> event)
 {
   NS_LOG_FUNCTION (this << packet << event);
   NS_ASSERT (IsStateRx ());
   NS_ASSERT (event->GetEndTime () == Simulator::Now ());
 
   struct InterferenceHelper::SnrPer snrPer;
-  snrPer = m_interference.CalculateSnrPer (event);
+  AmpduTag ampduTag;
+  bool isAmpdu = packet->PeekPacketTag (ampduTag);
+  std::vector<double> subframePers;
+  if (isAmpdu)
+    {
+      // snrPer.per is then the error rate of the PLCP header only
+      snrPer = m_interference.CalculateAmpduSnrPer (event, MpduAggregator::GetSubframeSizes (packet),
+                                                    subframePers);
+    }
+  else
+    {
+      snrPer = m_interference.CalculateSnrPer (event);
+    }
   m_interference.NotifyRxEnd ();
 
   NS_LOG_DEBUG ("mode=" << (event->GetPayloadMode ().GetDataRate ()) <<
                 ", snr=" << snrPer.snr << ", per=" << snrPer.per << ", size=" << packet->GetSize ());
-  if (m_random->GetValue () > snrPer.per)
+  bool rxOk = m_random->GetValue () > snrPer.per;
+  if (rxOk && isAmpdu)
+    {
+      // the A-MPDU is received if at least one of its subframes is
+      bool subframeOk = false;
+      for (uint32_t i = 0; i < subframePers.size (); i++)
+        {
+          if (m_random->GetValue () > subframePers[i])
+            {
+              subframeOk = true;
+            }
+          else
+            {
+              NS_LOG_DEBUG ("A-MPDU subframe " << i << " corrupted, per=" << subframePers[i]);
+              ampduTag.SetCorrupted (i);
+            }
+        }
+      rxOk = subframeOk;
+    }
+  if (rxOk)
     {
       NotifyRxEnd (packet);
       uint32_t dataRate500KbpsUnits = event->GetPayloadMode ().GetDataRate () * event->GetTxVector().GetNss()/ 500000;
@@ -805,7 +887,13 @@ YansWifiPhy::EndReceive (Ptr<Packet> packet, Ptr<InterferenceHelper::Event> even
       double signalDbm = RatioToDb (event->GetRxPowerW ()) + 30;
       double noiseDbm = RatioToDb (event->GetRxPowerW () / snrPer.snr) - GetRxNoiseFigure () + 30;
       NotifyMonitorSniffRx (packet, (uint16_t)GetChannelFrequencyMhz (), GetChannelNumber (), dataRate500KbpsUnits, isShortPreamble, signalDbm, noiseDbm);
-      m_state->SwitchFromRxEndOk (packet, snrPer.snr, event->GetPayloadMode (), event->GetPreambleType ());
+      // the packet is shared with the other receivers until here
+      Ptr<Packet> copy = packet->Copy ();
+      if (isAmpdu)
+        {
+          copy->ReplacePacketTag (ampduTag);
+        }
+      m_state->SwitchFromRxEndOk (copy, snrPer.snr, event->GetPayloadMode (), event->GetPreambleType ());
     }
   else
     {
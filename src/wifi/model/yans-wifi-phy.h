@@ -98,12 +98,12 @@ public:
   /**
    * Starting receiving the packet (i.e. the first bit of the preamble has arrived).
    *
-   * \param packet the arriving packet
+   * \param packet the arriving packet, which may be shared with other PHYs
    * \param rxPowerDbm the receive power in dBm
    * \param txVector the TXVECTOR of the arriving packet
    * \param preamble the preamble of the arriving packet
    */
-  void StartReceivePacket (Ptr<Packet> packet,
+  void StartReceivePacket (Ptr<const Packet> packet,
                            double rxPowerDbm,
                            WifiTxVector txVector,
                            WifiPreamble preamble);
@@ -114,6 +114,14 @@ public:
    * \param noiseFigureDb noise figure in dB
    */
   void SetRxNoiseFigure (double noiseFigureDb);
+  /**
+   * Enable or disable the abstraction mode of the reception, see
+   * InterferenceHelper::SetAbstraction.
+   *
+   * \param enable true to compute the PER from the effective SINR of
+   *        whole frames
+   */
+  void SetAbstraction (bool enable);
   /**
    * Sets the minimum available transmission power level (dBm).
    *
@@ -186,6 +194,10 @@ public:
    * \return the RX noise figure in dBm
    */
   double GetRxNoiseFigure (void) const;
+  /**
+   * \return true if the abstraction mode of the reception is enabled
+   */
+  bool GetAbstraction (void) const;
   /**
    * Return the transmission gain (dB).
    *
@@ -261,7 +273,7 @@ public:
   virtual uint32_t GetNModes (void) const;
   virtual WifiMode GetMode (uint32_t mode) const;
   virtual double CalculateSnr (WifiMode txMode, double ber) const;
-  virtual Ptr<WifiChannel> GetChannel (void) const;
+  virtual Ptr<Channel> GetChannel (void) const;
   
   virtual void ConfigureStandard (enum WifiPhyStandard standard);
 
@@ -368,9 +380,33 @@ public:
   virtual uint32_t WifiModeToMcs (WifiMode mode);
   virtual WifiMode McsToWifiMode (uint8_t mcs);
 
+protected:
+  virtual void DoDispose (void);
+  /**
+   * Hand a packet over to the channel, once the PHY is in TX state.
+   * Subclasses attached to other kinds of channels override this
+   * method.
+   *
+   * \param packet the packet to send
+   * \param txPowerDbm the transmission power, including the TX gain (dBm)
+   * \param txVector the TXVECTOR of the packet
+   * \param preamble the type of preamble to use to send this packet
+   * \param txDuration the duration of the transmission
+   */
+  virtual void StartTx (Ptr<const Packet> packet, double txPowerDbm,
+                        WifiTxVector txVector, WifiPreamble preamble,
+                        Time txDuration);
+  /**
+   * Start receiving a signal which cannot be decoded by this PHY. The
+   * signal only adds to the interference, and may make CCA busy.
+   *
+   * \param rxPowerDbm the received power of the signal (dBm)
+   * \param duration the duration of the signal
+   */
+  void StartReceiveInterference (double rxPowerDbm, Time duration);
+
 private:
   //YansWifiPhy (const YansWifiPhy &o);
-  virtual void DoDispose (void);
   /**
    * Configure YansWifiPhy with appropriate channel frequency and
    * supported rates for 802.11a standard.
@@ -450,7 +486,7 @@ private:
    * \param packet the packet that the last bit has arrived
    * \param event the corresponding event of the first time the packet arrives
    */
-  void EndReceive (Ptr<Packet> packet, Ptr<InterferenceHelper::Event> event);
+  void EndReceive (Ptr<const Packet> packet, Ptr<InterferenceHelper::Event> event);
 
 private:
   double   m_edThresholdW;        //!< Energy detection threshold in watts
@@ -24,23 +24,53 @@
 #include "ns3/yans-wifi-channel.h"
 #include "ns3/adhoc-wifi-mac.h"
 #include "ns3/yans-wifi-phy.h"
+#include "ns3/spectrum-wifi-phy.h"
+#include "ns3/multi-model-spectrum-channel.h"
+#include "ns3/waveform-generator.h"
+#include "ns3/interference-helper.h"
 #include "ns3/arf-wifi-manager.h"
+#include "ns3/constant-rate-wifi-manager.h"
+#include "ns3/minstrel-wifi-manager.h"
 #include "ns3/propagation-delay-model.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/error-rate-model.h"
 #include "ns3/yans-error-rate-model.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/table-error-rate-model.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
 #include "ns3/node.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
 #include "ns3/object-factory.h"
 #include "ns3/dca-txop.h"
+#include "ns3/wifi-mac-queue.h"
 #include "ns3/mac-rx-middle.h"
 #include "ns3/pointer.h"
 #include "ns3/rng-seed-manager.h"
 #include "ns3/edca-txop-n.h"
 #include "ns3/config.h"
 #include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/ampdu-tag.h"
+#include "ns3/mpdu-standard-aggregator.h"
+#include "ns3/mac-low.h"
+#include "ns3/ctrl-headers.h"
+#include "ns3/wifi-mac-trailer.h"
+#include "ns3/llc-snap-header.h"
+#include "ns3/wifi-helper.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/ht-wifi-mac-helper.h"
+#include "ns3/spectrum-wifi-helper.h"
+#include "ns3/spectrum-helper.h"
+#include "ns3/nqos-wifi-mac-helper.h"
+#include "ns3/mobility-helper.h"
+
+#include <limits>
+#include <cmath>
+#include <fstream>
 
 using namespace ns3;
 
@@ -478,6 +508,1176 @@ Bug555TestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_secondTransmissionTime, expectedSecondTransmissionTime, "The second transmission time not correct!");
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the YansWifiChannel MaxRange and MinRxPower attributes
+ * skip the far away receivers only, including receivers which move
+ * into range without changing course.
+ */
+class YansWifiChannelRangeTest : public TestCase
+{
+public:
+  YansWifiChannelRangeTest ();
+
+  virtual void DoRun (void);
+private:
+  void RunOne (double maxRange, double minRxPower);
+  Ptr<WifiNetDevice> CreateOne (Ptr<MobilityModel> mobility, Ptr<YansWifiChannel> channel, uint32_t *rxCount);
+  void SendOnePacket (Ptr<WifiNetDevice> dev);
+  static void CountRx (uint32_t *rxCount, Ptr<const Packet> packet);
+
+  uint32_t m_rxCount[4];
+};
+
+YansWifiChannelRangeTest::YansWifiChannelRangeTest ()
+  : TestCase ("YansWifiChannel maximum range and minimum rx power")
+{
+}
+
+void
+YansWifiChannelRangeTest::SendOnePacket (Ptr<WifiNetDevice> dev)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  dev->Send (p, dev->GetBroadcast (), 1);
+}
+
+void
+YansWifiChannelRangeTest::CountRx (uint32_t *rxCount, Ptr<const Packet> packet)
+{
+  (*rxCount)++;
+}
+
+Ptr<WifiNetDevice>
+YansWifiChannelRangeTest::CreateOne (Ptr<MobilityModel> mobility, Ptr<YansWifiChannel> channel, uint32_t *rxCount)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+
+  Ptr<WifiMac> mac = CreateObject<AdhocWifiMac> ();
+  mac->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  Ptr<ErrorRateModel> error = CreateObject<YansErrorRateModel> ();
+  phy->SetErrorRateModel (error);
+  phy->SetChannel (channel);
+  phy->SetDevice (dev);
+  phy->SetMobility (node);
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  // count every delivery, however weak
+  phy->SetAttribute ("EnergyDetectionThreshold", DoubleValue (-150.0));
+  phy->TraceConnectWithoutContext ("PhyRxBegin", MakeBoundCallback (&YansWifiChannelRangeTest::CountRx, rxCount));
+  Ptr<WifiRemoteStationManager> manager = CreateObject<ConstantRateWifiManager> ();
+
+  node->AggregateObject (mobility);
+  mac->SetAddress (Mac48Address::Allocate ());
+  dev->SetMac (mac);
+  dev->SetPhy (phy);
+  dev->SetRemoteStationManager (manager);
+  node->AddDevice (dev);
+
+  return dev;
+}
+
+void
+YansWifiChannelRangeTest::RunOne (double maxRange, double minRxPower)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  channel->SetAttribute ("MaxRange", DoubleValue (maxRange));
+  channel->SetAttribute ("MinRxPower", DoubleValue (minRxPower));
+
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      m_rxCount[i] = 0;
+    }
+
+  // a sender, a receiver at 50m, a receiver at 1000m, and a
+  // receiver coming from 390m at 10m/s, at 50m at 35s
+  Ptr<ConstantPositionMobilityModel> senderMobility = CreateObject<ConstantPositionMobilityModel> ();
+  senderMobility->SetPosition (Vector (0.0, 0.0, 0.0));
+  Ptr<WifiNetDevice> sender = CreateOne (senderMobility, channel, &m_rxCount[0]);
+  Ptr<ConstantPositionMobilityModel> nearMobility = CreateObject<ConstantPositionMobilityModel> ();
+  nearMobility->SetPosition (Vector (50.0, 0.0, 0.0));
+  CreateOne (nearMobility, channel, &m_rxCount[1]);
+  Ptr<ConstantPositionMobilityModel> farMobility = CreateObject<ConstantPositionMobilityModel> ();
+  farMobility->SetPosition (Vector (1000.0, 0.0, 0.0));
+  CreateOne (farMobility, channel, &m_rxCount[2]);
+  Ptr<ConstantVelocityMobilityModel> movingMobility = CreateObject<ConstantVelocityMobilityModel> ();
+  movingMobility->SetPosition (Vector (400.0, 0.0, 0.0));
+  movingMobility->SetVelocity (Vector (-10.0, 0.0, 0.0));
+  CreateOne (movingMobility, channel, &m_rxCount[3]);
+
+  Simulator::Schedule (Seconds (1.0), &YansWifiChannelRangeTest::SendOnePacket, this, sender);
+  Simulator::Schedule (Seconds (35.0), &YansWifiChannelRangeTest::SendOnePacket, this, sender);
+
+  Simulator::Stop (Seconds (40.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+YansWifiChannelRangeTest::DoRun (void)
+{
+  // everything is delivered by default
+  RunOne (0.0, -std::numeric_limits<double>::max ());
+  NS_TEST_EXPECT_MSG_EQ (m_rxCount[1], 2, "Near receiver");
+  NS_TEST_EXPECT_MSG_EQ (m_rxCount[2], 2, "Far receiver");
+  NS_TEST_EXPECT_MSG_EQ (m_rxCount[3], 2, "Moving receiver");
+
+  RunOne (100.0, -std::numeric_limits<double>::max ());
+  NS_TEST_EXPECT_MSG_EQ (m_rxCount[1], 2, "Near receiver out of range");
+  NS_TEST_EXPECT_MSG_EQ (m_rxCount[2], 0, "Far receiver in range");
+  NS_TEST_EXPECT_MSG_EQ (m_rxCount[3], 1, "Moving receiver not followed by the spatial index");
+
+  // about -82dBm at 50m, -108dBm at 390m and -121dBm at 1000m
+  RunOne (0.0, -90.0);
+  NS_TEST_EXPECT_MSG_EQ (m_rxCount[1], 2, "Near receiver below the minimum rx power");
+  NS_TEST_EXPECT_MSG_EQ (m_rxCount[2], 0, "Far receiver above the minimum rx power");
+  NS_TEST_EXPECT_MSG_EQ (m_rxCount[3], 1, "Moving receiver");
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Check the energy durations reported by InterferenceHelper while signals
+ * start and end, during a reception and after it.
+ */
+class InterferenceHelperEnergyDurationTest : public TestCase
+{
+public:
+  InterferenceHelperEnergyDurationTest ();
+
+  virtual void DoRun (void);
+private:
+  void Add (double powerW, Time duration);
+  void RxStart (void);
+  void RxEnd (void);
+  void CheckDuration (double energyW, Time expected);
+
+  InterferenceHelper m_interference;
+};
+
+InterferenceHelperEnergyDurationTest::InterferenceHelperEnergyDurationTest ()
+  : TestCase ("InterferenceHelper energy duration")
+{
+}
+
+void
+InterferenceHelperEnergyDurationTest::Add (double powerW, Time duration)
+{
+  m_interference.Add (1000, WifiPhy::GetOfdmRate6Mbps (), WIFI_PREAMBLE_LONG,
+                      duration, powerW, WifiTxVector ());
+}
+
+void
+InterferenceHelperEnergyDurationTest::RxStart (void)
+{
+  m_interference.NotifyRxStart ();
+}
+
+void
+InterferenceHelperEnergyDurationTest::RxEnd (void)
+{
+  m_interference.NotifyRxEnd ();
+}
+
+void
+InterferenceHelperEnergyDurationTest::CheckDuration (double energyW, Time expected)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_interference.GetEnergyDuration (energyW), expected,
+                         "Energy above " << energyW << "W at " << Simulator::Now ().GetSeconds ());
+}
+
+void
+InterferenceHelperEnergyDurationTest::DoRun (void)
+{
+  Time start = Seconds (1.0);
+  // a 1nW signal is received from 0 to 100us, a 2nW one overlaps it
+  // from 20us to 120us
+  Simulator::Schedule (start, &InterferenceHelperEnergyDurationTest::Add, this,
+                       1e-9, MicroSeconds (100));
+  Simulator::Schedule (start, &InterferenceHelperEnergyDurationTest::RxStart, this);
+  Simulator::Schedule (start, &InterferenceHelperEnergyDurationTest::CheckDuration, this,
+                       0.5e-9, MicroSeconds (100));
+  Simulator::Schedule (start + MicroSeconds (20), &InterferenceHelperEnergyDurationTest::Add, this,
+                       2e-9, MicroSeconds (100));
+  Simulator::Schedule (start + MicroSeconds (50), &InterferenceHelperEnergyDurationTest::CheckDuration, this,
+                       2.5e-9, MicroSeconds (50));
+  Simulator::Schedule (start + MicroSeconds (50), &InterferenceHelperEnergyDurationTest::CheckDuration, this,
+                       1.5e-9, MicroSeconds (70));
+  Simulator::Schedule (start + MicroSeconds (100), &InterferenceHelperEnergyDurationTest::RxEnd, this);
+  Simulator::Schedule (start + MicroSeconds (100), &InterferenceHelperEnergyDurationTest::CheckDuration, this,
+                       1.5e-9, MicroSeconds (20));
+  // a new 1nW signal from 110us to 210us, once the changes of the
+  // reception have been pruned
+  Simulator::Schedule (start + MicroSeconds (110), &InterferenceHelperEnergyDurationTest::Add, this,
+                       1e-9, MicroSeconds (100));
+  Simulator::Schedule (start + MicroSeconds (110), &InterferenceHelperEnergyDurationTest::CheckDuration, this,
+                       2.5e-9, MicroSeconds (10));
+  Simulator::Schedule (start + MicroSeconds (110), &InterferenceHelperEnergyDurationTest::CheckDuration, this,
+                       0.5e-9, MicroSeconds (100));
+  Simulator::Schedule (Seconds (2.0), &InterferenceHelperEnergyDurationTest::CheckDuration, this,
+                       0.5e-9, MicroSeconds (0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_interference.EraseEvents ();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Compare the success rates of TableErrorRateModel with the ones of the
+ * models it tabulates, and check that tables are loaded from and saved
+ * to the TableFile.
+ */
+class TableErrorRateModelTest : public TestCase
+{
+public:
+  TableErrorRateModelTest ();
+
+  virtual void DoRun (void);
+private:
+  void CheckAccuracy (Ptr<ErrorRateModel> model);
+};
+
+TableErrorRateModelTest::TableErrorRateModelTest ()
+  : TestCase ("TableErrorRateModel")
+{
+}
+
+void
+TableErrorRateModelTest::CheckAccuracy (Ptr<ErrorRateModel> model)
+{
+  Ptr<TableErrorRateModel> table = CreateObject<TableErrorRateModel> ();
+  table->SetAttribute ("ErrorRateModel", PointerValue (model));
+  WifiMode modes[] = { WifiPhy::GetOfdmRate6Mbps (), WifiPhy::GetOfdmRate12Mbps (),
+                       WifiPhy::GetOfdmRate24Mbps (), WifiPhy::GetOfdmRate54Mbps (),
+                       WifiPhy::GetDsssRate11Mbps () };
+  uint32_t nbits[] = { 1, 100, 12000 };
+  for (uint32_t i = 0; i < sizeof (modes) / sizeof (modes[0]); i++)
+    {
+      for (uint32_t j = 0; j < sizeof (nbits) / sizeof (nbits[0]); j++)
+        {
+          double tolerance = nbits[j] < 100 ? 1e-2 : 1e-4;
+          // off the grid, and beyond both of its ends
+          for (double snrDb = -12.0; snrDb < 52.0; snrDb += 0.0137)
+            {
+              double snr = std::pow (10.0, snrDb / 10.0);
+              NS_TEST_EXPECT_MSG_EQ_TOL (table->GetChunkSuccessRate (modes[i], snr, nbits[j]),
+                                         model->GetChunkSuccessRate (modes[i], snr, nbits[j]),
+                                         tolerance,
+                                         model->GetInstanceTypeId ().GetName () << " " << modes[i]
+                                         << " " << nbits[j] << " bits at " << snrDb << "dB");
+            }
+        }
+    }
+}
+
+void
+TableErrorRateModelTest::DoRun (void)
+{
+  CheckAccuracy (CreateObject<NistErrorRateModel> ());
+  CheckAccuracy (CreateObject<YansErrorRateModel> ());
+
+  // a table with two entries, at 0dB and 1dB
+  std::string fileName = CreateTempDirFilename ("wifi-error-rate-tables.txt");
+  WifiMode mode = WifiPhy::GetOfdmRate6Mbps ();
+  {
+    std::ofstream file (fileName.c_str ());
+    file.precision (17);
+    file << "ns3::NistErrorRateModel " << mode.GetUniqueName () << " 0 1 1 2 "
+         << std::log (0.5) << " " << std::log (0.9) << std::endl;
+  }
+  Ptr<TableErrorRateModel> table = CreateObject<TableErrorRateModel> ();
+  table->SetAttribute ("MinSnr", DoubleValue (0.0));
+  table->SetAttribute ("MaxSnr", DoubleValue (1.0));
+  table->SetAttribute ("Resolution", DoubleValue (1.0));
+  table->SetAttribute ("TableFile", StringValue (fileName));
+  NS_TEST_EXPECT_MSG_EQ_TOL (table->GetChunkSuccessRate (mode, std::pow (10.0, 0.05), 1), std::sqrt (0.5 * 0.9), 1e-12,
+                             "Table not loaded from the file");
+  NS_TEST_EXPECT_MSG_EQ_TOL (table->GetChunkSuccessRate (mode, std::pow (10.0, 0.05), 10),
+                             std::exp (10.0 * (std::log (0.5) + std::log (0.9)) / 2.0), 1e-12,
+                             "Table not loaded from the file");
+
+  // a new table is computed and saved along with the loaded one
+  WifiMode other = WifiPhy::GetOfdmRate9Mbps ();
+  table->GetChunkSuccessRate (other, 1.1, 1);
+  std::ifstream file (fileName.c_str ());
+  std::string line;
+  bool loaded = false;
+  bool computed = false;
+  while (std::getline (file, line))
+    {
+      loaded = loaded || line.find ("ns3::NistErrorRateModel " + mode.GetUniqueName () + " 0 1 1 2 ") == 0;
+      computed = computed || line.find ("ns3::NistErrorRateModel " + other.GetUniqueName () + " 0 1 1 2 ") == 0;
+    }
+  NS_TEST_EXPECT_MSG_EQ (loaded, true, "Loaded table not saved");
+  NS_TEST_EXPECT_MSG_EQ (computed, true, "Computed table not saved");
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Check the effective SINR and the PER computed by InterferenceHelper
+ * in abstraction mode against the chunk by chunk computation.
+ */
+class InterferenceHelperAbstractionTest : public TestCase
+{
+public:
+  InterferenceHelperAbstractionTest ();
+
+  virtual void DoRun (void);
+private:
+  /**
+   * Receive a 1nW frame during 1ms, with an interferer starting during
+   * the frame and lasting longer than it.
+   *
+   * \param abstraction true to enable the abstraction mode
+   * \param interfererStart start of the interferer, relative to the frame
+   * \param interfererW power of the interferer
+   */
+  void Receive (bool abstraction, Time interfererStart, double interfererW);
+  void StartFrame (void);
+  void AddInterferer (double powerW);
+  void EndFrame (void);
+
+  InterferenceHelper m_interference;
+  Ptr<InterferenceHelper::Event> m_event;
+  InterferenceHelper::SnrPer m_snrPer;
+  Time m_energyDuration;
+};
+
+InterferenceHelperAbstractionTest::InterferenceHelperAbstractionTest ()
+  : TestCase ("InterferenceHelper abstraction mode")
+{
+}
+
+void
+InterferenceHelperAbstractionTest::StartFrame (void)
+{
+  m_event = m_interference.Add (1000, WifiPhy::GetOfdmRate6Mbps (), WIFI_PREAMBLE_LONG,
+                                MilliSeconds (1), 1e-9, WifiTxVector ());
+  m_interference.NotifyRxStart ();
+}
+
+void
+InterferenceHelperAbstractionTest::AddInterferer (double powerW)
+{
+  m_interference.Add (1000, WifiPhy::GetOfdmRate6Mbps (), WIFI_PREAMBLE_LONG,
+                      MilliSeconds (2), powerW, WifiTxVector ());
+}
+
+void
+InterferenceHelperAbstractionTest::EndFrame (void)
+{
+  m_snrPer = m_interference.CalculateSnrPer (m_event);
+  m_interference.NotifyRxEnd ();
+  m_energyDuration = m_interference.GetEnergyDuration (1e-12);
+}
+
+void
+InterferenceHelperAbstractionTest::Receive (bool abstraction, Time interfererStart, double interfererW)
+{
+  m_interference.SetAbstraction (abstraction);
+  m_interference.SetNoiseFigure (1.0);
+  m_interference.SetErrorRateModel (CreateObject<NistErrorRateModel> ());
+  Simulator::Schedule (Seconds (1.0), &InterferenceHelperAbstractionTest::StartFrame, this);
+  if (interfererW > 0)
+    {
+      Simulator::Schedule (Seconds (1.0) + interfererStart,
+                           &InterferenceHelperAbstractionTest::AddInterferer, this, interfererW);
+    }
+  Simulator::Schedule (Seconds (1.0) + MilliSeconds (1), &InterferenceHelperAbstractionTest::EndFrame, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_interference.EraseEvents ();
+  m_event = 0;
+}
+
+void
+InterferenceHelperAbstractionTest::DoRun (void)
+{
+  // thermal noise over 20MHz at 290K
+  double noiseW = 1.3803e-23 * 290.0 * 20e6;
+
+  Receive (false, Seconds (0), 0);
+  InterferenceHelper::SnrPer exact = m_snrPer;
+  Receive (true, Seconds (0), 0);
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_snrPer.snr, exact.snr, exact.snr * 1e-12, "Without interference");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_snrPer.per, exact.per, 1e-12, "Without interference");
+  NS_TEST_EXPECT_MSG_EQ (m_energyDuration, Seconds (0), "Energy left on the medium");
+
+  // a constant interference over the whole frame is its own average
+  Receive (false, Seconds (0), 0.3e-9);
+  exact = m_snrPer;
+  Receive (true, Seconds (0), 0.3e-9);
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_snrPer.snr, 1e-9 / (noiseW + 0.3e-9), 1e-6, "Constant interference");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_snrPer.per, exact.per, 1e-9, "Constant interference");
+  NS_TEST_EXPECT_MSG_EQ (m_energyDuration, MilliSeconds (1), "Interferer not followed");
+
+  // an interferer over the second half of the frame counts for half its power
+  Receive (true, MicroSeconds (500), 0.6e-9);
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_snrPer.snr, 1e-9 / (noiseW + 0.3e-9), 1e-6, "Interference averaged over the frame");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_snrPer.per, exact.per, 1e-9, "Interference averaged over the frame");
+  NS_TEST_EXPECT_MSG_EQ (m_energyDuration, MicroSeconds (1500), "Interferer not followed");
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Send a frame between two SpectrumWifiPhy on a MultiModelSpectrumChannel,
+ * with a receiver on another channel, and a non-Wi-Fi interferer
+ * which starts during the frame.
+ */
+class SpectrumWifiPhyTest : public TestCase
+{
+public:
+  SpectrumWifiPhyTest ();
+
+  virtual void DoRun (void);
+private:
+  /**
+   * \param interfererPsd the PSD of the interferer (W/Hz), 0 for none
+   */
+  void RunOne (double interfererPsd);
+  Ptr<WifiNetDevice> CreateOne (Vector pos, uint16_t channelNumber, Ptr<SpectrumChannel> channel, uint32_t index);
+  void SendOnePacket (Ptr<WifiNetDevice> dev);
+  void CheckCcaBusy (Ptr<WifiNetDevice> dev);
+  static void CountRx (uint32_t *rxCount, Ptr<const Packet> packet);
+
+  uint32_t m_rxBegin[3];
+  uint32_t m_rxEnd[3];
+  bool m_ccaBusy;
+  Ptr<WaveformGenerator> m_interferer;
+};
+
+SpectrumWifiPhyTest::SpectrumWifiPhyTest ()
+  : TestCase ("SpectrumWifiPhy reception and interference")
+{
+}
+
+void
+SpectrumWifiPhyTest::SendOnePacket (Ptr<WifiNetDevice> dev)
+{
+  Ptr<Packet> p = Create<Packet> (1000);
+  dev->Send (p, dev->GetBroadcast (), 1);
+}
+
+void
+SpectrumWifiPhyTest::CheckCcaBusy (Ptr<WifiNetDevice> dev)
+{
+  m_ccaBusy = dev->GetPhy ()->IsStateCcaBusy ();
+}
+
+void
+SpectrumWifiPhyTest::CountRx (uint32_t *rxCount, Ptr<const Packet> packet)
+{
+  (*rxCount)++;
+}
+
+Ptr<WifiNetDevice>
+SpectrumWifiPhyTest::CreateOne (Vector pos, uint16_t channelNumber, Ptr<SpectrumChannel> channel, uint32_t index)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+
+  Ptr<WifiMac> mac = CreateObject<AdhocWifiMac> ();
+  mac->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<SpectrumWifiPhy> phy = CreateObject<SpectrumWifiPhy> ();
+  Ptr<ErrorRateModel> error = CreateObject<NistErrorRateModel> ();
+  phy->SetErrorRateModel (error);
+  phy->SetDevice (dev);
+  phy->SetMobility (node);
+  phy->SetChannel (channel);
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  phy->SetChannelNumber (channelNumber);
+  phy->TraceConnectWithoutContext ("PhyRxBegin", MakeBoundCallback (&SpectrumWifiPhyTest::CountRx, &m_rxBegin[index]));
+  phy->TraceConnectWithoutContext ("PhyRxEnd", MakeBoundCallback (&SpectrumWifiPhyTest::CountRx, &m_rxEnd[index]));
+  Ptr<WifiRemoteStationManager> manager = CreateObject<ConstantRateWifiManager> ();
+
+  mobility->SetPosition (pos);
+  node->AggregateObject (mobility);
+  mac->SetAddress (Mac48Address::Allocate ());
+  dev->SetMac (mac);
+  dev->SetPhy (phy);
+  dev->SetRemoteStationManager (manager);
+  node->AddDevice (dev);
+
+  return dev;
+}
+
+void
+SpectrumWifiPhyTest::RunOne (double interfererPsd)
+{
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  channel->AddPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      m_rxBegin[i] = 0;
+      m_rxEnd[i] = 0;
+    }
+  m_ccaBusy = false;
+
+  // channel 36 is 5170-5190MHz, channel 44 5210-5230MHz
+  Ptr<WifiNetDevice> sender = CreateOne (Vector (0.0, 0.0, 0.0), 36, channel, 0);
+  Ptr<WifiNetDevice> receiver = CreateOne (Vector (10.0, 0.0, 0.0), 36, channel, 1);
+  CreateOne (Vector (10.0, 0.0, 0.0), 44, channel, 2);
+
+  if (interfererPsd > 0)
+    {
+      // an interferer over 5160-5200MHz, without mobility model and
+      // so without propagation loss, from 100us after the start of
+      // the frame until after its end
+      Bands bands;
+      for (uint32_t i = 0; i < 4; i++)
+        {
+          BandInfo band;
+          band.fl = 5160e6 + i * 10e6;
+          band.fh = band.fl + 10e6;
+          band.fc = band.fl + 5e6;
+          bands.push_back (band);
+        }
+      Ptr<SpectrumValue> psd = Create<SpectrumValue> (Create<SpectrumModel> (bands));
+      *psd = interfererPsd;
+      m_interferer = CreateObject<WaveformGenerator> ();
+      m_interferer->SetChannel (channel);
+      m_interferer->SetTxPowerSpectralDensity (psd);
+      m_interferer->SetPeriod (MilliSeconds (2));
+      m_interferer->SetDutyCycle (1.0);
+      Simulator::Schedule (Seconds (1.0) + MicroSeconds (100), &WaveformGenerator::Start, m_interferer);
+      Simulator::Schedule (Seconds (1.0) + MicroSeconds (200), &WaveformGenerator::Stop, m_interferer);
+    }
+
+  // the frame lasts about 1.4ms
+  Simulator::Schedule (Seconds (1.0), &SpectrumWifiPhyTest::SendOnePacket, this, sender);
+  Simulator::Schedule (Seconds (1.0) + MilliSeconds (2), &SpectrumWifiPhyTest::CheckCcaBusy, this, receiver);
+
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_interferer = 0;
+}
+
+void
+SpectrumWifiPhyTest::DoRun (void)
+{
+  // about -62dBm at 10m
+  RunOne (0);
+  NS_TEST_EXPECT_MSG_EQ (m_rxBegin[1], 1, "Frame not received on the same channel");
+  NS_TEST_EXPECT_MSG_EQ (m_rxEnd[1], 1, "Frame not decoded on the same channel");
+  NS_TEST_EXPECT_MSG_EQ (m_rxBegin[2], 0, "Frame received on another channel");
+  NS_TEST_EXPECT_MSG_EQ (m_ccaBusy, false, "CCA busy without interference");
+
+  // a -60dBm interferer over the 20MHz of the channel
+  RunOne (1e-9 / 20e6);
+  NS_TEST_EXPECT_MSG_EQ (m_rxBegin[1], 1, "Frame not received on the same channel");
+  NS_TEST_EXPECT_MSG_EQ (m_rxEnd[1], 0, "Frame decoded despite the interferer");
+  NS_TEST_EXPECT_MSG_EQ (m_rxEnd[2], 0, "Frame decoded on another channel");
+  NS_TEST_EXPECT_MSG_EQ (m_ccaBusy, true, "Interferer not sensed after the frame");
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Install SpectrumWifiPhy instances with SpectrumWifiPhyHelper on the
+ * default SingleModelSpectrumChannel, and check that each frame reaches
+ * each receiver once, although the PHY changes its SpectrumModel after
+ * it is attached to the channel.
+ */
+class SpectrumWifiPhyHelperTest : public TestCase
+{
+public:
+  SpectrumWifiPhyHelperTest ();
+
+  virtual void DoRun (void);
+private:
+  void SendOnePacket (Ptr<NetDevice> dev);
+  void NotifyPathLoss (Ptr<SpectrumPhy> txPhy, Ptr<SpectrumPhy> rxPhy, double lossDb);
+  static void CountRx (uint32_t *rxCount, Ptr<const Packet> packet);
+
+  Ptr<SpectrumPhy> m_receiver;
+  uint32_t m_startRx;
+  uint32_t m_rxBegin;
+  uint32_t m_rxDrop;
+};
+
+SpectrumWifiPhyHelperTest::SpectrumWifiPhyHelperTest ()
+  : TestCase ("SpectrumWifiPhyHelper on the default SpectrumChannel")
+{
+}
+
+void
+SpectrumWifiPhyHelperTest::SendOnePacket (Ptr<NetDevice> dev)
+{
+  Ptr<Packet> p = Create<Packet> (1000);
+  dev->Send (p, dev->GetBroadcast (), 1);
+}
+
+void
+SpectrumWifiPhyHelperTest::NotifyPathLoss (Ptr<SpectrumPhy> txPhy, Ptr<SpectrumPhy> rxPhy, double lossDb)
+{
+  // the channel fires PathLoss once for each StartRx it schedules
+  if (rxPhy == m_receiver)
+    {
+      m_startRx++;
+    }
+}
+
+void
+SpectrumWifiPhyHelperTest::CountRx (uint32_t *rxCount, Ptr<const Packet> packet)
+{
+  (*rxCount)++;
+}
+
+void
+SpectrumWifiPhyHelperTest::DoRun (void)
+{
+  m_startRx = 0;
+  m_rxBegin = 0;
+  m_rxDrop = 0;
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  positions->Add (Vector (0.0, 0.0, 0.0));
+  positions->Add (Vector (10.0, 0.0, 0.0));
+  mobility.SetPositionAllocator (positions);
+  mobility.Install (nodes);
+
+  Ptr<SpectrumChannel> channel = SpectrumChannelHelper::Default ().Create ();
+  SpectrumWifiPhyHelper phy = SpectrumWifiPhyHelper::Default ();
+  phy.SetChannel (channel);
+  NqosWifiMacHelper mac = NqosWifiMacHelper::Default ();
+  mac.SetType ("ns3::AdhocWifiMac");
+  WifiHelper wifi = WifiHelper::Default ();
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211a);
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+
+  Ptr<SpectrumWifiPhy> rxPhy = DynamicCast<SpectrumWifiPhy> (DynamicCast<WifiNetDevice> (devices.Get (1))->GetPhy ());
+  m_receiver = rxPhy->GetSpectrumPhy ();
+  rxPhy->TraceConnectWithoutContext ("PhyRxBegin", MakeBoundCallback (&SpectrumWifiPhyHelperTest::CountRx, &m_rxBegin));
+  rxPhy->TraceConnectWithoutContext ("PhyRxDrop", MakeBoundCallback (&SpectrumWifiPhyHelperTest::CountRx, &m_rxDrop));
+  channel->TraceConnectWithoutContext ("PathLoss", MakeCallback (&SpectrumWifiPhyHelperTest::NotifyPathLoss, this));
+
+  Simulator::Schedule (Seconds (1.0), &SpectrumWifiPhyHelperTest::SendOnePacket, this, devices.Get (0));
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_receiver = 0;
+
+  NS_TEST_EXPECT_MSG_EQ (m_startRx, 1, "Frame delivered more than once to the receiver");
+  NS_TEST_EXPECT_MSG_EQ (m_rxBegin, 1, "Frame not received");
+  NS_TEST_EXPECT_MSG_EQ (m_rxDrop, 0, "Frame dropped");
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Check the lookups by TID and address, the counters and the expiry of
+ * WifiMacQueue against the FIFO order of the queue.
+ */
+class WifiMacQueueTest : public TestCase
+{
+public:
+  WifiMacQueueTest ();
+
+  virtual void DoRun (void);
+private:
+  /**
+   * Enqueue a QoS data packet.
+   *
+   * \param addr1 the receiver address
+   * \param tid the TID
+   * \param size the size of the packet, to tell the packets apart
+   * \param front true to push the packet at the front of the queue
+   */
+  void Enqueue (Mac48Address addr1, uint8_t tid, uint32_t size, bool front);
+  void CheckExpiry (void);
+
+  Ptr<WifiMacQueue> m_queue;
+  Mac48Address m_addr2;
+};
+
+WifiMacQueueTest::WifiMacQueueTest ()
+  : TestCase ("WifiMacQueue lookups by TID and address")
+{
+}
+
+void
+WifiMacQueueTest::Enqueue (Mac48Address addr1, uint8_t tid, uint32_t size, bool front)
+{
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetAddr1 (addr1);
+  hdr.SetAddr2 (m_addr2);
+  hdr.SetQosTid (tid);
+  if (front)
+    {
+      m_queue->PushFront (Create<Packet> (size), hdr);
+    }
+  else
+    {
+      m_queue->Enqueue (Create<Packet> (size), hdr);
+    }
+}
+
+void
+WifiMacQueueTest::CheckExpiry (void)
+{
+  // the packets of the first second have expired
+  Mac48Address a = Mac48Address ("00:00:00:00:00:01");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, WifiMacHeader::ADDR1, a), 1, "Expired packets counted");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetSize (), 1, "Expired packets counted");
+  WifiMacHeader hdr;
+  Ptr<const Packet> packet = m_queue->PeekByTidAndAddress (&hdr, 0, WifiMacHeader::ADDR1, a);
+  NS_TEST_EXPECT_MSG_EQ (packet->GetSize (), 30, "Expired packet peeked");
+}
+
+void
+WifiMacQueueTest::DoRun (void)
+{
+  m_queue = CreateObject<WifiMacQueue> ();
+  m_queue->SetMaxDelay (Seconds (1.0));
+  m_addr2 = Mac48Address ("00:00:00:00:00:10");
+  Mac48Address a = Mac48Address ("00:00:00:00:00:01");
+  Mac48Address b = Mac48Address ("00:00:00:00:00:02");
+
+  Enqueue (a, 0, 1, false);
+  Enqueue (b, 0, 2, false);
+  Enqueue (a, 5, 3, false);
+  Enqueue (a, 0, 4, false);
+  WifiMacHeader mgt;
+  mgt.SetType (WIFI_MAC_MGT_BEACON);
+  m_queue->Enqueue (Create<Packet> (5), mgt);
+  Enqueue (a, 0, 6, true);
+
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetSize (), 6, "Wrong queue size");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, WifiMacHeader::ADDR1, a), 3, "Wrong count");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (5, WifiMacHeader::ADDR1, a), 1, "Wrong count");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (5, WifiMacHeader::ADDR1, b), 0, "Wrong count");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, WifiMacHeader::ADDR2, m_addr2), 4, "Wrong count by Address 2");
+
+  WifiMacHeader hdr;
+  Ptr<const Packet> packet = m_queue->PeekByTidAndAddress (&hdr, 0, WifiMacHeader::ADDR1, a);
+  NS_TEST_EXPECT_MSG_EQ (packet->GetSize (), 6, "Pushed front packet not first");
+  packet = m_queue->DequeueByTidAndAddress (&hdr, 0, WifiMacHeader::ADDR1, a);
+  NS_TEST_EXPECT_MSG_EQ (packet->GetSize (), 6, "Pushed front packet not first");
+  packet = m_queue->DequeueByTidAndAddress (&hdr, 0, WifiMacHeader::ADDR1, a);
+  NS_TEST_EXPECT_MSG_EQ (packet->GetSize (), 1, "Wrong packet dequeued");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, WifiMacHeader::ADDR1, a), 1, "Wrong count");
+  packet = m_queue->DequeueByTidAndAddress (&hdr, 0, WifiMacHeader::ADDR2, m_addr2);
+  NS_TEST_EXPECT_MSG_EQ (packet->GetSize (), 2, "Wrong packet dequeued by Address 2");
+
+  packet = m_queue->Peek (&hdr);
+  NS_TEST_EXPECT_MSG_EQ (m_queue->Remove (packet), true, "Packet not removed");
+  NS_TEST_EXPECT_MSG_EQ (packet->GetSize (), 3, "Wrong front packet");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (5, WifiMacHeader::ADDR1, a), 0, "Removed packet counted");
+  packet = m_queue->Dequeue (&hdr);
+  NS_TEST_EXPECT_MSG_EQ (packet->GetSize (), 4, "Wrong front packet");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetSize (), 1, "Wrong queue size");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, WifiMacHeader::ADDR1, a), 0, "Dequeued packet counted");
+
+  // the remaining beacon and a packet expire at 1s, another one is
+  // pushed in front at 0.5s and expires at 1.5s
+  Enqueue (a, 0, 10, false);
+  Simulator::Schedule (Seconds (0.5), &WifiMacQueueTest::Enqueue, this, a, 0, 30, true);
+  Simulator::Schedule (Seconds (1.0), &WifiMacQueueTest::CheckExpiry, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ (m_queue->IsEmpty (), false, "Packet expired too early");
+  m_queue = 0;
+}
+
+//-----------------------------------------------------------------------------
+class AmpduAggregationTest : public TestCase
+{
+public:
+  enum Scenario
+  {
+    LOSSLESS,
+    CORRUPTED_SUBFRAMES,
+    MISSED_BLOCK_ACK,
+    MISSED_CTS,
+    NON_HT
+  };
+
+  AmpduAggregationTest (enum Scenario scenario);
+
+  virtual void DoRun (void);
+private:
+  static std::string BuildNameString (enum Scenario scenario);
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+  void PhyTxBegin (Ptr<const Packet> packet);
+  /// corrupt some subframes of the first A-MPDUs, as the receiving PHY would
+  void ReceiverRxOk (Ptr<Packet> packet, double snr, WifiMode mode, enum WifiPreamble preamble);
+  /// miss the first block acks or CTSs
+  void SenderRxOk (Ptr<Packet> packet, double snr, WifiMode mode, enum WifiPreamble preamble);
+  void SendPackets (Ptr<WifiNetDevice> device, Address to);
+  /// receive a QoS data frame under block ack from the sender
+  void InjectData (uint16_t sequence);
+  /// receive a block ack request from the sender
+  void InjectBlockAckReq (uint16_t startingSequence);
+  /// check that MPDUs are aggregated and deaggregated back
+  void CheckAggregator (void);
+
+  enum Scenario m_scenario;
+  Mac48Address m_senderAddress;
+  Mac48Address m_receiverAddress;
+  Ptr<MacLow> m_senderLow;
+  Ptr<MacLow> m_receiverLow;
+  uint32_t m_received;
+  uint32_t m_ampdus;
+  uint32_t m_retries; //!< MPDUs retransmitted in an A-MPDU
+  uint32_t m_bars;
+  uint32_t m_corruptedAmpdus; //!< A-MPDUs left to corrupt
+  uint32_t m_missedResponses; //!< block acks or CTSs left to miss
+};
+
+AmpduAggregationTest::AmpduAggregationTest (enum Scenario scenario)
+  : TestCase (BuildNameString (scenario)),
+    m_scenario (scenario)
+{
+}
+
+std::string
+AmpduAggregationTest::BuildNameString (enum Scenario scenario)
+{
+  switch (scenario)
+    {
+    case CORRUPTED_SUBFRAMES:
+      return "A-MPDU aggregation with corrupted subframes";
+    case MISSED_BLOCK_ACK:
+      return "A-MPDU aggregation with missed block acks";
+    case MISSED_CTS:
+      return "A-MPDU aggregation with missed CTSs";
+    case NON_HT:
+      return "No A-MPDU aggregation over a non-HT PHY";
+    default:
+      return "A-MPDU aggregation";
+    }
+}
+
+bool
+AmpduAggregationTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from)
+{
+  m_received++;
+  return true;
+}
+
+void
+AmpduAggregationTest::PhyTxBegin (Ptr<const Packet> packet)
+{
+  AmpduTag tag;
+  if (packet->PeekPacketTag (tag))
+    {
+      m_ampdus++;
+      MpduAggregator::DeaggregatedMpdus mpdus = MpduAggregator::Deaggregate (packet->Copy ());
+      for (MpduAggregator::DeaggregatedMpdusCI i = mpdus.begin (); i != mpdus.end (); i++)
+        {
+          WifiMacHeader hdr;
+          i->first->PeekHeader (hdr);
+          if (hdr.IsRetry ())
+            {
+              m_retries++;
+            }
+        }
+      return;
+    }
+  WifiMacHeader hdr;
+  packet->PeekHeader (hdr);
+  if (hdr.IsBlockAckReq ())
+    {
+      m_bars++;
+    }
+}
+
+void
+AmpduAggregationTest::ReceiverRxOk (Ptr<Packet> packet, double snr, WifiMode mode, enum WifiPreamble preamble)
+{
+  AmpduTag tag;
+  if (m_corruptedAmpdus > 0 && packet->PeekPacketTag (tag))
+    {
+      m_corruptedAmpdus--;
+      uint32_t nSubframes = MpduAggregator::GetSubframeSizes (packet).size ();
+      for (uint32_t i = 1; i < nSubframes; i += 2)
+        {
+          tag.SetCorrupted (i);
+        }
+      packet->ReplacePacketTag (tag);
+    }
+  m_receiverLow->ReceiveOk (packet, snr, mode, preamble);
+}
+
+void
+AmpduAggregationTest::SenderRxOk (Ptr<Packet> packet, double snr, WifiMode mode, enum WifiPreamble preamble)
+{
+  WifiMacHeader hdr;
+  packet->PeekHeader (hdr);
+  // the responses to the A-MPDUs only, not to the frames setting up the agreement
+  if (m_missedResponses > 0 && m_ampdus > 0
+      && ((m_scenario == MISSED_BLOCK_ACK && hdr.IsBlockAck ())
+          || (m_scenario == MISSED_CTS && hdr.IsCts ())))
+    {
+      m_missedResponses--;
+      m_senderLow->ReceiveError (packet, snr);
+      return;
+    }
+  m_senderLow->ReceiveOk (packet, snr, mode, preamble);
+}
+
+void
+AmpduAggregationTest::SendPackets (Ptr<WifiNetDevice> device, Address to)
+{
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      device->Send (Create<Packet> (1000), to, 1);
+    }
+}
+
+void
+AmpduAggregationTest::InjectData (uint16_t sequence)
+{
+  Ptr<Packet> packet = Create<Packet> (1000);
+  LlcSnapHeader llc;
+  llc.SetType (1);
+  packet->AddHeader (llc);
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetAddr1 (m_receiverAddress);
+  hdr.SetAddr2 (m_senderAddress);
+  hdr.SetAddr3 (m_receiverLow->GetBssid ());
+  hdr.SetDsNotFrom ();
+  hdr.SetDsNotTo ();
+  hdr.SetQosTid (0);
+  hdr.SetQosAckPolicy (WifiMacHeader::BLOCK_ACK);
+  hdr.SetQosNoEosp ();
+  hdr.SetQosNoAmsdu ();
+  hdr.SetQosTxopLimit (0);
+  hdr.SetSequenceNumber (sequence);
+  hdr.SetFragmentNumber (0);
+  hdr.SetNoMoreFragments ();
+  packet->AddHeader (hdr);
+  WifiMacTrailer fcs;
+  packet->AddTrailer (fcs);
+  m_receiverLow->ReceiveOk (packet, 100.0, WifiPhy::GetOfdmRate65MbpsBW20MHz (), WIFI_PREAMBLE_HT_MF);
+}
+
+void
+AmpduAggregationTest::InjectBlockAckReq (uint16_t startingSequence)
+{
+  CtrlBAckRequestHeader reqHdr;
+  reqHdr.SetType (COMPRESSED_BLOCK_ACK);
+  reqHdr.SetTidInfo (0);
+  reqHdr.SetStartingSequence (startingSequence);
+  Ptr<Packet> packet = Create<Packet> ();
+  packet->AddHeader (reqHdr);
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_CTL_BACKREQ);
+  hdr.SetAddr1 (m_receiverAddress);
+  hdr.SetAddr2 (m_senderAddress);
+  // long enough for the SIFS and the block ack
+  hdr.SetDuration (MicroSeconds (500));
+  hdr.SetDsNotFrom ();
+  hdr.SetDsNotTo ();
+  packet->AddHeader (hdr);
+  WifiMacTrailer fcs;
+  packet->AddTrailer (fcs);
+  m_receiverLow->ReceiveOk (packet, 100.0, WifiPhy::GetOfdmRate6_5MbpsBW20MHz (), WIFI_PREAMBLE_HT_MF);
+}
+
+void
+AmpduAggregationTest::CheckAggregator (void)
+{
+  Ptr<MpduStandardAggregator> aggregator = CreateObject<MpduStandardAggregator> ();
+  aggregator->SetAttribute ("MaxAmpduSize", UintegerValue (400));
+  Ptr<Packet> ampdu = Create<Packet> ();
+  NS_TEST_EXPECT_MSG_EQ (aggregator->Aggregate (Create<Packet> (100), ampdu), true, "MPDU not aggregated");
+  NS_TEST_EXPECT_MSG_EQ (aggregator->Aggregate (Create<Packet> (201), ampdu), true, "MPDU not aggregated");
+  NS_TEST_EXPECT_MSG_EQ (aggregator->CanBeAggregated (50, ampdu->GetSize ()), true, "MPDU should fit");
+  NS_TEST_EXPECT_MSG_EQ (aggregator->CanBeAggregated (100, ampdu->GetSize ()), false, "MPDU should not fit");
+  NS_TEST_EXPECT_MSG_EQ (aggregator->CanBeAggregated (4096, 0), false, "MPDU too large for a delimiter");
+  NS_TEST_EXPECT_MSG_EQ (aggregator->Aggregate (Create<Packet> (50), ampdu), true, "MPDU not aggregated");
+  NS_TEST_EXPECT_MSG_EQ (aggregator->Aggregate (Create<Packet> (30), ampdu), false, "A-MPDU larger than MaxAmpduSize");
+  // the first two subframes are padded to a multiple of 4 octets
+  NS_TEST_EXPECT_MSG_EQ (ampdu->GetSize (), 104 + 208 + 54, "Wrong A-MPDU size");
+
+  std::vector<uint32_t> sizes = MpduAggregator::GetSubframeSizes (ampdu);
+  NS_TEST_ASSERT_MSG_EQ (sizes.size (), 3, "Wrong number of subframes");
+  NS_TEST_EXPECT_MSG_EQ (sizes[0], 104, "Wrong subframe size");
+  NS_TEST_EXPECT_MSG_EQ (sizes[1], 208, "Wrong subframe size");
+  NS_TEST_EXPECT_MSG_EQ (sizes[2], 54, "Wrong subframe size");
+
+  MpduAggregator::DeaggregatedMpdus mpdus = MpduAggregator::Deaggregate (ampdu);
+  NS_TEST_ASSERT_MSG_EQ (mpdus.size (), 3, "Wrong number of MPDUs");
+  MpduAggregator::DeaggregatedMpdusCI i = mpdus.begin ();
+  NS_TEST_EXPECT_MSG_EQ (i->first->GetSize (), 100, "Wrong MPDU size");
+  NS_TEST_EXPECT_MSG_EQ (i->second.IsSignatureValid (), true, "Wrong delimiter signature");
+  i++;
+  NS_TEST_EXPECT_MSG_EQ (i->first->GetSize (), 201, "Wrong MPDU size");
+  i++;
+  NS_TEST_EXPECT_MSG_EQ (i->first->GetSize (), 50, "Wrong MPDU size");
+}
+
+void
+AmpduAggregationTest::DoRun (void)
+{
+  if (m_scenario == LOSSLESS)
+    {
+      CheckAggregator ();
+    }
+
+  m_received = 0;
+  m_ampdus = 0;
+  m_retries = 0;
+  m_bars = 0;
+  m_corruptedAmpdus = (m_scenario == CORRUPTED_SUBFRAMES) ? 3 : 0;
+  m_missedResponses = (m_scenario == MISSED_BLOCK_ACK || m_scenario == MISSED_CTS) ? 2 : 0;
+  NodeContainer nodes;
+  nodes.Create (2);
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (i * 5.0, 0.0, 0.0));
+      nodes.Get (i)->AggregateObject (mobility);
+    }
+
+  WifiHelper wifi = WifiHelper::Default ();
+  // an RTS protects every frame when the CTSs are missed
+  std::string rtsCtsThreshold = (m_scenario == MISSED_CTS) ? "0" : "2346";
+  HtWifiMacHelper mac = HtWifiMacHelper::Default ();
+  if (m_scenario == NON_HT)
+    {
+      wifi.SetStandard (WIFI_PHY_STANDARD_80211a);
+      wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                    "DataMode", StringValue ("OfdmRate54Mbps"),
+                                    "ControlMode", StringValue ("OfdmRate6Mbps"));
+    }
+  else
+    {
+      wifi.SetStandard (WIFI_PHY_STANDARD_80211n_5GHZ);
+      wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                    "DataMode", StringValue ("OfdmRate65MbpsBW20MHz"),
+                                    "ControlMode", StringValue ("OfdmRate6_5MbpsBW20MHz"),
+                                    "RtsCtsThreshold", StringValue (rtsCtsThreshold));
+    }
+  mac.SetType ("ns3::AdhocWifiMac",
+               "QosSupported", BooleanValue (true),
+               "HtSupported", BooleanValue (m_scenario != NON_HT));
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+  mac.SetBlockAckThresholdForAc (AC_BE, 2);
+  mac.SetMpduAggregatorForAc (AC_BE, "ns3::MpduStandardAggregator");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+
+  Ptr<WifiNetDevice> sender = DynamicCast<WifiNetDevice> (devices.Get (0));
+  Ptr<WifiNetDevice> receiver = DynamicCast<WifiNetDevice> (devices.Get (1));
+  m_senderAddress = Mac48Address::ConvertFrom (sender->GetAddress ());
+  m_receiverAddress = Mac48Address::ConvertFrom (receiver->GetAddress ());
+  PointerValue ptr;
+  sender->GetMac ()->GetAttribute ("BE_EdcaTxopN", ptr);
+  m_senderLow = ptr.Get<EdcaTxopN> ()->Low ();
+  receiver->GetMac ()->GetAttribute ("BE_EdcaTxopN", ptr);
+  m_receiverLow = ptr.Get<EdcaTxopN> ()->Low ();
+  sender->GetPhy ()->SetReceiveOkCallback (MakeCallback (&AmpduAggregationTest::SenderRxOk, this));
+  receiver->GetPhy ()->SetReceiveOkCallback (MakeCallback (&AmpduAggregationTest::ReceiverRxOk, this));
+  sender->GetPhy ()->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&AmpduAggregationTest::PhyTxBegin, this));
+  receiver->SetReceiveCallback (MakeCallback (&AmpduAggregationTest::Receive, this));
+
+  Simulator::Schedule (Seconds (1.0), &AmpduAggregationTest::SendPackets, this, sender, receiver->GetAddress ());
+  if (m_scenario == LOSSLESS)
+    {
+      /* the 100 packets used the sequence numbers 0 to 99: the recipient buffers
+         101 and 102 while waiting for 100, until a block ack request tells that
+         the originator does not send 100 any more */
+      Simulator::Schedule (Seconds (1.5), &AmpduAggregationTest::InjectData, this, 101);
+      Simulator::Schedule (Seconds (1.5), &AmpduAggregationTest::InjectData, this, 102);
+      Simulator::Schedule (Seconds (1.6), &AmpduAggregationTest::InjectBlockAckReq, this, 103);
+    }
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_senderLow = 0;
+  m_receiverLow = 0;
+
+  switch (m_scenario)
+    {
+    case LOSSLESS:
+      NS_TEST_EXPECT_MSG_EQ (m_received, 102, "Packets lost, or buffered packets not released by the block ack request");
+      NS_TEST_EXPECT_MSG_GT (m_ampdus, 0, "No A-MPDU sent");
+      NS_TEST_EXPECT_MSG_EQ (m_retries, 0, "MPDU retransmitted over a lossless channel");
+      break;
+    case CORRUPTED_SUBFRAMES:
+      NS_TEST_EXPECT_MSG_EQ (m_received, 100, "Packets lost");
+      NS_TEST_EXPECT_MSG_GT (m_retries, 0, "Corrupted MPDUs not retransmitted");
+      NS_TEST_EXPECT_MSG_EQ (m_bars, 0, "The block acks tell which MPDUs were corrupted");
+      break;
+    case MISSED_BLOCK_ACK:
+    case MISSED_CTS:
+      NS_TEST_EXPECT_MSG_EQ (m_received, 100, "Packets lost");
+      NS_TEST_EXPECT_MSG_EQ (m_missedResponses, 0, "Responses not missed");
+      NS_TEST_EXPECT_MSG_GT (m_bars, 0, "No block ack request after a missed response");
+      break;
+    case NON_HT:
+      NS_TEST_EXPECT_MSG_EQ (m_received, 100, "Packets lost");
+      NS_TEST_EXPECT_MSG_EQ (m_ampdus, 0, "A-MPDU sent over a non-HT PHY");
+      break;
+    }
+}
+
+//-----------------------------------------------------------------------------
+class WifiRemoteStationTableTest : public TestCase
+{
+public:
+  WifiRemoteStationTableTest ();
+
+  virtual void DoRun (void);
+};
+
+WifiRemoteStationTableTest::WifiRemoteStationTableTest ()
+  : TestCase ("WifiRemoteStationManager lookups of many stations")
+{
+}
+
+void
+WifiRemoteStationTableTest::DoRun (void)
+{
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<WifiRemoteStationManager> manager = CreateObject<MinstrelWifiManager> ();
+  manager->SetupPhy (phy);
+
+  std::vector<Mac48Address> addresses;
+  for (uint32_t i = 0; i < 300; i++)
+    {
+      Mac48Address address = Mac48Address::Allocate ();
+      addresses.push_back (address);
+      for (uint32_t j = 0; j < phy->GetNModes (); j++)
+        {
+          manager->AddSupportedMode (address, phy->GetMode (j));
+        }
+      if (i % 3 == 0)
+        {
+          manager->RecordGotAssocTxOk (address);
+        }
+      WifiMacHeader hdr;
+      hdr.SetType (WIFI_MAC_QOSDATA);
+      hdr.SetAddr1 (address);
+      hdr.SetQosTid (i % 8);
+      Ptr<Packet> packet = Create<Packet> (1000);
+      WifiTxVector txVector = manager->GetDataTxVector (address, &hdr, packet, packet->GetSize ());
+      manager->ReportDataOk (address, &hdr, 20.0, txVector.GetMode (), 20.0);
+    }
+  for (uint32_t i = 0; i < addresses.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (manager->IsBrandNew (addresses[i]), (i % 3 != 0), "Wrong brand new state");
+      NS_TEST_EXPECT_MSG_EQ (manager->IsAssociated (addresses[i]), (i % 3 == 0), "Wrong association state");
+    }
+  manager->RecordDisassociated (addresses[0]);
+  NS_TEST_EXPECT_MSG_EQ (manager->IsAssociated (addresses[0]), false, "Station should be disassociated");
+  NS_TEST_EXPECT_MSG_EQ (manager->IsAssociated (addresses[3]), true, "Other stations should stay associated");
+  manager->Dispose ();
+  phy->Dispose ();
+}
+
 //-----------------------------------------------------------------------------
 class WifiTestSuite : public TestSuite
 {
@@ -492,6 +1692,19 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new QosUtilsIsOldPacketTest, TestCase::QUICK);
   AddTestCase (new InterferenceHelperSequenceTest, TestCase::QUICK); // Bug 991
   AddTestCase (new Bug555TestCase, TestCase::QUICK); // Bug 555
+  AddTestCase (new YansWifiChannelRangeTest, TestCase::QUICK);
+  AddTestCase (new InterferenceHelperEnergyDurationTest, TestCase::QUICK);
+  AddTestCase (new TableErrorRateModelTest, TestCase::QUICK);
+  AddTestCase (new InterferenceHelperAbstractionTest, TestCase::QUICK);
+  AddTestCase (new SpectrumWifiPhyTest, TestCase::QUICK);
+  AddTestCase (new SpectrumWifiPhyHelperTest, TestCase::QUICK);
+  AddTestCase (new WifiMacQueueTest, TestCase::QUICK);
+  AddTestCase (new AmpduAggregationTest (AmpduAggregationTest::LOSSLESS), TestCase::QUICK);
+  AddTestCase (new AmpduAggregationTest (AmpduAggregationTest::CORRUPTED_SUBFRAMES), TestCase::QUICK);
+  AddTestCase (new AmpduAggregationTest (AmpduAggregationTest::MISSED_BLOCK_ACK), TestCase::QUICK);
+  AddTestCase (new AmpduAggregationTest (AmpduAggregationTest::MISSED_CTS), TestCase::QUICK);
+  AddTestCase (new AmpduAggregationTest (AmpduAggregationTest::NON_HT), TestCase::QUICK);
+  AddTestCase (new WifiRemoteStationTableTest, TestCase::QUICK);
 }
 
 static WifiTestSuite g_wifiTestSuite;